@@ -0,0 +1,84 @@
+#include "utils/logger/logger.h"
+#include "framework/core/thread_pool.h"
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+
+/*dispatch cost of the ThreadPool schedule policies: latency of one tiny task and throughput of many producers*/
+using namespace anakin;
+
+namespace {
+
+typedef std::chrono::steady_clock bench_clock;
+
+int g_tasks_per_producer = 20000;
+int g_latency_rounds = 2000;
+
+const char* policy_name(SchedulePolicy policy) {
+    return policy == SchedulePolicy::FIFO ? "fifo" : "work_stealing";
+}
+
+/// average round trip (us) of one tiny task pushed from outside the pool and waited by future.
+double dispatch_latency_us(SchedulePolicy policy, int thread_num) {
+    ThreadPool pool(thread_num, policy);
+    pool.launch();
+    std::function<int(int)> echo = [](int i) { return i; };
+    auto start = bench_clock::now();
+    for (int i = 0; i < g_latency_rounds; i++) {
+        auto ret = pool.RunAsync(echo, i);
+        CHECK_EQ(ret.get(), i);
+    }
+    return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count() / g_latency_rounds;
+}
+
+/// tiny tasks per second when thread_num producers keep pushing into the pool.
+double dispatch_throughput(SchedulePolicy policy, int thread_num) {
+    ThreadPool pool(thread_num, policy);
+    pool.launch();
+    std::atomic<int> done{0};
+    std::function<int(int)> count = [&done](int i) {
+        done++;
+        return i;
+    };
+    int producers = thread_num;
+    auto start = bench_clock::now();
+    std::vector<std::thread> producer_threads;
+    for (int p = 0; p < producers; p++) {
+        producer_threads.emplace_back([&]() {
+            for (int i = 0; i < g_tasks_per_producer; i++) {
+                pool.RunAsync(count, i);
+            }
+        });
+    }
+    for (auto& producer : producer_threads) {
+        producer.join();
+    }
+    while (done.load() < producers * g_tasks_per_producer) {
+        std::this_thread::yield();
+    }
+    double sec = std::chrono::duration<double>(bench_clock::now() - start).count();
+    return producers * g_tasks_per_producer / sec;
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+    logger::init(argv[0]);
+    if (argc > 1) {
+        g_tasks_per_producer = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        g_latency_rounds = atoi(argv[2]);
+    }
+    LOG(INFO) << "usage: ./" << argv[0] << " [tasks per producer] [latency rounds]";
+    for (int thread_num : {1, 2, 4, 8, 16, 32, 64}) {
+        for (auto policy : {SchedulePolicy::FIFO, SchedulePolicy::WORK_STEALING}) {
+            double latency = dispatch_latency_us(policy, thread_num);
+            double throughput = dispatch_throughput(policy, thread_num);
+            LOG(INFO) << "threads: " << thread_num << " policy: " << policy_name(policy)
+                      << " dispatch latency: " << latency << " us"
+                      << " throughput: " << throughput / 1e6 << " M tasks/s";
+        }
+    }
+    return 0;
+}
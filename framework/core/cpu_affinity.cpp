@@ -0,0 +1,176 @@
+#include "framework/core/cpu_affinity.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "utils/logger/logger.h"
+#if defined(__linux__) && !defined(USE_SGX)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+#if defined(USE_X86_PLACE) && !defined(USE_SGX)
+#include "mkl_service.h"
+#include "saber/funcs/impl/x86/anakin_thread.h"
+#endif
+
+namespace anakin {
+
+namespace {
+
+#if defined(__linux__) && !defined(USE_SGX)
+/// mode of set_mempolicy(2), numaif.h isn't always installed.
+const int kMpolPreferred = 1;
+#endif
+
+} // namespace
+
+int num_cores() {
+#if defined(USE_X86_PLACE) && !defined(USE_SGX)
+    return anakin_get_max_threads();
+#else
+    return std::max(1u, std::thread::hardware_concurrency());
+#endif
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cores;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) {
+            continue;
+        }
+        char* end = nullptr;
+        long first = strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || first < 0 || last < first) {
+            LOG(ERROR) << "malformed cpu list: " << list;
+            return {};
+        }
+        for (long core = first; core <= last; core++) {
+            cores.push_back(core);
+        }
+    }
+    return cores;
+}
+
+std::vector<int> thread_cores() {
+    std::vector<int> cores;
+#if defined(__linux__) && !defined(USE_SGX)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) == 0) {
+        for (int core = 0; core < CPU_SETSIZE; core++) {
+            if (CPU_ISSET(core, &mask)) {
+                cores.push_back(core);
+            }
+        }
+    }
+#endif
+    if (cores.empty()) {
+        for (int core = 0; core < num_cores(); core++) {
+            cores.push_back(core);
+        }
+    }
+    return cores;
+}
+
+bool bind_thread_to_cores(const std::vector<int>& cores) {
+#if defined(__linux__) && !defined(USE_SGX)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (auto core : cores) {
+        if (core >= 0 && core < CPU_SETSIZE) {
+            CPU_SET(core, &mask);
+        }
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    if (ret != 0) {
+        LOG(WARNING) << "bind thread to " << cores.size() << " cores from "
+                     << (cores.empty() ? -1 : cores[0]) << " failed: " << ret;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void set_team_size(int threads) {
+#if defined(USE_X86_PLACE) && !defined(USE_SGX)
+    anakin_set_num_threads(threads);
+    mkl_set_num_threads_local(threads);
+#endif
+}
+
+int team_size() {
+#if defined(USE_X86_PLACE) && !defined(USE_SGX)
+    return anakin_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int numa_node_num() {
+    int nodes = 0;
+#if defined(__linux__) && !defined(USE_SGX)
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (online >> list) {
+        auto ids = parse_cpu_list(list);
+        nodes = ids.empty() ? 0 : ids.back() + 1;
+    }
+#endif
+    return std::max(nodes, 1);
+}
+
+int numa_node_of_core(int core) {
+#if defined(__linux__) && !defined(USE_SGX)
+    // the core directory links to its node as nodeN
+    std::string dir_path = "/sys/devices/system/cpu/cpu" + std::to_string(core);
+    DIR* dir = opendir(dir_path.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    int node = 0;
+    while (auto* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0
+                && std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            node = atoi(name.c_str() + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+#else
+    return 0;
+#endif
+}
+
+bool prefer_numa_node(int node) {
+#if defined(__linux__) && !defined(USE_SGX) && defined(SYS_set_mempolicy)
+    const int bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] = 1UL << (node % bits);
+    // the kernel reads maxnode - 1 bits of mask
+    if (syscall(SYS_set_mempolicy, kMpolPreferred, mask.data(), mask.size() * bits + 1) != 0) {
+        LOG(WARNING) << "prefer memory of numa node " << node << " failed";
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+} /* namespace anakin */
@@ -0,0 +1,60 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_CPU_AFFINITY_H
+#define ANAKIN_CPU_AFFINITY_H
+
+#include <string>
+#include <vector>
+#include "anakin_config.h"
+
+namespace anakin {
+
+/**
+ *  \brief Cpu placement of the calling thread.
+ *   They are no-ops returning false (and node 0) where the os doesn't support them,
+ *   callers keep working without placement.
+ */
+
+/// cores the process may use for compute threads.
+int num_cores();
+
+/// parse a cpu list as in /sys/devices/system/cpu/online, e.g. "0-3,8,10-11", empty if malformed.
+std::vector<int> parse_cpu_list(const std::string& list);
+
+/// cores the calling thread may run on, all cores when unknown.
+std::vector<int> thread_cores();
+
+/// pin the calling thread to cores.
+bool bind_thread_to_cores(const std::vector<int>& cores);
+
+/// set the OpenMP team (and MKL threads) of the calling thread.
+void set_team_size(int threads);
+
+/// OpenMP team of the calling thread, 1 where there is none.
+int team_size();
+
+/// NUMA nodes of the host, 1 without NUMA information.
+int numa_node_num();
+
+/// NUMA node of core.
+int numa_node_of_core(int core);
+
+/// allocate the pages the calling thread touches first on node, falling back to others when it's full.
+bool prefer_numa_node(int node);
+
+} /* namespace anakin */
+
+#endif
@@ -0,0 +1,73 @@
+#include "framework/core/net/arena_planner.h"
+#include <algorithm>
+#include "utils/logger/logger.h"
+
+namespace anakin {
+
+void ArenaPlanner::add(const std::string& name, size_t size, int first_use, int last_use) {
+    CHECK_EQ(_index.count(name), 0) << "buffer " << name << " is added twice";
+    CHECK_LE(first_use, last_use) << "buffer " << name << " has a bad lifetime";
+    size_t aligned = (size + _alignment - 1) / _alignment * _alignment;
+    _index[name] = _blocks.size();
+    _blocks.push_back({name, aligned, first_use, last_use, 0});
+    _total += size;
+}
+
+size_t ArenaPlanner::plan() {
+    std::vector<int> order(_blocks.size());
+    for (int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    // big buffers first, ties broken by first use so the plan is deterministic.
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        if (_blocks[a].size != _blocks[b].size) {
+            return _blocks[a].size > _blocks[b].size;
+        }
+        return _blocks[a].first_use < _blocks[b].first_use;
+    });
+
+    _peak = 0;
+    std::vector<int> placed;
+    for (auto id : order) {
+        auto& block = _blocks[id];
+        // placed buffers alive at the same time, by offset
+        std::vector<int> conflicts;
+        for (auto other : placed) {
+            auto& o = _blocks[other];
+            if (o.first_use <= block.last_use && block.first_use <= o.last_use) {
+                conflicts.push_back(other);
+            }
+        }
+        std::sort(conflicts.begin(), conflicts.end(), [this](int a, int b) {
+            return _blocks[a].offset < _blocks[b].offset;
+        });
+        size_t best_offset = 0;
+        size_t best_gap = 0;
+        bool found = false;
+        size_t cursor = 0;
+        for (auto other : conflicts) {
+            auto& o = _blocks[other];
+            if (o.offset > cursor) {
+                size_t gap = o.offset - cursor;
+                if (gap >= block.size && (!found || gap < best_gap)) {
+                    best_offset = cursor;
+                    best_gap = gap;
+                    found = true;
+                }
+            }
+            cursor = std::max(cursor, o.offset + o.size);
+        }
+        block.offset = found ? best_offset : cursor;
+        _peak = std::max(_peak, block.offset + block.size);
+        placed.push_back(id);
+    }
+    return _peak;
+}
+
+size_t ArenaPlanner::offset(const std::string& name) const {
+    auto it = _index.find(name);
+    CHECK(it != _index.end()) << "buffer " << name << " is not planned";
+    return _blocks[it->second].offset;
+}
+
+} /* namespace anakin */
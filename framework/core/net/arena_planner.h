@@ -0,0 +1,71 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_ARENA_PLANNER_H
+#define ANAKIN_ARENA_PLANNER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace anakin {
+
+/**
+ *  \brief Static planner packing buffers with known lifetimes into one arena.
+ *
+ *   Every buffer has a size in bytes and a lifetime [first_use, last_use] in op
+ *   execution order. Buffers are placed greedily by decreasing size, each one at the
+ *   best fitting gap between the placed buffers whose lifetimes overlap it.
+ */
+class ArenaPlanner {
+public:
+    explicit ArenaPlanner(size_t alignment = 64) : _alignment(alignment) {}
+    ~ArenaPlanner() {}
+
+    /// add buffer name of size bytes alive from op first_use to op last_use (inclusive).
+    void add(const std::string& name, size_t size, int first_use, int last_use);
+
+    /// assign offsets to all buffers, return arena size in bytes.
+    size_t plan();
+
+    /// offset of buffer name in arena, valid after plan().
+    size_t offset(const std::string& name) const;
+
+    /// arena size in bytes, valid after plan().
+    size_t peak() const { return _peak; }
+
+    /// sum of all buffer sizes, the memory needed without any reuse.
+    size_t total() const { return _total; }
+
+    int size() const { return _blocks.size(); }
+
+private:
+    struct Block {
+        std::string name;
+        size_t size;
+        int first_use;
+        int last_use;
+        size_t offset;
+    };
+    size_t _alignment;
+    std::vector<Block> _blocks;
+    std::unordered_map<std::string, int> _index;
+    size_t _peak{0};
+    size_t _total{0};
+};
+
+} /* namespace anakin */
+
+#endif
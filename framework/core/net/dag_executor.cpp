@@ -0,0 +1,266 @@
+#include "framework/core/net/dag_executor.h"
+#include <algorithm>
+#include "framework/core/cpu_affinity.h"
+
+namespace anakin {
+
+namespace {
+
+/// bytes of the buffer a tensor lives in, tensors sharing memory have overlapping ranges.
+template<typename Ttype>
+std::pair<const char*, const char*> buffer_range(Tensor4dPtr<Ttype> tensor) {
+    const char* data = (const char*)tensor->data();
+    if (data == nullptr) {
+        data = (const char*)tensor;
+        return std::make_pair(data, data + 1);
+    }
+    return std::make_pair(data, data + std::max<size_t>(tensor->capacity(), 1));
+}
+
+} // namespace
+
+template<typename Ttype, Precision Ptype>
+DagExecutor<Ttype, Ptype>::~DagExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(_mut);
+        _stop = true;
+    }
+    _branch_cv.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+template<typename Ttype, Precision Ptype>
+std::vector<typename DagExecutor<Ttype, Ptype>::ByteRange> DagExecutor<Ttype, Ptype>::buffer_ranges() {
+    std::vector<ByteRange> ranges;
+    for (auto func : _funcs) {
+        for (auto in : func->ins) {
+            ranges.push_back(buffer_range<Ttype>(in));
+        }
+        for (auto out : func->outs) {
+            ranges.push_back(buffer_range<Ttype>(out));
+        }
+    }
+    return ranges;
+}
+
+template<typename Ttype, Precision Ptype>
+void DagExecutor<Ttype, Ptype>::build_deps(const std::vector<ByteRange>& ranges) {
+    // op j depends on an earlier op i when j reads what i writes (RAW), or writes
+    // what i reads or writes (WAR, WAW); the latter comes from memory reuse.
+    int op_num = _funcs.size();
+    std::vector<std::vector<ByteRange> > reads(op_num);
+    std::vector<std::vector<ByteRange> > writes(op_num);
+    auto range = ranges.begin();
+    for (int i = 0; i < op_num; i++) {
+        reads[i].assign(range, range + _funcs[i]->ins.size());
+        range += _funcs[i]->ins.size();
+        writes[i].assign(range, range + _funcs[i]->outs.size());
+        range += _funcs[i]->outs.size();
+    }
+    // buffers of an arena are distinct but may overlap, compare byte ranges.
+    auto intersect = [](const std::vector<ByteRange>& a, const std::vector<ByteRange>& b) {
+        for (auto& x : a) {
+            for (auto& y : b) {
+                if (x.first < y.second && y.first < x.second) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    _successors.assign(op_num, std::vector<int>());
+    _in_degree.assign(op_num, 0);
+    std::vector<int> level(op_num, 0);
+    for (int j = 0; j < op_num; j++) {
+        for (int i = 0; i < j; i++) {
+            if (intersect(reads[j], writes[i]) || intersect(writes[j], reads[i])
+                    || intersect(writes[j], writes[i])) {
+                _successors[i].push_back(j);
+                _in_degree[j]++;
+                level[j] = std::max(level[j], level[i] + 1);
+            }
+        }
+    }
+
+    // ops alone on their level run on the caller thread with all the cores.
+    std::vector<int> width(op_num, 0);
+    for (int i = 0; i < op_num; i++) {
+        if (_launch[i]) {
+            width[level[i]]++;
+        }
+    }
+    _max_width = std::max(1, *std::max_element(width.begin(), width.end()));
+    _serial.clear();
+    for (int i = 0; i < op_num; i++) {
+        _serial.push_back(!_launch[i] || width[level[i]] <= 1);
+    }
+    _ranges = ranges;
+}
+
+template<typename Ttype, Precision Ptype>
+void DagExecutor<Ttype, Ptype>::init(std::vector<OperatorFunc<Ttype, Ptype> >& exec_funcs,
+                                     int branch_threads, bool sync_all) {
+    CHECK(_workers.empty()) << "DagExecutor can only be initialized once";
+    CHECK_GT(branch_threads, 0);
+    _funcs.clear();
+    for (auto& executer : exec_funcs) {
+        _funcs.push_back(&executer);
+        _sync_ins.push_back(sync_all || executer.need_sync || executer.op_name == "Output");
+        _launch.push_back(executer.op_name != "Input" && executer.op_name != "Output");
+    }
+
+    build_deps(buffer_ranges());
+
+    // branches share the cores of the thread building the executor, e.g. the cpu set of a worker
+    auto cores = thread_cores();
+    _total_threads = std::max(1, std::min<int>(num_cores(), cores.size()));
+    cores.resize(_total_threads);
+    int workers = std::min(branch_threads, _max_width);
+    _partition_threads = std::max(1, _total_threads / workers);
+    for (int t = 0; t < workers; t++) {
+        std::vector<int> partition;
+        for (int i = 0; i < _partition_threads; i++) {
+            partition.push_back(cores[(t * _partition_threads + i) % _total_threads]);
+        }
+        _workers.emplace_back([this, partition]() {
+            bind_thread_to_cores(partition);
+            set_team_size(_partition_threads);
+            std::unique_lock<std::mutex> lock(_mut);
+            while (true) {
+                _branch_cv.wait(lock, [this]() { return _stop || !_branch_ready.empty(); });
+                if (_stop) {
+                    return;
+                }
+                int id = _branch_ready.front();
+                _branch_ready.pop_front();
+                lock.unlock();
+                execute(id);
+                lock.lock();
+                finish(id);
+            }
+        });
+    }
+    LOG(INFO) << "DagExecutor: " << _funcs.size() << " ops, max branch width: " << _max_width
+              << ", branch threads: " << workers << " x " << _partition_threads << " cores";
+}
+
+template<typename Ttype, Precision Ptype>
+void DagExecutor<Ttype, Ptype>::execute(int id) {
+    auto& executer = *_funcs[id];
+    if (_sync_ins[id]) {
+        for (auto in : executer.ins) {
+            in->sync();
+        }
+    }
+    unsigned long long op_start = _profiler ? OpProfiler::now_ns() : 0;
+    if (_launch[id]) {
+        executer.infer_shape();
+        executer.launch();
+    }
+    for (auto out : executer.outs) {
+        out->record_event(executer.ctx_p->get_compute_stream());
+    }
+    if (_profiler) {
+        for (auto out : executer.outs) {
+            out->sync();
+        }
+        _profiler->record(id, op_start, OpProfiler::now_ns());
+    }
+}
+
+template<typename Ttype, Precision Ptype>
+void DagExecutor<Ttype, Ptype>::finish(int id) {
+    bool wake_branch = false;
+    for (auto succ : _successors[id]) {
+        if (--_remaining[succ] == 0) {
+            if (_serial[succ]) {
+                _serial_ready.push_back(succ);
+            } else {
+                _branch_ready.push_back(succ);
+                wake_branch = true;
+            }
+        }
+    }
+    _done++;
+    if (wake_branch) {
+        _branch_cv.notify_all();
+    }
+    _caller_cv.notify_one();
+}
+
+template<typename Ttype, Precision Ptype>
+void DagExecutor<Ttype, Ptype>::run(OpProfiler* profiler) {
+    // a reshape since the last run may have moved or grown buffers, the overlaps changed with them.
+    // a reshape during this run only moves a buffer to fresh memory, it drops overlaps but never adds one.
+    auto ranges = buffer_ranges();
+    if (ranges != _ranges) {
+        build_deps(ranges);
+    }
+    int caller_team = team_size();
+    set_team_size(_total_threads);
+    std::unique_lock<std::mutex> lock(_mut);
+    // branch threads read it after taking an op from the queue under the lock
+    _profiler = profiler;
+    _remaining = _in_degree;
+    _done = 0;
+    for (int i = 0; i < _funcs.size(); i++) {
+        if (_in_degree[i] == 0) {
+            (_serial[i] ? _serial_ready : _branch_ready).push_back(i);
+        }
+    }
+    _branch_cv.notify_all();
+    while (_done < _funcs.size()) {
+        if (_serial_ready.empty()) {
+            _caller_cv.wait(lock);
+            continue;
+        }
+        int id = _serial_ready.front();
+        _serial_ready.pop_front();
+        lock.unlock();
+        execute(id);
+        lock.lock();
+        finish(id);
+    }
+    lock.unlock();
+    set_team_size(caller_team);
+}
+
+#ifdef USE_CUDA
+template class DagExecutor<NV, Precision::FP32>;
+template class DagExecutor<NV, Precision::FP16>;
+template class DagExecutor<NV, Precision::INT8>;
+#endif
+
+#ifdef USE_MLU
+template class DagExecutor<MLU, Precision::FP32>;
+template class DagExecutor<MLU, Precision::FP16>;
+template class DagExecutor<MLU, Precision::INT8>;
+#endif
+
+#ifdef USE_X86_PLACE
+template class DagExecutor<X86, Precision::FP32>;
+template class DagExecutor<X86, Precision::FP16>;
+template class DagExecutor<X86, Precision::INT8>;
+#endif
+
+#ifdef AMD_GPU
+template class DagExecutor<AMD, Precision::FP32>;
+template class DagExecutor<AMD, Precision::FP16>;
+template class DagExecutor<AMD, Precision::INT8>;
+#endif
+
+#ifdef USE_ARM_PLACE
+template class DagExecutor<ARM, Precision::FP32>;
+template class DagExecutor<ARM, Precision::FP16>;
+template class DagExecutor<ARM, Precision::INT8>;
+#endif
+
+#ifdef USE_BM_PLACE
+template class DagExecutor<BM, Precision::FP32>;
+template class DagExecutor<BM, Precision::FP16>;
+template class DagExecutor<BM, Precision::INT8>;
+#endif
+
+} /* namespace anakin */
@@ -0,0 +1,109 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_DAG_EXECUTOR_H
+#define ANAKIN_DAG_EXECUTOR_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "framework/core/thread_safe_macros.h"
+#include "framework/core/net/operator_func.h"
+#include "framework/core/net/op_profiler.h"
+
+namespace anakin {
+
+/**
+ *  \brief Executor running independent branches of a net concurrently on CPU.
+ *
+ *   Dependencies are built from the buffers ops read and write, so the memory
+ *   reused by the graph optimizer is still accessed in the serial order.
+ *   Ops on levels of the DAG that hold one op run on the caller thread with the whole
+ *   OpenMP team, ops on wider levels run on branch threads. Every branch thread is
+ *   pinned to its own partition of cores and runs its ops with an OpenMP team of the
+ *   partition size, so branch parallelism and OpenMP inside an op don't oversubscribe.
+ */
+template<typename Ttype, Precision Ptype>
+class DagExecutor {
+public:
+    DagExecutor() {}
+    ~DagExecutor();
+
+    /**
+     *  \brief Build dependencies of exec_funcs and launch branch threads.
+     *   The dependencies are rebuilt by run when a reshape moved or grew the buffers of the ops.
+     *  \param exec_funcs ops in serial execution order, must outlive the executor.
+     *  \param branch_threads number of branch threads.
+     *  \param sync_all sync inputs of every op (OpRunType::SYNC).
+     */
+    void init(std::vector<OperatorFunc<Ttype, Ptype> >& exec_funcs, int branch_threads, bool sync_all);
+
+    /**
+     *  \brief Run all ops once, block until they are finished.
+     *   The OpenMP team of the caller is restored on return.
+     *  \param profiler records the ops of this run when not nullptr, ops are identified
+     *   by their index in exec_funcs.
+     */
+    void run(OpProfiler* profiler = nullptr);
+
+    /// Max number of ops on one level of the DAG.
+    int max_width() { return _max_width; }
+
+private:
+    typedef std::pair<const char*, const char*> ByteRange;
+
+    /// byte ranges of the inputs and outputs of every op, in op order.
+    std::vector<ByteRange> buffer_ranges();
+
+    /// build the dependencies, levels and serial ops from ranges (see buffer_ranges).
+    void build_deps(const std::vector<ByteRange>& ranges);
+
+    /// sync inputs, launch op id and record its outputs.
+    void execute(int id);
+
+    /// mark op id finished and push the successors which are ready.
+    void finish(int id) EXCLUSIVE_LOCKS_REQUIRED(_mut);
+
+private:
+    std::vector<OperatorFunc<Ttype, Ptype>*> _funcs;
+    ///< buffer ranges the dependencies were built from.
+    std::vector<ByteRange> _ranges;
+    std::vector<std::vector<int> > _successors;
+    std::vector<int> _in_degree;
+    std::vector<int> _remaining GUARDED_BY(_mut);
+    ///< ops run by caller thread, otherwise by branch threads.
+    std::vector<bool> _serial;
+    std::vector<bool> _sync_ins;
+    std::vector<bool> _launch;
+    std::deque<int> _serial_ready GUARDED_BY(_mut);
+    std::deque<int> _branch_ready GUARDED_BY(_mut);
+    int _done GUARDED_BY(_mut) {0};
+    int _max_width{1};
+    int _total_threads{1};
+    int _partition_threads{1};
+    std::vector<std::thread> _workers;
+    std::mutex _mut;
+    std::condition_variable _caller_cv;
+    std::condition_variable _branch_cv;
+    bool _stop GUARDED_BY(_mut) {false};
+    ///< profiler of the current run, nullptr if it isn't profiled.
+    OpProfiler* _profiler{nullptr};
+};
+
+} /* namespace anakin */
+
+#endif
@@ -0,0 +1,192 @@
+#include "framework/core/net/metrics.h"
+#include <algorithm>
+#include <sstream>
+#include "utils/logger/logger.h"
+
+namespace anakin {
+
+namespace {
+
+/// quantiles exported by summaries.
+const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+std::string escape_label(const std::string& value) {
+    std::string escaped;
+    for (auto c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/// {name="value",...} or empty without labels.
+std::string render_labels(const MetricLabels& labels) {
+    if (labels.empty()) {
+        return "";
+    }
+    std::string rendered = "{";
+    for (int i = 0; i < labels.size(); i++) {
+        rendered += (i ? "," : "") + labels[i].first + "=\"" + escape_label(labels[i].second) + "\"";
+    }
+    return rendered + "}";
+}
+
+/// labels with one more label appended, for quantile and le.
+std::string append_label(const std::string& labels, const std::string& name, const std::string& value) {
+    std::string label = name + "=\"" + value + "\"";
+    if (labels.empty()) {
+        return "{" + label + "}";
+    }
+    return labels.substr(0, labels.size() - 1) + "," + label + "}";
+}
+
+std::string format_bound(double bound) {
+    std::ostringstream os;
+    os << bound;
+    return os.str();
+}
+
+} // namespace
+
+void Counter::render(std::ostream& os, const std::string& name, const std::string& labels) {
+    os << name << labels << " " << value() << "\n";
+}
+
+void Gauge::render(std::ostream& os, const std::string& name, const std::string& labels) {
+    os << name << labels << " " << value() << "\n";
+}
+
+void Summary::rotate(unsigned long long now) {
+    if (now - _window_start < _window_ns) {
+        return;
+    }
+    // an idle gap longer than a window leaves nothing recent
+    if (now - _window_start < 2 * _window_ns) {
+        _previous = _current;
+    } else {
+        _previous.reset();
+    }
+    _current.reset();
+    _window_start = now;
+}
+
+void Summary::observe_ns(unsigned long long ns) {
+    std::lock_guard<std::mutex> guard(_mut);
+    rotate(OpProfiler::now_ns());
+    _current.add(ns);
+    _count++;
+    _sum_ns += ns;
+}
+
+LatencyHistogram Summary::recent() {
+    std::lock_guard<std::mutex> guard(_mut);
+    rotate(OpProfiler::now_ns());
+    LatencyHistogram hist = _previous;
+    hist.merge(_current);
+    return hist;
+}
+
+void Summary::render(std::ostream& os, const std::string& name, const std::string& labels) {
+    auto hist = recent();
+    unsigned long long count = 0;
+    unsigned long long sum_ns = 0;
+    {
+        std::lock_guard<std::mutex> guard(_mut);
+        count = _count;
+        sum_ns = _sum_ns;
+    }
+    for (auto quantile : kQuantiles) {
+        os << name << append_label(labels, "quantile", format_bound(quantile)) << " "
+           << hist.percentile_ms(quantile * 100) / 1e3 << "\n";
+    }
+    os << name << "_sum" << labels << " " << sum_ns / 1e9 << "\n";
+    os << name << "_count" << labels << " " << count << "\n";
+}
+
+Histogram::Histogram(const std::vector<double>& bounds) : _bounds(bounds) {
+    std::sort(_bounds.begin(), _bounds.end());
+    _counts.resize(_bounds.size() + 1, 0);
+}
+
+void Histogram::observe(double value) {
+    int bucket = std::lower_bound(_bounds.begin(), _bounds.end(), value) - _bounds.begin();
+    std::lock_guard<std::mutex> guard(_mut);
+    _counts[bucket]++;
+    _sum += value;
+}
+
+void Histogram::render(std::ostream& os, const std::string& name, const std::string& labels) {
+    std::vector<unsigned long long> counts;
+    double sum = 0.;
+    {
+        std::lock_guard<std::mutex> guard(_mut);
+        counts = _counts;
+        sum = _sum;
+    }
+    // buckets are cumulative
+    unsigned long long seen = 0;
+    for (int i = 0; i < _bounds.size(); i++) {
+        seen += counts[i];
+        os << name << "_bucket" << append_label(labels, "le", format_bound(_bounds[i])) << " " << seen << "\n";
+    }
+    seen += counts.back();
+    os << name << "_bucket" << append_label(labels, "le", "+Inf") << " " << seen << "\n";
+    os << name << "_sum" << labels << " " << sum << "\n";
+    os << name << "_count" << labels << " " << seen << "\n";
+}
+
+template<typename MetricType, typename Creator>
+MetricType* MetricsRegistry::lookup(const std::string& name, const std::string& help, const std::string& type,
+                                    const MetricLabels& labels, Creator create) {
+    std::lock_guard<std::mutex> guard(_mut);
+    auto& family = _families[name];
+    if (family.type.empty()) {
+        family.help = help;
+        family.type = type;
+    }
+    CHECK_EQ(family.type, type) << "metric " << name << " is a " << family.type;
+    auto& series = family.series[render_labels(labels)];
+    if (!series) {
+        series.reset(create());
+    }
+    return static_cast<MetricType*>(series.get());
+}
+
+Counter* MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    return lookup<Counter>(name, help, "counter", labels, []() { return new Counter; });
+}
+
+Gauge* MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    return lookup<Gauge>(name, help, "gauge", labels, []() { return new Gauge; });
+}
+
+Summary* MetricsRegistry::summary(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    return lookup<Summary>(name, help, "summary", labels, []() { return new Summary; });
+}
+
+Histogram* MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& bounds, const MetricLabels& labels) {
+    return lookup<Histogram>(name, help, "histogram", labels, [&bounds]() { return new Histogram(bounds); });
+}
+
+std::string MetricsRegistry::prometheus_text() {
+    std::ostringstream os;
+    os.precision(9);
+    std::lock_guard<std::mutex> guard(_mut);
+    for (auto& family : _families) {
+        os << "# HELP " << family.first << " " << family.second.help << "\n";
+        os << "# TYPE " << family.first << " " << family.second.type << "\n";
+        for (auto& series : family.second.series) {
+            series.second->render(os, family.first, series.first);
+        }
+    }
+    return os.str();
+}
+
+} /* namespace anakin */
@@ -0,0 +1,153 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_METRICS_H
+#define ANAKIN_METRICS_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "framework/core/thread_safe_macros.h"
+#include "framework/core/net/op_profiler.h"
+
+namespace anakin {
+
+/// label name and value pairs of a metric series.
+typedef std::vector<std::pair<std::string, std::string> > MetricLabels;
+
+/// one series of a metric family.
+class Metric {
+public:
+    virtual ~Metric() {}
+    /// write the samples of the series in Prometheus text format, labels are rendered already.
+    virtual void render(std::ostream& os, const std::string& name, const std::string& labels) = 0;
+};
+
+/// monotonic counter.
+class Counter : public Metric {
+public:
+    void inc(unsigned long long n = 1) { _value += n; }
+    unsigned long long value() const { return _value; }
+    void render(std::ostream& os, const std::string& name, const std::string& labels) override;
+
+private:
+    std::atomic<unsigned long long> _value{0};
+};
+
+/// value that goes up and down.
+class Gauge : public Metric {
+public:
+    void set(long long value) { _value = value; }
+    void add(long long delta) { _value += delta; }
+    long long value() const { return _value; }
+    void render(std::ostream& os, const std::string& name, const std::string& labels) override;
+
+private:
+    std::atomic<long long> _value{0};
+};
+
+/**
+ *  \brief Latency summary exported in seconds.
+ *   Quantiles cover the last one or two windows, so a regression shows up within a window
+ *   instead of being diluted by the whole uptime; sum and count cover the uptime.
+ */
+class Summary : public Metric {
+public:
+    explicit Summary(int window_sec = 60) : _window_ns(window_sec * 1000000000ULL) {}
+
+    void observe_ns(unsigned long long ns);
+    /// samples of the current and the previous window.
+    LatencyHistogram recent();
+    void render(std::ostream& os, const std::string& name, const std::string& labels) override;
+
+private:
+    /// start a new window if the current one is over.
+    void rotate(unsigned long long now) EXCLUSIVE_LOCKS_REQUIRED(_mut);
+
+    std::mutex _mut;
+    unsigned long long _window_ns;
+    unsigned long long _window_start GUARDED_BY(_mut) {0};
+    LatencyHistogram _current GUARDED_BY(_mut);
+    LatencyHistogram _previous GUARDED_BY(_mut);
+    unsigned long long _count GUARDED_BY(_mut) {0};
+    unsigned long long _sum_ns GUARDED_BY(_mut) {0};
+};
+
+/// distribution of values over fixed upper bounds (e.g. batch sizes).
+class Histogram : public Metric {
+public:
+    explicit Histogram(const std::vector<double>& bounds);
+
+    void observe(double value);
+    void render(std::ostream& os, const std::string& name, const std::string& labels) override;
+
+private:
+    std::mutex _mut;
+    std::vector<double> _bounds;
+    ///< samples of each bound, the last one is +Inf.
+    std::vector<unsigned long long> _counts GUARDED_BY(_mut);
+    double _sum GUARDED_BY(_mut) {0.};
+};
+
+/**
+ *  \brief Registry of serving metrics, rendered in Prometheus text exposition format.
+ *
+ *   Metrics are families of series told apart by their labels (e.g. model). A series is
+ *   created on its first lookup and lives as long as the registry, its pointer can be kept
+ *   and updated from any thread without touching the registry again.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry() {}
+    ~MetricsRegistry() {}
+
+    Counter* counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    Gauge* gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    Summary* summary(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    /// bounds of the first lookup of a series are kept.
+    Histogram* histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& bounds, const MetricLabels& labels = {});
+
+    /// all series in Prometheus text format (version 0.0.4).
+    std::string prometheus_text();
+
+    /// content type of prometheus_text for http responses.
+    static const char* content_type() { return "text/plain; version=0.0.4"; }
+
+private:
+    struct Family {
+        std::string help;
+        std::string type;
+        ///< series by rendered labels.
+        std::map<std::string, std::unique_ptr<Metric> > series;
+    };
+
+    /// series of family name, created by create when it doesn't exist.
+    template<typename MetricType, typename Creator>
+    MetricType* lookup(const std::string& name, const std::string& help, const std::string& type,
+                       const MetricLabels& labels, Creator create);
+
+    std::mutex _mut;
+    std::map<std::string, Family> _families GUARDED_BY(_mut);
+};
+
+} /* namespace anakin */
+
+#endif
@@ -2,9 +2,10 @@
 #include "saber/funcs/debug.h"
 #include "framework/core/mem_info.h"
 #include "framework/core/net/auto_layout_config.h"
-#ifdef ENABLE_OP_TIMER
-#include "saber/funcs/timer.h"
-#endif
+#include "framework/graph/llvm/optimizer/memory_scheduler.h"
+#include "saber/core/weight_registry.h"
+#include <sstream>
+#include <set>
 
 namespace anakin {
 
@@ -127,6 +128,10 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph, \
                                       OpContextPtr<Ttype> ctx, bool auto_config_layout) {
 
     init_env(graph);
+    // derived weights of kernels are read from (and stored to) the cache
+    saber::WeightCache::Scope weights_cache_scope(_weights_cache);
+    // weights blocks fused by the ops are freed with the graph of the net
+    typename graph::GraphGlobalMemBase<Ttype>::Scope weights_owner(_graph_p);
     // shallow copy
     _graph_p->CopyFrom(graph);
     auto node_names_in_exec_order = graph.get_nodes_in_order();
@@ -208,6 +213,8 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph, \
         op_func.op->_helper->Init(*(op_func.ctx_p), op_func.ins, op_func.outs);
     }
     // init memory of _graph_p
+    save_weights_cache();
+    init_profiler();
     init_memory();
 }
 
@@ -215,6 +222,10 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph, \
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph,bool auto_config_layout) {
     init_env(graph);
+    // derived weights of kernels are read from (and stored to) the cache
+    saber::WeightCache::Scope weights_cache_scope(_weights_cache);
+    // weights blocks fused by the ops are freed with the graph of the net
+    typename graph::GraphGlobalMemBase<Ttype>::Scope weights_owner(_graph_p);
     // shallow copy
     _graph_p->CopyFrom(graph);
 
@@ -368,6 +379,8 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph,bool aut
     double curr_mem_in_mb_end = MemoryInfo<Ttype>::Global().get_used_mem_in_mb();
     this->_graph_p->statistics.template set_info<graph::SYSTEM_MEM>(curr_mem_in_mb_end - curr_mem_in_mb_start);
     // init memory of _graph_p
+    save_weights_cache();
+    init_profiler();
     init_memory();
 
     graph.statistics = _graph_p->statistics; // copy statistic back
@@ -379,13 +392,12 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph,bool aut
             get_info<graph::MODEL_MEM>() << " MB";
     LOG(INFO) << "System mem used:      " << this->_graph_p->statistics.template
             get_info<graph::SYSTEM_MEM>() << " MB";
+    LOG(INFO) << "Shared weights mem:   " << saber::WeightRegistry::global().shared_bytes() / 1024.0 / 1024.0
+              << " MB (" << saber::WeightRegistry::global().unshared_bytes() / 1024.0 / 1024.0
+              << " MB without sharing)";
 
 
 
-#ifdef ENABLE_OP_TIMER
-    _op_time = std::vector<float>(_exec_funcs.size(), 0.0f);
-#endif
-
 #ifdef ENABLE_DEBUG
     LOG(WARNING) << "Checking memory...";
 
@@ -415,10 +427,306 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph,bool aut
 }
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
-void Net<Ttype, Ptype, RunType>::prediction() {
+void Net<Ttype, Ptype, RunType>::register_shape_buckets(std::string in_name,
+                                                        std::vector<saber::Shape> buckets) {
+    auto in = get_in(in_name);
+    for (auto& bucket : buckets) {
+        CHECK_EQ(bucket.dims(), in->valid_shape().dims()) << " bucket dims of " << in_name << " mismatch";
+        CHECK_LE(bucket.count() * in->get_dtype_size(), in->capacity()) << " bucket of " << in_name
+                << " exceeds the memory planned by init, init net with the largest bucket.";
+    }
+    // smaller buckets first, so the first covering bucket is the nearest one
+    std::sort(buckets.begin(), buckets.end(), [](const saber::Shape& lhs, const saber::Shape& rhs) {
+        return lhs.count() < rhs.count();
+    });
+    _shape_buckets[in_name] = buckets;
+    // padding stages the inputs here, predictions don't allocate
+    auto& padded = _padded_buckets[in_name];
+    padded.clear();
+    for (auto& bucket : buckets) {
+        padded.emplace_back(new Tensor4d<Ttype>());
+        padded.back()->re_alloc(bucket, in->get_dtype());
+    }
+    set_frozen_plan(true);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+int Net<Ttype, Ptype, RunType>::pad_to_buckets() {
+    int real_batch = -1;
+    for (auto& it : _shape_buckets) {
+        auto in = get_in(it.first);
+        auto shape = in->valid_shape();
+        if (in->get_seq_offset().size() > 0) {
+            continue;
+        }
+        int target = -1;
+        for (int i = 0; i < it.second.size(); i++) {
+            if (it.second[i] == shape) {
+                target = -1;
+                break;
+            }
+            if (target < 0 && shape <= it.second[i]) {
+                target = i;
+            }
+        }
+        if (target < 0) {
+            continue;
+        }
+        auto& bucket = it.second[target];
+        bool batch_only = true;
+        for (int i = 1; i < shape.dims(); i++) {
+            batch_only = batch_only && shape[i] == bucket[i];
+        }
+        if (batch_only && shape.num_index() == 0) {
+            real_batch = shape[0];
+        }
+        // stage the real data at the origin of the zero padded bucket, then move it into the input
+        auto& padded = *_padded_buckets[it.first][target];
+        fill_tensor_const(padded, 0.f);
+        Tensor4d<Ttype> roi;
+        roi.share_sub_buffer(padded, shape, saber::Shape::zero(shape));
+        roi.copy_from(*in);
+        in->reshape(bucket);
+        in->copy_from(padded);
+    }
+    return real_batch;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::trim_outputs(int real_batch) {
+    for (auto out : get_out_list()) {
+        auto shape = out->valid_shape();
+        if (shape.num_index() == 0 && shape[0] > real_batch) {
+            // the plan stays current, only these outputs are given back their shapes
+            _trimmed_outs.push_back({out, shape});
+            shape[0] = real_batch;
+            out->reshape(shape);
+        }
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::untrim_outputs() {
+    for (auto& it : _trimmed_outs) {
+        it.first->reshape(it.second);
+    }
+    _trimmed_outs.clear();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+int Net<Ttype, Ptype, RunType>::match_frozen_plan() {
+    if (_frozen_plans.empty()) {
+        return -1;
+    }
+    for (int plan_id = 0; plan_id < _frozen_plans.size(); plan_id++) {
+        auto& plan = _frozen_plans[plan_id];
+        bool match = true;
+        for (int i = 0; i < _frozen_ins.size() && match; i++) {
+            match = _frozen_ins[i]->valid_shape() == plan.in_shapes[i]
+                    && _frozen_ins[i]->get_seq_offset() == plan.in_offsets[i];
+        }
+        if (match) {
+            return plan_id;
+        }
+    }
+    return -1;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::freeze_plan() {
+    if (_frozen_steps.empty()) {
+        _frozen_ins = get_in_list();
+        for (auto& executer : _exec_funcs) {
+            FrozenStep step;
+            step.func = &executer;
+            step.sync_ins = RunType == OpRunType::SYNC || executer.need_sync || executer.op_name == "Output";
+            step.launch = executer.op_name != "Input" && executer.op_name != "Output";
+            _frozen_steps.push_back(step);
+        }
+    }
+    int max_plans = _shape_buckets.empty() ? _max_unbucketed_plans : _max_bucketed_plans;
+    if (_frozen_plans.size() >= max_plans) {
+        _frozen_plans.erase(_frozen_plans.begin());
+    }
+    FrozenPlan plan;
+    for (auto in : _frozen_ins) {
+        plan.in_shapes.push_back(in->valid_shape());
+        plan.in_offsets.push_back(in->get_seq_offset());
+    }
+    for (auto& step : _frozen_steps) {
+        for (auto out : step.func->outs) {
+            plan.out_shapes.push_back(out->valid_shape());
+            plan.out_offsets.push_back(out->get_seq_offset());
+        }
+    }
+    if (!_shape_buckets.empty()) {
+        // the ops of the net are re-created on every shape change, a bucket keeps its own
+        saber::WeightCache::Scope weights_cache_scope(_weights_cache);
+        typename graph::GraphGlobalMemBase<Ttype>::Scope weights_owner(_graph_p);
+        for (auto& step : _frozen_steps) {
+            plan.ops.push_back(step.launch ? create_bucket_op(*step.func) : nullptr);
+        }
+    }
+    _frozen_plans.push_back(plan);
+    _current_plan = _frozen_plans.size() - 1;
+    _trimmed_outs.clear();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+std::shared_ptr<OperatorBase> Net<Ttype, Ptype, RunType>::create_bucket_op(OperatorFunc<Ttype, Ptype>& executer) {
+    if (executer.op->_helper->rnn_state() != nullptr) {
+        // session states live in the op of the net
+        return nullptr;
+    }
+    auto node_ptr = (*_graph_p)[executer.name];
+    auto* op = static_cast<Operator<Ttype, Ptype>*>(calibrator_op<Ttype>(executer.op_name, executer.name,
+               _calibrator_parser));
+    CHECK_NOTNULL(op) << executer.name << ", type " << executer.op_name << " is null";
+    std::shared_ptr<OperatorBase> holder(op);
+    op->_helper->BindParam(node_ptr);
+    op->_helper->InitParam();
+    op->_helper->Init(*executer.ctx_p, executer.ins, executer.outs);
+    return holder;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::apply_frozen_plan(int plan_id) {
+    auto& plan = _frozen_plans[plan_id];
+    int out_id = 0;
+    for (auto& step : _frozen_steps) {
+        for (auto out : step.func->outs) {
+            out->reshape(plan.out_shapes[out_id]);
+            out->set_seq_offset(plan.out_offsets[out_id]);
+            out_id++;
+        }
+    }
+    _current_plan = plan_id;
+    _trimmed_outs.clear();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::frozen_prediction(bool profiled) {
+    auto& ops = _frozen_plans[_current_plan].ops;
+    for (int step_id = 0; step_id < _frozen_steps.size(); step_id++) {
+        auto& step = _frozen_steps[step_id];
+        auto& executer = *step.func;
+        if (step.sync_ins) {
+            for (auto in : executer.ins) {
+                in->sync();
+            }
+        }
+        unsigned long long op_start = profiled ? OpProfiler::now_ns() : 0;
+        if (step.launch && step_id < ops.size() && ops[step_id]) {
+            (*static_cast<Operator<Ttype, Ptype>*>(ops[step_id].get()))(*executer.ctx_p, executer.ins, executer.outs);
+        } else if (step.launch) {
+            executer.launch();
+        }
+        for (auto out : executer.outs) {
+            out->record_event(executer.ctx_p->get_compute_stream());
+        }
+        if (profiled) {
+            for (auto out : executer.outs) {
+                out->sync();
+            }
+            _profiler.record(step.func - _exec_funcs.data(), op_start, OpProfiler::now_ns());
+        }
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+std::string Net<Ttype, Ptype, RunType>::memory_report() {
+    std::ostringstream msg;
+    msg << "per instance: temp mem " << _graph_p->statistics.template get_info<graph::TEMP_MEM>()
+        << " MB (" << _graph_p->statistics.template get_info<graph::ORI_TEMP_MEM>()
+        << " MB without reuse)\n";
+    msg << "shared by process: weights " << saber::WeightRegistry::global().shared_bytes() / 1024.0 / 1024.0
+        << " MB (" << saber::WeightRegistry::global().unshared_bytes() / 1024.0 / 1024.0
+        << " MB without sharing)\n";
+    msg << saber::WeightRegistry::global().report();
+    return msg.str();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::set_weights_cache(const std::string& path) {
+    _weights_cache = path.empty() ? nullptr : saber::WeightCache::open(path);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::save_weights_cache() {
+    if (_weights_cache == nullptr) {
+        return;
+    }
+    LOG(INFO) << "Weights cache " << _weights_cache->path() << ": " << _weights_cache->hits()
+              << " hits, " << _weights_cache->misses() << " misses";
+    if (!_weights_cache->save()) {
+        LOG(WARNING) << "weights cache is not saved, the next init builds the weights again";
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::init_profiler() {
+    std::vector<std::string> names;
+    std::vector<std::string> types;
+    for (auto& executer : _exec_funcs) {
+        names.push_back(executer.name);
+        types.push_back(executer.op_name);
+    }
+    _profiler.init(names, types);
 #ifdef ENABLE_OP_TIMER
-    int op_id = 0;
+    if (!_profiler.enabled()) {
+        _profiler.set_sample_every(1);
+    }
+#endif
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::set_parallel_branches(int branch_threads) {
+    if (!std::is_same<Ttype, X86>::value && branch_threads > 0) {
+        LOG(WARNING) << "parallel branches are only supported on X86, run serially";
+        branch_threads = 0;
+    }
+    _branch_threads = branch_threads;
+    _dag_executor.reset();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::prediction() {
+    int real_batch = -1;
+    bool profiled = _profiler.begin_prediction();
+#ifndef ENABLE_DEBUG
+    if (_branch_threads > 0) {
+        if (!_dag_executor) {
+            _dag_executor = std::make_shared<DagExecutor<Ttype, Ptype> >();
+            _dag_executor->init(_exec_funcs, _branch_threads, RunType == OpRunType::SYNC);
+        }
+        _dag_executor->run(profiled ? &_profiler : nullptr);
+        if (profiled) {
+            _profiler.end_prediction();
+        }
+        return;
+    }
+    if (_enable_frozen_plan) {
+        real_batch = pad_to_buckets();
+        int plan_id = match_frozen_plan();
+        if (plan_id >= 0) {
+            // every shape is set only when the bucket changes
+            if (plan_id != _current_plan) {
+                apply_frozen_plan(plan_id);
+            } else {
+                untrim_outputs();
+            }
+            frozen_prediction(profiled);
+            if (real_batch > 0) {
+                trim_outputs(real_batch);
+            }
+            if (profiled) {
+                _profiler.end_prediction();
+            }
+            return;
+        }
+    }
 #endif
+    int op_id = 0;
 #ifdef ENABLE_DEBUG
     int op_cnt = 0;
 #endif
@@ -442,11 +750,7 @@ void Net<Ttype, Ptype, RunType>::prediction() {
 
 #endif
 
-#ifdef ENABLE_OP_TIMER
-        Context<Ttype> ctx(0, 0, 0);
-        saber::SaberTimer<Ttype> my_time;
-        my_time.start(ctx);
-#endif
+        unsigned long long op_start = profiled ? OpProfiler::now_ns() : 0;
 
         if (executer.op_name != "Input" && executer.op_name != "Output") {
             executer.infer_shape();
@@ -491,23 +795,129 @@ void Net<Ttype, Ptype, RunType>::prediction() {
 
 #endif
 
-#ifdef ENABLE_OP_TIMER
-
-        for (int i = 0; i < executer.outs.size(); i++) {
-            // record
-            executer.outs[i]->record_event(executer.ctx_p->get_compute_stream());
-            executer.outs[i]->sync();
+        if (profiled) {
+            // wait for the op on devices, sampled predictions only
+            for (int i = 0; i < executer.outs.size(); i++) {
+                executer.outs[i]->sync();
+            }
+            _profiler.record(op_id, op_start, OpProfiler::now_ns());
         }
+        op_id++;
+    } // for
 
-        my_time.end(ctx);
-        float timmer_time = my_time.get_average_ms();
-        //LOG(INFO)<<"[OP TIMER]  name = "<< _op_param[op_id]<<"  ,  time = "<<timmer_time<<" ms";
-        _op_time[op_id++] += timmer_time;
+#ifndef ENABLE_DEBUG
+    if (_enable_frozen_plan) {
+        // output shapes are inferred for current inputs, reuse them when the inputs come again
+        freeze_plan();
+        if (real_batch > 0) {
+            trim_outputs(real_batch);
+        }
+    }
 #endif
+    if (profiled) {
+        _profiler.end_prediction();
+    }
+}
 
-    } // for
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+RnnSessionStore& Net<Ttype, Ptype, RunType>::sessions() {
+    if (!_sessions) {
+        _sessions = std::make_shared<RnnSessionStore>();
+    }
+    return *_sessions;
 }
 
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Status Net<Ttype, Ptype, RunType>::prediction(const std::vector<std::string>& session_ids) {
+    typedef typename target_host<Ttype>::type target_h;
+    if (!std::is_same<Ttype, X86>::value) {
+        return Status::ANAKINFAIL("streaming sessions are only supported on X86");
+    }
+    if (std::set<std::string>(session_ids.begin(), session_ids.end()).size() != session_ids.size()) {
+        return Status::ANAKINFAIL("a session can't continue twice in one prediction");
+    }
+    std::vector<OperatorHelper<Ttype, Ptype>*> rnn_ops;
+    for (auto& executer : _exec_funcs) {
+        if (executer.op != nullptr && executer.op->_helper != nullptr
+                && executer.op->_helper->rnn_state() != nullptr) {
+            rnn_ops.push_back(executer.op->_helper);
+        }
+    }
+    if (rnn_ops.empty()) {
+        LOG(WARNING) << "the net has no rnn op, sessions carry no state";
+        prediction();
+        return Status::OK();
+    }
+    auto& store = sessions();
+    int batch = session_ids.size();
+    std::vector<std::shared_ptr<const RnnSession> > saved(batch);
+    for (int i = 0; i < batch; i++) {
+        saved[i] = store.find(session_ids[i]);
+        // a state of another net (its rnn ops differ) is no state
+        if (saved[i] && saved[i]->hidden.size() != rnn_ops.size()) {
+            saved[i] = nullptr;
+        }
+    }
+    // state rows of the batch in session order, zeros for new sessions
+    auto load_rows = [&](Tensor4d<Ttype>& state, int op_id, int hidden_size, bool cell) {
+        Tensor4d<target_h> rows(saber::Shape({batch, hidden_size, 1, 1}));
+        auto* data = static_cast<float*>(rows.mutable_data());
+        for (int i = 0; i < batch; i++) {
+            auto* row = data + i * hidden_size;
+            const std::vector<float>* values = nullptr;
+            if (saved[i]) {
+                values = cell ? &saved[i]->cell[op_id] : &saved[i]->hidden[op_id];
+            }
+            if (values != nullptr && values->size() == hidden_size) {
+                std::copy(values->begin(), values->end(), row);
+            } else {
+                std::fill(row, row + hidden_size, 0.f);
+            }
+        }
+        state.reshape(rows.valid_shape());
+        state.copy_from(rows);
+    };
+    for (int op_id = 0; op_id < rnn_ops.size(); op_id++) {
+        auto* state = rnn_ops[op_id]->rnn_state();
+        load_rows(state->hidden, op_id, state->hidden_size, false);
+        if (state->with_cell) {
+            load_rows(state->cell, op_id, state->hidden_size, true);
+        }
+        rnn_ops[op_id]->enable_rnn_state(true);
+    }
+
+    prediction();
+
+    std::vector<std::shared_ptr<RnnSession> > updated(batch);
+    for (auto& session : updated) {
+        session = std::make_shared<RnnSession>();
+        session->hidden.resize(rnn_ops.size());
+        session->cell.resize(rnn_ops.size());
+    }
+    auto store_rows = [&](Tensor4d<Ttype>& state, int op_id, int hidden_size, bool cell) {
+        Tensor4d<target_h> rows(state.valid_shape());
+        rows.copy_from(state);
+        auto* data = static_cast<const float*>(rows.data());
+        for (int i = 0; i < batch; i++) {
+            auto& values = cell ? updated[i]->cell[op_id] : updated[i]->hidden[op_id];
+            values.assign(data + i * hidden_size, data + (i + 1) * hidden_size);
+        }
+    };
+    for (int op_id = 0; op_id < rnn_ops.size(); op_id++) {
+        auto* state = rnn_ops[op_id]->rnn_state();
+        rnn_ops[op_id]->enable_rnn_state(false);
+        store_rows(state->hidden, op_id, state->hidden_size, false);
+        if (state->with_cell) {
+            store_rows(state->cell, op_id, state->hidden_size, true);
+        }
+    }
+    for (int i = 0; i < batch; i++) {
+        store.put(session_ids[i], updated[i]);
+    }
+    return Status::OK();
+}
+
+
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 void Net<Ttype, Ptype, RunType>::fusion_prediction() {
 //	ASIC_CHECK(Ttype);
@@ -523,12 +933,17 @@ template<typename Ttype, Precision Ptype, OpRunType RunType>
 std::unique_ptr<Net<Ttype, Ptype, RunType> > Net<Ttype, Ptype, RunType>::Clone() {
     auto ret_net = std::unique_ptr<Net<Ttype, Ptype, RunType> >(new Net<Ttype, Ptype, RunType>);
     ret_net->_graph_p->CopyFrom(*(this->_graph_p));
+    ret_net->_weights_cache = _weights_cache;
     return ret_net;
 }
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 void Net<Ttype, Ptype, RunType>::init() {
     init_env(*_graph_p);
+    // derived weights of kernels are read from (and stored to) the cache
+    saber::WeightCache::Scope weights_cache_scope(_weights_cache);
+    // weights blocks fused by the ops are freed with the graph of the net
+    typename graph::GraphGlobalMemBase<Ttype>::Scope weights_owner(_graph_p);
 
     double curr_mem_in_mb_start = MemoryInfo<Ttype>::Global().get_used_mem_in_mb();
 
@@ -634,6 +1049,8 @@ void Net<Ttype, Ptype, RunType>::init() {
     double curr_mem_in_mb_end = MemoryInfo<Ttype>::Global().get_used_mem_in_mb();
     this->_graph_p->statistics.template set_info<graph::SYSTEM_MEM>(curr_mem_in_mb_end - curr_mem_in_mb_start);
     // init memory of _graph_p
+    save_weights_cache();
+    init_profiler();
     init_memory();
 
     LOG(INFO) << "Temp mem used:        " << this->_graph_p->statistics.template
@@ -644,6 +1061,9 @@ void Net<Ttype, Ptype, RunType>::init() {
             get_info<graph::MODEL_MEM>() << " MB";
     LOG(INFO) << "System mem used:      " << this->_graph_p->statistics.template
             get_info<graph::SYSTEM_MEM>() << " MB";
+    LOG(INFO) << "Shared weights mem:   " << saber::WeightRegistry::global().shared_bytes() / 1024.0 / 1024.0
+              << " MB (" << saber::WeightRegistry::global().unshared_bytes() / 1024.0 / 1024.0
+              << " MB without sharing)";
 }
 
 
@@ -811,6 +1231,15 @@ Status Net<Ttype, Ptype, RunType>::alloc_memory_first(graph::Graph<Ttype, Ptype>
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 Status Net<Ttype, Ptype, RunType>::init_memory() {
+    // executors are rebuilt, the frozen plans and dag are out of date
+    _frozen_steps.clear();
+    _frozen_plans.clear();
+    _current_plan = -1;
+    _trimmed_outs.clear();
+    _dag_executor.reset();
+    if (_enable_arena) {
+        return init_arena_memory();
+    }
     auto alloc_memory = [this](graph::Edge<Ttype>& edge) {
         auto& tensor_p = edge.weight();
 
@@ -897,6 +1326,155 @@ Status Net<Ttype, Ptype, RunType>::init_memory() {
     return Status::OK();
 }
 
+/// make tensors share bytes [offset, offset + bytes) of arena.
+template<typename Ttype>
+struct ArenaView {
+    static void share(Tensor4d<Ttype>& arena, size_t offset, size_t bytes,
+                      std::vector<Tensor4dPtr<Ttype> >& tensors) {
+        auto base = static_cast<char*>(arena.mutable_data()) + offset;
+        Tensor4d<Ttype> view(static_cast<void*>(base), Ttype(), TargetWrapper<Ttype>::get_device_id(),
+                             saber::Shape({static_cast<int>(bytes), 1, 1, 1}), AK_INT8);
+        for (auto tensor : tensors) {
+            tensor->share_from(view);
+        }
+    }
+};
+#ifdef AMD_GPU
+template<>
+struct ArenaView<AMD> {
+    static void share(Tensor4d<AMD>&, size_t, size_t, std::vector<Tensor4dPtr<AMD> >&) {
+        LOG(FATAL) << "arena memory is not supported on AMD";
+    }
+};
+#endif
+#ifdef USE_BM_PLACE
+template<>
+struct ArenaView<BM> {
+    static void share(Tensor4d<BM>&, size_t, size_t, std::vector<Tensor4dPtr<BM> >&) {
+        LOG(FATAL) << "arena memory is not supported on BM";
+    }
+};
+#endif
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Status Net<Ttype, Ptype, RunType>::init_arena_memory() {
+    CHECK((std::is_same<Ttype, X86>::value || std::is_same<Ttype, NV>::value
+           || std::is_same<Ttype, ARM>::value)) << "arena memory is only supported on X86, NV and ARM";
+    std::unordered_map<std::string, int> exec_id;
+    for (int i = 0; i < _exec_funcs.size(); i++) {
+        exec_id[_exec_funcs[i].name] = i;
+    }
+    int net_end = _exec_funcs.size();
+
+    // ins and outs of self shared ops (Split, Reshape ...) are one buffer, union them.
+    std::unordered_map<std::string, std::string> parent;
+    std::function<std::string(const std::string&)> find_root = [&](const std::string& name) {
+        if (parent.count(name) == 0 || parent[name] == name) {
+            return name;
+        }
+        parent[name] = find_root(parent[name]);
+        return parent[name];
+    };
+    graph::check_self_shared self_shared;
+    for (auto& executer : _exec_funcs) {
+        if (std::find(self_shared.ops.begin(), self_shared.ops.end(), executer.op_name) == self_shared.ops.end()) {
+            continue;
+        }
+        std::vector<std::string> names;
+        for (auto& edge_it : _graph_p->get_in_arc_its(executer.name)) {
+            names.push_back(edge_it->name());
+        }
+        for (auto& edge_it : _graph_p->get_out_arc_its(executer.name)) {
+            names.push_back(edge_it->name());
+        }
+        for (int i = 1; i < names.size(); i++) {
+            parent[find_root(names[i])] = find_root(names[0]);
+        }
+    }
+
+    std::set<std::string> registed_outs;
+    for (auto& pair : _graph_p->get_registed_outs()) {
+        registed_outs.insert(pair.first + "_" + pair.second);
+    }
+    struct Group {
+        std::vector<Tensor4dPtr<Ttype> > tensors;
+        Tensor4dPtr<Ttype> largest{nullptr};
+        size_t bytes{0};
+        int first_use{0};
+        int last_use{0};
+        bool standalone{false};
+    };
+    std::map<std::string, Group> groups;
+    size_t sum_of_edges = 0;
+    auto collect = [&](graph::Edge<Ttype>& edge) {
+        auto& tensor_p = edge.weight();
+        size_t bytes = tensor_p->shape().count()
+                       * std::max(tensor_p->get_dtype_size(), tensor_p->get_buf_dtype_size());
+        sum_of_edges += bytes;
+        int first_use = exec_id.count(edge.bottom()) ? exec_id[edge.bottom()] : 0;
+        int last_use = exec_id.count(edge.top()) ? exec_id[edge.top()] : net_end;
+        auto& group = groups[find_root(edge.name())];
+        if (group.tensors.empty()) {
+            group.first_use = first_use;
+            group.last_use = last_use;
+        }
+        group.tensors.push_back(tensor_p.get());
+        if (group.largest == nullptr || bytes > group.bytes) {
+            group.largest = tensor_p.get();
+            group.bytes = bytes;
+        }
+        group.first_use = std::min(group.first_use, first_use);
+        group.last_use = std::max(group.last_use, last_use);
+        // the net ins and outs are touched by users, they keep their own buffers.
+        group.standalone = group.standalone || (*_graph_p)[edge.bottom()]->get_op_name() == "Input"
+                           || (*_graph_p)[edge.top()]->get_op_name() == "Output"
+                           || registed_outs.count(edge.name()) > 0;
+    };
+    _graph_p->Scanner->BFS_Edge(collect);
+
+    ArenaPlanner planner;
+    size_t standalone_bytes = 0;
+    for (auto& pair : groups) {
+        auto& group = pair.second;
+        if (group.standalone) {
+            if (group.largest->mutable_data() == nullptr) {
+                group.largest->re_alloc(group.largest->shape(), group.largest->get_dtype());
+            }
+            for (auto tensor : group.tensors) {
+                if (tensor != group.largest) {
+                    tensor->share_from(*group.largest);
+                }
+            }
+            standalone_bytes += group.bytes;
+        } else {
+            planner.add(pair.first, group.bytes, group.first_use, group.last_use);
+        }
+    }
+    size_t arena_bytes = planner.plan();
+    _arena = std::make_shared<Tensor4d<Ttype> >(AK_INT8);
+    if (arena_bytes > 0) {
+        CHECK_LT(arena_bytes, static_cast<size_t>(std::numeric_limits<int>::max())) << "arena is too large";
+        _arena->re_alloc(saber::Shape({static_cast<int>(arena_bytes), 1, 1, 1}), AK_INT8);
+        for (auto& pair : groups) {
+            if (!pair.second.standalone) {
+                ArenaView<Ttype>::share(*_arena, planner.offset(pair.first), pair.second.bytes,
+                                        pair.second.tensors);
+            }
+        }
+    }
+    LOG(INFO) << "arena memory: " << planner.size() << " buffers planned to "
+              << arena_bytes / 1024.0 / 1024.0 << " MB, sum of activations "
+              << sum_of_edges / 1024.0 / 1024.0 << " MB, net ins and outs "
+              << standalone_bytes / 1024.0 / 1024.0 << " MB";
+
+    if (_need_summary) {
+        this->_graph_p->statistics.template set_info<graph::TEMP_MEM>(
+                (arena_bytes + standalone_bytes) / 1024.0 / 1024.0);
+        this->_graph_p->statistics.template set_info<graph::ORI_TEMP_MEM>(sum_of_edges / 1024.0 / 1024.0);
+    }
+    return Status::OK();
+}
+
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 Status Net<Ttype, Ptype, RunType>::init_env(graph::Graph<Ttype, Ptype>& graph) {
     LOG(WARNING) << "Detect and initial " << graph.get_ins().size() << " lanes.";
@@ -914,6 +1492,7 @@ void Net<Ttype, Ptype, RunType>::fusion_init(graph::Graph<Ttype, Ptype>& graph,
     }
 
     init_env(graph);
+    typename graph::GraphGlobalMemBase<Ttype>::Scope weights_owner(_graph_p);
     // shallow copy
     _graph_p->CopyFrom(graph);
     auto node_names_in_exec_order = graph.get_nodes_in_order();
@@ -18,9 +18,14 @@
 
 #include "framework/graph/graph.h"
 #include "framework/core/net/operator_func.h"
+#include "framework/core/net/dag_executor.h"
+#include "framework/core/net/arena_planner.h"
+#include "framework/core/net/op_profiler.h"
+#include "framework/core/net/rnn_session.h"
 #include "framework/core/net/calibrator_factory.h"
 #include "framework/utils/csv.h"
 #include "saber/core/tensor_op.h"
+#include "saber/core/weight_cache.h"
 
 namespace anakin {
 
@@ -77,6 +82,107 @@ public:
      */
     void prediction();
 
+    /**
+     * \brief Streaming prediction of recurrent nets (LSTM, GRU ops).
+     *  Sequence i of the inputs continues the stream session_ids[i]: the rnn ops start it
+     *  from the hidden (and cell) state the previous prediction of the session left,
+     *  zeros for a new session, and store its state after its last frame back, so a stream
+     *  feeds only its new frames instead of its whole history.
+     *  Predictions of one session must not run concurrently. The X86 rnn kernels carry the
+     *  state, see saber::RnnState for what they support.
+     *  \return error, and nothing runs, on other targets or if a session id repeats.
+     */
+    Status prediction(const std::vector<std::string>& session_ids);
+
+    /**
+     * \brief Keep the session states in store, e.g. shared by the nets of a worker's threads.
+     *  Without one, the net creates its own store on the first streaming prediction.
+     */
+    void set_session_store(std::shared_ptr<RnnSessionStore> store) {
+        _sessions = store;
+    }
+
+    /// session states of prediction(session_ids), to end sessions or cap their memory.
+    RnnSessionStore& sessions();
+
+    /**
+     * \brief Enable or disable frozen execution plan.
+     *  When the input shapes and seq offsets match a plan built by a previous prediction,
+     *  the ops are dispatched through a flat launch list without per-op infer_shape,
+     *  op name compares and sync checks.
+     *  Note: only use it for models whose output shapes only depend on input shapes.
+     */
+    void set_frozen_plan(bool enable) {
+        _enable_frozen_plan = enable;
+        _frozen_plans.clear();
+        _current_plan = -1;
+        _trimmed_outs.clear();
+    }
+
+    /**
+     * \brief Register the recurring shapes of input in_name, it enables frozen plan.
+     *  Every bucket gets its own frozen plan (tensor shapes and seq offsets of all edges) and
+     *  its own ops initialized for its shapes, so moving between known buckets never re-runs
+     *  infer_shape nor re-creates kernels (jit code, packed weights).
+     *  Inputs without seq offset that don't match a bucket are zero padded up to the smallest
+     *  bucket covering them, outputs are trimmed back when only the batch (dim 0) was padded.
+     *  The padding staging buffer of every bucket is allocated here, predictions don't allocate.
+     *  Note: The net should be initialized with the largest bucket, memory is planned by init.
+     */
+    void register_shape_buckets(std::string in_name, std::vector<saber::Shape> buckets);
+
+    /**
+     * \brief Run independent branches of the net concurrently (only X86).
+     *  Ops are dispatched by a dependency DAG over the buffers they read and write,
+     *  ops on wide levels run on branch_threads threads, each pinned to its own partition
+     *  of cores with an OpenMP team of the partition size.
+     *  branch_threads <= 0 restores serial execution. It takes precedence over frozen plan.
+     */
+    void set_parallel_branches(int branch_threads);
+
+    /**
+     * \brief Plan the temp memory of the net as one arena (only X86, NV and ARM).
+     *  Edge tensors are packed at byte offsets by their sizes and lifetimes in execution order
+     *  instead of reusing whole tensors per lane. Net inputs, outputs and registered outs keep
+     *  their own buffers. It must be called before init.
+     */
+    void set_arena_memory(bool enable) {
+        _enable_arena = enable;
+    }
+
+    /**
+     * \brief Persist the derived weights kernels build at init (reordered, pre-packed,
+     *  winograd transformed) in the cache file at path, e.g. next to the model.
+     *  Later inits, in this or other processes, load them instead of building them again.
+     *  It must be called before init, an empty path disables the cache.
+     */
+    void set_weights_cache(const std::string& path);
+
+    /**
+     * \brief Profile the ops of one in every sample_every predictions, 0 disables profiling.
+     *  It can be switched at any time between predictions, the ops of sampled predictions are
+     *  timed in every execution mode and their outputs synced (only on devices), the others
+     *  run as without profiler. See profiler() for the histograms and exports.
+     */
+    void set_profiling(int sample_every) {
+        _profiler.set_sample_every(sample_every);
+    }
+
+    /**
+     * \brief Per op and per op type latency statistics of the sampled predictions,
+     *  exported by summary(), export_csv() and export_chrome_trace().
+     */
+    OpProfiler& profiler() {
+        return _profiler;
+    }
+
+    /**
+     * \brief Memory report: temp memory owned by this instance and the read-only
+     *  derived weights (reordered, pre-packed) shared by all nets of the process.
+     *  Note: temp mem is only measured when the net is created with need_summary.
+     */
+    std::string memory_report();
+
     /**
      * \brief clone new execute net engine
      */
@@ -111,12 +217,13 @@ public:
       */
     void load_calibrator_table();
 
-    //! get time for each op;
+    //! get time for each op, the op timer profiles every prediction by default;
 #ifdef ENABLE_OP_TIMER
     void print_and_reset_optime_summary(int epoch) {
+        std::vector<float> op_time = get_op_time();
         for (int i = 0; i < _op_param.size(); i++) {
             LOG(INFO) << "[SUMMARY OP TIMER]  name = " << _exec_funcs[i].name << " param " << _op_param[i] <<
-                      "  ,  time = " << _op_time[i] / epoch << " ms";
+                      "  ,  time = " << op_time[i] / epoch << " ms";
         }
 
         std::map<std::string, float> op_type_time_map;
@@ -126,9 +233,9 @@ public:
             it = op_type_time_map.find(_op_param[i]);
 
             if (it != op_type_time_map.end()) {
-                op_type_time_map[_op_param[i]] += (_op_time[i]);
+                op_type_time_map[_op_param[i]] += (op_time[i]);
             } else {
-                op_type_time_map[_op_param[i]] = (_op_time[i]);
+                op_type_time_map[_op_param[i]] = (op_time[i]);
             }
         }
 
@@ -137,18 +244,20 @@ public:
                       << " MS " << it->second / epoch;
         }
 
+        LOG(INFO) << _profiler.summary();
         reset_op_time();
     }
     void print_and_reset_optime_summary(int epoch, std::string const& file, bool app_mode = false) {
         try {
             Csvfile csvfile(file, app_mode);
+            std::vector<float> op_time = get_op_time();
             float sum_time = 0;
             csvfile << "EPOCH" << epoch << endrow;
 
             for (int i = 0; i < _op_param.size(); i++) {
                 csvfile << "NAME" << _exec_funcs[i].name << "PARAM" << _op_param[i] \
-                        << "MS" << _op_time[i] / epoch << endrow;
-                sum_time += _op_time[i] / epoch;
+                        << "MS" << op_time[i] / epoch << endrow;
+                sum_time += op_time[i] / epoch;
             }
 
             csvfile << "SUM" << sum_time << endrow;
@@ -159,9 +268,9 @@ public:
                 it = op_type_time_map.find(_op_param[i]);
 
                 if (it != op_type_time_map.end()) {
-                    op_type_time_map[_op_param[i]] += _op_time[i] / epoch;
+                    op_type_time_map[_op_param[i]] += op_time[i] / epoch;
                 } else {
-                    op_type_time_map[_op_param[i]] = _op_time[i] / epoch;
+                    op_type_time_map[_op_param[i]] = op_time[i] / epoch;
                 }
             }
 
@@ -176,10 +285,14 @@ public:
         reset_op_time();
     }
     void reset_op_time() {
-        _op_time = std::vector<float>(_exec_funcs.size(), 0.0f);
+        _profiler.reset();
     }
     std::vector<float> get_op_time() {
-        return _op_time;
+        std::vector<float> op_time(_exec_funcs.size(), 0.0f);
+        for (int i = 0; i < _profiler.op_num(); i++) {
+            op_time[i] = _profiler.op_histogram(i).sum_ns() / 1e6;
+        }
+        return op_time;
     }
     std::vector<std::string> get_op_param() {
         return _op_param;
@@ -290,11 +403,68 @@ private:
      */
     Status init_memory();
 
+    /**
+     *  \brief Alloc the temp memory of the net from one planned arena.
+     */
+    Status init_arena_memory();
+
     /**
      *  \brief Initial context environments.
      */
     Status init_env(graph::Graph<Ttype, Ptype>&);
 
+    /**
+     *  \brief Return index of the frozen plan built with current net inputs, -1 if not found.
+     */
+    int match_frozen_plan();
+
+    /**
+     *  \brief Record net inputs and tensor shapes of all ops as a new frozen plan.
+     */
+    void freeze_plan();
+
+    /**
+     *  \brief Create and init an op of executer for the current shapes, nullptr if the plan
+     *   keeps running the op of the net (Input/Output, ops holding rnn session state).
+     */
+    std::shared_ptr<OperatorBase> create_bucket_op(OperatorFunc<Ttype, Ptype>& executer);
+
+    /**
+     *  \brief Restore the tensor shapes of plan into net.
+     */
+    void apply_frozen_plan(int plan_id);
+
+    /**
+     *  \brief Run the frozen launch list.
+     */
+    void frozen_prediction(bool profiled);
+
+    /**
+     *  \brief Pad net inputs up to their nearest shape bucket.
+     *  \return the real batch before padding, -1 if batch isn't padded.
+     */
+    int pad_to_buckets();
+
+    /**
+     *  \brief Trim outputs of a batch padded prediction back to real batch.
+     */
+    void trim_outputs(int real_batch);
+
+    /**
+     *  \brief Give the outputs trimmed by the previous prediction their shapes of the current plan back.
+     */
+    void untrim_outputs();
+
+    /**
+     *  \brief Write the derived weights built by init to the weights cache.
+     */
+    void save_weights_cache();
+
+    /**
+     *  \brief Set the ops of the profiler from the initialized ops.
+     */
+    void init_profiler();
+
 private:
     ///< layout config file path , layout config will be load or create
     std::string _layout_config_path{""};
@@ -320,11 +490,56 @@ private:
     bool _need_summary{false};
 
 #ifdef ENABLE_OP_TIMER
-    std::vector<float> _op_time;
     std::vector<std::string> _op_param;
 #endif
+    ///< runtime op profiler, disabled unless set_profiling (or ENABLE_OP_TIMER).
+    OpProfiler _profiler;
 
     OperatorFunc<Ttype, Ptype>* _fusion{nullptr};
+
+    ///< one step of frozen execution plan.
+    struct FrozenStep {
+        OperatorFunc<Ttype, Ptype>* func;
+        bool sync_ins;
+        bool launch;
+    };
+    ///< tensor shapes of a frozen plan.
+    struct FrozenPlan {
+        std::vector<saber::Shape> in_shapes;
+        std::vector<std::vector<std::vector<int> > > in_offsets;
+        ///< shapes and seq offsets of every out tensor in the order of _frozen_steps
+        std::vector<saber::Shape> out_shapes;
+        std::vector<std::vector<std::vector<int> > > out_offsets;
+        ///< ops of a bucketed plan in the order of _frozen_steps, nullptr runs the op of the net.
+        std::vector<std::shared_ptr<OperatorBase> > ops;
+    };
+    bool _enable_frozen_plan{false};
+    ///< flat launch list shared by all frozen plans.
+    std::vector<FrozenStep> _frozen_steps;
+    ///< net inputs the frozen plans are keyed by.
+    std::vector<Tensor4dPtr<Ttype> > _frozen_ins;
+    std::vector<FrozenPlan> _frozen_plans;
+    ///< the plan whose shapes are currently set in net, -1 if unknown.
+    int _current_plan{-1};
+    ///< registered shape buckets of inputs.
+    std::unordered_map<std::string, std::vector<saber::Shape> > _shape_buckets;
+    ///< zero padded staging buffer of every bucket, in the order of _shape_buckets.
+    std::unordered_map<std::string, std::vector<std::shared_ptr<Tensor4d<Ttype> > > > _padded_buckets;
+    ///< outputs trimmed by the last prediction and their shapes in the current plan.
+    std::vector<std::pair<Tensor4dPtr<Ttype>, saber::Shape> > _trimmed_outs;
+    ///< max frozen plans kept with or without registered shape buckets.
+    const int _max_bucketed_plans{16};
+    const int _max_unbucketed_plans{1};
+    ///< branch threads of parallel execution, 0 for serial execution.
+    int _branch_threads{0};
+    std::shared_ptr<DagExecutor<Ttype, Ptype> > _dag_executor;
+    bool _enable_arena{false};
+    ///< arena holding the planned edge tensors.
+    std::shared_ptr<Tensor4d<Ttype> > _arena;
+    ///< persisted derived weights of the kernels, nullptr if disabled.
+    std::shared_ptr<saber::WeightCache> _weights_cache;
+    ///< states of streaming sessions.
+    std::shared_ptr<RnnSessionStore> _sessions;
 };
 
 }
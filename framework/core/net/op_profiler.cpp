@@ -0,0 +1,267 @@
+#include "framework/core/net/op_profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include "framework/utils/csv.h"
+#include "utils/logger/logger.h"
+
+namespace anakin {
+
+namespace {
+
+/// small id of the calling thread for trace rows.
+int trace_tid() {
+    static std::atomic<int> next_tid{0};
+    thread_local int tid = next_tid++;
+    return tid;
+}
+
+std::string json_escape(const std::string& str) {
+    std::string escaped;
+    for (auto c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            escaped += buf;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+int LatencyHistogram::bucket(unsigned long long ns) {
+    if (ns < (1ULL << MinExp)) {
+        return 0;
+    }
+    int exp = 63 - __builtin_clzll(ns);
+    if (exp >= MaxExp) {
+        return BucketNum - 1;
+    }
+    int sub = (ns >> (exp - SubBits)) & (SubBuckets - 1);
+    return 1 + (exp - MinExp) * SubBuckets + sub;
+}
+
+unsigned long long LatencyHistogram::lower_ns(int bucket) {
+    if (bucket <= 0) {
+        return 0;
+    }
+    if (bucket >= BucketNum - 1) {
+        return 1ULL << MaxExp;
+    }
+    int exp = MinExp + (bucket - 1) / SubBuckets;
+    unsigned long long sub = (bucket - 1) % SubBuckets;
+    return (SubBuckets + sub) << (exp - SubBits);
+}
+
+unsigned long long LatencyHistogram::upper_ns(int bucket) {
+    if (bucket >= BucketNum - 1) {
+        return ~0ULL;
+    }
+    return lower_ns(bucket + 1);
+}
+
+void LatencyHistogram::add(unsigned long long ns) {
+    _buckets[bucket(ns)]++;
+    _count++;
+    _sum += ns;
+    _min = std::min(_min, ns);
+    _max = std::max(_max, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BucketNum; i++) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _sum += other._sum;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(_buckets.begin(), _buckets.end(), 0);
+    _count = 0;
+    _sum = 0;
+    _min = ~0ULL;
+    _max = 0;
+}
+
+double LatencyHistogram::percentile_ms(double percent) const {
+    if (_count == 0) {
+        return 0.;
+    }
+    percent = std::min(std::max(percent, 0.), 100.);
+    unsigned long long rank = std::max(1ULL, (unsigned long long)std::ceil(percent / 100. * _count));
+    unsigned long long seen = 0;
+    for (int i = 0; i < BucketNum; i++) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            if (i == BucketNum - 1) {
+                return _max / 1e6;
+            }
+            // middle of the bucket, the samples of the bucket are within [min, max]
+            double mid = (lower_ns(i) + upper_ns(i)) / 2.;
+            mid = std::min(std::max(mid, (double)_min), (double)_max);
+            return mid / 1e6;
+        }
+    }
+    return _max / 1e6;
+}
+
+void OpProfiler::init(const std::vector<std::string>& names, const std::vector<std::string>& types,
+                      int trace_capacity) {
+    CHECK_EQ(names.size(), types.size()) << "every op needs a type";
+    _names = names;
+    _types = types;
+    _ops = std::vector<LatencyHistogram>(names.size());
+    _trace.resize(std::max(trace_capacity, 1));
+    reset();
+}
+
+void OpProfiler::end_prediction() {
+    _prediction.add(now_ns() - _prediction_start);
+}
+
+void OpProfiler::record(int op_id, unsigned long long start_ns, unsigned long long end_ns) {
+    _ops[op_id].add(end_ns - start_ns);
+    auto& event = _trace[_trace_next++ % _trace.size()];
+    event.op_id = op_id;
+    event.tid = trace_tid();
+    event.start_ns = start_ns;
+    event.dur_ns = end_ns - start_ns;
+}
+
+void OpProfiler::reset() {
+    for (auto& hist : _ops) {
+        hist.reset();
+    }
+    _prediction.reset();
+    _predictions = 0;
+    _trace_next = 0;
+    _epoch_ns = now_ns();
+}
+
+std::vector<std::string> OpProfiler::type_names() const {
+    std::vector<std::string> types;
+    for (auto& type : _types) {
+        if (std::find(types.begin(), types.end(), type) == types.end()) {
+            types.push_back(type);
+        }
+    }
+    return types;
+}
+
+LatencyHistogram OpProfiler::type_histogram(const std::string& type) const {
+    LatencyHistogram hist;
+    for (int i = 0; i < _ops.size(); i++) {
+        if (_types[i] == type) {
+            hist.merge(_ops[i]);
+        }
+    }
+    return hist;
+}
+
+std::string OpProfiler::summary() const {
+    std::ostringstream msg;
+    double predictions = std::max(1ULL, sampled_predictions());
+    msg << std::fixed << std::setprecision(4);
+    msg << "sampled predictions: " << sampled_predictions() << " (1 in " << _sample_every << ")"
+        << ", mean " << _prediction.mean_ms() << " ms, p50 " << _prediction.percentile_ms(50)
+        << " ms, p99 " << _prediction.percentile_ms(99) << " ms\n";
+    auto print = [&](const std::string& name, const std::string& type, const LatencyHistogram& hist) {
+        msg << std::left << std::setw(40) << name << std::setw(20) << type << std::right
+            << " calls " << std::setw(8) << hist.count()
+            << " ms/pred " << std::setw(10) << hist.sum_ns() / 1e6 / predictions
+            << " mean " << std::setw(10) << hist.mean_ms()
+            << " p50 " << std::setw(10) << hist.percentile_ms(50)
+            << " p99 " << std::setw(10) << hist.percentile_ms(99)
+            << " max " << std::setw(10) << hist.max_ns() / 1e6 << "\n";
+    };
+    std::vector<int> order(_ops.size());
+    for (int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return _ops[a].sum_ns() > _ops[b].sum_ns();
+    });
+    msg << "per op:\n";
+    for (auto i : order) {
+        print(_names[i], _types[i], _ops[i]);
+    }
+    std::vector<std::pair<std::string, LatencyHistogram> > types;
+    for (auto& type : type_names()) {
+        types.push_back({type, type_histogram(type)});
+    }
+    std::stable_sort(types.begin(), types.end(), [](const std::pair<std::string, LatencyHistogram>& a,
+                                                    const std::pair<std::string, LatencyHistogram>& b) {
+        return a.second.sum_ns() > b.second.sum_ns();
+    });
+    msg << "per op type:\n";
+    for (auto& type : types) {
+        print(type.first, "", type.second);
+    }
+    return msg.str();
+}
+
+void OpProfiler::export_csv(const std::string& file, bool app_mode) const {
+    try {
+        Csvfile csvfile(file, app_mode);
+        double predictions = std::max(1ULL, sampled_predictions());
+        csvfile << "EPOCH" << sampled_predictions() << endrow;
+        double sum_ms = 0.;
+        for (int i = 0; i < _ops.size(); i++) {
+            auto& hist = _ops[i];
+            csvfile << "NAME" << _names[i] << "PARAM" << _types[i] \
+                    << "MS" << hist.sum_ns() / 1e6 / predictions \
+                    << "CALLS" << hist.count() << "MEAN" << hist.mean_ms() \
+                    << "P50" << hist.percentile_ms(50) << "P99" << hist.percentile_ms(99) \
+                    << "MAX" << hist.max_ns() / 1e6 << endrow;
+            sum_ms += hist.sum_ns() / 1e6 / predictions;
+        }
+        csvfile << "SUM" << sum_ms << endrow;
+        for (auto& type : type_names()) {
+            auto hist = type_histogram(type);
+            csvfile << "PARAM" << type << "MS" << hist.sum_ns() / 1e6 / predictions \
+                    << "CALLS" << hist.count() << "MEAN" << hist.mean_ms() \
+                    << "P50" << hist.percentile_ms(50) << "P99" << hist.percentile_ms(99) \
+                    << "MAX" << hist.max_ns() / 1e6 << endrow;
+        }
+    } catch (const std::exception& ex) {
+        LOG(ERROR) << "write op profile " << file << " failed: " << ex.what();
+    }
+}
+
+bool OpProfiler::export_chrome_trace(const std::string& file) const {
+    FILE* f = fopen(file.c_str(), "w");
+    if (f == nullptr) {
+        LOG(ERROR) << "can't write chrome trace " << file;
+        return false;
+    }
+    unsigned long long recorded = _trace_next;
+    unsigned long long first = recorded > _trace.size() ? recorded - _trace.size() : 0;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (unsigned long long i = first; i < recorded; i++) {
+        auto& event = _trace[i % _trace.size()];
+        fprintf(f, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,"
+                "\"ts\":%.3f,\"dur\":%.3f}", i == first ? "" : ",",
+                json_escape(_names[event.op_id]).c_str(), json_escape(_types[event.op_id]).c_str(),
+                event.tid, (event.start_ns - _epoch_ns) / 1e3, event.dur_ns / 1e3);
+    }
+    fprintf(f, "\n]}\n");
+    if (fclose(f) != 0) {
+        LOG(ERROR) << "write chrome trace " << file << " failed";
+        return false;
+    }
+    return true;
+}
+
+} /* namespace anakin */
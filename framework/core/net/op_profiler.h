@@ -0,0 +1,165 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_OP_PROFILER_H
+#define ANAKIN_OP_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace anakin {
+
+/**
+ *  \brief Latency histogram with log spaced buckets.
+ *
+ *   Every power of two of nanoseconds is split in SubBuckets linear buckets, so a
+ *   percentile is within 1 / (2 * SubBuckets) of the real value and is read without
+ *   keeping or sorting the samples. Histograms of the same layout can be merged.
+ */
+class LatencyHistogram {
+public:
+    static const int SubBits = 3;
+    static const int SubBuckets = 1 << SubBits;
+    ///< latencies below 2^MinExp ns fall in the first bucket, from 2^MaxExp ns in the last one.
+    static const int MinExp = 6;
+    static const int MaxExp = 37;
+    static const int BucketNum = (MaxExp - MinExp) * SubBuckets + 2;
+
+    LatencyHistogram() : _buckets(BucketNum, 0) {}
+
+    void add(unsigned long long ns);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    unsigned long long count() const { return _count; }
+    unsigned long long sum_ns() const { return _sum; }
+    unsigned long long min_ns() const { return _count ? _min : 0; }
+    unsigned long long max_ns() const { return _max; }
+    double mean_ms() const { return _count ? _sum / 1e6 / _count : 0.; }
+
+    /// latency in ms below which percent (0-100) of the samples are.
+    double percentile_ms(double percent) const;
+
+    /// bucket of a latency, and the [lower, upper) ns range of a bucket.
+    static int bucket(unsigned long long ns);
+    static unsigned long long lower_ns(int bucket);
+    static unsigned long long upper_ns(int bucket);
+
+private:
+    std::vector<unsigned long long> _buckets;
+    unsigned long long _count{0};
+    unsigned long long _sum{0};
+    unsigned long long _min{~0ULL};
+    unsigned long long _max{0};
+};
+
+/**
+ *  \brief Runtime profiler of the ops of a net.
+ *
+ *   One in every sample_every predictions is profiled: the latency of each op goes to
+ *   its histogram and to a bounded ring of trace events, the other predictions only pay
+ *   a counter increment. Ops are timed by the monotonic clock (vdso, no syscall).
+ *   Ops of one prediction may be recorded from several threads (parallel branches),
+ *   every op from one thread. Reports and exports must not run concurrently with a
+ *   profiled prediction.
+ */
+class OpProfiler {
+public:
+    OpProfiler() {}
+    ~OpProfiler() {}
+
+    /**
+     *  \brief Set the ops to profile, it resets all statistics.
+     *  \param names op names in execution order.
+     *  \param types op types, statistics are also aggregated per type.
+     *  \param trace_capacity trace events kept, the oldest ones are overwritten.
+     */
+    void init(const std::vector<std::string>& names, const std::vector<std::string>& types,
+              int trace_capacity = 1 << 16);
+
+    /// profile one in every sample_every predictions, 0 disables the profiler.
+    void set_sample_every(int sample_every) { _sample_every = sample_every < 0 ? 0 : sample_every; }
+    int sample_every() const { return _sample_every; }
+    bool enabled() const { return _sample_every > 0; }
+
+    /// return true if the coming prediction is sampled, then it must be closed by end_prediction.
+    bool begin_prediction() {
+        if (_sample_every <= 0 || (_predictions++ % _sample_every) != 0) {
+            return false;
+        }
+        _prediction_start = now_ns();
+        return true;
+    }
+    void end_prediction();
+
+    /// monotonic time in ns.
+    static unsigned long long now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// record op op_id of a sampled prediction running from start_ns to end_ns.
+    void record(int op_id, unsigned long long start_ns, unsigned long long end_ns);
+
+    /// drop the statistics and trace events, the ops are kept.
+    void reset();
+
+    int op_num() const { return _names.size(); }
+    const std::string& op_name(int op_id) const { return _names[op_id]; }
+    const std::string& op_type(int op_id) const { return _types[op_id]; }
+    const LatencyHistogram& op_histogram(int op_id) const { return _ops[op_id]; }
+    /// latency of the whole sampled predictions.
+    const LatencyHistogram& prediction_histogram() const { return _prediction; }
+    unsigned long long sampled_predictions() const { return _prediction.count(); }
+
+    /// op types in first seen order and their merged histograms.
+    std::vector<std::string> type_names() const;
+    LatencyHistogram type_histogram(const std::string& type) const;
+
+    /// per op and per type table: calls, mean, p50, p99 and max in ms, sorted by total time.
+    std::string summary() const;
+
+    /// write the per op and per type statistics to a csv file.
+    void export_csv(const std::string& file, bool app_mode = false) const;
+
+    /// write the trace events as chrome trace json (chrome://tracing, perfetto), return false on failure.
+    bool export_chrome_trace(const std::string& file) const;
+
+private:
+    struct TraceEvent {
+        int op_id;
+        int tid;
+        unsigned long long start_ns;
+        unsigned long long dur_ns;
+    };
+
+    std::vector<std::string> _names;
+    std::vector<std::string> _types;
+    std::vector<LatencyHistogram> _ops;
+    LatencyHistogram _prediction;
+    int _sample_every{0};
+    unsigned long long _predictions{0};
+    unsigned long long _prediction_start{0};
+    ///< ring of trace events, written at _trace_next % capacity.
+    std::vector<TraceEvent> _trace;
+    std::atomic<unsigned long long> _trace_next{0};
+    unsigned long long _epoch_ns{0};
+};
+
+} /* namespace anakin */
+
+#endif
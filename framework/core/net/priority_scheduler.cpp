@@ -0,0 +1,66 @@
+#include "framework/core/net/priority_scheduler.h"
+#include <algorithm>
+#include "utils/logger/logger.h"
+
+namespace anakin {
+
+void PriorityScheduler::configure(int classes, std::vector<int> weights, int max_wait_ms) {
+    CHECK_GT(classes, 0) << "at least one priority class";
+    CHECK(weights.empty() || weights.size() == classes) << "one weight per priority class";
+    for (auto weight : weights) {
+        CHECK_GT(weight, 0) << "weights of priority classes must be positive";
+    }
+    _classes = classes;
+    _weights = weights;
+    _credits.assign(classes, 0);
+    _max_wait = std::chrono::milliseconds(std::max(0, max_wait_ms));
+}
+
+int PriorityScheduler::class_of(int priority) const {
+    return std::min(std::max(priority, 0), _classes - 1);
+}
+
+int PriorityScheduler::pick(const std::vector<TimePoint>& heads, TimePoint now) const {
+    int picked = -1;
+    // starved requests first, the oldest of them
+    if (_max_wait.count() > 0) {
+        for (int cls = 0; cls < heads.size(); cls++) {
+            if (heads[cls] != TimePoint::max() && now - heads[cls] > _max_wait
+                    && (picked < 0 || heads[cls] < heads[picked])) {
+                picked = cls;
+            }
+        }
+        if (picked >= 0) {
+            return picked;
+        }
+    }
+    for (int cls = 0; cls < heads.size(); cls++) {
+        if (heads[cls] == TimePoint::max()) {
+            continue;
+        }
+        if (_weights.empty()) {
+            return cls;
+        }
+        if (picked < 0 || _credits[cls] + _weights[cls] > _credits[picked] + _weights[picked]) {
+            picked = cls;
+        }
+    }
+    return picked;
+}
+
+void PriorityScheduler::served(int cls, const std::vector<TimePoint>& heads) {
+    if (_weights.empty() || cls < 0) {
+        return;
+    }
+    // every waiting class earns its weight, the served one pays for all of them
+    long long total = 0;
+    for (int c = 0; c < heads.size(); c++) {
+        if (heads[c] != TimePoint::max() || c == cls) {
+            _credits[c] += _weights[c];
+            total += _weights[c];
+        }
+    }
+    _credits[cls] -= total;
+}
+
+} /* namespace anakin */
@@ -0,0 +1,71 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef ANAKIN_PRIORITY_SCHEDULER_H
+#define ANAKIN_PRIORITY_SCHEDULER_H
+
+#include <chrono>
+#include <vector>
+
+namespace anakin {
+
+/**
+ *  \brief Picks the priority class whose request a worker serves next, class 0 is the most urgent.
+ *
+ *   Strict: the most urgent class with waiting requests.
+ *   Weighted: smooth weighted round robin over the classes with waiting requests, while they
+ *   all wait class c gets weights[c] of every sum(weights) picks.
+ *   Either way a request that waited longer than max_wait_ms is served first (oldest first),
+ *   so the background classes can't starve.
+ *   Note: It isn't thread safe, the worker calls it under its queue lock.
+ */
+class PriorityScheduler {
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    PriorityScheduler() {}
+    ~PriorityScheduler() {}
+
+    /// weights empty for strict priority, max_wait_ms 0 disables the starvation protection.
+    void configure(int classes, std::vector<int> weights, int max_wait_ms);
+
+    int classes() const {
+        return _classes;
+    }
+
+    /// class of priority, out of range priorities go to the nearest class.
+    int class_of(int priority) const;
+
+    /**
+     *  \brief Class to serve at now, -1 if no request waits.
+     *  \param heads arrival of the oldest waiting request of each class, TimePoint::max() if none.
+     */
+    int pick(const std::vector<TimePoint>& heads, TimePoint now) const;
+
+    /// account a request of cls served, heads as passed to pick.
+    void served(int cls, const std::vector<TimePoint>& heads);
+
+private:
+    int _classes{1};
+    std::vector<int> _weights;
+    ///< smooth weighted round robin credit of each class.
+    std::vector<long long> _credits;
+    std::chrono::milliseconds _max_wait{0};
+};
+
+} /* namespace anakin */
+
+#endif
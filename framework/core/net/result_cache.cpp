@@ -0,0 +1,63 @@
+#include "framework/core/net/result_cache.h"
+#include <cstring>
+
+namespace anakin {
+
+namespace {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/// murmur3 finalizer, every input bit flips about half of the output bits.
+inline uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+} // namespace
+
+ResultKeyBuilder::ResultKeyBuilder(const std::string& seed) : _lo(kPrime1), _hi(kPrime2) {
+    update(seed.data(), seed.size());
+}
+
+void ResultKeyBuilder::update(const void* data, size_t bytes) {
+    const char* ptr = static_cast<const char*>(data);
+    uint64_t lo = _lo;
+    uint64_t hi = _hi;
+    size_t words = bytes / sizeof(uint64_t);
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        memcpy(&word, ptr + i * sizeof(uint64_t), sizeof(uint64_t));
+        lo = rotl(lo ^ (word * kPrime2), 31) * kPrime1;
+        hi = rotl(hi + (word * kPrime4), 27) * kPrime3 + kPrime1;
+    }
+    size_t tail = bytes - words * sizeof(uint64_t);
+    if (tail > 0) {
+        uint64_t word = 0;
+        memcpy(&word, ptr + words * sizeof(uint64_t), tail);
+        lo = rotl(lo ^ (word * kPrime2), 31) * kPrime1;
+        hi = rotl(hi + (word * kPrime4), 27) * kPrime3 + kPrime1;
+    }
+    _lo = lo;
+    _hi = hi;
+    _bytes += bytes;
+}
+
+ResultKey ResultKeyBuilder::key() const {
+    ResultKey key;
+    key.lo = mix(_lo ^ _bytes);
+    key.hi = mix(_hi + _bytes * kPrime3);
+    return key;
+}
+
+} /* namespace anakin */
@@ -0,0 +1,224 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef ANAKIN_RESULT_CACHE_H
+#define ANAKIN_RESULT_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "framework/core/thread_safe_macros.h"
+#include "framework/core/parameter.h"
+
+namespace anakin {
+
+/// 128 bit fingerprint of the inputs of a prediction and of the model version that ran it.
+struct ResultKey {
+    uint64_t lo{0};
+    uint64_t hi{0};
+
+    bool operator==(const ResultKey& other) const {
+        return lo == other.lo && hi == other.hi;
+    }
+};
+
+struct ResultKeyHash {
+    size_t operator()(const ResultKey& key) const {
+        return static_cast<size_t>(key.lo);
+    }
+};
+
+/**
+ *  \brief Streaming hash of the bytes making a ResultKey.
+ *   Two independent 64 bit lanes fed a word at a time, fast enough to hash every request
+ *   and wide enough that distinct inputs don't meet in practice.
+ */
+class ResultKeyBuilder {
+public:
+    /// seed tells apart the keys of different models or model versions.
+    explicit ResultKeyBuilder(const std::string& seed = "");
+
+    void update(const void* data, size_t bytes);
+
+    template<typename T>
+    void update_value(T value) {
+        update(&value, sizeof(T));
+    }
+
+    ResultKey key() const;
+
+private:
+    uint64_t _lo;
+    uint64_t _hi;
+    uint64_t _bytes{0};
+};
+
+/**
+ *  \brief Outputs of recent predictions keyed by the hash of their inputs, so identical
+ *   requests are answered without running the net.
+ *
+ *   Entries are kept until, beyond max_bytes of outputs, they are evicted least recently
+ *   used first. The cache keeps its own copies of the tensors: what put is given and what
+ *   find hands out may be modified by the caller.
+ *   Note: Keys have to carry the model version (see ResultKeyBuilder), entries of a version
+ *   are never hit by another one, or the cache is cleared when the model changes.
+ */
+template<typename HostType>
+class ResultCache {
+public:
+    typedef std::vector<Tensor4d<HostType> > Outputs;
+
+    explicit ResultCache(size_t max_bytes = 0) : _max_bytes(max_bytes) {}
+    ~ResultCache() {}
+
+    /// cap of the outputs kept, 0 disables the cache.
+    void set_capacity(size_t max_bytes) {
+        std::lock_guard<std::mutex> guard(_mut);
+        _max_bytes = max_bytes;
+        evict();
+    }
+
+    size_t capacity() const {
+        return _max_bytes;
+    }
+
+    bool enabled() const {
+        return _max_bytes > 0;
+    }
+
+    /// copy the outputs of key to outs, false on a miss.
+    bool find(const ResultKey& key, Outputs& outs) {
+        std::lock_guard<std::mutex> guard(_mut);
+        auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            _misses++;
+            return false;
+        }
+        _hits++;
+        _lru.splice(_lru.begin(), _lru, it->second.lru);
+        outs = deep_copy(it->second.outs);
+        return true;
+    }
+
+    /// store outs as the outputs of key, outputs bigger than the cap aren't kept.
+    void put(const ResultKey& key, const Outputs& outs) {
+        size_t bytes = 0;
+        for (auto& out : outs) {
+            bytes += out.valid_size() * out.get_dtype_size();
+        }
+        if (bytes > _max_bytes) {
+            return;
+        }
+        auto copies = deep_copy(outs);
+        std::lock_guard<std::mutex> guard(_mut);
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            // concurrent misses of the same inputs, the outputs are the same
+            _lru.splice(_lru.begin(), _lru, it->second.lru);
+            return;
+        }
+        _lru.push_front(key);
+        Entry& entry = _entries[key];
+        entry.outs = std::move(copies);
+        entry.bytes = bytes;
+        entry.lru = _lru.begin();
+        _bytes += bytes;
+        evict();
+    }
+
+    /// drop every entry, e.g. when the model changes.
+    void clear() {
+        std::lock_guard<std::mutex> guard(_mut);
+        _entries.clear();
+        _lru.clear();
+        _bytes = 0;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard(_mut);
+        return _entries.size();
+    }
+
+    size_t bytes() {
+        std::lock_guard<std::mutex> guard(_mut);
+        return _bytes;
+    }
+
+    long long hits() {
+        std::lock_guard<std::mutex> guard(_mut);
+        return _hits;
+    }
+
+    long long misses() {
+        std::lock_guard<std::mutex> guard(_mut);
+        return _misses;
+    }
+
+    /// entries evicted by the memory cap.
+    long long evicted() {
+        std::lock_guard<std::mutex> guard(_mut);
+        return _evicted;
+    }
+
+private:
+    static Outputs deep_copy(const Outputs& outs) {
+        Outputs copies(outs.size());
+        for (int i = 0; i < outs.size(); i++) {
+            copies[i].re_alloc(outs[i].valid_shape(), outs[i].get_dtype());
+            copies[i].copy_from(outs[i]);
+            copies[i].set_seq_offset(outs[i].get_seq_offset());
+        }
+        return copies;
+    }
+
+    /// evict the least recently used entries until the outputs fit in the cap, all if it's 0.
+    void evict() EXCLUSIVE_LOCKS_REQUIRED(_mut) {
+        size_t max_bytes = _max_bytes;
+        while (!_lru.empty() && (max_bytes == 0 || _bytes > max_bytes)) {
+            auto it = _entries.find(_lru.back());
+            _bytes -= it->second.bytes;
+            _entries.erase(it);
+            _lru.pop_back();
+            _evicted++;
+        }
+    }
+
+    struct Entry {
+        Outputs outs;
+        size_t bytes{0};
+        ///< position in _lru.
+        typename std::list<ResultKey>::iterator lru;
+    };
+
+    std::mutex _mut;
+    ///< read without the lock by enabled, it's set before the cache serves.
+    std::atomic<size_t> _max_bytes;
+    size_t _bytes GUARDED_BY(_mut) {0};
+    long long _hits GUARDED_BY(_mut) {0};
+    long long _misses GUARDED_BY(_mut) {0};
+    long long _evicted GUARDED_BY(_mut) {0};
+    ///< keys, most recently used first.
+    std::list<ResultKey> _lru GUARDED_BY(_mut);
+    std::unordered_map<ResultKey, Entry, ResultKeyHash> _entries GUARDED_BY(_mut);
+};
+
+} /* namespace anakin */
+
+#endif
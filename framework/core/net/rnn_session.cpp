@@ -0,0 +1,86 @@
+#include "framework/core/net/rnn_session.h"
+#include "utils/logger/logger.h"
+
+namespace anakin {
+
+size_t RnnSession::bytes() const {
+    size_t floats = 0;
+    for (auto& state : hidden) {
+        floats += state.size();
+    }
+    for (auto& state : cell) {
+        floats += state.size();
+    }
+    return floats * sizeof(float);
+}
+
+void RnnSessionStore::set_memory_limit(size_t max_bytes) {
+    std::lock_guard<std::mutex> guard(_mut);
+    _max_bytes = max_bytes;
+    evict("");
+}
+
+std::shared_ptr<const RnnSession> RnnSessionStore::find(const std::string& id) {
+    std::lock_guard<std::mutex> guard(_mut);
+    auto it = _sessions.find(id);
+    if (it == _sessions.end()) {
+        return nullptr;
+    }
+    _lru.splice(_lru.begin(), _lru, it->second.lru);
+    return it->second.session;
+}
+
+void RnnSessionStore::put(const std::string& id, std::shared_ptr<const RnnSession> session) {
+    std::lock_guard<std::mutex> guard(_mut);
+    auto it = _sessions.find(id);
+    if (it != _sessions.end()) {
+        _bytes -= it->second.session->bytes();
+        _lru.splice(_lru.begin(), _lru, it->second.lru);
+        it->second.session = session;
+    } else {
+        _lru.push_front(id);
+        _sessions[id] = Entry{session, _lru.begin()};
+    }
+    _bytes += session->bytes();
+    evict(id);
+}
+
+bool RnnSessionStore::erase(const std::string& id) {
+    std::lock_guard<std::mutex> guard(_mut);
+    auto it = _sessions.find(id);
+    if (it == _sessions.end()) {
+        return false;
+    }
+    _bytes -= it->second.session->bytes();
+    _lru.erase(it->second.lru);
+    _sessions.erase(it);
+    return true;
+}
+
+size_t RnnSessionStore::size() {
+    std::lock_guard<std::mutex> guard(_mut);
+    return _sessions.size();
+}
+
+size_t RnnSessionStore::bytes() {
+    std::lock_guard<std::mutex> guard(_mut);
+    return _bytes;
+}
+
+size_t RnnSessionStore::evicted() {
+    std::lock_guard<std::mutex> guard(_mut);
+    return _evicted;
+}
+
+void RnnSessionStore::evict(const std::string& keep) {
+    while (_max_bytes > 0 && _bytes > _max_bytes && !_lru.empty() && _lru.back() != keep) {
+        auto it = _sessions.find(_lru.back());
+        DLOG(INFO) << "rnn session " << it->first << " is evicted";
+        _bytes -= it->second.session->bytes();
+        _sessions.erase(it);
+        _lru.pop_back();
+        _evicted++;
+    }
+}
+
+} /* namespace anakin */
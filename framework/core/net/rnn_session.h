@@ -0,0 +1,90 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef ANAKIN_RNN_SESSION_H
+#define ANAKIN_RNN_SESSION_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "framework/core/thread_safe_macros.h"
+
+namespace anakin {
+
+/// recurrent state a stream left after its last prediction, one entry per rnn op of the net.
+struct RnnSession {
+    std::vector<std::vector<float> > hidden;
+    ///< empty for ops without cell (gru).
+    std::vector<std::vector<float> > cell;
+
+    size_t bytes() const;
+};
+
+/**
+ *  \brief States of streaming sessions keyed by session id.
+ *
+ *   Sessions are kept until they are ended or, beyond max_bytes of states, evicted least
+ *   recently used first; an evicted session starts again from zeros on its next prediction.
+ *   The store is shared by the nets of a worker, so consecutive predictions of a session can
+ *   run on any of its threads.
+ */
+class RnnSessionStore {
+public:
+    explicit RnnSessionStore(size_t max_bytes = 0) : _max_bytes(max_bytes) {}
+    ~RnnSessionStore() {}
+
+    /// cap of the states kept, 0 for no cap.
+    void set_memory_limit(size_t max_bytes);
+
+    /// state of session id, nullptr for a new, ended or evicted session.
+    std::shared_ptr<const RnnSession> find(const std::string& id);
+
+    /// store the state of session id, replacing the previous one.
+    void put(const std::string& id, std::shared_ptr<const RnnSession> session);
+
+    /// end session id, false if it isn't kept.
+    bool erase(const std::string& id);
+
+    size_t size();
+    size_t bytes();
+    /// sessions evicted by the memory cap.
+    size_t evicted();
+
+private:
+    /// evict the least recently used sessions but keep, until the states fit in the cap.
+    void evict(const std::string& keep) EXCLUSIVE_LOCKS_REQUIRED(_mut);
+
+    struct Entry {
+        std::shared_ptr<const RnnSession> session;
+        ///< position in _lru.
+        std::list<std::string>::iterator lru;
+    };
+
+    std::mutex _mut;
+    size_t _max_bytes GUARDED_BY(_mut);
+    size_t _bytes GUARDED_BY(_mut) {0};
+    size_t _evicted GUARDED_BY(_mut) {0};
+    ///< session ids, most recently used first.
+    std::list<std::string> _lru GUARDED_BY(_mut);
+    std::unordered_map<std::string, Entry> _sessions GUARDED_BY(_mut);
+};
+
+} /* namespace anakin */
+
+#endif
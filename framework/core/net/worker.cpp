@@ -1,65 +1,174 @@
 #include "framework/core/net/worker.h"
 
 #ifndef USE_SGX
+#include <cstring>
+#include <set>
+#include <stdexcept>
 #include "saber/funcs/timer.h"
 
 namespace anakin {
 
-//! \brief a model map between thread_id and net model
+//! \brief models of the workers: the graph of a worker and the nets of its threads.
+//! a model is keyed by its path and the generation of its worker, so workers never share
+//! nets (thread ids are reused) and a reloaded file is loaded again.
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 struct NetGraphWrapper {
     typedef std::thread::id key;
 
-    void initial(std::string model_path, std::unordered_map<std::string, std::vector<int>>& shape_map) EXCLUSIVE_LOCKS_REQUIRED(this->_mut) {
+    /// load model_path as model_key once and init the net of the calling thread, nullptr if load fails.
+    Net<Ttype, Ptype, RunType>* initial(const std::string& model_key, const std::string& model_path, 
+                                        std::unordered_map<std::string, std::vector<int>>& shape_map) {
         std::lock_guard<std::mutex> guard(this->_mut);
-        if(_graph_map.count(model_path) <= 0) {
-            // graph load is thread safe
-            _graph_map[model_path].load(model_path);
-            for(auto it = shape_map.begin(); it != shape_map.end();) {
-                // thread safe
-                _graph_map[model_path].Reshape(it->first, it->second);
-                ++it;
+        auto& model = _models[model_key];
+        if (!model.loaded) {
+            auto status = model.graph.load(model_path);
+            if (!status) {
+                LOG(ERROR) << "load model " << model_path << " failed: " << status.info();
+                _models.erase(model_key);
+                return nullptr;
             }
-            // thread safe
-            _graph_map[model_path].Optimize();
-            {// make sure thread safety
-                key id = std::this_thread::get_id();
-                LOG(INFO) << "CURRENT thread ID : " << id;
-                if(_thread_to_net.find(id) == _thread_to_net.end()) {
-                    _thread_to_net[id].init(_graph_map[model_path]);
-                }
-            }
-        } else {
-            key id = std::this_thread::get_id(); 
-            LOG(INFO) << "CURRENT thread ID : " << id; 
-            if (_thread_to_net.find(id) == _thread_to_net.end()) { 
-                _thread_to_net[id].init(_graph_map[model_path]); 
+            for (auto it = shape_map.begin(); it != shape_map.end(); ++it) {
+                model.graph.Reshape(it->first, it->second);
             }
+            model.graph.Optimize();
+            model.loaded = true;
+        }
+        key id = std::this_thread::get_id();
+        LOG(INFO) << "CURRENT thread ID : " << id << " model: " << model_key;
+        if (model.nets.find(id) == model.nets.end()) {
+            model.nets[id].init(model.graph);
         }
+        // nets are nodes of the map, they don't move when other threads add theirs
+        return &model.nets[id];
     }
 
-    inline Net<Ttype, Ptype, RunType>& get_net(key id) {
-        if(_thread_to_net.find(id) != _thread_to_net.end()) { 
-            return _thread_to_net[id];
-        }
-        LOG(FATAL) << " target key(thread_id) not found in NetGraphWrapper";
-        return _thread_to_net[id];
+    /// release the graph and the nets of model_key, its threads must have exited.
+    void release(const std::string& model_key) {
+        std::lock_guard<std::mutex> guard(this->_mut);
+        _models.erase(model_key);
     }
     
 private:
-    std::unordered_map<std::string, graph::Graph<Ttype, Ptype>> _graph_map;
-    std::unordered_map<key, Net<Ttype, Ptype, RunType>> _thread_to_net GUARDED_BY(this->_mut);
+    struct Model {
+        graph::Graph<Ttype, Ptype> graph;
+        std::unordered_map<key, Net<Ttype, Ptype, RunType>> nets;
+        bool loaded{false};
+    };
+    std::unordered_map<std::string, Model> _models GUARDED_BY(this->_mut);
     std::mutex _mut;
 };
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 using MultiThreadModel = Singleton<NetGraphWrapper<Ttype, Ptype, RunType>>;
 
+namespace {
+
+/// generation of the next worker, it tells apart the models of workers loading the same path.
+std::atomic<unsigned long long> g_worker_generation{0};
+
+} // namespace
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Worker<Ttype, Ptype, RunType>::Worker(std::string model_path, int num_thread, SchedulePolicy policy)
+    : _model_path(model_path), ThreadPool(num_thread, policy) {
+    _model_key = model_path + "#" + std::to_string(g_worker_generation++);
+    _sessions = std::make_shared<RnnSessionStore>();
+    _batch_ques.resize(_scheduler.classes());
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Worker<Ttype, Ptype, RunType>::~Worker() {
+    // the threads use the members and the nets, they exit first
+    stop_dispatcher();
+    this->stop();
+    MultiThreadModel<Ttype, Ptype, RunType>::Global().release(_model_key);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Net<Ttype, Ptype, RunType>*& Worker<Ttype, Ptype, RunType>::local_net() {
+    static thread_local Net<Ttype, Ptype, RunType>* net = nullptr;
+    return net;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Net<Ttype, Ptype, RunType>& Worker<Ttype, Ptype, RunType>::thread_net() {
+    CHECK(local_net() != nullptr) << "model " << _model_path << " isn't loaded";
+    return *local_net();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::copy_config(const Worker& other) {
+    _inputs_in_order = other._inputs_in_order;
+    _outputs_in_order = other._outputs_in_order;
+    _edges_in_order = other._edges_in_order;
+    _auxiliary_funcs = other._auxiliary_funcs;
+    _in_shapes = other._in_shapes;
+    _max_batch = other._max_batch;
+    _max_wait_us = other._max_wait_us;
+    _cores = other._cores;
+    _omp_threads = other._omp_threads;
+    _max_queue = other._max_queue;
+    _metrics = other._metrics;
+    set_priority_classes(other._scheduler.classes(), other._class_weights, other._class_max_wait_ms);
+    set_session_memory_limit(other._session_memory_limit);
+    // a new cache: the outputs of the old version don't hold for this one
+    set_result_cache(other._result_cache.capacity());
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::set_warmup(int rounds, 
+        std::vector<Tensor4d<typename target_host<Ttype>::type> > ins) {
+    _warmup_rounds = std::max(0, rounds);
+    _warmup_ins.clear();
+    for (auto& in : ins) {
+        _warmup_ins.push_back(in);
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+bool Worker<Ttype, Ptype, RunType>::wait_ready() {
+    std::unique_lock<std::mutex> lock(_ready_mut);
+    _ready_cv.wait(lock, [this]() { return _ready_threads >= this->num_thread(); });
+    return !_init_failed;
+}
+
 template<typename Ttype, Precision Ptype, OpRunType RunType>
-Worker<Ttype, Ptype, RunType>::Worker(std::string model_path, int num_thread) : _model_path(model_path), ThreadPool(num_thread) {}
+std::vector<saber::DataType> Worker<Ttype, Ptype, RunType>::input_dtypes() {
+    std::unique_lock<std::mutex> lock(_ready_mut);
+    _ready_cv.wait(lock, [this]() { return _ready_threads > 0; });
+    if (_input_dtypes.empty()) {
+        return std::vector<saber::DataType>(_inputs_in_order.size(), AK_INVALID);
+    }
+    return _input_dtypes;
+}
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
-Worker<Ttype, Ptype, RunType>::~Worker() {}
+void Worker<Ttype, Ptype, RunType>::warm_up(Net<Ttype, Ptype, RunType>& net) {
+    typedef typename target_host<Ttype>::type target_h;
+    auto ins = _warmup_ins;
+    if (ins.empty()) {
+        // zeros of the net input shapes
+        for (auto& name : _inputs_in_order) {
+            auto* in = net.get_in(name);
+            Tensor4d<target_h> zeros;
+            zeros.re_alloc(in->valid_shape(), in->get_dtype());
+            memset(zeros.mutable_data(), 0, zeros.valid_size() * zeros.get_dtype_size());
+            ins.push_back(zeros);
+        }
+    }
+    for (int round = 0; round < _warmup_rounds; round++) {
+        for (int i = 0; i < _inputs_in_order.size(); i++) {
+            auto d_tensor_in_p = net.get_in(_inputs_in_order[i]);
+            d_tensor_in_p->reshape(ins[i].valid_shape());
+            d_tensor_in_p->copy_from(ins[i]);
+            d_tensor_in_p->set_seq_offset(ins[i].get_seq_offset());
+        }
+        net.prediction();
+        for (auto& out : _outputs_in_order) {
+            net.get_out(out)->sync();
+        }
+    }
+}
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 void Worker<Ttype, Ptype, RunType>::pause(size_t time) {
@@ -92,68 +201,716 @@ void Worker<Ttype, Ptype, RunType>::register_interior_edges(std::string bottom,
 }
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
-std::future<std::vector<Tensor4d<typename target_host<Ttype>::type> > > 
-Worker<Ttype, Ptype, RunType>::sync_prediction(std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_ins_list) {
-    auto task = [&](std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins) 
-                                -> std::vector<Tensor4d<typename target_host<Ttype>::type> > {
-        auto& net = MultiThreadModel<Ttype, Ptype, RunType>::Global().get_net(std::this_thread::get_id()); 
-        //fill the graph inputs
+void Worker<Ttype, Ptype, RunType>::set_batching(int max_batch, int max_wait_us) {
+    _max_batch = max_batch;
+    _max_wait_us = max_wait_us < 0 ? 0 : max_wait_us;
+}
 
-        for(int i = 0; i < _inputs_in_order.size(); i++) { 
-            float* data = (float*)(ins[i].mutable_data());
-            for(int j=0; j<10; j++) {
-                LOG(INFO) << "------> data " << data[j];;
-            }
-            auto d_tensor_in_p = net.get_in(_inputs_in_order[i]);
-            d_tensor_in_p->reshape(ins[i].valid_shape());
-            d_tensor_in_p->copy_from(ins[i]);
-            d_tensor_in_p->set_seq_offset(ins[i].get_seq_offset());
-        }
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::set_priority_classes(int classes, std::vector<int> weights, int max_wait_ms) {
+    {
+        std::lock_guard<std::mutex> guard(_batch_mut);
+        _scheduler.configure(classes, weights, max_wait_ms);
+        _batch_ques.resize(classes);
+    }
+    _class_weights = weights;
+    _class_max_wait_ms = max_wait_ms;
+    set_class_metrics();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::set_result_cache(size_t max_bytes) {
+    _result_cache.set_capacity(max_bytes);
+    if (_metrics.cache_bytes != nullptr) {
+        _metrics.cache_bytes->set(_result_cache.bytes());
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::set_queue_limit(int max_queue) {
+    _max_queue = std::max(0, max_queue);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::set_metrics(MetricsRegistry* registry, std::string model) {
+    MetricLabels labels = {{"model", model}};
+    _metrics.requests = registry->counter("anakin_requests_total", "Requests submitted to the model.", labels);
+    _metrics.overloaded = registry->counter("anakin_request_errors_total", "Requests that failed, by reason.",
+                                            {{"model", model}, {"reason", "overloaded"}});
+    _metrics.expired = registry->counter("anakin_request_errors_total", "Requests that failed, by reason.",
+                                         {{"model", model}, {"reason", "deadline_exceeded"}});
+    _metrics.queue_depth = registry->gauge("anakin_queue_depth", "Requests waiting for a worker thread.", labels);
+    _metrics.queue_wait = registry->summary("anakin_queue_wait_seconds", 
+                                            "Wait from the arrival of a request to the start of its prediction.",
+                                            labels);
+    _metrics.compute = registry->summary("anakin_compute_seconds", 
+                                         "Copy of the inputs, prediction and copy of the outputs of a request.",
+                                         labels);
+    _metrics.latency = registry->summary("anakin_request_latency_seconds", 
+                                         "End to end latency of a request in the worker.", labels);
+    _metrics.batch_size = registry->histogram("anakin_batch_size", "Samples of a prediction.",
+                                              {1, 2, 4, 8, 16, 32, 64, 128, 256}, labels);
+    _metrics.cache_hits = registry->counter("anakin_result_cache_lookups_total", "Lookups of the result cache.",
+                                            {{"model", model}, {"result", "hit"}});
+    _metrics.cache_misses = registry->counter("anakin_result_cache_lookups_total", "Lookups of the result cache.",
+                                              {{"model", model}, {"result", "miss"}});
+    _metrics.cache_bytes = registry->gauge("anakin_result_cache_bytes", "Outputs kept by the result cache.", labels);
+    _metrics.registry = registry;
+    _metrics.model = model;
+    set_class_metrics();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::set_class_metrics() {
+    _metrics.class_latency.clear();
+    if (_metrics.registry == nullptr || _scheduler.classes() <= 1) {
+        return;
+    }
+    for (int cls = 0; cls < _scheduler.classes(); cls++) {
+        _metrics.class_latency.push_back(_metrics.registry->summary("anakin_priority_latency_seconds",
+                "End to end latency of a request in the worker, by priority class.",
+                {{"model", _metrics.model}, {"priority", std::to_string(cls)}}));
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::observe(std::chrono::steady_clock::time_point arrive, 
+                                            std::chrono::steady_clock::time_point start) {
+    if (_metrics.requests == nullptr) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    auto ns = [](std::chrono::steady_clock::duration duration) -> unsigned long long {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    };
+    _metrics.queue_wait->observe_ns(ns(start - arrive));
+    _metrics.compute->observe_ns(ns(now - start));
+    _metrics.latency->observe_ns(ns(now - arrive));
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+typename Worker<Ttype, Ptype, RunType>::LoadStats Worker<Ttype, Ptype, RunType>::load_stats() {
+    LoadStats stats;
+    stats.queue_depth = _queued;
+    stats.max_queue = _max_queue;
+    stats.accepted = _accepted;
+    stats.rejected = _rejected;
+    stats.expired = _expired;
+    stats.completed = _completed;
+    stats.cache_hits = _result_cache.hits();
+    stats.cache_misses = _result_cache.misses();
+    return stats;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::set_cpu_set(std::vector<int> cores, int omp_threads) {
+    _cores = cores;
+    _omp_threads = std::max(1, omp_threads);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::bind_cpu_set() {
+    int team = std::min<int>(_omp_threads, _cores.size());
+    int first = (_next_slice++ * team) % _cores.size();
+    std::vector<int> slice;
+    for (int i = 0; i < team; i++) {
+        slice.push_back(_cores[(first + i) % _cores.size()]);
+    }
+    bind_thread_to_cores(slice);
+    set_team_size(team);
+    int node = numa_node_of_core(slice[0]);
+    // the net is initialized on this thread right after, its memory follows the cores
+    if (numa_node_num() > 1) {
+        prefer_numa_node(node);
+    }
+    LOG(INFO) << "worker thread " << std::this_thread::get_id() << " of " << _model_path
+              << " bound to cores [" << slice.front() << ", " << slice.back() << "] of numa node " << node
+              << ", OpenMP team " << team;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+std::vector<Tensor4d<typename target_host<Ttype>::type> > 
+Worker<Ttype, Ptype, RunType>::predict_on_host(Net<Ttype, Ptype, RunType>& net,
+                                               std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins,
+                        const std::vector<std::string>* session_ids) {
+    //fill the graph inputs
+    for (int i = 0; i < _inputs_in_order.size(); i++) { 
+        auto d_tensor_in_p = net.get_in(_inputs_in_order[i]);
+        d_tensor_in_p->reshape(ins[i].valid_shape());
+        d_tensor_in_p->copy_from(ins[i]);
+        d_tensor_in_p->set_seq_offset(ins[i].get_seq_offset());
+    }
+    if (_metrics.batch_size != nullptr && !ins.empty()) {
+        _metrics.batch_size->observe(ins[0].num());
+    }
 
-//        Context<NV> ctx(0, 0, 0);
-//        saber::SaberTimer<NV> my_time;
-//        my_time.start(ctx);
 #ifdef ENABLE_OP_TIMER
-        Context<Ttype> ctx(0, 0, 0);
-        saber::SaberTimer<Ttype> my_time;
-        my_time.start(ctx);
+    Context<Ttype> ctx(0, 0, 0);
+    saber::SaberTimer<Ttype> my_time;
+    my_time.start(ctx);
 #endif
+    if (session_ids != nullptr) {
+        auto status = net.prediction(*session_ids);
+        if (!status) {
+            throw std::invalid_argument(status.info());
+        }
+    } else {
         net.prediction();
-//
-//        my_time.end(ctx);
-//        LOG(ERROR) << " exec  << time: " << my_time.get_average_ms() << " ms ";
+    }
 
 #ifdef ENABLE_OP_TIMER
-        my_time.end(ctx); 
-        {
-            std::lock_guard<std::mutex> guard(_mut); 
-            _thead_id_to_prediction_times_vec_in_ms[std::this_thread::get_id()].push_back(my_time.get_average_ms());
-            LOG(ERROR) << " exec  << time: " << my_time.get_average_ms() << " ms ";
-        }
+    my_time.end(ctx); 
+    {
+        std::lock_guard<std::mutex> guard(_mut); 
+        _thead_id_to_prediction_times_vec_in_ms[std::this_thread::get_id()].push_back(my_time.get_average_ms());
+        LOG(ERROR) << " exec  << time: " << my_time.get_average_ms() << " ms ";
+    }
 #endif
-        // get outputs of graph
-        std::vector<Tensor4d<typename target_host<Ttype>::type>> ret;
-        ret.resize(_outputs_in_order.size());
-        for (int out_idx = 0; out_idx <  _outputs_in_order.size(); out_idx++) {
-            auto d_tensor_out_p = net.get_out(_outputs_in_order[out_idx]);
-            ret[out_idx].re_alloc(d_tensor_out_p->valid_shape());
-            ret[out_idx].copy_from(*d_tensor_out_p);
-            float* data = (float*)(ret[out_idx].mutable_data());
-            LOG(INFO) << "this thread: " << std::this_thread::get_id();
-            for(int i=0; i< 10; i++) {
-                LOG(INFO) << "????? data " << data[i];
+    // get outputs of graph
+    std::vector<Tensor4d<typename target_host<Ttype>::type>> ret;
+    ret.resize(_outputs_in_order.size());
+    for (int out_idx = 0; out_idx <  _outputs_in_order.size(); out_idx++) {
+        auto d_tensor_out_p = net.get_out(_outputs_in_order[out_idx]);
+        ret[out_idx].re_alloc(d_tensor_out_p->valid_shape(), d_tensor_out_p->get_dtype());
+        ret[out_idx].copy_from(*d_tensor_out_p);
+        ret[out_idx].set_seq_offset(d_tensor_out_p->get_seq_offset());
+    }
+    return ret;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+std::future<std::vector<Tensor4d<typename target_host<Ttype>::type> > > 
+Worker<Ttype, Ptype, RunType>::sync_prediction(std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_ins_list,
+        int priority) {
+    if (_metrics.requests != nullptr) {
+        _metrics.requests->inc();
+    }
+    bool cached = _result_cache.enabled();
+    ResultKey key;
+    if (cached) {
+        std::vector<Tensor4d<typename target_host<Ttype>::type> > outs;
+        if (find_result(net_ins_list, key, outs)) {
+            std::promise<std::vector<Tensor4d<typename target_host<Ttype>::type> > > hit;
+            _completed++;
+            hit.set_value(std::move(outs));
+            return hit.get_future();
+        }
+    }
+    if (scheduled()) {
+        auto request = std::make_shared<BatchRequest>();
+        for (auto& in : net_ins_list) {
+            request->ins.push_back(in);
+        }
+        request->priority = _scheduler.class_of(priority);
+        request->cached = cached;
+        request->cache_key = key;
+        auto result = request->result.get_future();
+        push_batch_request(request);
+        return result;
+    }
+    auto arrive = std::chrono::steady_clock::now();
+    auto task = [&, arrive, cached, key](std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins) 
+                                -> std::vector<Tensor4d<typename target_host<Ttype>::type> > {
+        auto start = std::chrono::steady_clock::now();
+        auto& net = thread_net(); 
+        auto outs = predict_on_host(net, ins);
+        if (cached) {
+            put_result(key, outs);
+        }
+        observe(arrive, start);
+        _completed++;
+        return outs;
+    };
+    return this->RunAsync(task, net_ins_list);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+std::future<std::vector<Tensor4d<typename target_host<Ttype>::type> > > 
+Worker<Ttype, Ptype, RunType>::stream_prediction(std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_ins_list,
+        std::vector<std::string> session_ids) {
+    if (_metrics.requests != nullptr) {
+        _metrics.requests->inc();
+    }
+    auto request = std::make_shared<StreamRequest>();
+    for (auto& in : net_ins_list) {
+        request->ins.push_back(in);
+    }
+    request->session_ids = std::move(session_ids);
+    request->arrive = std::chrono::steady_clock::now();
+    auto result = request->result.get_future();
+    push_stream_request(request);
+    return result;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::push_stream_request(std::shared_ptr<StreamRequest> request) {
+    // a repeated id is queued once, the net refuses the request
+    std::set<std::string> sessions(request->session_ids.begin(), request->session_ids.end());
+    bool ready = false;
+    {
+        std::lock_guard<std::mutex> guard(_stream_mut);
+        for (auto& id : sessions) {
+            auto& que = _stream_ques[id];
+            if (!que.empty()) {
+                request->blocked++;
             }
+            que.push_back(request);
         }
+        ready = request->blocked == 0;
+    }
+    if (ready) {
+        post_stream_request(request);
+    }
+}
 
-        return ret; 
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::post_stream_request(std::shared_ptr<StreamRequest> request) {
+    auto task = [this, request]() -> int {
+        auto start = std::chrono::steady_clock::now();
+        try {
+            auto outs = predict_on_host(thread_net(), request->ins, &request->session_ids);
+            observe(request->arrive, start);
+            _completed++;
+            request->result.set_value(std::move(outs));
+        } catch (const std::invalid_argument&) {
+            request->result.set_exception(std::current_exception());
+        }
+        // the next request of each session may run now
+        std::set<std::string> sessions(request->session_ids.begin(), request->session_ids.end());
+        std::vector<std::shared_ptr<StreamRequest> > ready;
+        {
+            std::lock_guard<std::mutex> guard(_stream_mut);
+            for (auto& id : sessions) {
+                auto it = _stream_ques.find(id);
+                it->second.pop_front();
+                if (it->second.empty()) {
+                    _stream_ques.erase(it);
+                } else if (--it->second.front()->blocked == 0) {
+                    ready.push_back(it->second.front());
+                }
+            }
+        }
+        for (auto& next : ready) {
+            post_stream_request(next);
+        }
+        return 0;
     };
-    return this->RunAsync(task, net_ins_list);
+    this->RunAsync(task);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+bool Worker<Ttype, Ptype, RunType>::submit_prediction(
+        std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_ins_list, 
+        Callback done, Deadline deadline, int priority) {
+    if (_metrics.requests != nullptr) {
+        _metrics.requests->inc();
+    }
+    bool cached = _result_cache.enabled();
+    ResultKey key;
+    if (cached) {
+        std::vector<Tensor4d<typename target_host<Ttype>::type> > outs;
+        if (find_result(net_ins_list, key, outs)) {
+            _accepted++;
+            // done runs on a pool thread as for the other requests, never inside submit
+            auto hit = std::make_shared<std::vector<Tensor4d<typename target_host<Ttype>::type> > >(std::move(outs));
+            auto task = [this, hit, done]() -> int {
+                _completed++;
+                done(*hit, Timing());
+                return 0;
+            };
+            this->RunAsync(task);
+            return true;
+        }
+    }
+    // take the slot first, concurrent submits can't overshoot the bound together
+    if (_queued++ >= _max_queue && _max_queue > 0) {
+        _queued--;
+        _rejected++;
+        if (_metrics.overloaded != nullptr) {
+            _metrics.overloaded->inc();
+        }
+        return false;
+    }
+    _accepted++;
+    if (_metrics.queue_depth != nullptr) {
+        _metrics.queue_depth->add(1);
+    }
+    auto request = std::make_shared<BatchRequest>();
+    for (auto& in : net_ins_list) {
+        request->ins.push_back(in);
+    }
+    request->done = done;
+    request->deadline = deadline;
+    request->queued = true;
+    request->priority = _scheduler.class_of(priority);
+    request->cached = cached;
+    request->cache_key = key;
+    if (scheduled()) {
+        push_batch_request(request);
+        return true;
+    }
+    request->arrive = std::chrono::steady_clock::now();
+    auto task = [this, request]() -> int {
+        auto start = std::chrono::steady_clock::now();
+        dequeue_request(*request);
+        if (start > request->deadline) {
+            expire_request(*request, start);
+            return 0;
+        }
+        auto& net = thread_net(); 
+        auto outs = predict_on_host(net, request->ins);
+        finish_request(*request, outs, start);
+        return 0;
+    };
+    this->RunAsync(task);
+    return true;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::push_batch_request(std::shared_ptr<BatchRequest> request) {
+    request->arrive = std::chrono::steady_clock::now();
+    start_dispatcher();
+    {
+        std::lock_guard<std::mutex> guard(_batch_mut);
+        _batch_ques[request->priority].push_back(request);
+    }
+    _batch_cv.notify_all();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::start_dispatcher() {
+    std::call_once(_dispatcher_once, [this]() {
+        {
+            std::lock_guard<std::mutex> guard(_batch_mut);
+            _free_threads = this->num_thread();
+        }
+        _dispatcher = std::thread([this]() { this->dispatch_batches(); });
+    });
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::stop_dispatcher() {
+    {
+        std::lock_guard<std::mutex> guard(_batch_mut);
+        _dispatcher_stop = true;
+    }
+    _batch_cv.notify_all();
+    if (_dispatcher.joinable()) {
+        _dispatcher.join();
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::dequeue_request(BatchRequest& request) {
+    if (request.queued) {
+        request.queued = false;
+        _queued--;
+        if (_metrics.queue_depth != nullptr) {
+            _metrics.queue_depth->add(-1);
+        }
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::expire_request(BatchRequest& request, 
+        std::chrono::steady_clock::time_point now) {
+    _expired++;
+    if (_metrics.expired != nullptr) {
+        _metrics.expired->inc();
+    }
+    std::vector<Tensor4d<typename target_host<Ttype>::type> > none;
+    if (!request.done) {
+        request.result.set_value(none);
+        return;
+    }
+    Timing timing;
+    timing.queue_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.arrive).count();
+    timing.expired = true;
+    request.done(none, timing);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::finish_request(BatchRequest& request,
+        std::vector<Tensor4d<typename target_host<Ttype>::type> >& outs,
+        std::chrono::steady_clock::time_point start) {
+    if (request.cached) {
+        put_result(request.cache_key, outs);
+    }
+    observe(request.arrive, start);
+    if (request.priority < _metrics.class_latency.size()) {
+        _metrics.class_latency[request.priority]->observe_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - request.arrive).count());
+    }
+    _completed++;
+    if (!request.done) {
+        request.result.set_value(std::move(outs));
+        return;
+    }
+    Timing timing;
+    timing.queue_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start - request.arrive).count();
+    timing.compute_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+    request.done(outs, timing);
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+ResultKey Worker<Ttype, Ptype, RunType>::result_key(
+        const std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins) {
+    // the model key is the version: a reloaded model is another worker with another key
+    ResultKeyBuilder builder(_model_key);
+    builder.update_value(ins.size());
+    for (auto& in : ins) {
+        auto shape = in.valid_shape();
+        builder.update_value(static_cast<int>(in.get_dtype()));
+        builder.update_value(shape.dims());
+        for (int dim = 0; dim < shape.dims(); dim++) {
+            builder.update_value(shape[dim]);
+        }
+        auto seq_offset = in.get_seq_offset();
+        builder.update_value(seq_offset.size());
+        for (auto& level : seq_offset) {
+            builder.update_value(level.size());
+            builder.update(level.data(), level.size() * sizeof(int));
+        }
+        if (in.valid_size() > 0) {
+            builder.update((const char*)(in.data()) + in.data_offset() * in.get_dtype_size(),
+                           in.valid_size() * in.get_dtype_size());
+        }
+    }
+    return builder.key();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+bool Worker<Ttype, Ptype, RunType>::find_result(
+        const std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins,
+        ResultKey& key, std::vector<Tensor4d<typename target_host<Ttype>::type> >& outs) {
+    key = result_key(ins);
+    if (_result_cache.find(key, outs)) {
+        if (_metrics.cache_hits != nullptr) {
+            _metrics.cache_hits->inc();
+        }
+        return true;
+    }
+    if (_metrics.cache_misses != nullptr) {
+        _metrics.cache_misses->inc();
+    }
+    return false;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::put_result(const ResultKey& key,
+        const std::vector<Tensor4d<typename target_host<Ttype>::type> >& outs) {
+    _result_cache.put(key, outs);
+    if (_metrics.cache_bytes != nullptr) {
+        _metrics.cache_bytes->set(_result_cache.bytes());
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+bool Worker<Ttype, Ptype, RunType>::mergeable(const BatchRequest& front, const BatchRequest& request) {
+    if (_merge_disabled || front.ins.size() != request.ins.size()) {
+        return false;
+    }
+    for (int i = 0; i < front.ins.size(); i++) {
+        auto& lhs = front.ins[i];
+        auto& rhs = request.ins[i];
+        // only batch major and non sequence inputs could be merged along dim 0
+        if (lhs.num_index() != 0 || rhs.num_index() != 0) {
+            return false;
+        }
+        if (lhs.get_seq_offset().size() > 0 || rhs.get_seq_offset().size() > 0) {
+            return false;
+        }
+        if (lhs.get_dtype() != rhs.get_dtype() || lhs.dims() != rhs.dims()) {
+            return false;
+        }
+        auto lhs_shape = lhs.valid_shape();
+        auto rhs_shape = rhs.valid_shape();
+        for (int dim = 1; dim < lhs_shape.dims(); dim++) {
+            if (lhs_shape[dim] != rhs_shape[dim]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+std::vector<PriorityScheduler::TimePoint> Worker<Ttype, Ptype, RunType>::queue_heads() {
+    std::vector<PriorityScheduler::TimePoint> heads;
+    for (auto& que : _batch_ques) {
+        heads.push_back(que.empty() ? PriorityScheduler::TimePoint::max() : que.front()->arrive);
+    }
+    return heads;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+int Worker<Ttype, Ptype, RunType>::pending_samples(const std::deque<std::shared_ptr<BatchRequest> >& que) {
+    auto& front = *que.front();
+    int samples = front.ins[0].num();
+    for (auto it = que.begin() + 1; it != que.end(); ++it) {
+        if (!mergeable(front, **it) || samples + (*it)->ins[0].num() > _max_batch) {
+            break;
+        }
+        samples += (*it)->ins[0].num();
+    }
+    return samples;
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::dispatch_batches() {
+    std::unique_lock<std::mutex> lock(_batch_mut);
+    for (;;) {
+        auto now = std::chrono::steady_clock::now();
+        // requests whose deadline passed while they waited aren't run
+        std::vector<std::shared_ptr<BatchRequest> > expired;
+        bool empty = true;
+        for (auto& que : _batch_ques) {
+            for (auto it = que.begin(); it != que.end();) {
+                if ((*it)->deadline < now) {
+                    expired.push_back(*it);
+                    it = que.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            empty = empty && que.empty();
+        }
+        // the class is picked when a thread is free, so a batch holds the most urgent requests of that time.
+        // on stop the rest is posted at once.
+        std::vector<std::shared_ptr<BatchRequest> > batch;
+        auto wake = PriorityScheduler::TimePoint::max();
+        if (!empty && (_free_threads > 0 || _dispatcher_stop)) {
+            auto heads = queue_heads();
+            int cls = _scheduler.pick(heads, now);
+            if (cls >= 0) {
+                auto& que = _batch_ques[cls];
+                auto fill_deadline = que.front()->arrive + std::chrono::microseconds(_max_wait_us);
+                if (!_dispatcher_stop && now < fill_deadline && pending_samples(que) < _max_batch) {
+                    // wait for the batch to fill, a more urgent request may come meanwhile
+                    wake = fill_deadline;
+                } else {
+                    _scheduler.served(cls, heads);
+                    int samples = que.front()->ins[0].num();
+                    batch.push_back(que.front());
+                    que.pop_front();
+                    while (!que.empty() && mergeable(*batch[0], *que.front())
+                            && samples + que.front()->ins[0].num() <= _max_batch) {
+                        samples += que.front()->ins[0].num();
+                        batch.push_back(que.front());
+                        que.pop_front();
+                    }
+                }
+            }
+        }
+        if (!batch.empty() || !expired.empty()) {
+            if (!batch.empty()) {
+                _free_threads--;
+            }
+            lock.unlock();
+            auto task = [this, batch, expired]() -> int {
+                this->run_batch(batch, expired);
+                if (!batch.empty()) {
+                    {
+                        std::lock_guard<std::mutex> guard(_batch_mut);
+                        _free_threads++;
+                    }
+                    _batch_cv.notify_all();
+                }
+                return 0;
+            };
+            this->RunAsync(task);
+            lock.lock();
+            continue;
+        }
+        if (_dispatcher_stop && empty) {
+            return;
+        }
+        if (wake == PriorityScheduler::TimePoint::max()) {
+            _batch_cv.wait(lock);
+        } else {
+            _batch_cv.wait_until(lock, wake);
+        }
+    }
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Worker<Ttype, Ptype, RunType>::run_batch(const std::vector<std::shared_ptr<BatchRequest> >& batch,
+                                              const std::vector<std::shared_ptr<BatchRequest> >& expired) {
+    typedef typename target_host<Ttype>::type target_h;
+    auto now = std::chrono::steady_clock::now();
+    for (auto& request : expired) {
+        dequeue_request(*request);
+        expire_request(*request, now);
+    }
+    if (batch.empty()) {
+        return;
+    }
+    for (auto& request : batch) {
+        dequeue_request(*request);
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto& net = thread_net();
+    if (batch.size() == 1) {
+        auto outs = predict_on_host(net, batch[0]->ins);
+        finish_request(*batch[0], outs, start);
+        return;
+    }
+    // merge inputs along the batch dimension
+    std::vector<Tensor4d<target_h> > merged_ins(batch[0]->ins.size());
+    for (int i = 0; i < merged_ins.size(); i++) {
+        saber::Shape merged_shape = batch[0]->ins[i].valid_shape();
+        merged_shape[0] = 0;
+        for (auto& request : batch) {
+            merged_shape[0] += request->ins[i].num();
+        }
+        merged_ins[i].re_alloc(merged_shape, batch[0]->ins[i].get_dtype());
+        char* dst = (char*)(merged_ins[i].mutable_data());
+        for (auto& request : batch) {
+            auto& in = request->ins[i];
+            size_t bytes = in.valid_size() * in.get_dtype_size();
+            memcpy(dst, (char*)(in.mutable_data()) + in.data_offset() * in.get_dtype_size(), bytes);
+            dst += bytes;
+        }
+    }
+    auto merged_outs = predict_on_host(net, merged_ins);
+    for (auto& out : merged_outs) {
+        if (out.valid_shape()[0] != merged_ins[0].num()) {
+            // the outputs can't be split, run the requests alone and stop merging them
+            if (!_merge_disabled.exchange(true)) {
+                LOG(WARNING) << "outputs of " << _model_path << " aren't batched along dim 0, batching is disabled.";
+            }
+            for (auto& request : batch) {
+                auto outs = predict_on_host(net, request->ins);
+                finish_request(*request, outs, start);
+            }
+            return;
+        }
+    }
+    // split outputs back into each request
+    std::vector<std::vector<Tensor4d<target_h> > > rets(batch.size());
+    for (auto& out : merged_outs) {
+        saber::Shape out_shape = out.valid_shape();
+        size_t sample_bytes = out.count_valid(1, out.dims()) * out.get_dtype_size();
+        const char* src = (const char*)(out.data());
+        for (int r = 0; r < batch.size(); r++) {
+            out_shape[0] = batch[r]->ins[0].num();
+            Tensor4d<target_h> part;
+            part.re_alloc(out_shape, out.get_dtype());
+            memcpy(part.mutable_data(), src, sample_bytes * out_shape[0]);
+            src += sample_bytes * out_shape[0];
+            rets[r].push_back(part);
+        }
+    }
+    for (int r = 0; r < batch.size(); r++) {
+        finish_request(*batch[r], rets[r], start);
+    }
 }
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 std::future<std::vector<Tensor4dPtr<Ttype> > > Worker<Ttype, Ptype, RunType>::sync_prediction_device(std::vector<Tensor4dPtr<Ttype> >& net_ins_list) {
     auto task = [&](std::vector<Tensor4dPtr<Ttype> >& ins) -> std::vector<Tensor4dPtr<Ttype> > {
-        auto& net = MultiThreadModel<Ttype, Ptype, RunType>::Global().get_net(std::this_thread::get_id()); 
+        auto& net = thread_net(); 
         //fill the graph inputs 
         for (int i = 0; i < _inputs_in_order.size(); i++) { 
             auto d_tensor_in_p = net.get_in(_inputs_in_order[i]); 
@@ -176,7 +933,7 @@ template<typename Ttype, Precision Ptype, OpRunType RunType>
 void Worker<Ttype, Ptype, RunType>::async_prediction(std::vector<Tensor4dPtr<typename target_host<Ttype>::type> >& net_ins_list) {
     std::lock_guard<std::mutex> guard(this->_async_que_mut);    
     auto task = [&](std::vector<Tensor4dPtr<typename target_host<Ttype>::type> >& ins) -> std::vector<Tensor4dPtr<Ttype> > {
-            auto& net = MultiThreadModel<Ttype, Ptype, RunType>::Global().get_net(std::this_thread::get_id());
+            auto& net = thread_net();
             //fill the graph inputs
             for(int i = 0; i < _inputs_in_order.size(); i++) {
                 auto d_tensor_in_p = net.get_in(_inputs_in_order[i]);
@@ -209,7 +966,37 @@ std::vector<Tensor4dPtr<Ttype> > Worker<Ttype, Ptype, RunType>::async_get_result
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 void Worker<Ttype, Ptype, RunType>::init() {
-    MultiThreadModel<Ttype, Ptype, RunType>::Global().initial(_model_path, _in_shapes);
+    if (!_cores.empty()) {
+        bind_cpu_set();
+    }
+    auto shapes = _in_shapes;
+    if (_max_batch > 1) {
+        // nets hold memory for the largest merged batch
+        for (auto& it : shapes) {
+            if (it.second.size() > 0) {
+                it.second[0] = _max_batch;
+            }
+        }
+    }
+    auto* net = MultiThreadModel<Ttype, Ptype, RunType>::Global().initial(_model_key, _model_path, shapes);
+    local_net() = net;
+    if (net != nullptr) {
+        net->set_session_store(_sessions);
+    }
+    if (net != nullptr && _warmup_rounds > 0) {
+        warm_up(*net);
+    }
+    {
+        std::lock_guard<std::mutex> guard(_ready_mut);
+        _ready_threads++;
+        _init_failed = _init_failed || net == nullptr;
+        if (net != nullptr && _input_dtypes.empty()) {
+            for (auto& name : _inputs_in_order) {
+                _input_dtypes.push_back(net->get_in(name)->get_dtype());
+            }
+        }
+    }
+    _ready_cv.notify_all();
 }
 
 template<typename Ttype, Precision Ptype, OpRunType RunType>
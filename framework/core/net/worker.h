@@ -23,15 +23,22 @@
 #include <vector>
 #include <thread>
 #include <queue>
+#include <deque>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include "framework/core/thread_safe_macros.h"
 #include "framework/core/thread_pool.h"
 #include "framework/core/singleton.h"
+#include "framework/core/cpu_affinity.h"
 #include "framework/core/net/operator_func.h"
 #include "framework/core/net/net.h"
+#include "framework/core/net/metrics.h"
+#include "framework/core/net/priority_scheduler.h"
+#include "framework/core/net/result_cache.h"
 
 namespace anakin {
 
@@ -64,12 +71,49 @@ namespace anakin {
  *              auto outs = worker_for_vgg_net.async_get_result();         
  *          }
  *          \endcode
+ *      - \p [BATCHING]
+ *          \code
+ *          Worker<X86, Precision::FP32>  worker_for_vgg_net(vgg, 4);
+ *          worker_for_vgg_net.Reshape("input_0", {1, 3, 224, 224});
+ *          // merge concurrent requests up to 16 samples, never wait longer than 2ms for a batch to fill.
+ *          worker_for_vgg_net.set_batching(16, 2000);
+ *          worker_for_vgg_net.launch();
+ *          auto outs = worker_for_vgg_net.sync_prediction(net_ins).get();
+ *          \endcode
+ *      - \p [CPU SET]
+ *          \code
+ *          // two models sharing a host: each gets the cores of one socket, 4 threads x 4 OpenMP cores.
+ *          Worker<X86, Precision::FP32>  worker_for_vgg_net(vgg, 4);
+ *          worker_for_vgg_net.set_cpu_set(parse_cpu_list("0-15"), 4);
+ *          Worker<X86, Precision::FP32>  worker_for_resnet(resnet, 4);
+ *          worker_for_resnet.set_cpu_set(parse_cpu_list("16-31"), 4);
+ *          \endcode
+ *      - \p [STREAMING]
+ *          \code
+ *          Worker<X86, Precision::FP32>  worker_for_asr(asr_lstm, 4);
+ *          worker_for_asr.set_session_memory_limit(256 << 20);
+ *          worker_for_asr.launch();
+ *          // each call carries only the new frames of the streams, one sequence per stream
+ *          auto outs = worker_for_asr.stream_prediction(new_frames, {"call_17", "call_42"}).get();
+ *          worker_for_asr.end_session("call_17");
+ *          \endcode
+ *      - \p [RESULT CACHE]
+ *          \code
+ *          Worker<X86, Precision::FP32>  worker_for_ranker(ranker, 4);
+ *          // repeated inputs are answered from up to 64MB of recent outputs without running the net
+ *          worker_for_ranker.set_result_cache(64 << 20);
+ *          worker_for_ranker.launch();
+ *          \endcode
  *
  */
 template<typename Ttype, Precision Ptype, OpRunType RunTyp = OpRunType::ASYNC>
 class Worker : public ThreadPool {
 public:
-    Worker(std::string model_path, int thread_num);
+    /**
+     *  \brief Worker of the model at model_path with thread_num threads.
+     *  \param policy how the threads take requests, see SchedulePolicy.
+     */
+    Worker(std::string model_path, int thread_num, SchedulePolicy policy = SchedulePolicy::FIFO);
     ~Worker();
 
 	/** 
@@ -104,14 +148,168 @@ public:
      */
     void register_interior_edges(std::string, std::string);
 
+    /** 
+     *  \brief Enable dynamic batching for sync_prediction.
+     *  Concurrent requests are merged along the batch dimension (dim 0) up to max_batch samples,
+     *  run by one Net::prediction and split back into each caller's future.
+     *  The oldest pending request never waits longer than max_wait_us for the batch to fill.
+     *  Note: It must be invoked before launch, the net inputs are initialized with batch max_batch.
+     *  \param max_batch max samples in one merged prediction (<= 1 disables batching).
+     *  \param max_wait_us batching deadline in micro seconds.
+     */
+    void set_batching(int max_batch, int max_wait_us);
+
+    /** 
+     *  \brief Confine the worker to cores, so models sharing a host don't compete for them.
+     *  Thread i of the worker is pinned to its own omp_threads cores of the set (wrapping around
+     *  when the threads need more cores than the set has), runs OpenMP teams of omp_threads and
+     *  allocates its net on the NUMA node of its cores.
+     *  Note: It must be invoked before launch.
+     *  \param cores cpu set of the worker, empty to leave the threads unbound.
+     *  \param omp_threads OpenMP team size of each thread.
+     */
+    void set_cpu_set(std::vector<int> cores, int omp_threads = 1);
+
+    /** 
+     *  \brief Queue the requests of sync_prediction and submit_prediction by priority class
+     *  instead of one FIFO, so background traffic fills the idle threads without delaying the
+     *  latency critical requests ahead of it. Class 0 is the most urgent.
+     *  Strict priority serves a class only when the more urgent ones have nothing waiting,
+     *  weights share the threads between waiting classes (class c gets weights[c] of every
+     *  sum(weights) requests). A request waiting longer than max_wait_ms goes first anyway.
+     *  Dynamic batching merges requests of the same class only.
+     *  Note: It must be invoked before launch.
+     *  \param classes number of priority classes (1 restores one FIFO).
+     *  \param weights one per class, empty for strict priority.
+     *  \param max_wait_ms starvation bound, 0 for none.
+     */
+    void set_priority_classes(int classes, std::vector<int> weights = {}, int max_wait_ms = 0);
+
+    /** 
+     *  \brief Answer sync_prediction and submit_prediction from the outputs of a previous request
+     *  with the same inputs (shapes, dtypes, sequence offsets and data), without running the net.
+     *  Entries are keyed by the model version of the worker and a hash of the inputs, and are
+     *  evicted least recently used first beyond max_bytes of outputs. A hit doesn't take a
+     *  queue slot; sync_prediction returns a ready future and submit_prediction calls done
+     *  on a pool thread, as for a request that runs.
+     *  Only models whose outputs depend on their inputs alone should enable it.
+     *  \param max_bytes cap of the cached outputs, 0 disables the cache.
+     */
+    void set_result_cache(size_t max_bytes);
+
+    /// forget the cached outputs, e.g. when something besides the model changes them.
+    void clear_result_cache() {
+        _result_cache.clear();
+        if (_metrics.cache_bytes != nullptr) {
+            _metrics.cache_bytes->set(0);
+        }
+    }
+
 public:
+    /** 
+     *  \brief Bound the requests of submit_prediction waiting for a thread.
+     *  Beyond max_queue waiting requests submit_prediction refuses new ones at once,
+     *  so a traffic spike sheds a few requests instead of making all of them late.
+     *  \param max_queue max waiting requests, 0 for no bound.
+     */
+    void set_queue_limit(int max_queue);
+
+    /** 
+     *  \brief Report the requests of the worker to registry, as the series of label model.
+     *  Requests, overloaded and expired ones, queue depth, queue wait, compute and end to end
+     *  latency of the requests and the batch size of the predictions are tracked.
+     *  Note: It must be invoked before launch, registry must outlive the worker.
+     */
+    void set_metrics(MetricsRegistry* registry, std::string model);
+
+    /** 
+     *  \brief Take the inputs, outputs, shapes, batching, cpu set, priority classes, queue limit, metrics,
+     *  session memory limit, result cache size and auxiliary functions of other, e.g. for a new version
+     *  of its model. Sessions and cached results aren't taken, they don't hold for the new version.
+     *  Note: It must be invoked before launch.
+     */
+    void copy_config(const Worker& other);
+
+    /** 
+     *  \brief Run rounds predictions on the net of every thread when it's initialized, so first
+     *  requests don't pay for lazy allocations and cold caches.
+     *  Note: It must be invoked before launch.
+     *  \param ins sample host inputs, zeros of the net input shapes if empty.
+     */
+    void set_warmup(int rounds, std::vector<Tensor4d<typename target_host<Ttype>::type> > ins = {});
+
+    /** 
+     *  \brief Wait until every thread has loaded (and warmed up) its net after launch.
+     *  \return false if the model failed to load, the worker can't serve.
+     */
+    bool wait_ready();
+
+    /** 
+     *  \brief Dtypes of the registered inputs of the net, in order.
+     *  Note: It waits until the first thread has loaded the net after launch,
+     *  the dtypes are AK_INVALID if it failed.
+     */
+    std::vector<saber::DataType> input_dtypes();
+
+public:
+    /// durations of one prediction in ns.
+    struct Timing {
+        long long queue_ns{0};      ///< from submit to the start of its prediction.
+        long long compute_ns{0};    ///< copy in, prediction and copy out.
+        bool expired{false};        ///< its deadline passed before it started, it wasn't run.
+    };
+    /// admission counters of submit_prediction since launch.
+    struct LoadStats {
+        long long queue_depth{0};   ///< requests waiting for a thread.
+        long long max_queue{0};     ///< bound of queue_depth, 0 if unbounded.
+        long long accepted{0};
+        long long rejected{0};      ///< refused by submit_prediction, the queue was full.
+        long long expired{0};       ///< dropped before they started, their deadline had passed.
+        long long completed{0};     ///< requests answered, of every prediction api.
+        ///< result cache lookups of sync and submit_prediction, a submitted hit is accepted and completed.
+        long long cache_hits{0};
+        long long cache_misses{0};
+    };
+    typedef std::chrono::steady_clock::time_point Deadline;
+    /// completion callback of submit_prediction, invoked on the worker thread.
+    typedef std::function<void(std::vector<Tensor4d<typename target_host<Ttype>::type> >&, 
+                               const Timing&)> Callback;
+
     /** 
      *  \brief do sync prediction in multi-thread worker useful in sync rpc server. 
      *  \param host net_in_list the inputs of net graph (note: the len of net_in_list should be equal to the net inputs).  
      *  \return the net graph outputs.
      */
     std::future<std::vector<Tensor4d<typename target_host<Ttype>::type> > > sync_prediction(\
-        std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_in_list);
+        std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_in_list, int priority = 0);
+
+    /** 
+     *  \brief Streaming prediction of a recurrent model, sequence i of the inputs continues
+     *  session session_ids[i] from the rnn state its previous prediction left (see
+     *  Net::prediction(session_ids)). Sessions are shared by the threads of the worker, the
+     *  predictions of a session run one at a time in the order they are submitted.
+     *  Streaming predictions aren't merged by dynamic batching.
+     *  The future holds std::invalid_argument if the net refuses the sessions (a repeated
+     *  id, a target without streaming).
+     */
+    std::future<std::vector<Tensor4d<typename target_host<Ttype>::type> > > stream_prediction(\
+        std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_in_list,
+        std::vector<std::string> session_ids);
+
+    /// forget the state of session id, e.g. when its stream ends.
+    bool end_session(const std::string& id) {
+        return _sessions->erase(id);
+    }
+
+    /// cap of the session states, least recently used sessions are evicted beyond it, 0 for none.
+    void set_session_memory_limit(size_t max_bytes) {
+        _session_memory_limit = max_bytes;
+        _sessions->set_memory_limit(max_bytes);
+    }
+
+    size_t session_num() {
+        return _sessions->size();
+    }
 
     /** 
      *  \brief Do sync prediction in multi-thread worker useful in sync rpc server, this function need 
@@ -121,6 +319,21 @@ public:
     std::future<std::vector<Tensor4dPtr<Ttype> > > sync_prediction_device(\
         std::vector<Tensor4dPtr<Ttype> >& net_in_list);
 
+    /** 
+     *  \brief Submit a prediction and return at once, nobody waits for it.
+     *  done gets the outputs and the timing on the worker thread that ran it, dynamic batching
+     *  applies as for sync_prediction. A request still waiting at its deadline isn't run,
+     *  done gets no outputs and timing.expired.
+     *  \param net_in_list host inputs, their memory must stay valid until done is invoked.
+     *  \param priority class of the request, see set_priority_classes.
+     *  \return false if the queue is full, the request is dropped and done is never invoked.
+     */
+    bool submit_prediction(std::vector<Tensor4d<typename target_host<Ttype>::type> >& net_in_list,
+                           Callback done, Deadline deadline = Deadline::max(), int priority = 0);
+
+    /// snapshot of the admission counters.
+    LoadStats load_stats();
+
     /** 
      *  \brief do async prediction in multi-thread worker, the result will be save to que 
      *  \param net_in_list the inputs of net graph (note: the len of net_in_list should be equal to the net inputs)  
@@ -171,8 +384,119 @@ private:
 
     virtual void auxiliary_funcs() override;
 
+    /// pin the calling pool thread to its slice of the cpu set.
+    void bind_cpu_set();
+
+    /// net of the calling pool thread, set by init.
+    static Net<Ttype, Ptype, RunTyp>*& local_net();
+    Net<Ttype, Ptype, RunTyp>& thread_net();
+
+    void warm_up(Net<Ttype, Ptype, RunTyp>& net);
+
+    /// copy host inputs into net, run prediction (streaming if session_ids) and copy outputs back to host.
+    std::vector<Tensor4d<typename target_host<Ttype>::type> > \
+        predict_on_host(Net<Ttype, Ptype, RunTyp>& net, 
+                        std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins,
+                        const std::vector<std::string>* session_ids = nullptr);
+
+private:
+    /// pending request of dynamic batching.
+    struct BatchRequest {
+        std::vector<Tensor4d<typename target_host<Ttype>::type> > ins;
+        std::promise<std::vector<Tensor4d<typename target_host<Ttype>::type> > > result;
+        ///< set by submit_prediction, the result is handed to it instead of the promise.
+        Callback done;
+        std::chrono::steady_clock::time_point arrive;
+        Deadline deadline{Deadline::max()};
+        ///< counted in _queued until it starts.
+        bool queued{false};
+        int priority{0};
+        ///< its outputs go to the result cache under cache_key.
+        bool cached{false};
+        ResultKey cache_key;
+    };
+
+    /// requests go through the queues of the dispatcher instead of straight to the pool.
+    bool scheduled() const {
+        return _max_batch > 1 || _scheduler.classes() > 1;
+    }
+
+    /** 
+     *  \brief Loop of the dispatcher thread: collect the queued requests into batches and post
+     *  a batch to the pool when a thread is free for it. Only the dispatcher waits for a batch
+     *  to fill, the pool threads run full batches.
+     */
+    void dispatch_batches();
+
+    /// start the dispatcher with the first queued request.
+    void start_dispatcher();
+
+    /// stop the dispatcher once every queued request is posted.
+    void stop_dispatcher();
+
+    /// merged samples of the head of que.
+    int pending_samples(const std::deque<std::shared_ptr<BatchRequest> >& que) EXCLUSIVE_LOCKS_REQUIRED(_batch_mut);
+
+    /// run batch on current thread's net and fulfill the results, expired requests finish unrun.
+    void run_batch(const std::vector<std::shared_ptr<BatchRequest> >& batch,
+                   const std::vector<std::shared_ptr<BatchRequest> >& expired);
+
+    /// arrival of the oldest request of each class, TimePoint::max() for empty classes.
+    std::vector<PriorityScheduler::TimePoint> queue_heads() EXCLUSIVE_LOCKS_REQUIRED(_batch_mut);
+
+    /// series of the priority classes, when both set_metrics and set_priority_classes are set.
+    void set_class_metrics();
+
+    /// report a request that started at start and finished now to the metrics.
+    void observe(std::chrono::steady_clock::time_point arrive, std::chrono::steady_clock::time_point start);
+
+    /// take request out of the queue depth when a thread picks it.
+    void dequeue_request(BatchRequest& request);
+
+    /// finish request without running it, its deadline passed.
+    void expire_request(BatchRequest& request, std::chrono::steady_clock::time_point now);
+
+    /// queue request for the dispatcher.
+    void push_batch_request(std::shared_ptr<BatchRequest> request);
+
+    /// hand outputs of request to its callback or promise.
+    void finish_request(BatchRequest& request, 
+                        std::vector<Tensor4d<typename target_host<Ttype>::type> >& outs,
+                        std::chrono::steady_clock::time_point start);
+
+    /// key of ins in the result cache, the model version is part of it.
+    ResultKey result_key(const std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins);
+
+    /// look ins up in the result cache, outs are set and key is left unset on a hit.
+    bool find_result(const std::vector<Tensor4d<typename target_host<Ttype>::type> >& ins,
+                     ResultKey& key, std::vector<Tensor4d<typename target_host<Ttype>::type> >& outs);
+
+    /// store outs as the result of key.
+    void put_result(const ResultKey& key, const std::vector<Tensor4d<typename target_host<Ttype>::type> >& outs);
+
+    /// pending request of stream_prediction.
+    struct StreamRequest {
+        std::vector<Tensor4d<typename target_host<Ttype>::type> > ins;
+        std::vector<std::string> session_ids;
+        std::promise<std::vector<Tensor4d<typename target_host<Ttype>::type> > > result;
+        std::chrono::steady_clock::time_point arrive;
+        ///< sessions of the request whose earlier requests haven't finished, under _stream_mut.
+        int blocked{0};
+    };
+
+    /// queue request behind the pending requests of its sessions, post it when there are none.
+    void push_stream_request(std::shared_ptr<StreamRequest> request);
+
+    /// post request to the pool, it posts the requests of its sessions waiting for it when done.
+    void post_stream_request(std::shared_ptr<StreamRequest> request);
+
+    /// return true if request can be merged into batch whose head is front.
+    bool mergeable(const BatchRequest& front, const BatchRequest& request);
+
 private:
     std::string _model_path;
+    ///< key of the model of this worker in MultiThreadModel, path and generation.
+    std::string _model_key;
     ///< vector of inputs node in order.
     std::vector<std::string> _inputs_in_order;
     ///< vector of outputs node in order.
@@ -183,6 +507,72 @@ private:
     std::mutex _async_que_mut;    
     std::vector<std::function<void(void)> > _auxiliary_funcs;
     std::unordered_map<std::string, std::vector<int>> _in_shapes;
+    ///< dynamic batching config, batching is disabled when _max_batch <= 1.
+    int _max_batch{1};
+    int _max_wait_us{0};
+    ///< pending requests of each priority class.
+    std::vector<std::deque<std::shared_ptr<BatchRequest> > > _batch_ques GUARDED_BY(_batch_mut);
+    PriorityScheduler _scheduler;
+    std::vector<int> _class_weights;
+    int _class_max_wait_ms{0};
+    std::mutex _batch_mut;
+    std::condition_variable _batch_cv;
+    ///< collects the queued requests, see dispatch_batches.
+    std::thread _dispatcher;
+    std::once_flag _dispatcher_once;
+    bool _dispatcher_stop GUARDED_BY(_batch_mut) {false};
+    ///< pool threads not running a batch, a batch is posted only when one is free.
+    int _free_threads GUARDED_BY(_batch_mut) {0};
+    ///< set when a merged prediction had outputs not batched along dim 0, requests run alone since.
+    std::atomic<bool> _merge_disabled{false};
+    ///< cpu set config, threads are unbound when _cores is empty.
+    std::vector<int> _cores;
+    int _omp_threads{1};
+    ///< next slice of _cores handed to a pool thread.
+    std::atomic<int> _next_slice{0};
+    ///< admission of submit_prediction, unbounded when _max_queue is 0.
+    int _max_queue{0};
+    std::atomic<long long> _queued{0};
+    std::atomic<long long> _accepted{0};
+    std::atomic<long long> _rejected{0};
+    std::atomic<long long> _expired{0};
+    std::atomic<long long> _completed{0};
+    ///< rnn states of stream_prediction, shared by the nets of the threads.
+    std::shared_ptr<RnnSessionStore> _sessions;
+    size_t _session_memory_limit{0};
+    ///< unfinished stream requests of each session in submission order, the head one is posted.
+    std::unordered_map<std::string, std::deque<std::shared_ptr<StreamRequest> > > _stream_ques GUARDED_BY(_stream_mut);
+    std::mutex _stream_mut;
+    ///< outputs of recent requests, disabled until set_result_cache.
+    ResultCache<typename target_host<Ttype>::type> _result_cache;
+    int _warmup_rounds{0};
+    std::vector<Tensor4d<typename target_host<Ttype>::type> > _warmup_ins;
+    ///< threads done with init, and whether a load failed.
+    int _ready_threads GUARDED_BY(_ready_mut) {0};
+    bool _init_failed GUARDED_BY(_ready_mut) {false};
+    ///< dtypes of the net inputs, set by the first thread loading the net.
+    std::vector<saber::DataType> _input_dtypes GUARDED_BY(_ready_mut);
+    std::mutex _ready_mut;
+    std::condition_variable _ready_cv;
+    ///< series of set_metrics, none is reported while requests is nullptr.
+    struct Metrics {
+        Counter* requests{nullptr};
+        Counter* overloaded{nullptr};
+        Counter* expired{nullptr};
+        Gauge* queue_depth{nullptr};
+        Summary* queue_wait{nullptr};
+        Summary* compute{nullptr};
+        Summary* latency{nullptr};
+        Histogram* batch_size{nullptr};
+        ///< end to end latency of each priority class.
+        std::vector<Summary*> class_latency;
+        ///< lookups of the result cache and the outputs it keeps.
+        Counter* cache_hits{nullptr};
+        Counter* cache_misses{nullptr};
+        Gauge* cache_bytes{nullptr};
+        MetricsRegistry* registry{nullptr};
+        std::string model;
+    } _metrics;
 #ifdef ENABLE_OP_TIMER
     std::unordered_map<std::thread::id, std::vector<float>> _thead_id_to_prediction_times_vec_in_ms;
     std::mutex _mut;
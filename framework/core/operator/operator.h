@@ -21,6 +21,7 @@
 #include "framework/core/operator/operator_attr.h"
 #include "framework/core/factory.h"
 #include "framework/core/parameter.h"
+#include "saber/saber_funcs_param.h"
 #include "framework/core/singleton.h"
 #include "framework/utils/parameter_fusion.h"
 #include "framework/graph/graph_global_mem.h"
@@ -100,6 +101,19 @@ public:
         return Status::ANAKINFAIL();
     }
 
+    /** 
+     *  \brief Recurrent state the op carries across predictions of streaming sessions,
+     *  nullptr for ops without one (see Net::prediction(session_ids)).
+     */
+    virtual saber::RnnState<Ttype>* rnn_state() {
+        return nullptr;
+    }
+
+    /** 
+     *  \brief Read and write rnn_state in the next dispatches instead of starting from zeros.
+     */
+    virtual void enable_rnn_state(bool enable) {}
+
     /** 
      *  \brief Bind parameter pack from graph.
      */
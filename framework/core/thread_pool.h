@@ -20,6 +20,9 @@
 #include <vector>
 #include <thread>
 #include <queue>
+#include <deque>
+#include <memory>
+#include <atomic>
 #include <functional>
 #include <future>
 #include <mutex> 
@@ -30,9 +33,19 @@
 
 namespace anakin {
 
+/** 
+ *  \brief Task scheduling policy of ThreadPool.
+ */
+enum class SchedulePolicy : int {
+    FIFO,           ///< all threads share one task queue guarded by one mutex.
+    WORK_STEALING   ///< every thread owns a deque of the tasks it spawns (run LIFO) and a queue of tasks submitted
+                    ///< from outside (run FIFO), idle threads steal the oldest tasks of the others.
+};
+
 class ThreadPool {
 public:
-    ThreadPool(int num_thread):_num_thread(num_thread) {}
+    ThreadPool(int num_thread, SchedulePolicy policy = SchedulePolicy::FIFO)
+        :_num_thread(num_thread), _policy(policy) {}
     virtual ~ThreadPool();
 
     void launch();
@@ -49,9 +62,14 @@ public:
     template<typename functor, typename ...ParamTypes>
     typename std::future<typename function_traits<functor>::return_type> RunAsync(functor function, ParamTypes ...args);
     
-    /// Stop the pool.
+    /// Stop the pool in either policy, tasks still queued are dropped, tasks a thread has taken finish.
+    /// It returns when the threads have exited.
     void stop();
 
+    int num_thread() const { return _num_thread; }
+
+    SchedulePolicy policy() const { return _policy; }
+
 private:
     /// The initial function should be overrided by user who derive the ThreadPool class.
     virtual void init();
@@ -59,13 +77,39 @@ private:
     /// Auxiliary function should be overrided when you want to do other things in the derived class.
     virtual void auxiliary_funcs();
 
+    /// Push task to the queue of current policy.
+    void push_task(std::function<void(void)> task);
+
+    /// Pop task for thread(id) in work stealing mode: the newest task it spawned, else the oldest one submitted to it,
+    /// else steal the oldest task of the others.
+    bool pop_task(int id, std::function<void(void)>& task);
+
+    /// Index of the calling thread in this pool, -1 if the caller isn't one of its workers.
+    int& local_worker_id();
+    ThreadPool*& local_pool();
+
 private:
+    /// tasks owned by a thread in work stealing mode.
+    struct TaskDeque {
+        std::mutex mut;
+        std::deque<std::function<void(void)> > tasks GUARDED_BY(mut);      ///< spawned by the owner.
+        std::deque<std::function<void(void)> > submitted GUARDED_BY(mut);  ///< pushed from outside the pool.
+    };
+
     int _num_thread;
+    SchedulePolicy _policy;
     std::vector<std::thread> _workers;
     std::queue<std::function<void(void)> > _tasks GUARDED_BY(_mut);
+    std::vector<std::unique_ptr<TaskDeque> > _deques;
+    ///< tasks pushed but not popped yet in work stealing mode, counted before a task is published.
+    std::atomic<int> _pending{0};
+    ///< threads waiting on _cv in work stealing mode.
+    std::atomic<int> _sleepers{0};
+    ///< round robin index for tasks pushed from outside the pool.
+    std::atomic<unsigned int> _next{0};
     std::mutex _mut;
     std::condition_variable _cv;
-    bool _stop{false};
+    std::atomic<bool> _stop{false};
 };
 
 } /* namespace anakin */
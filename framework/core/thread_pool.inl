@@ -2,6 +2,44 @@
 namespace anakin {
 
 inline void ThreadPool::launch() {
+    if (_policy == SchedulePolicy::WORK_STEALING) {
+        for (size_t i = 0; i < _num_thread; ++i) {
+            _deques.emplace_back(new TaskDeque);
+        }
+        for (size_t i = 0; i < _num_thread; ++i) {
+            _workers.emplace_back(
+                [i, this]() {
+                    this->local_pool() = this;
+                    this->local_worker_id() = i;
+                    // initial
+                    this->init();
+                    for (;;) {
+                        std::function<void(void)> task;
+                        if (this->_stop) {
+                            return ;
+                        }
+                        if (!this->pop_task(i, task)) {
+                            std::unique_lock<std::mutex> lock(this->_mut);
+                            this->_sleepers++;
+                            while (!this->_stop && this->_pending.load() == 0) {
+                                this->_cv.wait(lock);
+                            }
+                            this->_sleepers--;
+                            if (this->_stop) {
+                                return ;
+                            }
+                            continue;
+                        }
+                        // a task taken before stop still runs, its future is waited by someone
+                        DLOG(INFO) << " Thread (" << i <<") processing";
+                        auxiliary_funcs();
+                        task();
+                    }
+                }
+            );
+        }
+        return;
+    }
     for(size_t i = 0; i<_num_thread; ++i) {
         _workers.emplace_back(
             [i ,this]() {
@@ -29,9 +67,80 @@ inline void ThreadPool::launch() {
     }
 }
 
+inline int& ThreadPool::local_worker_id() {
+    static thread_local int id = -1;
+    return id;
+}
+
+inline ThreadPool*& ThreadPool::local_pool() {
+    static thread_local ThreadPool* pool = nullptr;
+    return pool;
+}
+
+inline void ThreadPool::push_task(std::function<void(void)> task) {
+    if (_policy == SchedulePolicy::FIFO || _deques.empty()) {
+        {
+            std::unique_lock<std::mutex> lock(this->_mut);
+            this->_tasks.emplace(std::move(task));
+        }
+        this->_cv.notify_one();
+        return;
+    }
+    // workers push to their own deque, outside callers spread tasks round robin on the submitted queues.
+    bool spawned = local_pool() == this;
+    int id = spawned ? local_worker_id() : (_next++ % _num_thread);
+    // count it before it can be popped, so _pending never goes below zero
+    _pending++;
+    {
+        std::lock_guard<std::mutex> guard(_deques[id]->mut);
+        if (spawned) {
+            _deques[id]->tasks.emplace_back(std::move(task));
+        } else {
+            _deques[id]->submitted.emplace_back(std::move(task));
+        }
+    }
+    // only touch the global mutex when some thread may sleep, see the wait loop in launch.
+    if (_sleepers.load() > 0) {
+        std::lock_guard<std::mutex> guard(this->_mut);
+        this->_cv.notify_one();
+    }
+}
+
+inline bool ThreadPool::pop_task(int id, std::function<void(void)>& task) {
+    for (int k = 0; k < _num_thread; ++k) {
+        auto& deque = *_deques[(id + k) % _num_thread];
+        std::lock_guard<std::mutex> guard(deque.mut);
+        // the owner takes the newest task it spawned (still in cache), submitted tasks run in arrival order,
+        // thieves take the oldest ones
+        if (k == 0 && !deque.tasks.empty()) {
+            task = std::move(deque.tasks.back());
+            deque.tasks.pop_back();
+        } else if (!deque.submitted.empty()) {
+            task = std::move(deque.submitted.front());
+            deque.submitted.pop_front();
+        } else if (!deque.tasks.empty()) {
+            task = std::move(deque.tasks.front());
+            deque.tasks.pop_front();
+        } else {
+            continue;
+        }
+        _pending--;
+        return true;
+    }
+    return false;
+}
+
 inline void ThreadPool::stop() {
-    std::unique_lock<std::mutex> lock(this->_mut);
-    _stop = true;
+    {
+        std::unique_lock<std::mutex> lock(this->_mut);
+        _stop = true;
+    }
+    this->_cv.notify_all();
+    for (auto& worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
 }
 
 inline void ThreadPool::init() {}
@@ -40,10 +149,6 @@ inline void ThreadPool::auxiliary_funcs() {}
 
 inline ThreadPool::~ThreadPool() {
     stop();
-    this->_cv.notify_all();
-    for(auto & worker: _workers){ 
-        worker.join(); 
-    }
 }
 
 template<typename functor, typename ...ParamTypes>
@@ -53,11 +158,7 @@ inline typename function_traits<functor>::return_type ThreadPool::RunSync(functo
             std::bind(function, std::forward<ParamTypes>(args)...)
     );
     std::future<typename function_traits<functor>::return_type> result = task->get_future(); 
-    { 
-        std::unique_lock<std::mutex> lock(this->_mut);
-        this->_tasks.emplace( [&]() { (*task)(); } );
-    }
-    this->_cv.notify_one();
+    push_task( [&]() { (*task)(); } );
     return result.get();
 }
 
@@ -68,11 +169,7 @@ inline std::future<typename function_traits<functor>::return_type> ThreadPool::R
             std::bind(function, std::forward<ParamTypes>(args)...)
     );
     std::future<typename function_traits<functor>::return_type> result = task->get_future(); 
-    { 
-        std::unique_lock<std::mutex> lock(this->_mut);
-        this->_tasks.emplace( [=]() { (*task)(); } );
-    }
-    this->_cv.notify_one();
+    push_task( [=]() { (*task)(); } );
     return result;
 }
 
@@ -1,4 +1,5 @@
 #include "framework/graph/graph.h"
+#include <set>
 #include "framework/model_parser/parser/parser.h"
 #include "framework/graph/llvm/scheduler.h"
 #include "framework/graph/llvm/optimizer/conv_elewise_fusion_scheduler.h"
@@ -7,6 +8,11 @@
 #include "framework/graph/llvm/fusion/graph_pattern.h"
 #include "framework/core/operator/operator.h"
 #include "framework/graph/llvm/optimizer/optimize_strategy.h"
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/bf16_gemm.h"
+#include "saber/funcs/impl/x86/fp16_gemm.h"
+#include "saber/funcs/impl/x86/embedding_quant.h"
+#endif
 
 namespace anakin {
 
@@ -18,6 +24,8 @@ Status Graph<Ttype, Ptype>::load(std::string model_path) EXCLUSIVE_LOCKS_REQUIRE
     Status ret = Status::OK();
     if (model_path != _model_path) {
         this->Clean();
+        // the weights blocks are freed with the graph
+        typename GraphGlobalMemBase<Ttype>::Scope owner(this);
         ret = parser::load<Ttype>(this, model_path);
         _model_path = model_path;
     }
@@ -27,6 +35,7 @@ Status Graph<Ttype, Ptype>::load(std::string model_path) EXCLUSIVE_LOCKS_REQUIRE
 
 template<typename Ttype, Precision Ptype>
 Status Graph<Ttype, Ptype>::load(const char* model_path) {
+    typename GraphGlobalMemBase<Ttype>::Scope owner(this);
     return parser::load<Ttype>(this, model_path);
 }
 
@@ -35,6 +44,7 @@ Status Graph<Ttype, Ptype>::load(const char* buffer, size_t len) EXCLUSIVE_LOCKS
     std::unique_lock<std::mutex> lock(this->_mut);
     Status ret = Status::OK();
     this->Clean();
+    typename GraphGlobalMemBase<Ttype>::Scope owner(this);
     ret = parser::load<Ttype, Ptype>(this, buffer, len);
     return ret;
 }
@@ -139,6 +149,128 @@ Status Graph<Ttype, Ptype>::SetWeightsScale(const std::string& name, const std::
     return Status::ANAKINFAIL("[EEROR]: SetOpPrec is called on an unknown op name");
 }
 
+/// true if the kernels of op read weights stored in dtype.
+static bool weights_prec_supported(const std::string& op, DataType dtype) {
+    if (dtype == AK_FLOAT) {
+        return true;
+    }
+    if (dtype == AK_BFLOAT16) {
+        return op == "Dense" || op == "Convolution" || op == "Lstm";
+    }
+    if (dtype == AK_HALF) {
+        return op == "Dense" || op == "Embedding" || op == "EmbeddingSeqPool";
+    }
+    if (dtype == AK_INT8 || dtype == AK_INT4) {
+        return op == "Embedding" || op == "EmbeddingSeqPool";
+    }
+    return false;
+}
+
+/// row_len is the length of the rows which are quantized with a scale each, e.g. emb_dim of embedding tables.
+template<typename Ttype>
+static Status convert_weights(PBlock<Ttype>& weights, DataType dtype, int row_len) {
+    return Status::ANAKINFAIL("[ERROR]: weights precision is only supported on x86");
+}
+
+#ifdef USE_X86_PLACE
+template<>
+Status convert_weights<X86>(PBlock<X86>& weights, DataType dtype, int row_len) {
+    auto& tensor = weights.d_tensor();
+    if (tensor.get_dtype() == dtype) {
+        return Status::OK();
+    }
+    SaberStatus status = SaberSuccess;
+    if (tensor.get_dtype() == AK_INT8 || tensor.get_dtype() == AK_INT4) {
+        return Status::ANAKINFAIL("[ERROR]: quantized weights can't be converted again");
+    }
+    if (tensor.get_dtype() == AK_BFLOAT16 || tensor.get_dtype() == AK_HALF) {
+        // back to fp32 first, e.g. bf16 to fp16
+        status = saber::tensor_to_float(tensor);
+    }
+    if (status == SaberSuccess && tensor.get_dtype() == AK_FLOAT) {
+        if (dtype == AK_BFLOAT16) {
+            status = saber::tensor_to_bf16(tensor);
+        } else if (dtype == AK_HALF) {
+            status = saber::tensor_to_half(tensor);
+        } else if ((dtype == AK_INT8 || dtype == AK_INT4) && row_len > 0) {
+            status = saber::quantize_embedding_table(tensor, row_len, dtype);
+        }
+    }
+    if (status != SaberSuccess || tensor.get_dtype() != dtype) {
+        return Status::ANAKINFAIL("[ERROR]: can't convert weights to the requested precision");
+    }
+    return Status::OK();
+}
+#endif
+
+template<typename Ttype, Precision Ptype>
+Status Graph<Ttype, Ptype>::SetWeightsPrec(const std::string& name, DataType dtype) {
+    if (Ptype != Precision::FP32) {
+        return Status::ANAKINFAIL("[ERROR]: SetWeightsPrec is only supported by fp32 graphs");
+    }
+    if (!name.empty()) {
+        if (!this->has_vertex(name)) {
+            return Status::ANAKINFAIL("[ERROR]: SetWeightsPrec is called on an unknown op name");
+        }
+        if (!weights_prec_supported((*this)[name]->get_op_name(), dtype)) {
+            return Status::ANAKINFAIL("[ERROR]: SetWeightsPrec is called on an op which doesn't support the precision");
+        }
+    }
+    _weights_prec[name] = dtype;
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status Graph<Ttype, Ptype>::apply_weights_prec() {
+    if (_weights_prec.empty()) {
+        return Status::OK();
+    }
+    for (auto& it : _weights_prec) {
+        if (!it.first.empty() && !this->has_vertex(it.first)) {
+            LOG(WARNING) << "op " << it.first << " is fused, its weights keep their precision";
+        }
+    }
+    Status ret = Status::OK();
+    auto convert = [&, this](NodePtr& node_p) {
+        auto it = _weights_prec.find(node_p->name());
+        if (it == _weights_prec.end()) {
+            it = _weights_prec.find("");
+        }
+        if (it == _weights_prec.end() || !weights_prec_supported(node_p->get_op_name(), it->second)
+                || !node_p->inspect_attr("weight_1")) {
+            return Status::OK();
+        }
+        auto weights = node_p->template get_attr<PBlock<Ttype>>("weight_1");
+        int row_len = node_p->inspect_attr("emb_dim") ? node_p->template get_attr<int>("emb_dim") : 0;
+        DLOG(INFO) << "store weights of " << node_p->name() << " in " << it->second;
+        ret = convert_weights<Ttype>(weights, it->second, row_len);
+        return ret;
+    };
+    this->Scanner->BFS(convert);
+    return ret;
+}
+
+template<typename Ttype, Precision Ptype>
+bool Graph<Ttype, Ptype>::embedding_seq_pool_fusable() {
+    if (!std::is_same<Ttype, X86>::value || Ptype != Precision::FP32) {
+        return false;
+    }
+    bool fusable = true;
+    auto check = [&, this](NodePtr& node_p) {
+        if (node_p->get_op_name() == "Embedding" && node_p->inspect_attr("num_direct")) {
+            fusable = fusable && node_p->template get_attr<int>("num_direct") == 1;
+        }
+        if (node_p->get_op_name() == "SequencePool") {
+            static const std::set<std::string> pool_types = {"AVERAGE", "SUM", "SQRT", "LAST", "FIRST", "MAX"};
+            fusable = fusable && node_p->inspect_attr("pooltype")
+                      && pool_types.count(node_p->template get_attr<std::string>("pooltype")) > 0;
+        }
+        return Status::OK();
+    };
+    this->Scanner->BFS(check);
+    return fusable;
+}
+
 template<typename Ttype, Precision Ptype>
 Status Graph<Ttype, Ptype>::SetVarScale(const std::string& var, float scale) {
     std::unordered_map<std::string, std::vector<std::string> > in_to_op_map;
@@ -349,6 +481,7 @@ Status Graph<Ttype, Ptype>::RegistAllOut() {
 template<typename Ttype, Precision Ptype>
 Status Graph<Ttype, Ptype>::Optimize(bool with_fusion) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
     std::unique_lock<std::mutex> lock(this->_mut);
+    typename GraphGlobalMemBase<Ttype>::Scope owner(this);
 
     if (!_has_graph_optimized) {
         DLOG(WARNING) << "Get virtual graph of graph ... ";
@@ -388,6 +521,10 @@ Status Graph<Ttype, Ptype>::Optimize(bool with_fusion) EXCLUSIVE_LOCKS_REQUIRED(
                         (fusion_name == "ConvReluPool" || fusion_name == "ConvBatchnormScaleReluPool")) {
                         continue;
                     }
+                    if (fusion_name == "EmbeddingSeqPool" && !embedding_seq_pool_fusable()) {
+                        DLOG(INFO) << " EmbeddingSeqPool is not fused, the graph has lookups or pools it can't run";
+                        continue;
+                    }
                     DLOG(INFO) << " processing in-ordered fusion : " << fusion_name;
                     _vgraph->Match(FusionOpRegister::Global()[fusion_name]);
 
@@ -453,6 +590,10 @@ Status Graph<Ttype, Ptype>::Optimize(bool with_fusion) EXCLUSIVE_LOCKS_REQUIRED(
             restore_from_vgraph(_vgraph);
         }
 
+        auto ret = apply_weights_prec();
+        if (!ret) {
+            return ret;
+        }
         _has_graph_optimized = true;
     }
 
@@ -840,6 +981,8 @@ Status Graph<Ttype, Ptype>::CopyFrom(Graph<Ttype, Ptype>& graph) {
     // get graph inputs and outputs
     _ins = graph._ins;
     _outs = graph._outs;
+    _registed_outs = graph._registed_outs;
+    _weights_prec = graph._weights_prec;
     // get statistic
     statistics = graph.statistics;
     return Status::OK();
@@ -852,8 +995,8 @@ Status Graph<Ttype, Ptype>::Clean() {
     // delete _vgraph pointer
     delete _vgraph;
     _vgraph = nullptr;
-    // clenn all weights
-    graph::GraphGlobalMem<Ttype>::Global().clean_all();
+    // clean the weights of this graph, other graphs keep theirs
+    graph::GraphGlobalMem<Ttype>::Global().release(this);
 
     return Status::OK();
 }
@@ -55,6 +55,8 @@ public:
             delete _vgraph;
             _vgraph = nullptr;
         }
+        // weights blocks created for this graph, ops keep the memory they use
+        GraphGlobalMem<Ttype>::Global().release(this);
     }
 
     /// get graph name
@@ -67,6 +69,8 @@ public:
     /// graph io node name
     std::vector<std::string>& get_ins() { return _ins; }
     std::vector<std::string>& get_outs() { return _outs; }
+    /// registered outs (bottom, top) exported by RegistOut
+    std::vector<std::pair<std::string, std::string> >& get_registed_outs() { return _registed_outs; }
 
     /// Judge if graph is directed graph, must be override.
     virtual bool directed() final { return true; }
@@ -119,6 +123,18 @@ public:
      */
     Status SetWeightsScale(const std::string& name, const std::vector<float>& scales, bool is_bias);
     
+    /**
+     * \brief store operation's weights in dtype, they are converted at the end of Optimize
+     *
+     *  note: name "" stands for all the ops which support dtype weights.
+     *        AK_BFLOAT16 is supported by Dense, Convolution and Lstm on x86, the kernels accumulate in fp32.
+     *        AK_HALF is supported by Dense and Embedding on x86, the kernels expand it to fp32 (f16c).
+     *        AK_INT8 and AK_INT4 are supported by Embedding on x86: the table is quantized with a scale
+     *        per row and its rows are expanded to fp32 by the lookup, e.g. the fused EmbeddingSeqPool.
+     *        Fused ops keep their weights.
+     */
+    Status SetWeightsPrec(const std::string& name, DataType dtype);
+
     /**
      * \brief set operation's variable scale factor manually
      */
@@ -185,10 +201,18 @@ public:
 
 private:
     /**
-     * \brief clean all the resources(include the graph parameter and weights) used by this graph
+     * \brief clean all the resources(include the graph parameter and weights) used by this graph,
+     *  the weights blocks of other graphs are kept
      */
     Status Clean();
 
+    /// convert the weights requested by SetWeightsPrec.
+    Status apply_weights_prec();
+
+    /// true if the Embedding -> SequencePool pairs of the graph may be fused: the fused op
+    /// runs x86 fp32 lookups of one direction followed by a known pool type only.
+    bool embedding_seq_pool_fusable();
+
 private:
     ///< _vgraph stand for graph. default nullptr
     VGraph* _vgraph{nullptr};
@@ -210,6 +234,8 @@ private:
 
     ///< _registed_outs:outs that needs to be exported
     std::vector<std::pair<std::string, std::string>> _registed_outs;
+    ///< _weights_prec: op name ("" for all ops) map to the dtype its weights are stored in
+    std::unordered_map<std::string, DataType> _weights_prec;
     //
     
 
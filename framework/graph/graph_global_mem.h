@@ -90,6 +90,23 @@ public:
 
     ~GraphGlobalMemBase() {}
 
+    /**
+     *  \brief Blocks created on this thread while a Scope is alive belong to its owner
+     *   (the graph they are loaded or fused for) and are deleted by release(owner).
+     *   Blocks created outside of any scope live until clean_all.
+     */
+    class Scope {
+    public:
+        explicit Scope(const void* owner) : _prev(current_owner()) {
+            current_owner() = owner;
+        }
+        ~Scope() {
+            current_owner() = _prev;
+        }
+    private:
+        const void* _prev{nullptr};
+    };
+
     /// create Block memory
     template<DataType Dtype>
     PBlock<Ttype> *new_block(saber::Shape &shape) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
@@ -101,6 +118,21 @@ public:
         return block_p;
     }
 
+    /// create Block whose host memory is external (e.g. a mapped model file), holder keeps it alive
+    /// as long as a tensor uses it
+    template<DataType Dtype>
+    PBlock<Ttype> *new_block(void* host_data, saber::Shape &shape, std::shared_ptr<void> holder) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
+        std::unique_lock<std::mutex> lock(this->_mut);
+        PBlock<Ttype> *block_p = new PBlock<Ttype>(Dtype);
+        block_p->h_tensor().attach(host_data, shape, Dtype, holder);
+        if ((void*)&block_p->h_tensor() != (void*)&block_p->d_tensor()) {
+            block_p->d_tensor().re_alloc(shape, Dtype);
+        }
+        _res_guard[block_p->d_tensor().data()].reset(new LevelList());
+        _push_mem_pool(block_p, DataTypeWarpper<Dtype>());
+        return block_p;
+    }
+
     /// register external block
     void register_block(PBlock<Ttype> * block_p) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
         std::unique_lock<std::mutex> lock(this->_mut);
@@ -253,6 +285,18 @@ public:
             delete block_p;
         }
         _fp32_mem_pool.clear();
+        _owners.clear();
+    }
+
+    /// delete the blocks of owner, tensors still using their memory keep it alive.
+    void release(const void* owner) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
+        if (owner == nullptr) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(this->_mut);
+        _release_from(_int8_mem_pool, owner);
+        _release_from(_fp16_mem_pool, owner);
+        _release_from(_fp32_mem_pool, owner);
     }
 
     /// get pool size
@@ -260,19 +304,52 @@ public:
     size_t get_pool_size() { return _get_pool_size(DataTypeWarpper<Dtype>()); }
 
 private:
+    /// owner of the blocks created by the calling thread, nullptr if it has none.
+    static const void*& current_owner() {
+        static thread_local const void* owner = nullptr;
+        return owner;
+    }
+
+    void _own(PBlock<Ttype> *block_p) {
+        if (current_owner() != nullptr) {
+            _owners[block_p] = current_owner();
+        }
+    }
+
+    void _release_from(std::vector<PBlock<Ttype> *>& pool, const void* owner) {
+        auto kept = pool.begin();
+        for (auto block_p : pool) {
+            auto it = _owners.find(block_p);
+            if (it == _owners.end() || it->second != owner) {
+                *kept++ = block_p;
+                continue;
+            }
+            _owners.erase(it);
+            void* key = block_p->d_tensor().data();
+            if (key != nullptr) {
+                _res_guard.erase(key);
+            }
+            delete block_p;
+        }
+        pool.erase(kept, pool.end());
+    }
+
     /// push int8_mem operaiton
     void _push_mem_pool(PBlock<Ttype> *block_p, DataTypeWarpper<AK_INT8>) {
         _int8_mem_pool.push_back(block_p);
+        _own(block_p);
     }
 
     /// push fp16_mem operaiton
     void _push_mem_pool(PBlock<Ttype> *block_p, DataTypeWarpper<AK_HALF>) {
         _fp16_mem_pool.push_back(block_p);
+        _own(block_p);
     }
 
     /// push fp32_mem operaiton
     void _push_mem_pool(PBlock<Ttype> *block_p, DataTypeWarpper<AK_FLOAT>) {
         _fp32_mem_pool.push_back(block_p);
+        _own(block_p);
     }
 
     /// get int8_mem pool size
@@ -298,6 +375,8 @@ private:
     std::vector<PBlock<Ttype> *> _fp16_mem_pool GUARDED_BY(_mut);
     ///< _fp32_mem_pool stand for fp32 type memory
     std::vector<PBlock<Ttype> *> _fp32_mem_pool GUARDED_BY(_mut);
+    ///< _owners stand for the owner of the blocks created in a Scope
+    std::unordered_map<PBlock<Ttype> *, const void *> _owners GUARDED_BY(_mut);
     ///< _mut
     std::mutex _mut;
 };
@@ -162,6 +162,13 @@ REGISTER_GRAPH_FUSION_PATTERN(SeqConcatSeqPoolSoftSign)
 .AddConnect("seq_pool_0", "soft_sign_0")
 .CreatePattern([](VGraph* graph) {});
 
+REGISTER_GRAPH_FUSION_PATTERN(EmbeddingSeqPool)
+.Type(IN_ORDER)
+.AddOpNode("embedding_0",  "Embedding")
+.AddOpNode("seq_pool_0", "SequencePool")
+.AddConnect("embedding_0", "seq_pool_0")
+.CreatePattern([](VGraph* graph) {});
+
 REGISTER_GRAPH_FUSION_PATTERN(ConvFusion)
 .Type(IN_PARELLEL)
 .AddOpNode("conv_0",  "ConvBatchnormScaleRelu")
@@ -169,12 +169,22 @@ NodeIO<Ttype, Ptype>& NodeIO<Ttype, Ptype>::operator>>(const NodeProto& node_pro
                         saber_shape[i] = real_shape.dim().value()[i];
                     }
 
-                    auto* block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(saber_shape);
-                    // fill data to block
-                    float* cpu_data = static_cast<float*>(block->h_tensor().mutable_data());
+                    PBlock<Ttype>* block = nullptr;
+                    auto mapped = mapped_weights(node_p->name(), key);
+                    if (mapped.data != nullptr) {
+                        // point the block to the weights in the mapped model
+                        CHECK_EQ(mapped.bytes, saber_shape.count() * sizeof(float))
+                            << "mapped weights " << node_p->name() << "/" << key << " size mismatch";
+                        block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(
+                                (void*)mapped.data, saber_shape, _mapped_model);
+                    } else {
+                        block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(saber_shape);
+                        // fill data to block
+                        float* cpu_data = static_cast<float*>(block->h_tensor().mutable_data());
 
-                    for (int i = 0; i < data.size(); i++) {
-                        cpu_data[i] = data.f()[i];
+                        for (int i = 0; i < data.size(); i++) {
+                            cpu_data[i] = data.f()[i];
+                        }
                     }
                     block->d_tensor().set_scale(scale_vector);
                     block->h_tensor().set_scale(scale_vector);
@@ -209,11 +219,21 @@ NodeIO<Ttype, Ptype>& NodeIO<Ttype, Ptype>::operator>>(const NodeProto& node_pro
                         saber_shape[i] = real_shape.dim().value()[i];
                     }
 
-                    auto* block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_INT8>(saber_shape);
-                    // fill data to block
-                    char* cpu_data = static_cast<char*>(block->h_tensor().mutable_data());
-                    for (int i = 0; i < data.size(); i++) {
-                        cpu_data[i] = data.c().data()[i];
+                    PBlock<Ttype>* block = nullptr;
+                    auto mapped = mapped_weights(node_p->name(), key);
+                    if (mapped.data != nullptr) {
+                        // point the block to the weights in the mapped model
+                        CHECK_EQ(mapped.bytes, saber_shape.count())
+                            << "mapped weights " << node_p->name() << "/" << key << " size mismatch";
+                        block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_INT8>(
+                                (void*)mapped.data, saber_shape, _mapped_model);
+                    } else {
+                        block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_INT8>(saber_shape);
+                        // fill data to block
+                        char* cpu_data = static_cast<char*>(block->h_tensor().mutable_data());
+                        for (int i = 0; i < data.size(); i++) {
+                            cpu_data[i] = data.c().data()[i];
+                        }
                     }
                     block->d_tensor().set_scale(scale_vector);
                     block->h_tensor().set_scale(scale_vector);
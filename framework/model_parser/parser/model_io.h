@@ -22,6 +22,7 @@
 #include "framework/graph/node.h"
 #include "framework/graph/algorithm.h"
 #include "framework/model_parser/parser/parser.h"
+#include "framework/model_parser/parser/model_mmap.h"
 #ifdef USE_NANOPB
 #include "graph.pb.hpp"
 #include "node.pb.hpp"
@@ -61,10 +62,22 @@ public:
     // get que node name in order
     std::vector<std::string>& get_node_name_in_order() { return _que_node_name_in_order; }
 
+    // read weights from the packed model instead of the node proto
+    void set_mapped_model(std::shared_ptr<MappedModel> model) { _mapped_model = model; }
+
+private:
+    MappedModel::Weights mapped_weights(const std::string& node, const std::string& attr) {
+        if (_mapped_model == nullptr) {
+            return MappedModel::Weights();
+        }
+        return _mapped_model->find(node, attr);
+    }
+
 private:
     std::queue<graph::NodePtr> _que;
     std::vector<std::string> _que_node_name_in_order;
     std::unordered_map<std::string, graph::NodePtr> _node_name2ptr_map;
+    std::shared_ptr<MappedModel> _mapped_model;
 };
 
 } /* parser */
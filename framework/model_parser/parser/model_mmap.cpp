@@ -0,0 +1,131 @@
+#include "framework/model_parser/parser/model_mmap.h"
+#include "utils/logger/logger.h"
+#include <cstring>
+#ifndef USE_SGX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace anakin {
+
+namespace parser {
+
+MappedModel::~MappedModel() {
+#ifndef USE_SGX
+    if (_addr != nullptr) {
+        munmap(_addr, _size);
+    }
+#endif
+}
+
+bool MappedModel::is_packed(const char* model_path) {
+    PackedModelHeader header;
+    FILE* f = fopen(model_path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    bool packed = fread(&header, sizeof(header), 1, f) == 1
+                  && memcmp(header.magic, PackedModelMagic, sizeof(header.magic)) == 0;
+    fclose(f);
+    return packed;
+}
+
+std::shared_ptr<MappedModel> MappedModel::open(const char* model_path) {
+#ifdef USE_SGX
+    LOG(ERROR) << "model mapping is not supported in sgx";
+    return nullptr;
+#else
+    int fd = ::open(model_path, O_RDONLY);
+    if (fd == -1) {
+        LOG(ERROR) << " Can't open " << model_path;
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        LOG(ERROR) << " Can't stat " << model_path;
+        close(fd);
+        return nullptr;
+    }
+    // private and writable: fused weights are copied on write, the file stays as is.
+    void* addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOG(ERROR) << " Can't map " << model_path;
+        return nullptr;
+    }
+    std::shared_ptr<MappedModel> model(new MappedModel());
+    model->_addr = addr;
+    model->_size = st.st_size;
+    const char* base = static_cast<const char*>(addr);
+    model->_proto = base;
+    model->_proto_bytes = model->_size;
+
+    PackedModelHeader header;
+    if (model->_size < sizeof(header)) {
+        return model;
+    }
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, PackedModelMagic, sizeof(header.magic)) != 0) {
+        return model;
+    }
+    // every offset and size comes from the file, a corrupt one must not read beyond the mapping.
+    size_t size = model->_size;
+    auto within = [size](uint64_t offset, uint64_t bytes) {
+        return offset <= size && bytes <= size - offset;
+    };
+    if (!within(header.proto_offset, header.proto_bytes)
+            || !within(header.weights_offset, header.weights_bytes)
+            || !within(header.index_offset, 0)) {
+        LOG(ERROR) << model_path << " is truncated or corrupt: sections beyond " << size << " bytes";
+        return nullptr;
+    }
+    model->_packed = true;
+    model->_proto = base + header.proto_offset;
+    model->_proto_bytes = header.proto_bytes;
+    model->_weights_bytes = header.weights_bytes;
+    uint64_t pos = header.index_offset;
+    for (uint64_t i = 0; i < header.index_count; i++) {
+        uint32_t name_len = 0;
+        if (!within(pos, sizeof(name_len))) {
+            LOG(ERROR) << model_path << " is truncated or corrupt: index entry " << i << " beyond the file";
+            return nullptr;
+        }
+        memcpy(&name_len, base + pos, sizeof(name_len));
+        pos += sizeof(name_len);
+        PackedWeightsEntry entry;
+        if (!within(pos, name_len) || !within(pos + name_len, sizeof(entry))) {
+            LOG(ERROR) << model_path << " is truncated or corrupt: index entry " << i << " beyond the file";
+            return nullptr;
+        }
+        std::string name(base + pos, name_len);
+        pos += name_len;
+        memcpy(&entry, base + pos, sizeof(entry));
+        pos += sizeof(entry);
+        if (!within(entry.offset, entry.bytes)) {
+            LOG(ERROR) << model_path << " is truncated or corrupt: weights " << name << " beyond the file";
+            return nullptr;
+        }
+        Weights weights;
+        weights.data = base + entry.offset;
+        weights.bytes = entry.bytes;
+        model->_weights[name] = weights;
+    }
+    // weights are read soon after, start reading them ahead.
+    madvise(addr, model->_size, MADV_WILLNEED);
+    return model;
+#endif
+}
+
+MappedModel::Weights MappedModel::find(const std::string& node, const std::string& attr) const {
+    auto it = _weights.find(packed_weights_name(node, attr));
+    if (it == _weights.end()) {
+        return Weights();
+    }
+    return it->second;
+}
+
+} /* parser */
+
+} /* anakin */
@@ -0,0 +1,124 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_MODEL_MMAP_H
+#define ANAKIN_MODEL_MMAP_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "framework/core/base.h"
+
+namespace anakin {
+
+namespace parser {
+
+/// first bytes of a packed model file.
+const char PackedModelMagic[8] = {'A', 'K', 'M', 'M', 'A', 'P', '0', '1'};
+
+/// every packed weights starts at a multiple of PackedWeightsAlign bytes.
+const size_t PackedWeightsAlign = 64;
+
+/**
+ *  \brief Header of a packed model file, offsets are from the beginning of the file.
+ */
+struct PackedModelHeader {
+    char magic[8];
+    uint64_t index_offset;
+    uint64_t index_count;     ///< index entries: uint32 name length, name, PackedWeightsEntry
+    uint64_t proto_offset;
+    uint64_t proto_bytes;
+    uint64_t weights_offset;
+    uint64_t weights_bytes;
+};
+
+struct PackedWeightsEntry {
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+/// name of the weights of attr of node in a packed model.
+inline std::string packed_weights_name(const std::string& node, const std::string& attr) {
+    return node + "/" + attr;
+}
+
+/**
+ *  \brief Mapped anakin model file.
+ *
+ *   A packed model file is laid out for mapping:
+ *     header | weight index | graph proto without weight payloads | weights
+ *   every weight starts at a 64 bytes boundary, so weight tensors point straight
+ *   into the mapping instead of being decoded and copied to the heap. Processes
+ *   serving the same packed model share its page cache.
+ *   The mapping is private: the pages weights fusion writes are copied on write,
+ *   the file is never modified.
+ */
+class MappedModel {
+public:
+    /// weights of one node attribute in the mapping.
+    struct Weights {
+        const char* data{nullptr};
+        size_t bytes{0};
+    };
+
+    ~MappedModel();
+
+    /**
+     *  \brief Map the model file, return nullptr when it can't be mapped or the packed layout is
+     *   malformed (an offset or size beyond the file).
+     *   Both packed and plain (protobuf only) model files can be mapped. Weights tensors attached
+     *   to the mapping hold the returned pointer, it's unmapped with the last of them.
+     */
+    static std::shared_ptr<MappedModel> open(const char* model_path);
+
+    /// return true if the file at model_path is a packed model.
+    static bool is_packed(const char* model_path);
+
+    bool packed() const { return _packed; }
+
+    /// the graph proto, the whole file for a plain model.
+    const char* proto() const { return _proto; }
+    size_t proto_bytes() const { return _proto_bytes; }
+
+    /// weights of attr of node, data is nullptr if the packed model has none.
+    Weights find(const std::string& node, const std::string& attr) const;
+
+    /// bytes of all the weights in the mapping.
+    size_t weights_bytes() const { return _weights_bytes; }
+
+private:
+    MappedModel() {}
+
+    void* _addr{nullptr};
+    size_t _size{0};
+    bool _packed{false};
+    const char* _proto{nullptr};
+    size_t _proto_bytes{0};
+    size_t _weights_bytes{0};
+    std::map<std::string, Weights> _weights;
+};
+
+/**
+ *  \brief Pack the model at model_path into a model file laid out for mapping.
+ *   Graph::load accepts both formats, it maps the packed one.
+ */
+Status save_mmap(const char* model_path, const char* packed_path);
+
+} /* parser */
+
+} /* anakin */
+
+#endif
@@ -1,5 +1,6 @@
 #include "framework/model_parser/parser/parser.h"
 #include "framework/model_parser/parser/model_io.h"
+#include <cstring>
 #ifdef USE_NANOPB
 #include "graph.pb.hpp"
 #include "node.pb.hpp"
@@ -129,7 +130,8 @@ bool InspectAnakin(const char* buffer, size_t len) {
 }
 
 template<typename Ttype, Precision Ptype>
-Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphProto& graph_proto) {
+Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphProto& graph_proto,
+                                       std::shared_ptr<MappedModel> mapped_model = nullptr) {
     // fill the graph with name
     LOG(INFO) << "graph name: " << graph_proto.name();
     graph->set_name(graph_proto.name());
@@ -149,6 +151,7 @@ Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphP
 
     // fill the graph with nodes
     NodeIO<Ttype, Ptype> node_io;
+    node_io.set_mapped_model(mapped_model);
 
     for (int i = 0; i < graph_proto.nodes().size(); i++) {
         node_io >> graph_proto.nodes()[i];
@@ -236,8 +239,30 @@ Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphP
     return Status::OK();
 }
 
+template<typename Ttype, Precision Ptype>
+Status load_mmap(graph::Graph<Ttype, Ptype>* graph, const char* model_path) {
+    auto model = MappedModel::open(model_path);
+    if (model == nullptr) {
+        return Status::ANAKINFAIL("Mapping model file ERROR");
+    }
+    GraphProto graph_proto;
+    Status ret = parse_graph_proto(graph_proto, model->proto(), model->proto_bytes());
+    if (!ret) {
+        return ret;
+    }
+    // weight blocks point into the mapping, their buffers keep it alive.
+    ret = generate_graph_with_graph_proto(graph, graph_proto, model);
+    LOG(INFO) << "mapped model " << model_path << ", weights: " << model->weights_bytes() / 1e6 << " MB";
+    return ret;
+}
+
 template<typename Ttype, Precision Ptype>
 Status load(graph::Graph<Ttype, Ptype>* graph, const char* model_path) {
+#ifndef USE_SGX
+    if (MappedModel::is_packed(model_path)) {
+        return load_mmap(graph, model_path);
+    }
+#endif
     GraphProto graph_proto;
     parse_graph_proto(graph_proto, model_path);
     return generate_graph_with_graph_proto(graph, graph_proto);
@@ -376,6 +401,115 @@ Status save(graph::Graph<Ttype, Ptype>* graph, const char* model_path) {
     return Status::OK();
 }
 
+Status save_mmap(const char* model_path, const char* packed_path) {
+    GraphProto graph_proto;
+    Status ret = parse_graph_proto(graph_proto, model_path);
+    if (!ret) {
+        return ret;
+    }
+    // move the weights out of the proto, they are laid out aligned behind it.
+    std::vector<std::pair<std::string, std::string> > weights;
+    for (int i = 0; i < graph_proto.nodes().size(); i++) {
+        auto* node_proto = graph_proto.mutable_nodes(i);
+        auto* attrs = node_proto->mutable_attr();
+        for (auto it = attrs->begin(); it != attrs->end(); ++it) {
+            auto& value = it->second;
+            if (value.type() != TENSOR || value.tensor().shared()) {
+                continue;
+            }
+            auto* data = value.mutable_tensor()->mutable_data();
+            std::string payload;
+            if (data->type() == FLOAT) {
+                payload.assign(reinterpret_cast<const char*>(data->f().data()), data->f().size() * sizeof(float));
+                data->clear_f();
+            } else if (data->type() == INT8) {
+                payload = data->c();
+                data->clear_c();
+            } else {
+                continue;
+            }
+            weights.emplace_back(packed_weights_name(node_proto->name(), it->first), payload);
+        }
+    }
+
+    std::string proto;
+#ifdef USE_NANOPB
+    auto callback = [](pb_ostream_t *stream, const pb_byte_t *buf, size_t count) {
+        static_cast<std::string *>(stream->state)->append(reinterpret_cast<const char *>(buf), count);
+        return true;
+    };
+    pb_ostream_t output {
+        .callback = callback,
+        .state = &proto,
+        .max_size = SIZE_MAX,
+        .bytes_written = 0,
+        .errmsg = "nanopb writing to string failed",
+    };
+    bool success = graph_proto.SerializeToOstream(&output);
+#else
+    bool success = graph_proto.SerializeToString(&proto);
+#endif
+    if (!success) {
+        LOG(ERROR) << " Serializing GraphProto " << model_path << " ERROR";
+        return Status::ANAKINFAIL("Serializing GraphProto ERROR");
+    }
+
+    auto align = [](uint64_t offset, uint64_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    };
+    PackedModelHeader header;
+    memcpy(header.magic, PackedModelMagic, sizeof(header.magic));
+    header.index_offset = sizeof(header);
+    header.index_count = weights.size();
+    uint64_t index_bytes = 0;
+    for (auto& pair : weights) {
+        index_bytes += sizeof(uint32_t) + pair.first.size() + sizeof(PackedWeightsEntry);
+    }
+    header.proto_offset = header.index_offset + index_bytes;
+    header.proto_bytes = proto.size();
+    // weights start on a page of their own.
+    header.weights_offset = align(header.proto_offset + header.proto_bytes, 4096);
+    std::vector<PackedWeightsEntry> entries(weights.size());
+    uint64_t end = header.weights_offset;
+    for (int i = 0; i < weights.size(); i++) {
+        entries[i].offset = align(end, PackedWeightsAlign);
+        entries[i].bytes = weights[i].second.size();
+        end = entries[i].offset + entries[i].bytes;
+    }
+    header.weights_bytes = end - header.weights_offset;
+
+    FILE* f = fopen(packed_path, "wb");
+    if (!f) {
+        LOG(ERROR) << packed_path << " : File not found. ";
+        return Status::ANAKINFAIL("File not found");
+    }
+    success = fwrite(&header, sizeof(header), 1, f) == 1;
+    for (int i = 0; i < weights.size(); i++) {
+        uint32_t name_len = weights[i].first.size();
+        success = success && fwrite(&name_len, sizeof(name_len), 1, f) == 1;
+        success = success && fwrite(weights[i].first.data(), 1, name_len, f) == name_len;
+        success = success && fwrite(&entries[i], sizeof(entries[i]), 1, f) == 1;
+    }
+    success = success && fwrite(proto.data(), 1, proto.size(), f) == proto.size();
+    uint64_t written = header.proto_offset + header.proto_bytes;
+    std::vector<char> padding(4096, 0);
+    for (int i = 0; i < weights.size(); i++) {
+        success = success && fwrite(padding.data(), 1, entries[i].offset - written, f) == entries[i].offset - written;
+        success = success && fwrite(weights[i].second.data(), 1, entries[i].bytes, f) == entries[i].bytes;
+        written = entries[i].offset + entries[i].bytes;
+    }
+    // buffered writes fail at flush or close when the disk is full.
+    success = success && fflush(f) == 0;
+    success = (fclose(f) == 0) && success;
+    if (!success) {
+        LOG(ERROR) << " Writing packed model " << packed_path << " ERROR";
+        return Status::ANAKINFAIL("Writing packed model ERROR");
+    }
+    LOG(INFO) << "packed " << model_path << " to " << packed_path << ": " << weights.size()
+              << " weights, " << header.weights_bytes / 1e6 << " MB";
+    return Status::OK();
+}
+
 #ifdef USE_CUDA
 template
 Status load<NV, Precision::FP32>(graph::Graph<NV, Precision::FP32>* graph, const char* model_path);
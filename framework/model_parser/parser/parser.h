@@ -19,6 +19,7 @@
 #include "framework/graph/graph.h"
 #include "framework/graph/node.h"
 #include "framework/graph/algorithm.h"
+#include "framework/model_parser/parser/model_mmap.h"
 #include <limits>
 
 #define ProtoReadBytesLimit std::numeric_limits<int>::max() 
@@ -0,0 +1,91 @@
+#include "framework/operators/fusion_ops/embedding_seq_pool.h"
+
+namespace anakin {
+
+namespace ops {
+
+#define INSTANCE_EMBEDDING_SEQ_POOL(Ttype, Ptype) \
+template<> \
+void EmbeddingSeqPool<Ttype, Ptype>::operator()(OpContext<Ttype>& ctx, \
+    const std::vector<Tensor4dPtr<Ttype> >& ins, \
+    std::vector<Tensor4dPtr<Ttype> >& outs) { \
+    auto* impl = \
+        static_cast<EmbeddingSeqPoolHelper<Ttype, Ptype>*>(this->_helper); \
+    auto& param = \
+        static_cast<EmbeddingSeqPoolHelper<Ttype, Ptype>*>(this->_helper)->_param_embedding_seq_pool; \
+    impl->_funcs_embedding_seq_pool(ins, outs, param, ctx); \
+}
+
+/// set helper
+template<typename Ttype, Precision Ptype>
+EmbeddingSeqPoolHelper<Ttype, Ptype>::~EmbeddingSeqPoolHelper() {
+}
+
+template<typename Ttype, Precision Ptype>
+Status EmbeddingSeqPoolHelper<Ttype, Ptype>::InitParam() {
+    DLOG(WARNING) << "Parsing EmbeddingSeqPool op parameter.";
+    auto word_num = GET_PARAMETER(int, word_num);
+    auto emb_dim = GET_PARAMETER(int, emb_dim);
+    auto padding_idx = GET_PARAMETER(int, padding_idx);
+    auto num_direct = 1;
+    if (CHECK_PARAMETER(num_direct)) {
+        num_direct = GET_PARAMETER(int, num_direct);
+    }
+    using pblock_type = PBlock<Ttype>;
+    auto weights = GET_PARAMETER(pblock_type, weight_1);
+    auto pooltype = GET_PARAMETER(std::string, seq_pool_0_pooltype);
+    std::unordered_map<std::string, SequencePoolType> type_map;
+    type_map.insert(std::make_pair("null", anakin::saber::Sequence_pool_unknow));
+    type_map.insert(std::make_pair("AVERAGE", anakin::saber::Sequence_pool_average));
+    type_map.insert(std::make_pair("SUM", anakin::saber::Sequence_pool_sum));
+    type_map.insert(std::make_pair("SQRT", anakin::saber::Sequence_pool_sqrt));
+    type_map.insert(std::make_pair("LAST", anakin::saber::Sequence_pool_last));
+    type_map.insert(std::make_pair("FIRST", anakin::saber::Sequence_pool_first));
+    type_map.insert(std::make_pair("MAX", anakin::saber::Sequence_pool_max));
+
+    saber::EmbeddingParam<Ttype> embedding_param(word_num, emb_dim, padding_idx, num_direct,
+            &(weights.d_tensor()));
+    saber::SequencePoolParam<Ttype> seq_pool_param(type_map[pooltype]);
+    saber::EmbeddingSeqPoolParam<Ttype> embedding_seq_pool_param(embedding_param, seq_pool_param);
+    _param_embedding_seq_pool = embedding_seq_pool_param;
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status EmbeddingSeqPoolHelper<Ttype, Ptype>::Init(OpContext<Ttype>& ctx,
+        const std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_embedding_seq_pool.init(ins, outs, _param_embedding_seq_pool, SPECIFY, SABER_IMPL, ctx));
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status EmbeddingSeqPoolHelper<Ttype, Ptype>::InferShape(const
+        std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_embedding_seq_pool.compute_output_shape(ins, outs, _param_embedding_seq_pool));
+    return Status::OK();
+}
+
+#ifdef USE_X86_PLACE
+INSTANCE_EMBEDDING_SEQ_POOL(X86, Precision::FP32);
+template class EmbeddingSeqPoolHelper<X86, Precision::FP32>;
+ANAKIN_REGISTER_OP_HELPER(EmbeddingSeqPool, EmbeddingSeqPoolHelper, X86, Precision::FP32);
+#endif
+
+//! register op
+ANAKIN_REGISTER_OP(EmbeddingSeqPool)
+.Doc("EmbeddingSeqPool fusion operator")
+#ifdef USE_X86_PLACE
+.__alias__<X86, Precision::FP32>("embedding_seq_pool")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("word_num", "word_num")
+.Args<int>("emb_dim", " emb_dim ")
+.Args<int>("padding_idx", " padding idx ")
+.Args<std::string>("pooltype", " sequence pool type");
+
+} /* namespace ops */
+
+} /* namespace anakin */
@@ -57,6 +57,8 @@ Status GruHelper<Ttype, Ptype>::InitParam() {
                               act_map[hidden_act], is_reverse);
 
     _param_gru = gru_param;
+    _rnn_state.hidden_size = bias.d_tensor().valid_size() / 3;
+    _rnn_state.with_cell = false;
 
     return Status::OK();
 }
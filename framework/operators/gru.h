@@ -87,11 +87,21 @@ public:
     Status InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
                       std::vector<Tensor4dPtr<Ttype> >& outs) override;
 
+    saber::RnnState<Ttype>* rnn_state() override {
+        return &_rnn_state;
+    }
+
+    void enable_rnn_state(bool enable) override {
+        _param_gru.state = enable ? &_rnn_state : nullptr;
+    }
+
 public:
     ///< _param_gru stand for Gru parameter
     saber::GruParam<Ttype> _param_gru;
     ///< _funcs_gru stand for Gru function
     saber::Gru<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_gru;
+    ///< state of streaming sessions, used while enable_rnn_state.
+    saber::RnnState<Ttype> _rnn_state;
 };
 
 } /* namespace ops */
@@ -60,6 +60,8 @@ Status LstmHelper<Ttype, Ptype>::InitParam() {
             use_peepholes, false, is_reverse, dropout_param,
             num_direction, num_layers);
     _param_lstm = lstm_param;
+    _rnn_state.hidden_size = bias.d_tensor().valid_size() / (use_peepholes ? 7 : 4);
+    _rnn_state.with_cell = true;
 
     return Status::OK();
 }
@@ -88,11 +88,21 @@ public:
     Status InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
                       std::vector<Tensor4dPtr<Ttype> >& outs) override;
 
+    saber::RnnState<Ttype>* rnn_state() override {
+        return &_rnn_state;
+    }
+
+    void enable_rnn_state(bool enable) override {
+        _param_lstm.state = enable ? &_rnn_state : nullptr;
+    }
+
 public:
     ///< _param_lstm stand for Lstm parameter
     saber::LstmParam<Ttype> _param_lstm;
     ///< _funcs_lstm stand for Lstm function
     saber::Lstm<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_lstm;
+    ///< state of streaming sessions, used while enable_rnn_state.
+    saber::RnnState<Ttype> _rnn_state;
 };
 
 } /* namespace ops */
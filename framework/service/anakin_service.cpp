@@ -1,9 +1,264 @@
 #include "framework/service/anakin_service.h"
+#include <condition_variable>
 
 namespace anakin {
 
 namespace rpc {
 
+namespace {
+
+/// \brief the served worker, reload waits until the last request holding its handle releases it.
+struct Retirement {
+    std::shared_ptr<void> worker;
+    std::mutex mut;
+    std::condition_variable cv;
+    bool released{false};
+};
+
+/// deleter of a worker handle, it runs on the thread dropping the last handle and only signals,
+/// the worker is destroyed with the retirement (its threads can't join themselves).
+struct ReleaseHandle {
+    std::shared_ptr<Retirement> retirement;
+
+    void operator()(void*) const {
+        std::lock_guard<std::mutex> guard(retirement->mut);
+        retirement->released = true;
+        retirement->cv.notify_all();
+    }
+};
+
+} // namespace
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::_evaluate(::google::protobuf::RpcController* controller_base,
+        const RPCRequest* request,
+        RPCResponse* response,
+        ::google::protobuf::Closure* done,
+        ServiceRunPatternToType<ServiceRunPattern::SYNC>) {
+    typedef typename target_host<Ttype>::type target_h;
+    // make sure that done will be invoked
+    brpc::ClosureGuard done_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller_base);
+    DLOG(INFO) << "Received request[log_id=" << cntl->log_id() << "] from " << cntl->remote_side()
+               << " model: " << request->model() << " id: " << request->request_id();
+    auto worker = find_worker(request->model());
+    if (worker == nullptr) {
+        cntl->SetFailed(brpc::EREQUEST, "model %s is not served", request->model().c_str());
+        return;
+    }
+    std::vector<Tensor4d<target_h> > inputs;
+    std::string error;
+    if (!extract_request(request, *worker, inputs, &error)) {
+        count_bad_request(request->model());
+        cntl->SetFailed(brpc::EREQUEST, "%s", error.c_str());
+        return;
+    }
+    // the rpc thread is released here, the worker thread responds.
+    // inputs view the request, it lives until done is run.
+    // the callback holds the worker, a reload retires it after its requests are answered.
+    bool accepted = worker->submit_prediction(inputs, [this, worker, request, response, done](
+                                                  std::vector<Tensor4d<target_h> >& outputs,
+                                                  const typename ServiceWorker::Timing& timing) {
+        brpc::ClosureGuard done_guard(done);
+        fill_response_data(request->request_id(), request->model(), request->raw_output(), response, outputs);
+        fill_response_exec_info(response, timing);
+    }, deadline_of(request), request->priority());
+    if (!accepted) {
+        response->set_model(request->model());
+        response->set_request_id(request->request_id());
+        response->mutable_info()->set_msg("OVERLOADED");
+        return;
+    }
+    done_guard.release();
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::_evaluate(::google::protobuf::RpcController* controller_base,
+        const RPCRequest* request,
+        RPCResponse* response,
+        ::google::protobuf::Closure* done,
+        ServiceRunPatternToType<ServiceRunPattern::ASYNC>) {
+    typedef typename target_host<Ttype>::type target_h;
+    // make sure that done will be invoked
+    brpc::ClosureGuard done_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller_base);
+    std::string model_name = request->model();
+    long long request_id = request->request_id();
+    bool raw_output = request->raw_output();
+    auto worker = find_worker(model_name);
+    if (worker == nullptr) {
+        cntl->SetFailed(brpc::EREQUEST, "model %s is not served", model_name.c_str());
+        return;
+    }
+    std::vector<Tensor4d<target_h> > views;
+    std::string error;
+    if (!extract_request(request, *worker, views, &error)) {
+        count_bad_request(model_name);
+        cntl->SetFailed(brpc::EREQUEST, "%s", error.c_str());
+        return;
+    }
+    std::string key = CompletionStore::key(model_name, request_id);
+    auto admission = _completions.submit(key);
+    if (admission == CompletionStore::DUPLICATE) {
+        count_bad_request(model_name);
+        cntl->SetFailed(brpc::EREQUEST, "request %lld of model %s is running or not fetched yet",
+                        request_id, model_name.c_str());
+        return;
+    }
+    if (admission == CompletionStore::FULL) {
+        // too many requests wait for a worker, shed this one as the worker queue limit does
+        response->set_model(model_name);
+        response->set_request_id(request_id);
+        response->mutable_info()->set_msg("OVERLOADED");
+        return;
+    }
+    // the request is gone when the prediction runs, the inputs are copied
+    std::vector<Tensor4d<target_h> > inputs(views.size());
+    for (int i = 0; i < views.size(); i++) {
+        inputs[i].re_alloc(views[i].valid_shape(), views[i].get_dtype());
+        inputs[i].copy_from(views[i]);
+        inputs[i].set_seq_offset(views[i].get_seq_offset());
+    }
+    bool accepted = worker->submit_prediction(inputs, [this, worker, key, model_name, request_id, raw_output](
+                                                  std::vector<Tensor4d<target_h> >& outputs,
+                                                  const typename ServiceWorker::Timing& timing) {
+        std::unique_ptr<RPCResponse> result(new RPCResponse);
+        fill_response_data(request_id, model_name, raw_output, result.get(), outputs);
+        fill_response_exec_info(result.get(), timing);
+        _completions.complete(key, std::move(result));
+    }, deadline_of(request), request->priority());
+    if (!accepted) {
+        _completions.cancel(key);
+    }
+    response->set_model(model_name);
+    response->set_request_id(request_id);
+    response->mutable_info()->set_msg(accepted ? "ACCEPTED" : "OVERLOADED");
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::fetch(::google::protobuf::RpcController* controller_base,
+        const FetchRequest* request,
+        RPCResponse* response,
+        ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    auto state = _completions.fetch(CompletionStore::key(request->model(), request->request_id()), response);
+    if (state == CompletionStore::DONE) {
+        return;
+    }
+    response->set_model(request->model());
+    response->set_request_id(request->request_id());
+    response->mutable_info()->set_msg(state == CompletionStore::PENDING ? "PENDING" : "NOT_FOUND");
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::load(::google::protobuf::RpcController* controller_base,
+        const LoadRequest* request,
+        LoadResponse* response,
+        ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller_base);
+    if (!request->model().empty() && find_worker(request->model()) == nullptr) {
+        cntl->SetFailed(brpc::EREQUEST, "model %s is not served", request->model().c_str());
+        return;
+    }
+    for (auto& it : _worker_map) {
+        if (!request->model().empty() && it.first != request->model()) {
+            continue;
+        }
+        auto stats = std::atomic_load(&it.second)->load_stats();
+        auto* model_load = response->add_models();
+        model_load->set_model(it.first);
+        model_load->set_queue_depth(stats.queue_depth);
+        model_load->set_max_queue(stats.max_queue);
+        model_load->set_accepted(stats.accepted);
+        model_load->set_rejected(stats.rejected);
+        model_load->set_expired(stats.expired);
+        model_load->set_completed(stats.completed);
+    }
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+typename AnakinService<Ttype, Ptype, RunP>::ServiceWorker::Deadline 
+AnakinService<Ttype, Ptype, RunP>::deadline_of(const RPCRequest* request) {
+    long long timeout_ms = request->timeout_ms();
+    if (timeout_ms <= 0) {
+        auto it = _timeouts_ms.find(request->model());
+        timeout_ms = it == _timeouts_ms.end() ? 0 : it->second;
+    }
+    if (timeout_ms <= 0) {
+        return ServiceWorker::Deadline::max();
+    }
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+std::shared_ptr<typename AnakinService<Ttype, Ptype, RunP>::ServiceWorker> 
+AnakinService<Ttype, Ptype, RunP>::find_worker(const std::string& model_name) {
+    auto it = _worker_map.find(model_name);
+    if (it == _worker_map.end()) {
+        return nullptr;
+    }
+    // reload swaps the worker while rpc threads read it
+    return std::atomic_load(&it->second);
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+bool AnakinService<Ttype, Ptype, RunP>::reload(std::string model_name,
+        std::string model_path,
+        int warmup_rounds,
+        std::vector<Tensor4d<typename target_host<Ttype>::type> > warmup_inputs) {
+    auto it = _worker_map.find(model_name);
+    if (it == _worker_map.end()) {
+        LOG(ERROR) << "model " << model_name << " is not served, it can't be reloaded";
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(_reload_mut);
+    auto reloads = [&](const std::string& result) {
+        _metrics.counter("anakin_model_reloads_total", "Model reloads, by result.",
+                         {{"model", model_name}, {"result", result}})->inc();
+    };
+    auto old_worker = std::atomic_load(&it->second);
+    auto new_worker = std::make_shared<ServiceWorker>(model_path, old_worker->num_thread(),
+                                                      old_worker->policy());
+    new_worker->copy_config(*old_worker);
+    new_worker->set_warmup(warmup_rounds, warmup_inputs);
+    // the new version loads, optimizes and warms up on its own threads, the old one keeps serving
+    new_worker->launch();
+    if (!new_worker->wait_ready()) {
+        LOG(ERROR) << "reload of model " << model_name << " from " << model_path << " failed, "
+                   << "the running version keeps serving";
+        reloads("failed");
+        return false;
+    }
+    std::atomic_store(&it->second, serve(new_worker));
+    LOG(INFO) << "model " << model_name << " switched to " << model_path;
+    // requests submitted to the old version hold its handle until they are answered
+    auto retirement = std::get_deleter<ReleaseHandle>(old_worker)->retirement;
+    old_worker.reset();
+    {
+        std::unique_lock<std::mutex> lock(retirement->mut);
+        retirement->cv.wait(lock, [&retirement]() { return retirement->released; });
+    }
+    // its threads exit and its graph, nets and weights are released
+    retirement->worker.reset();
+    reloads("succeeded");
+    return true;
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+std::shared_ptr<typename AnakinService<Ttype, Ptype, RunP>::ServiceWorker> 
+AnakinService<Ttype, Ptype, RunP>::serve(std::shared_ptr<ServiceWorker> worker) {
+    auto retirement = std::make_shared<Retirement>();
+    retirement->worker = worker;
+    return std::shared_ptr<ServiceWorker>(worker.get(), ReleaseHandle{retirement});
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::count_bad_request(const std::string& model_name) {
+    _metrics.counter("anakin_request_errors_total", "Requests that failed, by reason.",
+                     {{"model", model_name}, {"reason", "bad_request"}})->inc();
+}
+
 template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
 void AnakinService<Ttype, Ptype, RunP>::set_device_id(int dev_id) {
     _dev_id = dev_id;
@@ -13,9 +268,10 @@ void AnakinService<Ttype, Ptype, RunP>::set_device_id(int dev_id) {
 template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
 void AnakinService<Ttype, Ptype, RunP>::initial(std::string model_name,
         std::string model_path,
-        int thread_num) {
-    _worker_map[model_name] = std::make_shared<Worker<Ttype, Ptype, OpRunType::ASYNC> >(model_path,
-                              thread_num);
+        int thread_num,
+        SchedulePolicy policy) {
+    _worker_map[model_name] = serve(std::make_shared<ServiceWorker>(model_path, thread_num, policy));
+    _worker_map[model_name]->set_metrics(&_metrics, model_name);
 }
 
 template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
@@ -53,78 +309,104 @@ void AnakinService<Ttype, Ptype, RunP>::register_interior_edges(std::string mode
 }
 
 template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
-inline void AnakinService<Ttype, Ptype, RunP>::extract_request(
-    const RPCRequest* request,
-    std::vector<Tensor4d<typename target_host<Ttype>::type> >& inputs) {
-    for (int i = 0; i < request->inputs_size(); i++) {
-        LOG(INFO) << "Get " << i << "input";
-        auto& io = request->inputs(i);
-        auto& data = io.tensor();
-        auto& shape = data.shape();
-        saber::Shape tensor_shape({shape[0], shape[1], shape[2], shape[3]});
-        Tensor4d<typename target_host<Ttype>::type> h_tensor;
-        h_tensor.re_alloc(tensor_shape);
-        float* h_data = (float*)(h_tensor.mutable_data());
-        DLOG(INFO) << "Check shape: " << shape[0] << " " << shape[1] << " " << shape[2] << " " << shape[3];
-        DLOG(INFO) << "h_data: " << h_data << "data_p: " << data.data().data();
-
-        for (int j = 0; j < 10; j++) {
-            LOG(INFO) << "  \\__ request data[" << j << "]: " << data.data(j);
-        }
+void AnakinService<Ttype, Ptype, RunP>::set_cpu_set(std::string model_name,
+        std::vector<int> cores,
+        int omp_threads) {
+    _worker_map[model_name]->set_cpu_set(cores, omp_threads);
+}
 
-        memcpy(h_data, data.data().data(), shape[0]*shape[1]*shape[2]*shape[3]*h_tensor.get_dtype_size());
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::set_admission(std::string model_name,
+        int max_queue,
+        int timeout_ms) {
+    _worker_map[model_name]->set_queue_limit(max_queue);
+    _timeouts_ms[model_name] = timeout_ms;
+}
 
-        for (int j = 0; j < 10; j++) {
-            LOG(WARNING) << "  \\__ copy to inputs data[" << j << "]: " << h_data[j];
-        }
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::set_batching(std::string model_name,
+        int max_batch,
+        int max_wait_us) {
+    _worker_map[model_name]->set_batching(max_batch, max_wait_us);
+}
 
-        inputs.push_back(h_tensor);
-    }
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::set_priority_classes(std::string model_name,
+        int classes,
+        std::vector<int> weights,
+        int max_wait_ms) {
+    _worker_map[model_name]->set_priority_classes(classes, weights, max_wait_ms);
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+void AnakinService<Ttype, Ptype, RunP>::set_result_cache(std::string model_name, size_t max_bytes) {
+    _worker_map[model_name]->set_result_cache(max_bytes);
+}
+
+template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
+inline bool AnakinService<Ttype, Ptype, RunP>::extract_request(
+    const RPCRequest* request,
+    ServiceWorker& worker,
+    std::vector<Tensor4d<typename target_host<Ttype>::type> >& inputs,
+    std::string* error) {
+    return extract_request_inputs(*request, worker.input_dtypes(), inputs, error);
 }
 
 template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
 inline void AnakinService<Ttype, Ptype, RunP>::fill_response_data(
-    int request_id,
+    long long request_id,
     std::string model_name,
+    bool raw_output,
     RPCResponse* response,
     std::vector<Tensor4d<typename target_host<Ttype>::type> >& outputs) {
     response->set_model(model_name);
     response->set_request_id(request_id);
-    int count = 0;
 
     for (auto& h_out : outputs) {
-        LOG(INFO) << "Get " << count << " output";
-        count++;
-        // copy to host
         auto shape = h_out.valid_shape();
         // fill response
         IO* output = response->add_outputs();
         Data* data = output->mutable_tensor();
-        data->add_shape(shape[0]);
-        data->add_shape(shape[1]);
-        data->add_shape(shape[2]);
-        data->add_shape(shape[3]);
-        data->mutable_data()->Reserve(shape[0]*shape[1]*shape[2]*shape[3]);
-
-        for (int j = 0; j < shape[0]*shape[1]*shape[2]*shape[3]; j++) {
-            data->add_data(((float*)(h_out.mutable_data()))[j]);
+        for (int dim = 0; dim < shape.dims(); dim++) {
+            data->add_shape(shape[dim]);
         }
-
-        LOG(INFO) << " output size: " << data->data_size();
+        for (auto& level : h_out.get_seq_offset()) {
+            SeqOffset* seq_offset = data->add_seq_offset();
+            for (auto offset : level) {
+                seq_offset->add_offset(offset);
+            }
+        }
+        const char* src = (const char*)(h_out.data()) + h_out.data_offset() * h_out.get_dtype_size();
+        size_t count = h_out.valid_size();
+        if (!raw_output && h_out.get_dtype() == AK_FLOAT) {
+            data->mutable_data()->Resize(count, 0.f);
+            memcpy(data->mutable_data()->mutable_data(), src, count * sizeof(float));
+            continue;
+        }
+        DataType dtype;
+        if (!payload_dtype(h_out.get_dtype(), &dtype)) {
+            LOG(ERROR) << "output of dtype " << h_out.get_dtype() << " can't be serialized";
+            continue;
+        }
+        data->set_dtype(dtype);
+        data->set_raw_data(src, count * h_out.get_dtype_size());
     }
 }
 
 template<typename Ttype, Precision Ptype, ServiceRunPattern RunP>
-inline void AnakinService<Ttype, Ptype, RunP>::fill_response_exec_info(RPCResponse* response) {
+inline void AnakinService<Ttype, Ptype, RunP>::fill_response_exec_info(RPCResponse* response,
+        const typename ServiceWorker::Timing& timing) {
     auto* info = response->mutable_info();
-    info->set_msg("SUC");
+    info->set_msg(timing.expired ? "DEADLINE_EXCEEDED" : "SUC");
     DeviceStatus* status_p =  info->mutable_device_status();
     status_p->set_id(_monitor.get_id());
     status_p->set_name(_monitor.get_name());
     status_p->set_temp(_monitor.get_temp());
     status_p->set_mem_free(_monitor.get_mem_free());
     status_p->set_mem_used(_monitor.get_mem_used());
-    info->set_duration_in_nano_seconds(-1);
+    info->set_duration_in_nano_seconds(timing.queue_ns + timing.compute_ns);
+    info->set_queue_duration_in_nano_seconds(timing.queue_ns);
+    info->set_compute_duration_in_nano_seconds(timing.compute_ns);
 }
 
 #ifdef USE_CUDA
@@ -19,6 +19,8 @@
 #include <brpc/server.h>
 
 #include "framework/service/monitor.h"
+#include "framework/service/completion_store.h"
+#include "framework/service/request_inputs.h"
 #include "framework/core/net/worker.h"
 #include "framework/service/api/service.pb.h"
 
@@ -26,6 +28,14 @@ namespace anakin {
 
 namespace rpc {
 
+/**
+ *  \brief Anakin rpc service.
+ *   SYNC pattern: evaluate responds with the outputs.
+ *   ASYNC pattern: evaluate responds at once, the outputs wait in a bounded completion store
+ *   until fetch gets them by model and request_id.
+ *   In both patterns the rpc thread only decodes the request and submits it to the worker,
+ *   the worker thread fills the response (or the store) when the prediction is done.
+ */
 template<typename Ttype, Precision Ptype, ServiceRunPattern RunP = ServiceRunPattern::SYNC>
 class AnakinService : public RPCService {
 public: 
@@ -36,13 +46,46 @@ public:
         _evaluate(controller_base, request, response, done, ServiceRunPatternToType<RunP>());      
     }
 
+    /**
+     *  \brief Get the outputs of an async evaluation, it never waits for them.
+     */
+    void fetch(::google::protobuf::RpcController* controller_base,
+               const FetchRequest* request,
+               RPCResponse* response,
+               ::google::protobuf::Closure* done);
+
+    /**
+     *  \brief Admission counters of the models, the signal for scaling the service.
+     */
+    void load(::google::protobuf::RpcController* controller_base,
+              const LoadRequest* request,
+              LoadResponse* response,
+              ::google::protobuf::Closure* done);
+
 public:
     void set_device_id(int dev_id);
 
-    void initial(std::string model_name, std::string model_path, int thread_num);
+    /**
+     *  \brief Serve model_path as model_name with thread_num threads taking requests by policy
+     *   (see SchedulePolicy), a reload keeps the policy.
+     */
+    void initial(std::string model_name, std::string model_path, int thread_num,
+                 SchedulePolicy policy = SchedulePolicy::FIFO);
 
     void launch();
 
+    /**
+     *  \brief Replace the model of model_name by model_path without dropping requests.
+     *   The new version is loaded, optimized and warmed up (warmup_rounds predictions of
+     *   warmup_inputs, zeros if empty, on every thread) while the running one serves,
+     *   then new requests go to it. It returns when the requests of the old version are
+     *   answered and its memory is released. The worker config of the model is kept.
+     *   It must be invoked after launch, reloads of a service run one at a time.
+     *  \return false if the new version failed to load, the running one keeps serving.
+     */
+    bool reload(std::string model_name, std::string model_path, int warmup_rounds = 1,
+                std::vector<Tensor4d<typename target_host<Ttype>::type> > warmup_inputs = {});
+
     void Reshape(std::string model_name, std::string in_name, std::vector<int> in_shape);
 
     void register_inputs(std::string model_name, std::vector<std::string> in_names);
@@ -51,9 +94,56 @@ public:
 
     void register_interior_edges(std::string model_name, std::string edge_start, std::string edge_end);
 
+    /**
+     *  \brief Partition the host between models: the threads of model_name only run on cores,
+     *   omp_threads cores each, with their memory on the NUMA node of those cores.
+     *   Give models disjoint cpu sets (e.g. one socket each) to keep their tail latency apart.
+     *   It must be invoked before launch.
+     */
+    void set_cpu_set(std::string model_name, std::vector<int> cores, int omp_threads);
+
+    /**
+     *  \brief Shed load of model_name instead of queueing it without bound.
+     *   Requests beyond max_queue waiting ones are refused with "OVERLOADED" at once,
+     *   requests not started within their timeout_ms (timeout_ms by default) are dropped
+     *   with "DEADLINE_EXCEEDED". 0 disables the bound or the default timeout.
+     *   It must be invoked before launch.
+     */
+    void set_admission(std::string model_name, int max_queue, int timeout_ms);
+
+    /**
+     *  \brief Merge concurrent requests of model_name up to max_batch samples, waiting at most
+     *   max_wait_us for a batch to fill (see Worker::set_batching). It must be invoked before launch.
+     */
+    void set_batching(std::string model_name, int max_batch, int max_wait_us);
+
+    /**
+     *  \brief Serve requests of model_name by the priority field of RPCRequest
+     *   (see Worker::set_priority_classes). It must be invoked before launch.
+     */
+    void set_priority_classes(std::string model_name, int classes,
+                              std::vector<int> weights = {}, int max_wait_ms = 0);
+
+    /**
+     *  \brief Answer repeated inputs of model_name from up to max_bytes of recent outputs
+     *   (see Worker::set_result_cache). A reload starts from an empty cache.
+     */
+    void set_result_cache(std::string model_name, size_t max_bytes);
+
+    /// max async results waiting for their fetch, the oldest ones are evicted beyond it,
+    /// and max async requests pending, new ones are answered OVERLOADED beyond it.
+    void set_completion_capacity(size_t capacity) {
+        _completions.set_capacity(capacity);
+    }
+
+    /// serving metrics of the models, see MetricsHttpService to expose them.
+    MetricsRegistry& metrics() {
+        return _metrics;
+    }
+
     template<typename functor, typename ...ParamTypes> 
     void register_aux_function(std::string model_name, functor function, ParamTypes ...args) {
-        _worker_map[model_name].register_aux_function(function, std::forward<ParamTypes>(args)...);
+        _worker_map[model_name]->register_aux_function(function, std::forward<ParamTypes>(args)...);
     }
 
     template<Info ...infos>
@@ -62,55 +152,58 @@ public:
     }
 
 private:
-    void extract_request(const RPCRequest* request, 
-                         std::vector<Tensor4d<typename target_host<Ttype>::type> >& inputs);
-    void fill_response_data(int request_id, std::string model_name, 
+    typedef Worker<Ttype, Ptype, OpRunType::ASYNC> ServiceWorker;
+
+    /// current worker of model_name, nullptr if the model isn't served.
+    std::shared_ptr<ServiceWorker> find_worker(const std::string& model_name);
+
+    /// handle of worker put in the worker map, reload waits until its last copy is dropped.
+    static std::shared_ptr<ServiceWorker> serve(std::shared_ptr<ServiceWorker> worker);
+
+    /// count a malformed request of a served model.
+    void count_bad_request(const std::string& model_name);
+
+    /**
+     *  \brief Get the inputs of request as host tensors viewing the request payloads,
+     *   they are copied only once, into the net inputs.
+     *  \return false if an input is malformed or doesn't fit the net of worker, the reason is in error.
+     */
+    bool extract_request(const RPCRequest* request, ServiceWorker& worker,
+                         std::vector<Tensor4d<typename target_host<Ttype>::type> >& inputs,
+                         std::string* error);
+    /// serialize outputs in bulk, as raw bytes with dtype when raw_output is set or they aren't float.
+    void fill_response_data(long long request_id, std::string model_name, bool raw_output,
                             RPCResponse* response, 
                             std::vector<Tensor4d<typename target_host<Ttype>::type> >& outputs);
-    void fill_response_exec_info(RPCResponse* response);
+    void fill_response_exec_info(RPCResponse* response, const typename ServiceWorker::Timing& timing);
+    /// deadline of request by its timeout or the default one of its model.
+    typename ServiceWorker::Deadline deadline_of(const RPCRequest* request);
 
 private:
     void _evaluate(::google::protobuf::RpcController* controller_base, 
-                          const RPCRequest* request, 
-                          RPCResponse* response, 
-                          ::google::protobuf::Closure* done,
-                          ServiceRunPatternToType<ServiceRunPattern::SYNC>) {
-        // make sure that done will be invoked
-        brpc::ClosureGuard done_guard(done);
-        brpc::Controller* cntl = static_cast<brpc::Controller*>(controller_base);
-        // receive remote call from client.
-        LOG(INFO) << "Received request[log_id=" << cntl->log_id() << "] from " << cntl->remote_side();
-        if (!cntl->request_attachment().empty()) { 
-            LOG(INFO) << " |-- (attached=" << cntl->request_attachment() << ")"; 
-        }
-        std::string model_name = request->model();
-        int request_id = request->request_id();
-        LOG(INFO) <<" |-- Get model: "<<model_name << " id: " << request_id; 
-        std::vector<Tensor4d<typename target_host<Ttype>::type> > inputs;
-        extract_request(request, inputs);
-        auto ret = _worker_map[model_name]->sync_prediction(inputs);
-        auto results = ret.get();
-        LOG(ERROR) << "do infer over! thread id: " << std::this_thread::get_id();
-        fill_response_data(request_id, model_name, response, results);
-        fill_response_exec_info(response);
-    }
+                   const RPCRequest* request, 
+                   RPCResponse* response, 
+                   ::google::protobuf::Closure* done,
+                   ServiceRunPatternToType<ServiceRunPattern::SYNC>);
 
     void _evaluate(::google::protobuf::RpcController* controller_base, 
-                          const RPCRequest* request, 
-                          RPCResponse* response, 
-                          ::google::protobuf::Closure* done,
-                          ServiceRunPatternToType<ServiceRunPattern::ASYNC>) {
-        // make sure that done will be invoked
-        brpc::ClosureGuard done_guard(done);
-        brpc::Controller* cntl = static_cast<brpc::Controller*>(controller_base);
-    }
-
-
+                   const RPCRequest* request, 
+                   RPCResponse* response, 
+                   ::google::protobuf::Closure* done,
+                   ServiceRunPatternToType<ServiceRunPattern::ASYNC>);
 
 private:
-    std::unordered_map<std::string, std::shared_ptr<Worker<Ttype, Ptype, OpRunType::ASYNC> > > _worker_map;
+    std::unordered_map<std::string, std::shared_ptr<ServiceWorker> > _worker_map;
+    ///< serializes reloads.
+    std::mutex _reload_mut;
+    ///< default timeout of models in ms, a missing model has none.
+    std::unordered_map<std::string, int> _timeouts_ms;
     Monitor<Ttype> _monitor;
+    ///< requests, errors and latencies of the models.
+    MetricsRegistry _metrics;
     int _dev_id;
+    ///< results of async evaluations.
+    CompletionStore _completions;
 };
 
 } /* namespace rpc */
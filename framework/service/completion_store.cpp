@@ -0,0 +1,75 @@
+#include "framework/service/completion_store.h"
+#include "utils/logger/logger.h"
+
+namespace anakin {
+
+namespace rpc {
+
+void CompletionStore::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(_mut);
+    _capacity = capacity;
+}
+
+CompletionStore::Admission CompletionStore::submit(const std::string& key) {
+    std::lock_guard<std::mutex> guard(_mut);
+    if (_pending.count(key) > 0 || _completed.count(key) > 0) {
+        return DUPLICATE;
+    }
+    if (_pending.size() >= _capacity) {
+        return FULL;
+    }
+    _pending.insert(key);
+    return ADMITTED;
+}
+
+void CompletionStore::cancel(const std::string& key) {
+    std::lock_guard<std::mutex> guard(_mut);
+    _pending.erase(key);
+}
+
+void CompletionStore::complete(const std::string& key, std::unique_ptr<RPCResponse> response) {
+    std::lock_guard<std::mutex> guard(_mut);
+    if (_pending.erase(key) == 0) {
+        LOG(WARNING) << "completed request " << key << " was not submitted";
+    }
+    auto seq = _next_seq++;
+    _completed[key] = Completion{seq, std::move(response)};
+    _order[seq] = key;
+    while (_completed.size() > _capacity && !_order.empty()) {
+        LOG(WARNING) << "response of " << _order.begin()->second << " is evicted before it was fetched";
+        _completed.erase(_order.begin()->second);
+        _order.erase(_order.begin());
+        _evicted++;
+    }
+}
+
+CompletionStore::State CompletionStore::fetch(const std::string& key, RPCResponse* response) {
+    std::lock_guard<std::mutex> guard(_mut);
+    auto it = _completed.find(key);
+    if (it == _completed.end()) {
+        return _pending.count(key) > 0 ? PENDING : NOT_FOUND;
+    }
+    response->Swap(it->second.response.get());
+    _order.erase(it->second.seq);
+    _completed.erase(it);
+    return DONE;
+}
+
+size_t CompletionStore::pending() {
+    std::lock_guard<std::mutex> guard(_mut);
+    return _pending.size();
+}
+
+size_t CompletionStore::completed() {
+    std::lock_guard<std::mutex> guard(_mut);
+    return _completed.size();
+}
+
+size_t CompletionStore::evicted() {
+    std::lock_guard<std::mutex> guard(_mut);
+    return _evicted;
+}
+
+} /* namespace rpc */
+
+} /* namespace anakin */
@@ -0,0 +1,102 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_COMPLETION_STORE_H
+#define ANAKIN_COMPLETION_STORE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "framework/core/thread_safe_macros.h"
+#include "framework/service/api/service.pb.h"
+
+namespace anakin {
+
+namespace rpc {
+
+/**
+ *  \brief Responses of async requests waiting to be fetched, keyed by model and request id.
+ *
+ *   A request is pending from submit to complete, then its response waits for one fetch.
+ *   At most capacity responses are kept, the oldest completed ones are evicted beyond it
+ *   (their fetch finds nothing), so clients that never fetch can't exhaust the memory.
+ *   At most capacity requests are pending too, submit refuses new ones beyond it, so a burst
+ *   of requests can't hold unbounded copies of their inputs.
+ */
+class CompletionStore {
+public:
+    enum State {
+        NOT_FOUND,  ///< never submitted, fetched already or evicted.
+        PENDING,    ///< submitted and not completed yet.
+        DONE        ///< completed, the response is returned.
+    };
+
+    enum Admission {
+        ADMITTED,   ///< pending from now on.
+        DUPLICATE,  ///< key is pending or waits for its fetch already.
+        FULL        ///< capacity requests are pending already.
+    };
+
+    explicit CompletionStore(size_t capacity = 1024) : _capacity(capacity) {}
+    ~CompletionStore() {}
+
+    /// key of request_id of model.
+    static std::string key(const std::string& model, long long request_id) {
+        return model + "/" + std::to_string(request_id);
+    }
+
+    void set_capacity(size_t capacity);
+
+    /// register a pending request.
+    Admission submit(const std::string& key);
+
+    /// forget a pending request that will never complete.
+    void cancel(const std::string& key);
+
+    /// store the response of a pending request.
+    void complete(const std::string& key, std::unique_ptr<RPCResponse> response);
+
+    /// state of key, a DONE response is moved to response and removed from the store.
+    State fetch(const std::string& key, RPCResponse* response);
+
+    size_t pending();
+    size_t completed();
+    /// responses evicted before they were fetched.
+    size_t evicted();
+
+private:
+    struct Completion {
+        unsigned long long seq;
+        std::unique_ptr<RPCResponse> response;
+    };
+
+    std::mutex _mut;
+    size_t _capacity GUARDED_BY(_mut);
+    std::unordered_set<std::string> _pending GUARDED_BY(_mut);
+    std::unordered_map<std::string, Completion> _completed GUARDED_BY(_mut);
+    ///< completed keys in completion order, for eviction.
+    std::map<unsigned long long, std::string> _order GUARDED_BY(_mut);
+    unsigned long long _next_seq GUARDED_BY(_mut) {0};
+    size_t _evicted GUARDED_BY(_mut) {0};
+};
+
+} /* namespace rpc */
+
+} /* namespace anakin */
+
+#endif
@@ -0,0 +1,19 @@
+#include "framework/service/metrics_service.h"
+
+namespace anakin {
+
+namespace rpc {
+
+void MetricsHttpService::metrics(::google::protobuf::RpcController* controller_base,
+                                 const HttpRequest* request,
+                                 HttpResponse* response,
+                                 ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller_base);
+    cntl->http_response().set_content_type(MetricsRegistry::content_type());
+    cntl->response_attachment().append(_registry->prometheus_text());
+}
+
+} /* namespace rpc */
+
+} /* namespace anakin */
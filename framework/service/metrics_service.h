@@ -0,0 +1,55 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_METRICS_SERVICE_H
+#define ANAKIN_METRICS_SERVICE_H
+
+#include <brpc/server.h>
+
+#include "framework/core/net/metrics.h"
+#include "framework/service/api/service.pb.h"
+
+namespace anakin {
+
+namespace rpc {
+
+/**
+ *  \brief Http endpoint of a metrics registry for Prometheus scrapes.
+ *  \par Usage:
+ *      \code
+ *      MetricsHttpService metrics_service(&rpc_service.metrics());
+ *      server.AddService(&metrics_service, brpc::SERVER_DOESNT_OWN_SERVICE, "/metrics => metrics");
+ *      // curl http://host:port/metrics
+ *      \endcode
+ */
+class MetricsHttpService : public MetricsService {
+public:
+    explicit MetricsHttpService(MetricsRegistry* registry) : _registry(registry) {}
+    ~MetricsHttpService() {}
+
+    void metrics(::google::protobuf::RpcController* controller_base,
+                 const HttpRequest* request,
+                 HttpResponse* response,
+                 ::google::protobuf::Closure* done);
+
+private:
+    MetricsRegistry* _registry;
+};
+
+} /* namespace rpc */
+
+} /* namespace anakin */
+
+#endif
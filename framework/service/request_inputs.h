@@ -0,0 +1,157 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_REQUEST_INPUTS_H
+#define ANAKIN_REQUEST_INPUTS_H
+
+#include <string>
+#include <vector>
+#include "framework/core/parameter.h"
+#include "framework/service/api/service.pb.h"
+
+namespace anakin {
+
+namespace rpc {
+
+/// saber dtype of payload dtype, AK_INVALID if unsupported.
+inline saber::DataType saber_dtype(DataType dtype) {
+    switch (dtype) {
+    case DT_FLOAT32: return AK_FLOAT;
+    case DT_FLOAT16: return AK_HALF;
+    case DT_INT8: return AK_INT8;
+    case DT_UINT8: return AK_UINT8;
+    case DT_INT32: return AK_INT32;
+    case DT_INT64: return AK_INT64;
+    default: return AK_INVALID;
+    }
+}
+
+/// payload dtype of saber dtype, return false if it has none.
+inline bool payload_dtype(saber::DataType type, DataType* dtype) {
+    switch (type) {
+    case AK_FLOAT: *dtype = DT_FLOAT32; return true;
+    case AK_HALF: *dtype = DT_FLOAT16; return true;
+    case AK_INT8: *dtype = DT_INT8; return true;
+    case AK_UINT8: *dtype = DT_UINT8; return true;
+    case AK_INT32: *dtype = DT_INT32; return true;
+    case AK_INT64: *dtype = DT_INT64; return true;
+    default: return false;
+    }
+}
+
+/// payload dtype name of saber dtype, for errors.
+inline std::string payload_dtype_name(saber::DataType type) {
+    DataType dtype;
+    return payload_dtype(type, &dtype) ? DataType_Name(dtype) : "unsupported dtype " + std::to_string(type);
+}
+
+/// plain batch major layout of a payload rank, Layout_invalid if saber has none.
+inline LayoutType payload_layout(int rank) {
+    switch (rank) {
+    case 1: return Layout_W;
+    case 2: return Layout_NC;
+    case 3: return Layout_NHW;
+    case 4: return Layout_NCHW;
+    default: return Layout_invalid;
+    }
+}
+
+/**
+ *  \brief Get the inputs of request as host tensors viewing the request payloads,
+ *   they are copied only once, into the net inputs.
+ *   A request must carry one input per net input, each of the net input dtype, with 1 to 4
+ *   dims all > 0 and a payload of exactly its shape, anything else would break the worker.
+ *  \param net_dtypes dtypes of the net inputs in order.
+ *  \return false if an input is malformed, the reason is in error.
+ */
+template<typename TargetType>
+bool extract_request_inputs(const RPCRequest& request,
+                            const std::vector<saber::DataType>& net_dtypes,
+                            std::vector<Tensor4d<TargetType> >& inputs,
+                            std::string* error) {
+    if (request.inputs_size() != net_dtypes.size()) {
+        *error = "request has " + std::to_string(request.inputs_size()) + " inputs, the model takes "
+                 + std::to_string(net_dtypes.size());
+        return false;
+    }
+    for (int i = 0; i < request.inputs_size(); i++) {
+        auto& data = request.inputs(i).tensor();
+        std::vector<int> dims(data.shape().begin(), data.shape().end());
+        LayoutType layout = payload_layout(dims.size());
+        if (layout == Layout_invalid) {
+            *error = "input " + std::to_string(i) + " has " + std::to_string(dims.size())
+                     + " dims, only 1 to 4 are supported";
+            return false;
+        }
+        for (auto dim : dims) {
+            if (dim <= 0) {
+                *error = "input " + std::to_string(i) + " has dim " + std::to_string(dim)
+                         + ", dims must be > 0";
+                return false;
+            }
+        }
+        saber::Shape shape(dims, layout);
+        saber::DataType dtype = AK_FLOAT;
+        const void* payload = data.data().data();
+        size_t bytes = data.data_size() * sizeof(float);
+        if (!data.raw_data().empty()) {
+            dtype = saber_dtype(data.dtype());
+            if (dtype == AK_INVALID) {
+                *error = "input " + std::to_string(i) + " has unsupported dtype "
+                         + DataType_Name(data.dtype());
+                return false;
+            }
+            payload = data.raw_data().data();
+            bytes = data.raw_data().size();
+        }
+        if (dtype != net_dtypes[i]) {
+            *error = "input " + std::to_string(i) + " has dtype " + payload_dtype_name(dtype)
+                     + ", the model takes " + payload_dtype_name(net_dtypes[i]);
+            return false;
+        }
+        // counted in 64 bits, large dims must not wrap around to the payload size
+        unsigned long long needed = type_length(dtype);
+        for (auto dim : dims) {
+            needed = needed * dim;
+            if (needed > bytes) {
+                break;
+            }
+        }
+        if (needed != bytes) {
+            *error = "input " + std::to_string(i) + " has " + std::to_string(bytes)
+                     + " payload bytes, its shape needs " + std::to_string(needed)
+                     + (needed > bytes ? " or more" : "");
+            return false;
+        }
+        // no copy here, the payload is copied into the net input by the worker
+        Tensor4d<TargetType> h_tensor(const_cast<void*>(payload), TargetType(), 0, shape, dtype);
+        if (data.seq_offset_size() > 0) {
+            std::vector<std::vector<int> > seq_offset;
+            for (auto& level : data.seq_offset()) {
+                seq_offset.push_back(std::vector<int>(level.offset().begin(), level.offset().end()));
+            }
+            h_tensor.set_seq_offset(seq_offset);
+        }
+        DLOG(INFO) << "Get input " << i << ": " << shape << ", dtype " << dtype;
+        inputs.push_back(h_tensor);
+    }
+    return true;
+}
+
+} /* namespace rpc */
+
+} /* namespace anakin */
+
+#endif
@@ -3,8 +3,8 @@
 
 #include <iostream>
 #include <fstream>
-
-#ifdef ENABLE_OP_TIMER
+#include <sstream>
+#include <string>
 
 namespace anakin {
 
@@ -106,6 +106,4 @@ inline static Csvfile& flush(Csvfile& file) {
 
 }
 
-#endif /* ENABLE_OP_TIMER */
-
 #endif /* ANAKIN_FRAMEWORK_UTILS_CSV_H */
@@ -15,6 +15,7 @@
 
 #ifndef ANAKIN_SABER_CORE_BUFFER_H
 #define ANAKIN_SABER_CORE_BUFFER_H
+#include <memory>
 #include "saber/core/target_wrapper.h"
 #include "saber/core/data_traits.h"
 namespace anakin{
@@ -51,6 +52,14 @@ public:
         CHECK_EQ(id, _id) << "data is not in current device";
     }
 
+    /**
+     * \brief constructor with external data which holder keeps alive (e.g. a mapped file)
+     */
+    explicit Buffer(TPtr data, size_t size, int id, std::shared_ptr<void> holder)
+        : Buffer(data, size, id) {
+        _holder = holder;
+    }
+
     /**
      * \brief copy constructor
      */
@@ -62,6 +71,7 @@ public:
             _data = buf._data;
             _own_data = false;
             _capacity = _count;
+            _holder = buf._holder;
         } else{
             _own_data = true;
             SABER_CHECK(re_alloc(buf._count));
@@ -79,6 +89,7 @@ public:
             this->_data = buf._data;
             this->_capacity = this->_count;
             this->_own_data = false;
+            this->_holder = buf._holder;
         } else{
             this->_own_data = true;
             SABER_CHECK(this->re_alloc(buf._count));
@@ -95,6 +106,7 @@ public:
             _data = buf._data;
             _capacity = _count;
             _own_data = false;
+            _holder = buf._holder;
             return 1;
         } else{
             _own_data = true;
@@ -236,6 +248,8 @@ private:
     bool _own_data;
     size_t _count;
     size_t _capacity;
+    //! \brief keeps the external data alive, nullptr if the data isn't held by anyone
+    std::shared_ptr<void> _holder;
 
     /**
      * \brief free memory
@@ -248,6 +262,7 @@ private:
             API::mem_free(_data);
         }
         _data = nullptr;
+        _holder.reset();
         return SaberSuccess;
     }
 };
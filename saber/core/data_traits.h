@@ -48,6 +48,8 @@ static size_t type_length(DataType type) {
     switch (type) {
     case AK_INT8:
         return 1;
+    case AK_INT4:
+        return 1;
     case AK_UINT8:
         return 1;
     case AK_INT16:
@@ -64,6 +66,8 @@ static size_t type_length(DataType type) {
         return 8;
     case AK_HALF:
         return 2;
+    case AK_BFLOAT16:
+        return 2;
     case AK_FLOAT:
         return 4;
     case AK_DOUBLE:
@@ -85,6 +89,12 @@ struct DataTrait<Ttype, AK_HALF> {
     typedef short* PtrDtype;
 };
 
+template <typename Ttype>
+struct DataTrait<Ttype, AK_BFLOAT16> {
+    typedef unsigned short Dtype;
+    typedef unsigned short* PtrDtype;
+};
+
 template <typename Ttype>
 struct DataTrait<Ttype, AK_FLOAT> {
     typedef float Dtype;
@@ -97,6 +107,12 @@ struct DataTrait<Ttype, AK_DOUBLE> {
     typedef double* PtrDtype;
 };
 
+template <typename Ttype>
+struct DataTrait<Ttype, AK_INT4> {
+    typedef char Dtype;
+    typedef char* PtrDtype;
+};
+
 template <typename Ttype>
 struct DataTrait<Ttype, AK_INT8> {
     typedef char Dtype;
@@ -181,6 +181,9 @@ public:
             case AK_HALF: {
                 return sizeof(unsigned short);
             }
+            case AK_BFLOAT16: {
+                return sizeof(unsigned short);
+            }
             case AK_FLOAT: {
                 return sizeof(float);
             }
@@ -190,6 +193,9 @@ public:
             case AK_INT8: {
                 return sizeof(int8_t);
             }
+            case AK_INT4: {
+                return sizeof(int8_t);
+            }
             case AK_INT16: {
                 return sizeof(int16_t);
             }
@@ -329,6 +335,26 @@ public:
         return SaberSuccess;
     }
 
+    /**
+     *  \brief Point the tensor to memory it doesn't own, e.g. weights in a mapped model file.
+     *  Unlike the tensor constructed with a data ptr it is not shared,
+     *  re_alloc gives it memory of its own and leaves the external memory as is.
+     *  holder (e.g. the mapping) is kept alive while any tensor uses the memory.
+     */
+    SaberStatus attach(typename DataTraitBase<TargetType>::PtrDtype data, Shape shape, DataType type = AK_FLOAT,
+                       std::shared_ptr<void> holder = nullptr) {
+        _dtype = type;
+        _buf_dtype = type;
+        _type_len = type_length(type);
+        _shape = shape;
+        _valid_shape = shape;
+        _offset = Shape::zero(shape);
+        _buf = std::make_shared<Buffer<TargetType>>(data, shape.count() * _type_len, API::get_device_id(), holder);
+        _is_shared = false;
+        _is_subbuf = false;
+        return SaberSuccess;
+    }
+
     /**
      *  \brief Change tensor shape,
      *  if input shape's count is bigger than the capacity of buffer, alloc a new buffer.
@@ -0,0 +1,289 @@
+#include "saber/core/weight_cache.h"
+#include "saber/core/weight_registry.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#ifndef USE_SGX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace anakin {
+
+namespace saber {
+
+namespace {
+
+const char CacheMagic[8] = {'A', 'K', 'W', 'C', 'A', 'C', 'H', '1'};
+const size_t CacheAlign = 64;
+
+/// file layout: magic, uint64 entries, entries (uint32 key length, key, uint64 offset, uint64 bytes), data.
+struct CacheEntry {
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+/// highest vector isa of the cpu, derived weights are laid out for it.
+std::string cpu_isa() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return "avx512";
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return "avx2";
+    }
+    if (__builtin_cpu_supports("avx")) {
+        return "avx";
+    }
+    return "sse";
+#else
+    return "generic";
+#endif
+}
+
+thread_local WeightCache* current_cache = nullptr;
+
+} // namespace
+
+WeightCache::~WeightCache() {
+    unmap();
+}
+
+std::shared_ptr<WeightCache> WeightCache::open(const std::string& path) {
+    static std::mutex mut;
+    static std::map<std::string, std::weak_ptr<WeightCache> > caches;
+    std::lock_guard<std::mutex> lock(mut);
+    auto cache = caches[path].lock();
+    if (!cache) {
+        cache.reset(new WeightCache(path));
+        cache->map();
+        caches[path] = cache;
+    }
+    return cache;
+}
+
+WeightCache* WeightCache::current() {
+    return current_cache;
+}
+
+WeightCache::Scope::Scope(std::shared_ptr<WeightCache> cache) {
+    _prev = current_cache;
+    current_cache = cache.get();
+}
+
+WeightCache::Scope::~Scope() {
+    current_cache = _prev;
+}
+
+std::string WeightCache::make_key(const std::string& kind, const void* src, size_t src_bytes,
+                                  const std::vector<float>& attrs) {
+    // the whole source is hashed, a model retrained in place must not hit.
+    static const std::string isa = cpu_isa();
+    std::ostringstream key;
+    key << isa << "/" << kind << ":" << src_bytes << ":" << std::hex
+        << WeightRegistry::fingerprint(src, src_bytes) << std::dec << std::setprecision(9);
+    for (auto attr : attrs) {
+        key << ":" << attr;
+    }
+    return key.str();
+}
+
+void WeightCache::load_or_build(const std::string& kind, const void* src, size_t src_bytes,
+                                const std::vector<float>& attrs, void* dst, size_t bytes,
+                                std::function<void()> build) {
+    WeightCache* cache = current();
+    if (cache == nullptr) {
+        build();
+        return;
+    }
+    std::string key = make_key(kind, src, src_bytes, attrs);
+    if (cache->load(key, dst, bytes)) {
+        return;
+    }
+    build();
+    cache->store(key, dst, bytes);
+}
+
+bool WeightCache::load(const std::string& key, void* dst, size_t bytes) {
+    std::lock_guard<std::mutex> lock(_mut);
+    auto it = _entries.find(key);
+    if (it != _entries.end() && it->second.bytes == bytes) {
+        memcpy(dst, it->second.data, bytes);
+        _hits++;
+        return true;
+    }
+    auto stored = _stored.find(key);
+    if (stored != _stored.end() && stored->second.size() == bytes) {
+        memcpy(dst, stored->second.data(), bytes);
+        _hits++;
+        return true;
+    }
+    _misses++;
+    return false;
+}
+
+void WeightCache::store(const std::string& key, const void* src, size_t bytes) {
+    std::lock_guard<std::mutex> lock(_mut);
+    _stored[key].assign(static_cast<const char*>(src), bytes);
+}
+
+bool WeightCache::save() {
+    std::lock_guard<std::mutex> lock(_mut);
+    if (_stored.empty()) {
+        return true;
+    }
+    // the file keeps its entries and gets the stored ones.
+    std::map<std::string, Entry> entries = _entries;
+    for (auto& pair : _stored) {
+        Entry entry;
+        entry.data = pair.second.data();
+        entry.bytes = pair.second.size();
+        entries[pair.first] = entry;
+    }
+    uint64_t count = entries.size();
+    uint64_t offset = sizeof(CacheMagic) + sizeof(count);
+    for (auto& pair : entries) {
+        offset += sizeof(uint32_t) + pair.first.size() + sizeof(CacheEntry);
+    }
+    std::vector<CacheEntry> index;
+    for (auto& pair : entries) {
+        CacheEntry entry;
+        entry.offset = (offset + CacheAlign - 1) / CacheAlign * CacheAlign;
+        entry.bytes = pair.second.bytes;
+        index.push_back(entry);
+        offset = entry.offset + entry.bytes;
+    }
+
+    // write aside and rename, readers of the old file are not disturbed. the temp file is
+    // unique, processes and threads saving the same cache don't write into each other's file.
+#ifndef USE_SGX
+    std::vector<char> tmp_name(_path.begin(), _path.end());
+    const std::string suffix = ".XXXXXX";
+    tmp_name.insert(tmp_name.end(), suffix.begin(), suffix.end());
+    tmp_name.push_back('\0');
+    int fd = mkstemp(tmp_name.data());
+    std::string tmp_path(tmp_name.data());
+    if (fd != -1) {
+        // mkstemp creates it owner only, other processes serving the model read the cache too
+        fchmod(fd, 0644);
+    }
+    FILE* f = fd == -1 ? nullptr : fdopen(fd, "wb");
+    if (f == nullptr && fd != -1) {
+        close(fd);
+        remove(tmp_path.c_str());
+    }
+#else
+    std::string tmp_path = _path + ".tmp";
+    FILE* f = fopen(tmp_path.c_str(), "wb");
+#endif
+    if (f == nullptr) {
+        LOG(ERROR) << "can't write weights cache " << tmp_path;
+        return false;
+    }
+    bool success = fwrite(CacheMagic, sizeof(CacheMagic), 1, f) == 1;
+    success = success && fwrite(&count, sizeof(count), 1, f) == 1;
+    int i = 0;
+    for (auto& pair : entries) {
+        uint32_t key_len = pair.first.size();
+        success = success && fwrite(&key_len, sizeof(key_len), 1, f) == 1;
+        success = success && fwrite(pair.first.data(), 1, key_len, f) == key_len;
+        success = success && fwrite(&index[i++], sizeof(CacheEntry), 1, f) == 1;
+    }
+    uint64_t written = ftell(f);
+    std::vector<char> padding(CacheAlign, 0);
+    i = 0;
+    for (auto& pair : entries) {
+        size_t pad = index[i].offset - written;
+        success = success && fwrite(padding.data(), 1, pad, f) == pad;
+        success = success && fwrite(pair.second.data, 1, pair.second.bytes, f) == pair.second.bytes;
+        written = index[i].offset + index[i].bytes;
+        i++;
+    }
+    success = (fclose(f) == 0) && success;
+    if (!success || rename(tmp_path.c_str(), _path.c_str()) != 0) {
+        LOG(ERROR) << "write weights cache " << _path << " failed";
+        remove(tmp_path.c_str());
+        return false;
+    }
+    LOG(INFO) << "weights cache " << _path << ": " << _stored.size() << " new entries, "
+              << count << " total";
+    _stored.clear();
+    unmap();
+    map();
+    return true;
+}
+
+void WeightCache::map() {
+#ifndef USE_SGX
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < sizeof(CacheMagic) + sizeof(uint64_t)) {
+        close(fd);
+        return;
+    }
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return;
+    }
+    _addr = addr;
+    _size = st.st_size;
+    const char* base = static_cast<const char*>(addr);
+    const char* end = base + _size;
+    if (memcmp(base, CacheMagic, sizeof(CacheMagic)) != 0) {
+        LOG(WARNING) << _path << " is not a weights cache, it will be overwritten";
+        unmap();
+        return;
+    }
+    uint64_t count = 0;
+    memcpy(&count, base + sizeof(CacheMagic), sizeof(count));
+    const char* index = base + sizeof(CacheMagic) + sizeof(count);
+    for (uint64_t i = 0; i < count; i++) {
+        uint32_t key_len = 0;
+        CacheEntry entry;
+        if (index + sizeof(key_len) > end) {
+            break;
+        }
+        memcpy(&key_len, index, sizeof(key_len));
+        index += sizeof(key_len);
+        if (index + key_len + sizeof(entry) > end) {
+            break;
+        }
+        std::string key(index, key_len);
+        index += key_len;
+        memcpy(&entry, index, sizeof(entry));
+        index += sizeof(entry);
+        if (entry.offset + entry.bytes > _size) {
+            LOG(WARNING) << _path << " is truncated, entries from " << key << " are ignored";
+            break;
+        }
+        Entry cached;
+        cached.data = base + entry.offset;
+        cached.bytes = entry.bytes;
+        _entries[key] = cached;
+    }
+#endif
+}
+
+void WeightCache::unmap() {
+#ifndef USE_SGX
+    if (_addr != nullptr) {
+        munmap(_addr, _size);
+    }
+#endif
+    _addr = nullptr;
+    _size = 0;
+    _entries.clear();
+}
+
+} // namespace saber
+
+} // namespace anakin
@@ -0,0 +1,117 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_CORE_WEIGHT_CACHE_H
+#define ANAKIN_SABER_CORE_WEIGHT_CACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include "saber/core/common.h"
+
+namespace anakin {
+
+namespace saber {
+
+/**
+ *  \brief File of derived weights (reordered, pre-packed, transformed) persisted across processes.
+ *
+ *   Kernels build their derived weights at init, every process start does it again. With a
+ *   cache made current on the initializing thread (WeightCache::Scope, see Net::set_weights_cache),
+ *   load_or_build reads them from the cache file instead and stores the ones it had to build;
+ *   save() writes those to the file for the next start.
+ *   Entries are keyed by the cpu isa, the kernel and format, the full fingerprint of the source
+ *   weights and the attributes of the derivation, a cache of another model or machine just misses.
+ */
+class WeightCache {
+public:
+    ~WeightCache();
+
+    /// open the cache file at path, created on save if it doesn't exist. Caches are shared per path.
+    static std::shared_ptr<WeightCache> open(const std::string& path);
+
+    /// cache of the calling thread, nullptr if none.
+    static WeightCache* current();
+
+    /**
+     *  \brief Make cache current on the calling thread for the scope.
+     */
+    class Scope {
+    public:
+        explicit Scope(std::shared_ptr<WeightCache> cache);
+        ~Scope();
+    private:
+        WeightCache* _prev{nullptr};
+    };
+
+    /**
+     *  \brief Key of derived weights, stable across processes.
+     *  \param kind kernel and format of the derived weights, e.g. "jit_avx2_conv/OIhwi8o".
+     *  \param src source weights and their size in bytes, the content is fingerprinted.
+     *  \param attrs everything else the derivation depends on (dims, transpose flags, scales).
+     */
+    static std::string make_key(const std::string& kind, const void* src, size_t src_bytes,
+                                const std::vector<float>& attrs = std::vector<float>());
+
+    /**
+     *  \brief Fill dst with the derived weights from the current cache, or build them into dst.
+     *   Built weights are stored in the current cache, without one it is just build().
+     */
+    static void load_or_build(const std::string& kind, const void* src, size_t src_bytes,
+                              const std::vector<float>& attrs, void* dst, size_t bytes,
+                              std::function<void()> build);
+
+    /// copy the weights of key to dst, return false if there are none of bytes size.
+    bool load(const std::string& key, void* dst, size_t bytes);
+
+    /// store weights with key, they are written by save().
+    void store(const std::string& key, const void* src, size_t bytes);
+
+    /// write the stored weights to the file, return false on failure.
+    bool save();
+
+    int hits() const { return _hits; }
+    int misses() const { return _misses; }
+    const std::string& path() const { return _path; }
+
+private:
+    explicit WeightCache(const std::string& path) : _path(path) {}
+
+    /// map the cache file, an absent or invalid file gives an empty cache.
+    void map();
+    void unmap();
+
+    struct Entry {
+        const char* data{nullptr};
+        size_t bytes{0};
+    };
+    std::string _path;
+    std::mutex _mut;
+    void* _addr{nullptr};
+    size_t _size{0};
+    std::map<std::string, Entry> _entries;      ///< entries in the mapped file
+    std::map<std::string, std::string> _stored; ///< entries to save
+    int _hits{0};
+    int _misses{0};
+};
+
+} // namespace saber
+
+} // namespace anakin
+
+#endif
@@ -0,0 +1,114 @@
+#include "saber/core/weight_registry.h"
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <cstring>
+
+namespace anakin {
+
+namespace saber {
+
+const size_t WeightRegistry::kMinPurgeSize;
+
+WeightRegistry& WeightRegistry::global() {
+    static WeightRegistry registry;
+    return registry;
+}
+
+unsigned long long WeightRegistry::fingerprint(const void* src, size_t src_bytes, size_t max_samples) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(src);
+    size_t words = src_bytes / sizeof(unsigned int);
+    size_t step = (max_samples > 0 && words > max_samples) ? words / max_samples : 1;
+    unsigned long long hash = 1469598103934665603ULL;
+    for (size_t i = 0; src != nullptr && i < words; i += step) {
+        unsigned int word = 0;
+        memcpy(&word, bytes + i * sizeof(unsigned int), sizeof(unsigned int));
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for (size_t i = words * sizeof(unsigned int); src != nullptr && i < src_bytes; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string WeightRegistry::make_key(const std::string& kind, const void* src, size_t src_bytes,
+                                     const std::vector<float>& attrs) {
+    // the whole source is hashed: sampled words miss weights changed in place, and the
+    // address would keep equal weights of different buffers (e.g. cloned nets) apart.
+    unsigned long long hash = fingerprint(src, src_bytes);
+    std::ostringstream key;
+    key << kind << "#" << src_bytes << ":" << std::hex << hash << std::dec
+        << std::setprecision(std::numeric_limits<float>::max_digits10);
+    for (auto attr : attrs) {
+        key << ":" << attr;
+    }
+    return key.str();
+}
+
+size_t WeightRegistry::shared_bytes() {
+    std::lock_guard<std::mutex> lock(_mut);
+    size_t sum = 0;
+    for (auto& pair : _entries) {
+        if (!pair.second.weights.expired()) {
+            sum += pair.second.bytes;
+        }
+    }
+    return sum;
+}
+
+size_t WeightRegistry::unshared_bytes() {
+    std::lock_guard<std::mutex> lock(_mut);
+    size_t sum = 0;
+    for (auto& pair : _entries) {
+        sum += pair.second.bytes * pair.second.weights.use_count();
+    }
+    return sum;
+}
+
+std::string WeightRegistry::report() {
+    std::lock_guard<std::mutex> lock(_mut);
+    struct Summary {
+        int entries{0};
+        long users{0};
+        size_t bytes{0};
+        size_t saved{0};
+    };
+    std::map<std::string, Summary> kinds;
+    for (auto& pair : _entries) {
+        long users = pair.second.weights.use_count();
+        if (users == 0) {
+            continue;
+        }
+        auto& summary = kinds[pair.second.kind];
+        summary.entries++;
+        summary.users += users;
+        summary.bytes += pair.second.bytes;
+        summary.saved += pair.second.bytes * (users - 1);
+    }
+    std::ostringstream msg;
+    for (auto& pair : kinds) {
+        msg << pair.first << ": " << pair.second.entries << " weights, " << pair.second.users
+            << " users, stored " << pair.second.bytes / 1024.0 / 1024.0 << " MB, saved "
+            << pair.second.saved / 1024.0 / 1024.0 << " MB\n";
+    }
+    return msg.str();
+}
+
+void WeightRegistry::purge() {
+    std::lock_guard<std::mutex> lock(_mut);
+    purge_expired();
+}
+
+void WeightRegistry::purge_expired() {
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.weights.expired() && !it->second.build) {
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace saber
+
+} // namespace anakin
@@ -0,0 +1,163 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_CORE_WEIGHT_REGISTRY_H
+#define ANAKIN_SABER_CORE_WEIGHT_REGISTRY_H
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include <future>
+#include "saber/core/common.h"
+
+namespace anakin {
+
+namespace saber {
+
+/**
+ *  \brief Process wide registry of read-only weights derived at init (reordered or pre-packed).
+ *
+ *   Kernels ask the registry for the derived weights by a key built from the kernel name,
+ *   the source weights and everything else the derivation depends on. The first caller
+ *   builds them, the others (every thread's Net, Net::Clone) get the same copy. The registry
+ *   only holds weak references, the memory goes away with the last kernel using it.
+ *   Note: the shared weights are read-only, kernels must never write them after build.
+ */
+class WeightRegistry {
+public:
+    static WeightRegistry& global();
+
+    /**
+     *  \brief Build the key of derived weights.
+     *  \param kind kernel and format of the derived weights, e.g. "jit_avx2_conv/OIhwi8o".
+     *  \param src source weights and their size in bytes, the whole content is hashed, so
+     *   equal weights share wherever they live and weights changed in place don't.
+     *  \param attrs everything else the derivation depends on (dims, transpose flags, scales),
+     *   printed with full float precision.
+     */
+    static std::string make_key(const std::string& kind, const void* src, size_t src_bytes,
+                                const std::vector<float>& attrs = std::vector<float>());
+
+    /**
+     *  \brief fnv-1a hash of src, over at most max_samples words spread over it (0 for all words).
+     */
+    static unsigned long long fingerprint(const void* src, size_t src_bytes, size_t max_samples = 0);
+
+    /**
+     *  \brief Return the weights registered with key, build them with create if there are none.
+     *   The first caller of a key builds without holding the registry, so different keys build
+     *   concurrently; the other callers of the key wait for its build. Entries whose weights
+     *   are gone are purged along the way.
+     *  \param bytes size of the built weights, used by the memory report.
+     *  \return read-only weights.
+     */
+    template <typename T>
+    std::shared_ptr<const T> get_or_create(const std::string& key, size_t bytes,
+                                          std::function<std::shared_ptr<T>()> create) {
+        std::shared_ptr<Build> build;
+        bool builder = false;
+        {
+            std::lock_guard<std::mutex> lock(_mut);
+            if (_entries.size() >= _purge_size) {
+                purge_expired();
+                _purge_size = std::max<size_t>(kMinPurgeSize, 2 * _entries.size());
+            }
+            auto& entry = _entries[key];
+            auto weights = entry.weights.lock();
+            if (weights) {
+                entry.hits++;
+                return std::static_pointer_cast<const T>(weights);
+            }
+            if (!entry.build) {
+                entry.kind = key.substr(0, key.find('#'));
+                entry.bytes = bytes;
+                entry.build = std::make_shared<Build>();
+                builder = true;
+            } else {
+                entry.hits++;
+            }
+            build = entry.build;
+        }
+        if (!builder) {
+            return std::static_pointer_cast<const T>(build->weights.get());
+        }
+        std::shared_ptr<T> weights;
+        try {
+            weights = create();
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(_mut);
+                _entries[key].build.reset();
+            }
+            build->done.set_exception(std::current_exception());
+            throw;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mut);
+            auto& entry = _entries[key];
+            entry.weights = weights;
+            entry.build.reset();
+        }
+        build->done.set_value(weights);
+        return weights;
+    }
+
+    /// bytes of alive shared weights.
+    size_t shared_bytes();
+
+    /// bytes the alive shared weights would take if every user had its own copy.
+    size_t unshared_bytes();
+
+    /// one line per kind of alive weights: entries, users, bytes stored and bytes saved.
+    std::string report();
+
+    /// drop the entries whose weights are gone.
+    void purge();
+
+private:
+    WeightRegistry() {}
+
+    /// drop the entries whose weights are gone and nobody builds, _mut must be held.
+    void purge_expired();
+
+    /// build of a key in progress, the other callers of the key wait for its weights.
+    struct Build {
+        std::promise<std::shared_ptr<void> > done;
+        std::shared_future<std::shared_ptr<void> > weights{done.get_future().share()};
+    };
+    struct Entry {
+        std::string kind;
+        std::weak_ptr<void> weights;
+        size_t bytes{0};
+        int hits{0};
+        ///< set while the first caller builds the weights.
+        std::shared_ptr<Build> build;
+    };
+    ///< entries purged by get_or_create at least at this size, it doubles with the live entries.
+    static const size_t kMinPurgeSize = 256;
+    std::mutex _mut;
+    std::map<std::string, Entry> _entries;
+    size_t _purge_size{kMinPurgeSize};
+};
+
+} // namespace saber
+
+} // namespace anakin
+
+#endif
@@ -0,0 +1,106 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef ANAKIN_SABER_FUNCS_EMBEDDING_SEQ_POOL_H
+#define ANAKIN_SABER_FUNCS_EMBEDDING_SEQ_POOL_H
+
+#include "saber/funcs/base.h"
+#include "saber/funcs/impl/impl_base.h"
+#include "saber/funcs/impl/impl_embedding_seq_pool.h"
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/saber_embedding_seq_pool.h"
+#endif
+
+namespace anakin {
+namespace saber {
+
+/**
+ *  \brief Embedding lookup followed by a sequence pool, without the [words, emb_dim] tensor
+ *   in between: the rows of each sequence are expanded and pooled straight into its output row.
+ */
+template<typename TargetType,
+        DataType OpDtype>
+class EmbeddingSeqPool : public BaseFunc<
+        TargetType,
+        OpDtype,
+        ImplBase,
+        EmbeddingSeqPoolParam> {
+public:
+    using BaseFunc<
+            TargetType,
+            OpDtype,
+            ImplBase,
+            EmbeddingSeqPoolParam>::BaseFunc;
+
+    EmbeddingSeqPool() = default;
+
+    typedef Tensor<TargetType> InDataTensor;
+    typedef Tensor<TargetType> OutDataTensor;
+    typedef Tensor<TargetType> OpTensor;
+    typedef EmbeddingSeqPoolParam<TargetType> Param_t;
+    typedef std::vector<InDataTensor *> Input_v;
+    typedef std::vector<OutDataTensor *> Output_v;
+    typedef std::vector<Shape> Shape_v;
+
+    virtual SaberStatus compute_output_shape(const Input_v &input,
+                                             Output_v &output, Param_t &param) override {
+        // one row per sequence, each row is a sequence of its own as after the sequence pool
+        std::vector<std::vector<int> > offset = input[0]->get_seq_offset();
+        int seq_num = input[0]->valid_size();
+        if (offset.size() >= 1 && offset[0].size() > 1) {
+            seq_num = offset[0].size() - 1;
+        }
+        Shape output_shape({seq_num, param.embedding.emb_dim, 1, 1}, Layout_NCHW);
+        std::vector<int> offset_new(seq_num + 1);
+        for (int i = 0; i <= seq_num; i++) {
+            offset_new[i] = i;
+        }
+        output[0]->set_seq_offset({offset_new});
+        return output[0]->set_shape(output_shape);
+    }
+
+    virtual SaberStatus init_impl(ImplEnum implenum) override {
+        switch (implenum) {
+            case VENDER_IMPL:
+                this->_impl.push_back(new VenderEmbeddingSeqPool <TargetType, OpDtype>);
+                return SaberSuccess;
+
+            case SABER_IMPL:
+                this->_impl.push_back(new SaberEmbeddingSeqPool <TargetType, OpDtype>);
+                return SaberSuccess;
+
+            default:
+                return SaberUnImplError;
+        }
+    }
+
+private:
+
+    virtual void pick_best_static() override {
+        this->_best_impl = this->_impl[0];
+    }
+
+    virtual void pick_best_specify(ImplEnum implenum) override {
+        this->_best_impl = this->_impl[0];
+    }
+
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif
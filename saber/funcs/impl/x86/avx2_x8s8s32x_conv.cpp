@@ -0,0 +1,558 @@
+#include "saber/funcs/impl/x86/avx2_x8s8s32x_conv.h"
+#include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/core/weight_registry.h"
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+
+namespace anakin {
+namespace saber {
+
+using namespace jit;
+
+namespace {
+
+const int kOcBlock = 16;
+const int kPixBlock = 4;
+const int kRowsPerTask = 64;
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+/// the 4 input channels of a quad as an int32, the missing ones of the last quad are zero.
+inline int32_t load_quad(const uint8_t* src, int channels) {
+    int32_t quad = 0;
+    memcpy(&quad, src, channels);
+    return quad;
+}
+
+/**
+ *  \brief acc[2p], acc[2p + 1] += the 16 output channels of pixel p over the taps.
+ *   The input of pixel p and tap j is at img + pix_off[p] + tap_off[j], the weights of the tap
+ *   are the tap_idx[j]-th [ic_quads][16][4] block of wei.
+ */
+template <int P, bool SignedInput>
+inline void accumulate(const uint8_t* img, const ptrdiff_t* pix_off, const ptrdiff_t* tap_off,
+                       const int* tap_idx, int taps, int ic, int ic_quads, const int8_t* wei,
+                       __m256i* acc) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i even_bytes = _mm256_set1_epi16(0x00ff);
+    const int full_quads = ic / 4;
+    const int tail = ic % 4;
+
+    for (int j = 0; j < taps; j++) {
+        const int8_t* w = wei + static_cast<ptrdiff_t>(tap_idx[j]) * ic_quads * 64;
+        const uint8_t* src[P];
+
+        for (int p = 0; p < P; p++) {
+            src[p] = img + (pix_off[p] + tap_off[j]);
+        }
+
+        for (int q = 0; q < ic_quads; q++) {
+            __m256i w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + q * 64));
+            __m256i w1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + q * 64 + 32));
+
+            for (int p = 0; p < P; p++) {
+                __m256i a = _mm256_set1_epi32(load_quad(src[p] + q * 4, q < full_quads ? 4 : tail));
+                __m256i s0 = w0;
+                __m256i s1 = w1;
+
+                if (SignedInput) {
+                    // |a| * (w with the sign of a): |a| <= 128 and |w| <= 127, so a pair of
+                    // vpmaddubsw is at most 2 * 128 * 127 and never saturates int16.
+                    s0 = _mm256_sign_epi8(w0, a);
+                    s1 = _mm256_sign_epi8(w1, a);
+                    a = _mm256_abs_epi8(a);
+                    s0 = _mm256_madd_epi16(_mm256_maddubs_epi16(a, s0), ones);
+                    s1 = _mm256_madd_epi16(_mm256_maddubs_epi16(a, s1), ones);
+                } else {
+                    // a pair of u8 inputs reaches 2 * 255 * 127 and would saturate int16,
+                    // the even and the odd channels go through vpmaddubsw one at a time.
+                    __m256i a_even = _mm256_and_si256(a, even_bytes);
+                    __m256i a_odd = _mm256_andnot_si256(even_bytes, a);
+                    s0 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_maddubs_epi16(a_even, w0), ones),
+                                          _mm256_madd_epi16(_mm256_maddubs_epi16(a_odd, w0), ones));
+                    s1 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_maddubs_epi16(a_even, w1), ones),
+                                          _mm256_madd_epi16(_mm256_maddubs_epi16(a_odd, w1), ones));
+                }
+
+                acc[2 * p] = _mm256_add_epi32(acc[2 * p], s0);
+                acc[2 * p + 1] = _mm256_add_epi32(acc[2 * p + 1], s1);
+            }
+        }
+    }
+}
+
+inline __m256 load_prev(const void* src, DataType dt) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    __m256i prev = dt == AK_INT8 ? _mm256_cvtepi8_epi32(bytes) : _mm256_cvtepu8_epi32(bytes);
+    return _mm256_cvtepi32_ps(prev);
+}
+
+inline void store_int(__m256i v, void* dst, DataType dt) {
+    __m128i lo = _mm256_castsi256_si128(v);
+    __m128i hi = _mm256_extracti128_si256(v, 1);
+    __m128i half = _mm_packs_epi32(lo, hi);
+    __m128i bytes = dt == AK_INT8 ? _mm_packs_epi16(half, half) : _mm_packus_epi16(half, half);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), bytes);
+}
+
+/**
+ *  \brief The epilogue of the avx512 kernels on 16 output channels: bias, requantize scale,
+ *   relu (before the sum if there is none), sum of the previous output, relu after the sum,
+ *   rounding and saturation. n_oc < 16 goes through a buffer.
+ */
+template <typename OutputDtype>
+void store_block(const __m256i* acc, const float* bias, const float* scale,
+                 const jit_conv_conf_t& jcp, OutputDtype* dst, int n_oc) {
+    OutputDtype buf[kOcBlock];
+    OutputDtype* out = n_oc == kOcBlock ? dst : buf;
+
+    if (jcp.with_sum && n_oc != kOcBlock) {
+        memset(buf, 0, sizeof(buf));
+        memcpy(buf, dst, n_oc * sizeof(OutputDtype));
+    }
+
+    const bool relu_first = jcp.with_relu && !jcp.with_sum;
+    const bool relu_last = jcp.with_sum && (jcp.with_relu || jcp.dst_dt == AK_UINT8);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 sum_scale = _mm256_set1_ps(jcp.sum_scale);
+    const __m256 lo = _mm256_set1_ps(jcp.dst_dt == AK_INT8 ? -128.f : 0.f);
+    const __m256 hi = _mm256_set1_ps(jcp.dst_dt == AK_INT8 ? 127.f : 255.f);
+
+    for (int h = 0; h < 2; h++) {
+        __m256 d = _mm256_cvtepi32_ps(acc[h]);
+        d = _mm256_add_ps(d, _mm256_loadu_ps(bias + h * 8));
+        d = _mm256_mul_ps(d, _mm256_loadu_ps(scale + h * 8));
+
+        if (relu_first) {
+            d = _mm256_max_ps(d, zero);
+        }
+
+        if (jcp.with_sum) {
+            __m256 prev = load_prev(out + h * 8, jcp.sum_dt);
+            d = jcp.sum_scale == 1.f ? _mm256_add_ps(d, prev) : _mm256_fmadd_ps(prev, sum_scale, d);
+        }
+
+        if (relu_last) {
+            d = _mm256_max_ps(d, zero);
+        }
+
+        if (jcp.dst_dt == AK_FLOAT) {
+            _mm256_storeu_ps(reinterpret_cast<float*>(out + h * 8), d);
+        } else {
+            if (jcp.rm == round_mode::down) {
+                d = _mm256_floor_ps(d);
+            }
+
+            d = _mm256_min_ps(_mm256_max_ps(d, lo), hi);
+            store_int(_mm256_cvtps_epi32(d), out + h * 8, jcp.dst_dt);
+        }
+    }
+
+    if (out != dst) {
+        memcpy(dst, buf, n_oc * sizeof(OutputDtype));
+    }
+}
+
+template <int P, bool SignedInput, typename OutputDtype>
+inline void compute_pixels(const uint8_t* img, const ptrdiff_t* pix_off, const ptrdiff_t* tap_off,
+                           const int* tap_idx, int taps, const int8_t* wei, const float* bias,
+                           const float* scale, const jit_conv_conf_t& jcp, int ic_quads,
+                           OutputDtype* dst, ptrdiff_t dst_pix_stride, int n_oc) {
+    __m256i acc[2 * P];
+
+    for (int i = 0; i < 2 * P; i++) {
+        acc[i] = _mm256_setzero_si256();
+    }
+
+    accumulate<P, SignedInput>(img, pix_off, tap_off, tap_idx, taps, jcp.ic, ic_quads, wei, acc);
+
+    for (int p = 0; p < P; p++) {
+        store_block(acc + 2 * p, bias, scale, jcp, dst + p * dst_pix_stride, n_oc);
+    }
+}
+
+#endif
+
+} // namespace
+
+bool Avx2X8S8S32XConv::available(const ConvParam<X86>& param) {
+#if defined(__AVX2__) && defined(__FMA__)
+    return param.group == 1;
+#else
+    return false;
+#endif
+}
+
+SaberStatus Avx2X8S8S32XConv::init(const std::vector<Tensor<X86>*>& inputs,
+                                   std::vector<Tensor<X86>*>& outputs,
+                                   ConvEltwiseParam<X86>& param,
+                                   Context<X86>& ctx) {
+    this->_ctx = &ctx;
+    ConvParam<X86>* conv_param = &(param.conv_param);
+
+    if (!available(*conv_param)) {
+        return SaberUnImplError;
+    }
+
+    CHECK_GT(inputs[0]->get_scale().size(), 0) << "input scale must >0";
+    CHECK(outputs[0]->get_scale().size() > 0 || outputs[0]->get_dtype() == AK_FLOAT) << "output scale must >0";
+
+    Tensor<X86>* weights_orig = conv_param->mutable_weight();
+
+    if (weights_orig->get_dtype() == AK_FLOAT) {
+        _weights_scale.re_alloc(weights_orig->valid_shape(), AK_INT8);
+        utils::ScaleUtils::scale_conv_weights_to_nchw_host(_weights_scale, *conv_param->weight());
+        weights_orig = &_weights_scale;
+    }
+
+    CHECK_EQ(weights_orig->get_dtype(), AK_INT8);
+    Shape wgt_shape = weights_orig->valid_shape();
+    int oc = wgt_shape.num();
+    int ic = wgt_shape.channel();
+    int taps = wgt_shape.height() * wgt_shape.width();
+    _oc_blocks = (oc + kOcBlock - 1) / kOcBlock;
+    _ic_quads = (ic + 3) / 4;
+
+    // oihw to [oc / 16][hw][ic / 4][16 oc][4 ic], -128 is clamped for the sign trick of s8 inputs.
+    size_t count = static_cast<size_t>(_oc_blocks) * taps * _ic_quads * kOcBlock * 4;
+    const int8_t* src = static_cast<const int8_t*>(weights_orig->data());
+    // keyed by the model weights, the int8 ones quantized from fp32 are per instance.
+    const Tensor<X86>* weights_model = conv_param->weight();
+    std::vector<float> weights_attrs = {(float)oc, (float)ic, (float)wgt_shape.height(), (float)wgt_shape.width(),
+                                        (float)weights_model->get_dtype()};
+    std::vector<float> scales = weights_orig->get_scale();
+    weights_attrs.insert(weights_attrs.end(), scales.begin(), scales.end());
+    std::string key = WeightRegistry::make_key("avx2_x8s8s32x_conv/OhwI16o4i", weights_model->data(),
+                      weights_model->valid_size() * type_length(weights_model->get_dtype()), weights_attrs);
+    _packed_weights = WeightRegistry::global().get_or_create<std::vector<int8_t> >(key, count, [&]() {
+        auto packed = std::make_shared<std::vector<int8_t> >(count, 0);
+        int8_t* dst = packed->data();
+
+        #pragma omp parallel for schedule(static)
+        for (int o = 0; o < oc; o++) {
+            for (int i = 0; i < ic; i++) {
+                for (int t = 0; t < taps; t++) {
+                    int8_t w = src[(static_cast<size_t>(o) * ic + i) * taps + t];
+                    size_t idx = ((static_cast<size_t>(o / kOcBlock) * taps + t) * _ic_quads + i / 4) * kOcBlock * 4
+                                 + (o % kOcBlock) * 4 + i % 4;
+                    dst[idx] = w < -127 ? -127 : w;
+                }
+            }
+        }
+
+        return packed;
+    });
+
+    // bias in units of the s32 sums
+    _bias.assign(_oc_blocks * kOcBlock, 0.f);
+    const Tensor<X86>* bias_src = conv_param->bias();
+
+    if (bias_src != nullptr && bias_src->valid_size() > 0) {
+        CHECK_EQ(bias_src->get_dtype(), AK_FLOAT);
+        auto weights_scale = weights_orig->get_scale();
+        float in_scale = inputs[0]->get_scale()[0];
+        float fin = 1.f;
+
+        if (inputs[0]->get_dtype() == AK_UINT8) {
+            fin = 127.f / 255.f;
+        } else if (inputs[0]->get_dtype() != AK_INT8) {
+            LOG(FATAL) << "not support input dtype " << inputs[0]->get_dtype();
+        }
+
+        const float* bias_data = static_cast<const float*>(bias_src->data());
+
+        for (int i = 0; i < bias_src->valid_size(); i++) {
+            _bias[i] = bias_data[i] * (1.f / (weights_scale[i] * in_scale * fin));
+        }
+    }
+
+    return create(inputs, outputs, param, ctx);
+}
+
+SaberStatus Avx2X8S8S32XConv::create(const std::vector<Tensor<X86>*>& inputs,
+                                     std::vector<Tensor<X86>*>& outputs,
+                                     ConvEltwiseParam<X86>& param,
+                                     Context<X86>& ctx) {
+    this->_ctx = &ctx;
+    ConvParam<X86>* conv_param = &(param.conv_param);
+    EltwiseParam<X86>* eltwise_param = &(param.eltwise_param);
+    Tensor<X86>* input = inputs[0];
+    Tensor<X86>* output = outputs[0];
+    const Tensor<X86>* weights = conv_param->weight();
+    Shape src_shape(input->valid_shape());
+    Shape dst_shape(output->valid_shape());
+    Shape wgt_shape(weights->valid_shape());
+
+    jcp = jit_conv_conf_t();
+    jcp.ngroups = 1;
+    jcp.mb = src_shape.num();
+    jcp.ic = src_shape.channel();
+    jcp.ih = src_shape.height();
+    jcp.iw = src_shape.width();
+    jcp.oc = dst_shape.channel();
+    jcp.oh = dst_shape.height();
+    jcp.ow = dst_shape.width();
+    jcp.kh = wgt_shape.height();
+    jcp.kw = wgt_shape.width();
+    jcp.stride_h = conv_param->stride_h;
+    jcp.stride_w = conv_param->stride_w;
+    jcp.t_pad = conv_param->pad_h;
+    jcp.l_pad = conv_param->pad_w;
+    jcp.dilate_h = conv_param->dilation_h <= 0 ? 0 : (conv_param->dilation_h - 1);
+    jcp.dilate_w = conv_param->dilation_w <= 0 ? 0 : (conv_param->dilation_w - 1);
+    jcp.signed_input = input->get_dtype() == AK_INT8;
+    jcp.dst_dt = output->get_dtype();
+    jcp.rm = conv_param->rm;
+    jcp.with_bias = conv_param->bias() != nullptr && conv_param->bias()->valid_size() > 0;
+    jcp.with_relu = conv_param->activation_param.has_active;
+    jcp.with_sum = eltwise_param->has_eltwise && (eltwise_param->operation == Eltwise_sum);
+    jcp.sum_scale = 1.f;
+
+    if (jcp.ic != wgt_shape.channel() || jcp.oc != wgt_shape.num()) {
+        LOG(ERROR) << "the avx2 int8 conv only supports group 1";
+        return SaberUnImplError;
+    }
+
+    if (jcp.with_relu && conv_param->activation_param.active != Active_relu) {
+        LOG(ERROR) << "the avx2 int8 conv only fuses relu";
+        return SaberUnImplError;
+    }
+
+    if (jcp.rm != round_mode::nearest && jcp.rm != round_mode::down) {
+        LOG(ERROR) << "unsupported round mode " << jcp.rm;
+        return SaberUnImplError;
+    }
+
+    float scale_out = 1.f;
+
+    if (output->get_scale().size() > 0 && jcp.dst_dt != AK_FLOAT) {
+        scale_out = output->get_scale()[0];
+    }
+
+    if (jcp.with_sum) {
+        CHECK_EQ(output->get_scale().size(), 1);
+        DataType be_added_type = conv_param->beta_type;
+        CHECK(be_added_type == AK_INT8 || be_added_type == AK_UINT8);
+
+        if (be_added_type == AK_INT8 && jcp.dst_dt == AK_UINT8) {
+            _sum_scale = conv_param->beta * (255.f / 127.f) / scale_out;
+        } else if (be_added_type == AK_UINT8 && jcp.dst_dt == AK_INT8) {
+            _sum_scale = conv_param->beta * (127.f / 255.f) / scale_out;
+        } else if (be_added_type == jcp.dst_dt) {
+            _sum_scale = conv_param->beta / scale_out;
+        } else {
+            LOG(FATAL) << "not support type " << be_added_type << ":" << jcp.dst_dt;
+        }
+
+        jcp.sum_scale = _sum_scale;
+        jcp.sum_dt = be_added_type;
+        jcp.with_relu = eltwise_param->activation_param.has_active;
+    }
+
+    _is_1x1 = jcp.kh == 1 && jcp.kw == 1 && jcp.stride_h == 1 && jcp.stride_w == 1
+              && jcp.t_pad == 0 && jcp.l_pad == 0 && jcp.ih == jcp.oh && jcp.iw == jcp.ow;
+
+    // requantize scale of the s32 sums, padded to the oc blocks
+    float scale_in = input->get_scale()[0];
+    float fin = input->get_dtype() == AK_UINT8 ? 127.f / 255.f : 1.f;
+    float fout = jcp.dst_dt == AK_UINT8 ? 127.f / 255.f : 1.f;
+
+    if (input->get_dtype() != AK_INT8 && input->get_dtype() != AK_UINT8) {
+        LOG(FATAL) << "can`t cal scale for dtype " << input->get_dtype() << "," << jcp.dst_dt;
+    }
+
+    auto scale_w = conv_param->weight()->get_dtype() == AK_FLOAT ? _weights_scale.get_scale()
+                   : conv_param->weight()->get_scale();
+    CHECK_EQ(scale_w.size(), jcp.oc) << "weights need a scale per output channel";
+    _scale.assign(_oc_blocks * kOcBlock, 0.f);
+
+    for (int i = 0; i < jcp.oc; i++) {
+        _scale[i] = (scale_w[i] * scale_in * fin) / (scale_out * fout);
+    }
+
+    return SaberSuccess;
+}
+
+template <bool SignedInput, typename OutputDtype>
+SaberStatus Avx2X8S8S32XConv::sub_dispatch(const std::vector<Tensor<X86>*>& inputs,
+        std::vector<Tensor<X86>*>& outputs) {
+#if defined(__AVX2__) && defined(__FMA__)
+    const uint8_t* src = static_cast<const uint8_t*>(inputs[0]->data());
+    OutputDtype* dst = static_cast<OutputDtype*>(outputs[0]->mutable_data());
+    const int8_t* wei = _packed_weights->data();
+    const jit_conv_conf_t& conf = jcp;
+    const int ic_quads = _ic_quads;
+    const int oc_blocks = _oc_blocks;
+    const int taps = conf.kh * conf.kw;
+    const size_t wei_block = static_cast<size_t>(taps) * ic_quads * kOcBlock * 4;
+    const float* bias = _bias.data();
+    const float* scale = _scale.data();
+
+    if (_is_1x1) {
+        // [pixels, ic] x [ic, oc]
+        const ptrdiff_t tap_off = 0;
+        const int tap_idx = 0;
+        const int pixels = conf.mb * conf.oh * conf.ow;
+        const int tasks = (pixels + kRowsPerTask - 1) / kRowsPerTask;
+
+        #pragma omp parallel for collapse(2) schedule(static)
+        for (int task = 0; task < tasks; task++) {
+            for (int ocb = 0; ocb < oc_blocks; ocb++) {
+                const int8_t* w = wei + ocb * wei_block;
+                int n_oc = std::min(kOcBlock, conf.oc - ocb * kOcBlock);
+                int end = std::min(pixels, (task + 1) * kRowsPerTask);
+                int pix = task * kRowsPerTask;
+                ptrdiff_t pix_off[kPixBlock];
+
+                for (; pix + kPixBlock <= end; pix += kPixBlock) {
+                    for (int p = 0; p < kPixBlock; p++) {
+                        pix_off[p] = static_cast<ptrdiff_t>(pix + p) * conf.ic;
+                    }
+
+                    compute_pixels<kPixBlock, SignedInput>(src, pix_off, &tap_off, &tap_idx, 1, w,
+                                                           bias + ocb * kOcBlock, scale + ocb * kOcBlock, conf, ic_quads,
+                                                           dst + static_cast<ptrdiff_t>(pix) * conf.oc + ocb * kOcBlock, conf.oc, n_oc);
+                }
+
+                for (; pix < end; pix++) {
+                    pix_off[0] = static_cast<ptrdiff_t>(pix) * conf.ic;
+                    compute_pixels<1, SignedInput>(src, pix_off, &tap_off, &tap_idx, 1, w,
+                                                   bias + ocb * kOcBlock, scale + ocb * kOcBlock, conf, ic_quads,
+                                                   dst + static_cast<ptrdiff_t>(pix) * conf.oc + ocb * kOcBlock, conf.oc, n_oc);
+                }
+            }
+        }
+
+        return SaberSuccess;
+    }
+
+    // direct: the taps of an output row, all of them for the pixels away from the left and right
+    // padding, the ones inside the input for the others.
+    const int dh = conf.dilate_h + 1;
+    const int dw = conf.dilate_w + 1;
+    int ow_lo = std::min(conf.ow, (conf.l_pad + conf.stride_w - 1) / conf.stride_w);
+    int last_w = conf.iw - 1 + conf.l_pad - (conf.kw - 1) * dw;
+    int ow_hi = last_w < 0 ? 0 : std::min(conf.ow, last_w / conf.stride_w + 1);
+    ow_hi = std::max(ow_hi, ow_lo);
+    const size_t img_stride = static_cast<size_t>(conf.ih) * conf.iw * conf.ic;
+
+    #pragma omp parallel
+    {
+        std::vector<ptrdiff_t> row_off(taps);
+        std::vector<int> row_idx(taps);
+        std::vector<int> row_kw(taps);
+        std::vector<ptrdiff_t> pix_taps_off(taps);
+        std::vector<int> pix_taps_idx(taps);
+
+        #pragma omp for collapse(3) schedule(static)
+        for (int n = 0; n < conf.mb; n++) {
+            for (int oh = 0; oh < conf.oh; oh++) {
+                for (int ocb = 0; ocb < oc_blocks; ocb++) {
+                    const uint8_t* img = src + n * img_stride;
+                    const int8_t* w = wei + ocb * wei_block;
+                    int n_oc = std::min(kOcBlock, conf.oc - ocb * kOcBlock);
+                    OutputDtype* dst_row = dst + (static_cast<ptrdiff_t>(n) * conf.oh + oh) * conf.ow * conf.oc
+                                           + ocb * kOcBlock;
+                    int ih0 = oh * conf.stride_h - conf.t_pad;
+                    int row_taps = 0;
+
+                    for (int kh = 0; kh < conf.kh; kh++) {
+                        int ih = ih0 + kh * dh;
+
+                        if (ih < 0 || ih >= conf.ih) {
+                            continue;
+                        }
+
+                        for (int kw = 0; kw < conf.kw; kw++) {
+                            row_off[row_taps] = (static_cast<ptrdiff_t>(ih) * conf.iw + kw * dw) * conf.ic;
+                            row_idx[row_taps] = kh * conf.kw + kw;
+                            row_kw[row_taps] = kw;
+                            row_taps++;
+                        }
+                    }
+
+                    ptrdiff_t pix_off[kPixBlock];
+                    auto border_pixel = [&](int ow) {
+                        int iw0 = ow * conf.stride_w - conf.l_pad;
+                        int pix_taps = 0;
+
+                        for (int j = 0; j < row_taps; j++) {
+                            int iw = iw0 + row_kw[j] * dw;
+
+                            if (iw >= 0 && iw < conf.iw) {
+                                pix_taps_off[pix_taps] = row_off[j];
+                                pix_taps_idx[pix_taps] = row_idx[j];
+                                pix_taps++;
+                            }
+                        }
+
+                        pix_off[0] = static_cast<ptrdiff_t>(iw0) * conf.ic;
+                        compute_pixels<1, SignedInput>(img, pix_off, pix_taps_off.data(), pix_taps_idx.data(), pix_taps,
+                                                       w, bias + ocb * kOcBlock, scale + ocb * kOcBlock, conf, ic_quads,
+                                                       dst_row + static_cast<ptrdiff_t>(ow) * conf.oc, conf.oc, n_oc);
+                    };
+
+                    for (int ow = 0; ow < ow_lo; ow++) {
+                        border_pixel(ow);
+                    }
+
+                    int ow = ow_lo;
+
+                    for (; ow + kPixBlock <= ow_hi; ow += kPixBlock) {
+                        for (int p = 0; p < kPixBlock; p++) {
+                            pix_off[p] = static_cast<ptrdiff_t>((ow + p) * conf.stride_w - conf.l_pad) * conf.ic;
+                        }
+
+                        compute_pixels<kPixBlock, SignedInput>(img, pix_off, row_off.data(), row_idx.data(), row_taps,
+                                                               w, bias + ocb * kOcBlock, scale + ocb * kOcBlock, conf, ic_quads,
+                                                               dst_row + static_cast<ptrdiff_t>(ow) * conf.oc, conf.oc, n_oc);
+                    }
+
+                    for (; ow < ow_hi; ow++) {
+                        pix_off[0] = static_cast<ptrdiff_t>(ow * conf.stride_w - conf.l_pad) * conf.ic;
+                        compute_pixels<1, SignedInput>(img, pix_off, row_off.data(), row_idx.data(), row_taps,
+                                                       w, bias + ocb * kOcBlock, scale + ocb * kOcBlock, conf, ic_quads,
+                                                       dst_row + static_cast<ptrdiff_t>(ow) * conf.oc, conf.oc, n_oc);
+                    }
+
+                    for (; ow < conf.ow; ow++) {
+                        border_pixel(ow);
+                    }
+                }
+            }
+        }
+    }
+
+    return SaberSuccess;
+#else
+    return SaberUnImplError;
+#endif
+}
+
+SaberStatus Avx2X8S8S32XConv::dispatch(const std::vector<Tensor<X86>*>& inputs,
+                                       std::vector<Tensor<X86>*>& outputs,
+                                       ConvEltwiseParam<X86>& param) {
+    bool signed_input = inputs[0]->get_dtype() == AK_INT8;
+
+    switch (outputs[0]->get_dtype()) {
+    case AK_FLOAT:
+        return signed_input ? sub_dispatch<true, float>(inputs, outputs)
+               : sub_dispatch<false, float>(inputs, outputs);
+
+    case AK_INT8:
+        return signed_input ? sub_dispatch<true, int8_t>(inputs, outputs)
+               : sub_dispatch<false, int8_t>(inputs, outputs);
+
+    case AK_UINT8:
+        return signed_input ? sub_dispatch<true, uint8_t>(inputs, outputs)
+               : sub_dispatch<false, uint8_t>(inputs, outputs);
+
+    default:
+        LOG(FATAL) << "not support output dtype " << outputs[0]->get_dtype();
+        return SaberUnImplError;
+    }
+}
+
+} // namespace saber
+} // namespace anakin
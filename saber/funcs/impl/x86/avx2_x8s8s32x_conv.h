@@ -0,0 +1,94 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_AVX2_X8S8S32X_CONV_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_AVX2_X8S8S32X_CONV_H
+
+#include <memory>
+#include <vector>
+#include "anakin_config.h"
+#include "saber/funcs/impl/impl_base.h"
+#include "saber/funcs/impl/impl_macro.h"
+#include "saber/funcs/impl/x86/kernel/jit_call_conf.h"
+
+namespace anakin {
+namespace saber {
+
+using namespace jit;
+
+/**
+ *  \brief int8 convolution for avx2 cpus, u8 or s8 nhwc input and s8 weights with s32 sums.
+ *
+ *   The sums are vpmaddubsw + vpmaddwd on 4 input channels of a pixel broadcast against 16 output
+ *   channels. s8 input is multiplied as |x| * (w with the sign of x), so it needs neither the +128
+ *   shift nor the halved weights of the avx512 non-vnni path and its pairs can't saturate.
+ *   Pairs of u8 input could (2 * 255 * 127), its even and odd channels are summed apart, exactly.
+ *   Two drivers share the micro kernel: 1x1 convolutions without padding are a plain
+ *   [pixels, ic] x [ic, oc] product over blocks of 4 pixels, the direct one walks the taps of each
+ *   output row and skips the padded ones. The epilogue is the one of the avx512 kernels: bias,
+ *   requantize scale, relu, eltwise sum and relu after it, rounding and saturation to the output.
+ */
+class Avx2X8S8S32XConv :
+    public ImplBase<
+        X86,
+        AK_INT8,
+        ConvEltwiseParam<X86> > {
+public:
+    typedef typename DataTrait<X86, AK_INT8>::Dtype OpDataType;
+
+    Avx2X8S8S32XConv() {}
+
+    ~Avx2X8S8S32XConv() {}
+
+    /// true if the build has the avx2 kernels and they support param (dense convolutions).
+    static bool available(const ConvParam<X86>& param);
+
+    virtual SaberStatus init(const std::vector<Tensor<X86>*>& inputs,
+                             std::vector<Tensor<X86>*>& outputs,
+                             ConvEltwiseParam<X86>& param,
+                             Context<X86>& ctx);
+
+    virtual SaberStatus create(const std::vector<Tensor<X86>*>& inputs,
+                               std::vector<Tensor<X86>*>& outputs,
+                               ConvEltwiseParam<X86>& param,
+                               Context<X86>& ctx);
+
+    virtual SaberStatus dispatch(const std::vector<Tensor<X86>*>& inputs,
+                                 std::vector<Tensor<X86>*>& outputs,
+                                 ConvEltwiseParam<X86>& param);
+
+private:
+    template <bool SignedInput, typename OutputDtype>
+    SaberStatus sub_dispatch(const std::vector<Tensor<X86>*>& inputs,
+                             std::vector<Tensor<X86>*>& outputs);
+
+    jit_conv_conf_t jcp;
+    bool _is_1x1{false};
+    int _oc_blocks{0};
+    int _ic_quads{0};
+    Tensor<X86> _weights_scale;
+    ///< weights as [oc / 16][kh * kw][ic / 4][16 oc][4 ic], zero padded.
+    std::shared_ptr<const std::vector<int8_t> > _packed_weights;
+    ///< bias in units of the s32 sums and the requantize scales, padded to the oc blocks.
+    std::vector<float> _bias;
+    std::vector<float> _scale;
+    float _sum_scale{0.f};
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_AVX2_X8S8S32X_CONV_H
@@ -0,0 +1,408 @@
+#include "saber/funcs/impl/x86/bf16_gemm.h"
+#include "saber/funcs/impl/x86/fp16_gemm.h"
+#include "saber/funcs/impl/x86/packed_gemm.h"
+#include "saber/core/weight_registry.h"
+#include <cmath>
+#include <cpuid.h>
+#include <immintrin.h>
+
+// compilers which take avx512bf16 as a function target build the vdpbf16ps kernel, it runs
+// only on cpus which have the instruction
+#if (defined(__clang__) && __clang_major__ >= 9) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 10)
+#define ANAKIN_BF16_NATIVE_KERNEL
+#endif
+
+namespace anakin {
+namespace saber {
+
+namespace {
+
+///< columns of a packed B block, one zmm of fp32 accumulators.
+const int kBlock = 16;
+///< rows of A a micro kernel accumulates at once.
+const int kRows = 4;
+
+inline int pairs_of(int k) {
+    return (k + 1) / 2;
+}
+
+/// bf16 pair as vdpbf16ps reads it, the even k in the low half.
+inline uint32_t make_pair(uint16_t even, uint16_t odd) {
+    return static_cast<uint32_t>(even) | (static_cast<uint32_t>(odd) << 16);
+}
+
+inline float bits_to_float(uint32_t bits) {
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+/// element i of src as bf16, src is fp32 or bf16.
+inline uint16_t bf16_at(const void* src, DataType dtype, size_t i) {
+    if (dtype == AK_BFLOAT16) {
+        return static_cast<const uint16_t*>(src)[i];
+    }
+    return float_to_bf16(static_cast<const float*>(src)[i]);
+}
+
+/// vdpbf16ps treats denormal inputs as zero and flushes denormal results, so do the emulated kernels.
+class DenormalsAreZero {
+public:
+    DenormalsAreZero() : _csr(_mm_getcsr()) {
+        _mm_setcsr(_csr | 0x8040);
+    }
+    ~DenormalsAreZero() {
+        _mm_setcsr(_csr);
+    }
+private:
+    unsigned int _csr;
+};
+
+#ifdef ANAKIN_BF16_NATIVE_KERNEL
+/// avx512f and avx512_bf16 of the cpu, with the zmm and opmask state enabled by the os.
+bool cpu_has_avx512_bf16() {
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid_max(0, nullptr) < 7) {
+        return false;
+    }
+    __cpuid(1, eax, ebx, ecx, edx);
+    bool osxsave = ecx & (1u << 27);
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    bool avx512f = ebx & (1u << 16);
+    if (!osxsave || !avx512f || eax < 1) {
+        return false;
+    }
+    __cpuid_count(7, 1, eax, ebx, ecx, edx);
+    if (!(eax & (1u << 5))) {
+        return false;
+    }
+    unsigned int xcr0 = 0;
+    unsigned int xcr0_high = 0;
+    __asm__ __volatile__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+    // sse, avx, opmask, zmm0-15 high halves and zmm16-31
+    return (xcr0 & 0xe6u) == 0xe6u;
+}
+#endif
+
+/**
+ *  \brief c[ROWS, 16] (+)= a[ROWS, kp pairs] * b[kp pairs, 16], vdpbf16ps emulated with fp32 fma.
+ *   Each pair is accumulated odd element first, as vdpbf16ps does.
+ */
+template <int ROWS>
+inline void micro_kernel(int kp, const uint32_t* a, int lda, const uint32_t* b,
+                         float* c, int ldc, bool accumulate) {
+#if defined(__AVX512F__)
+    __m512 acc[ROWS];
+    for (int r = 0; r < ROWS; r++) {
+        acc[r] = accumulate ? _mm512_loadu_ps(c + r * ldc) : _mm512_setzero_ps();
+    }
+    const __m512i high = _mm512_set1_epi32(static_cast<int>(0xffff0000u));
+    for (int p = 0; p < kp; p++) {
+        __m512i bv = _mm512_loadu_si512(b + p * kBlock);
+        __m512 b_even = _mm512_castsi512_ps(_mm512_slli_epi32(bv, 16));
+        __m512 b_odd = _mm512_castsi512_ps(_mm512_and_si512(bv, high));
+        for (int r = 0; r < ROWS; r++) {
+            uint32_t pair = a[r * lda + p];
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(bits_to_float(pair & 0xffff0000u)), b_odd, acc[r]);
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(bits_to_float(pair << 16)), b_even, acc[r]);
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        _mm512_storeu_ps(c + r * ldc, acc[r]);
+    }
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256 acc[ROWS][2];
+    for (int r = 0; r < ROWS; r++) {
+        acc[r][0] = accumulate ? _mm256_loadu_ps(c + r * ldc) : _mm256_setzero_ps();
+        acc[r][1] = accumulate ? _mm256_loadu_ps(c + r * ldc + 8) : _mm256_setzero_ps();
+    }
+    const __m256i high = _mm256_set1_epi32(static_cast<int>(0xffff0000u));
+    for (int p = 0; p < kp; p++) {
+        __m256 b_even[2];
+        __m256 b_odd[2];
+        for (int h = 0; h < 2; h++) {
+            __m256i bv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * kBlock + h * 8));
+            b_even[h] = _mm256_castsi256_ps(_mm256_slli_epi32(bv, 16));
+            b_odd[h] = _mm256_castsi256_ps(_mm256_and_si256(bv, high));
+        }
+        for (int r = 0; r < ROWS; r++) {
+            uint32_t pair = a[r * lda + p];
+            __m256 a_odd = _mm256_set1_ps(bits_to_float(pair & 0xffff0000u));
+            __m256 a_even = _mm256_set1_ps(bits_to_float(pair << 16));
+            for (int h = 0; h < 2; h++) {
+                acc[r][h] = _mm256_fmadd_ps(a_odd, b_odd[h], acc[r][h]);
+                acc[r][h] = _mm256_fmadd_ps(a_even, b_even[h], acc[r][h]);
+            }
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        _mm256_storeu_ps(c + r * ldc, acc[r][0]);
+        _mm256_storeu_ps(c + r * ldc + 8, acc[r][1]);
+    }
+#else
+    float acc[ROWS][kBlock];
+    for (int r = 0; r < ROWS; r++) {
+        for (int j = 0; j < kBlock; j++) {
+            acc[r][j] = accumulate ? c[r * ldc + j] : 0.f;
+        }
+    }
+    for (int p = 0; p < kp; p++) {
+        for (int r = 0; r < ROWS; r++) {
+            uint32_t pair = a[r * lda + p];
+            float a_odd = bits_to_float(pair & 0xffff0000u);
+            float a_even = bits_to_float(pair << 16);
+            for (int j = 0; j < kBlock; j++) {
+                uint32_t b_pair = b[p * kBlock + j];
+                acc[r][j] = fmaf(a_odd, bits_to_float(b_pair & 0xffff0000u), acc[r][j]);
+                acc[r][j] = fmaf(a_even, bits_to_float(b_pair << 16), acc[r][j]);
+            }
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        for (int j = 0; j < kBlock; j++) {
+            c[r * ldc + j] = acc[r][j];
+        }
+    }
+#endif
+}
+
+inline void micro_kernel(int rows, int kp, const uint32_t* a, int lda, const uint32_t* b,
+                         float* c, int ldc, bool accumulate) {
+    switch (rows) {
+    case 4:
+        micro_kernel<4>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    case 3:
+        micro_kernel<3>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    case 2:
+        micro_kernel<2>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    default:
+        micro_kernel<1>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    }
+}
+
+#ifdef ANAKIN_BF16_NATIVE_KERNEL
+/// micro_kernel by vdpbf16ps, only called when the cpu has avx512_bf16.
+template <int ROWS>
+__attribute__((target("avx512f,avx512bf16")))
+void native_micro_kernel(int kp, const uint32_t* a, int lda, const uint32_t* b,
+                         float* c, int ldc, bool accumulate) {
+    __m512 acc[ROWS];
+    for (int r = 0; r < ROWS; r++) {
+        acc[r] = accumulate ? _mm512_loadu_ps(c + r * ldc) : _mm512_setzero_ps();
+    }
+    for (int p = 0; p < kp; p++) {
+        __m512i bv = _mm512_loadu_si512(b + p * kBlock);
+        for (int r = 0; r < ROWS; r++) {
+            __m512i av = _mm512_set1_epi32(static_cast<int>(a[r * lda + p]));
+            acc[r] = _mm512_dpbf16_ps(acc[r], (__m512bh)bv, (__m512bh)av);
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        _mm512_storeu_ps(c + r * ldc, acc[r]);
+    }
+}
+
+void native_micro_kernel(int rows, int kp, const uint32_t* a, int lda, const uint32_t* b,
+                         float* c, int ldc, bool accumulate) {
+    switch (rows) {
+    case 4:
+        native_micro_kernel<4>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    case 3:
+        native_micro_kernel<3>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    case 2:
+        native_micro_kernel<2>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    default:
+        native_micro_kernel<1>(kp, a, lda, b, c, ldc, accumulate);
+        break;
+    }
+}
+#endif
+
+/// c[m, n] (+)= a[m, kp pairs] * b, b packed in blocks of 16 columns.
+void gemm_packed(int m, int n, int kp, const uint32_t* a, int lda, const uint32_t* b,
+                 float* c, int ldc, bool accumulate) {
+    size_t b_block = static_cast<size_t>(kp) * kBlock;
+#ifdef ANAKIN_BF16_NATIVE_KERNEL
+    if (bf16_native()) {
+        packed_gemm<kBlock, kRows>(m, n, a, lda, b, b_block, c, ldc, accumulate,
+        [kp](int rows, const uint32_t* pa, int lda, const uint32_t* pb, float* pc, int ldc, bool accumulate) {
+            native_micro_kernel(rows, kp, pa, lda, pb, pc, ldc, accumulate);
+        });
+        return;
+    }
+#endif
+    packed_gemm<kBlock, kRows, DenormalsAreZero>(m, n, a, lda, b, b_block, c, ldc, accumulate,
+    [kp](int rows, const uint32_t* pa, int lda, const uint32_t* pb, float* pc, int ldc, bool accumulate) {
+        micro_kernel(rows, kp, pa, lda, pb, pc, ldc, accumulate);
+    });
+}
+
+/// rows of a as bf16 pairs along k, a(row, i) is at a[row * lda + i] (a[i * lda + row] if trans).
+void pack_rows(bool trans, int m, int k, const void* a, int lda, DataType dtype, uint32_t* dst) {
+    int kp = pairs_of(k);
+    #pragma omp parallel for schedule(static)
+    for (int row = 0; row < m; row++) {
+        for (int p = 0; p < kp; p++) {
+            int i = 2 * p;
+            size_t even = trans ? static_cast<size_t>(i) * lda + row : static_cast<size_t>(row) * lda + i;
+            size_t odd = trans ? even + lda : even + 1;
+            dst[static_cast<size_t>(row) * kp + p] = make_pair(bf16_at(a, dtype, even),
+                                                               i + 1 < k ? bf16_at(a, dtype, odd) : 0);
+        }
+    }
+}
+
+/// b as blocks of 16 columns of bf16 pairs along k, b(i, col) is at b[i * ldb + col] (b[col * ldb + i] if trans).
+void pack_columns(bool trans, int n, int k, const void* b, int ldb, DataType dtype, uint32_t* dst) {
+    int kp = pairs_of(k);
+    int blocks = (n + kBlock - 1) / kBlock;
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int nb = 0; nb < blocks; nb++) {
+        for (int p = 0; p < kp; p++) {
+            uint32_t* out = dst + (static_cast<size_t>(nb) * kp + p) * kBlock;
+            for (int j = 0; j < kBlock; j++) {
+                int col = nb * kBlock + j;
+                int i = 2 * p;
+                if (col >= n) {
+                    out[j] = 0;
+                    continue;
+                }
+                size_t even = trans ? static_cast<size_t>(col) * ldb + i : static_cast<size_t>(i) * ldb + col;
+                size_t odd = trans ? even + 1 : even + ldb;
+                out[j] = make_pair(bf16_at(b, dtype, even), i + 1 < k ? bf16_at(b, dtype, odd) : 0);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void float_to_bf16(const float* src, uint16_t* dst, size_t count) {
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = float_to_bf16(src[i]);
+    }
+}
+
+void bf16_to_float(const uint16_t* src, float* dst, size_t count) {
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = bf16_to_float(src[i]);
+    }
+}
+
+SaberStatus tensor_to_bf16(Tensor<X86>& tensor) {
+    if (tensor.get_dtype() == AK_BFLOAT16) {
+        return SaberSuccess;
+    }
+    CHECK_EQ(tensor.get_dtype(), AK_FLOAT) << "only fp32 tensors convert to bf16";
+    Shape shape = tensor.valid_shape();
+    std::vector<float> values(tensor.valid_size());
+    memcpy(values.data(), static_cast<const float*>(tensor.data()) + tensor.data_offset(),
+           values.size() * sizeof(float));
+    tensor.re_alloc(shape, AK_BFLOAT16);
+    float_to_bf16(values.data(), static_cast<uint16_t*>(tensor.mutable_data()), values.size());
+    return SaberSuccess;
+}
+
+SaberStatus tensor_to_float(Tensor<X86>& tensor) {
+    if (tensor.get_dtype() == AK_FLOAT) {
+        return SaberSuccess;
+    }
+    DataType dtype = tensor.get_dtype();
+    CHECK(dtype == AK_BFLOAT16 || dtype == AK_HALF) << "only bf16 and fp16 tensors convert to fp32";
+    Shape shape = tensor.valid_shape();
+    std::vector<uint16_t> values(tensor.valid_size());
+    memcpy(values.data(), static_cast<const uint16_t*>(tensor.data()) + tensor.data_offset(),
+           values.size() * sizeof(uint16_t));
+    tensor.re_alloc(shape, AK_FLOAT);
+    if (dtype == AK_HALF) {
+        half_to_float(values.data(), static_cast<float*>(tensor.mutable_data()), values.size());
+    } else {
+        bf16_to_float(values.data(), static_cast<float*>(tensor.mutable_data()), values.size());
+    }
+    return SaberSuccess;
+}
+
+bool bf16_native() {
+#ifdef ANAKIN_BF16_NATIVE_KERNEL
+    static const bool native = cpu_has_avx512_bf16();
+    return native;
+#else
+    return false;
+#endif
+}
+
+SaberStatus Bf16Gemm::init_b(bool trans_b, int n, int k, const void* b, DataType b_dtype) {
+    CHECK(b_dtype == AK_FLOAT || b_dtype == AK_BFLOAT16) << "bf16 gemm takes fp32 or bf16 weights";
+    _n = n;
+    _k = k;
+    _packed_a.reset();
+    size_t count = static_cast<size_t>((n + kBlock - 1) / kBlock) * pairs_of(k) * kBlock;
+    std::string key = WeightRegistry::make_key("bf16_gemm/packed_b", b,
+                      static_cast<size_t>(n) * k * type_length(b_dtype),
+                      {(float)n, (float)k, (float)trans_b, (float)b_dtype});
+    _packed_b = WeightRegistry::global().get_or_create<std::vector<uint32_t> >(key, count * sizeof(uint32_t),
+    [&]() {
+        auto packed = std::make_shared<std::vector<uint32_t> >(count);
+        pack_columns(trans_b, n, k, b, trans_b ? k : n, b_dtype, packed->data());
+        return packed;
+    });
+    return SaberSuccess;
+}
+
+SaberStatus Bf16Gemm::init_a(bool trans_a, int m, int k, const void* a, DataType a_dtype) {
+    CHECK(a_dtype == AK_FLOAT || a_dtype == AK_BFLOAT16) << "bf16 gemm takes fp32 or bf16 weights";
+    _m = m;
+    _k = k;
+    _packed_b.reset();
+    size_t count = static_cast<size_t>(m) * pairs_of(k);
+    std::string key = WeightRegistry::make_key("bf16_gemm/packed_a", a,
+                      static_cast<size_t>(m) * k * type_length(a_dtype),
+                      {(float)m, (float)k, (float)trans_a, (float)a_dtype});
+    _packed_a = WeightRegistry::global().get_or_create<std::vector<uint32_t> >(key, count * sizeof(uint32_t),
+    [&]() {
+        auto packed = std::make_shared<std::vector<uint32_t> >(count);
+        pack_rows(trans_a, m, k, a, trans_a ? m : k, a_dtype, packed->data());
+        return packed;
+    });
+    return SaberSuccess;
+}
+
+SaberStatus Bf16Gemm::dispatch_a(int m, const float* a, int lda, float* c, int ldc, bool accumulate) {
+    CHECK(_packed_b != nullptr) << "bf16 gemm: init_b first";
+    int kp = pairs_of(_k);
+    _workspace.resize(static_cast<size_t>(m) * kp);
+    pack_rows(false, m, _k, a, lda, AK_FLOAT, _workspace.data());
+    gemm_packed(m, _n, kp, _workspace.data(), kp, _packed_b->data(), c, ldc, accumulate);
+    return SaberSuccess;
+}
+
+SaberStatus Bf16Gemm::dispatch_b(int n, const float* b, int ldb, float* c, int ldc, bool accumulate) {
+    CHECK(_packed_a != nullptr) << "bf16 gemm: init_a first";
+    int kp = pairs_of(_k);
+    _workspace.resize(static_cast<size_t>((n + kBlock - 1) / kBlock) * kp * kBlock);
+    pack_columns(false, n, _k, b, ldb, AK_FLOAT, _workspace.data());
+    gemm_packed(_m, n, kp, _packed_a->data(), kp, _workspace.data(), c, ldc, accumulate);
+    return SaberSuccess;
+}
+
+size_t Bf16Gemm::weights_bytes() const {
+    if (_packed_a != nullptr) {
+        return _packed_a->size() * sizeof(uint32_t);
+    }
+    return _packed_b != nullptr ? _packed_b->size() * sizeof(uint32_t) : 0;
+}
+
+} // namespace saber
+} // namespace anakin
@@ -0,0 +1,116 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_BF16_GEMM_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_BF16_GEMM_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "saber/core/tensor.h"
+
+namespace anakin {
+namespace saber {
+
+/// bfloat16 of x as vcvtneps2bf16 does it: round to nearest even, denormals to zero, nans quiet.
+inline uint16_t float_to_bf16(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    if ((bits & 0x7f800000u) == 0) {
+        return static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    }
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x0040u);
+    }
+    bits += 0x7fffu + ((bits >> 16) & 1u);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+inline float bf16_to_float(uint16_t x) {
+    uint32_t bits = static_cast<uint32_t>(x) << 16;
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+/// convert count values between fp32 and bf16.
+void float_to_bf16(const float* src, uint16_t* dst, size_t count);
+void bf16_to_float(const uint16_t* src, float* dst, size_t count);
+
+/// convert a fp32 tensor to bf16 in place, its shape, layout and scale are kept.
+SaberStatus tensor_to_bf16(Tensor<X86>& tensor);
+
+/// convert a bf16 or fp16 tensor to fp32 in place.
+SaberStatus tensor_to_float(Tensor<X86>& tensor);
+
+/**
+ *  \brief True if the bf16 kernels run avx512_bf16 instructions (vdpbf16ps), which is checked
+ *   on the cpu at run time, false if they emulate them with fp32 fma. Both give the same bits:
+ *   products of two bf16 are exact in fp32, each pair is accumulated odd element first and
+ *   denormals are flushed as vdpbf16ps does, so the emulated path checks the native one on any
+ *   x86 host.
+ */
+bool bf16_native();
+
+/**
+ *  \brief C[m, n] = A[m, k] * B[k, n] (+ C) with bf16 operands and fp32 accumulation.
+ *
+ *   One operand is fixed (the weights) and converted and packed once by init_a or init_b,
+ *   the other one is fp32 and is converted to bf16 (round to nearest even) on every dispatch.
+ *   Weights take half the memory and bandwidth of fp32 without a calibration step.
+ *   The packed weights are shared through WeightRegistry by the kernels of the same model.
+ */
+class Bf16Gemm {
+public:
+    Bf16Gemm() {}
+    ~Bf16Gemm() {}
+
+    /**
+     *  \brief Fix B, e.g. the weights of fc: dispatch_a multiplies fp32 activations by it.
+     *  \param b k x n (n x k if trans_b), fp32 or bf16 by b_dtype.
+     */
+    SaberStatus init_b(bool trans_b, int n, int k, const void* b, DataType b_dtype);
+
+    /**
+     *  \brief Fix A, e.g. the weights of im2col conv: dispatch_b multiplies it by fp32 columns.
+     *  \param a m x k (k x m if trans_a), fp32 or bf16 by a_dtype.
+     */
+    SaberStatus init_a(bool trans_a, int m, int k, const void* a, DataType a_dtype);
+
+    /// c[m, n] = a[m, k] * B (+ c if accumulate), a is fp32 of leading dimension lda.
+    SaberStatus dispatch_a(int m, const float* a, int lda, float* c, int ldc, bool accumulate);
+
+    /// c[m, n] = A * b[k, n] (+ c if accumulate), b is fp32 of leading dimension ldb.
+    SaberStatus dispatch_b(int n, const float* b, int ldb, float* c, int ldc, bool accumulate);
+
+    /// bytes of the packed weights.
+    size_t weights_bytes() const;
+
+private:
+    int _m{0};
+    int _n{0};
+    int _k{0};
+    ///< fixed operand: A as rows of bf16 pairs along k, or B as blocks of 16 columns of pairs.
+    std::shared_ptr<const std::vector<uint32_t> > _packed_a;
+    std::shared_ptr<const std::vector<uint32_t> > _packed_b;
+    ///< the other operand converted by each dispatch.
+    std::vector<uint32_t> _workspace;
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_BF16_GEMM_H
@@ -0,0 +1,182 @@
+#include "saber/funcs/impl/x86/embedding_quant.h"
+#include "saber/funcs/impl/x86/fp16_gemm.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <immintrin.h>
+
+namespace anakin {
+namespace saber {
+
+namespace {
+
+/// element j of a row of signed 4 bit values, two per byte, low nibble first.
+inline int int4_at(const int8_t* row, int j) {
+    int byte = row[j >> 1];
+    return (j & 1) ? (byte >> 4) : (((byte & 0xf) ^ 8) - 8);
+}
+
+void float_row(const float* src, int emb_dim, float* out, bool accumulate) {
+    if (!accumulate) {
+        memcpy(out, src, sizeof(float) * emb_dim);
+        return;
+    }
+    for (int j = 0; j < emb_dim; j++) {
+        out[j] += src[j];
+    }
+}
+
+void half_row(const uint16_t* src, int emb_dim, float* out, bool accumulate) {
+    if (!accumulate) {
+        half_to_float(src, out, emb_dim);
+        return;
+    }
+    int j = 0;
+#if defined(__F16C__)
+    for (; j + 8 <= emb_dim; j += 8) {
+        __m256 v = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j)));
+        _mm256_storeu_ps(out + j, _mm256_add_ps(_mm256_loadu_ps(out + j), v));
+    }
+#endif
+    for (; j < emb_dim; j++) {
+        out[j] += half_to_float(src[j]);
+    }
+}
+
+/**
+ *  \brief the quantized rows: out = q * scale or out = fma(q, scale, out),
+ *   every path rounds the same way so they give the same bits.
+ */
+void int8_row(const int8_t* src, float scale, int emb_dim, float* out, bool accumulate) {
+    int j = 0;
+#if defined(__AVX512F__)
+    __m512 scale16 = _mm512_set1_ps(scale);
+    for (; j + 16 <= emb_dim; j += 16) {
+        __m512i q = _mm512_cvtepi8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j)));
+        __m512 v = _mm512_cvtepi32_ps(q);
+        v = accumulate ? _mm512_fmadd_ps(v, scale16, _mm512_loadu_ps(out + j)) : _mm512_mul_ps(v, scale16);
+        _mm512_storeu_ps(out + j, v);
+    }
+#endif
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256 scale8 = _mm256_set1_ps(scale);
+    for (; j + 8 <= emb_dim; j += 8) {
+        __m256i q = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + j)));
+        __m256 v = _mm256_cvtepi32_ps(q);
+        v = accumulate ? _mm256_fmadd_ps(v, scale8, _mm256_loadu_ps(out + j)) : _mm256_mul_ps(v, scale8);
+        _mm256_storeu_ps(out + j, v);
+    }
+#endif
+    for (; j < emb_dim; j++) {
+        float v = static_cast<float>(src[j]);
+        out[j] = accumulate ? fmaf(v, scale, out[j]) : v * scale;
+    }
+}
+
+void int4_row(const int8_t* src, float scale, int emb_dim, float* out, bool accumulate) {
+    int j = 0;
+    // each 32 bit lane takes the word of its 8 nibbles, shifts its nibble to the top
+    // and shifts it back down arithmetically, which sign extends it.
+#if defined(__AVX512F__)
+    const __m512i words = _mm512_set_epi32(1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m512i shifts16 = _mm512_set_epi32(0, 4, 8, 12, 16, 20, 24, 28, 0, 4, 8, 12, 16, 20, 24, 28);
+    __m512 scale16 = _mm512_set1_ps(scale);
+    for (; j + 16 <= emb_dim; j += 16) {
+        __m512i packed = _mm512_castsi128_si512(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + j / 2)));
+        __m512i q = _mm512_permutexvar_epi32(words, packed);
+        q = _mm512_srai_epi32(_mm512_sllv_epi32(q, shifts16), 28);
+        __m512 v = _mm512_cvtepi32_ps(q);
+        v = accumulate ? _mm512_fmadd_ps(v, scale16, _mm512_loadu_ps(out + j)) : _mm512_mul_ps(v, scale16);
+        _mm512_storeu_ps(out + j, v);
+    }
+#endif
+#if defined(__AVX2__) && defined(__FMA__)
+    const __m256i shifts8 = _mm256_set_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    __m256 scale8 = _mm256_set1_ps(scale);
+    for (; j + 8 <= emb_dim; j += 8) {
+        int32_t word;
+        memcpy(&word, src + j / 2, sizeof(word));
+        __m256i q = _mm256_srai_epi32(_mm256_sllv_epi32(_mm256_set1_epi32(word), shifts8), 28);
+        __m256 v = _mm256_cvtepi32_ps(q);
+        v = accumulate ? _mm256_fmadd_ps(v, scale8, _mm256_loadu_ps(out + j)) : _mm256_mul_ps(v, scale8);
+        _mm256_storeu_ps(out + j, v);
+    }
+#endif
+    for (; j < emb_dim; j++) {
+        float v = static_cast<float>(int4_at(src, j));
+        out[j] = accumulate ? fmaf(v, scale, out[j]) : v * scale;
+    }
+}
+
+} // namespace
+
+SaberStatus quantize_embedding_table(Tensor<X86>& table, int emb_dim, DataType dtype) {
+    if (table.get_dtype() == dtype) {
+        return SaberSuccess;
+    }
+    CHECK(dtype == AK_INT8 || dtype == AK_INT4) << "embedding tables are quantized to int8 or int4";
+    CHECK_EQ(table.get_dtype(), AK_FLOAT) << "only fp32 embedding tables are quantized";
+    CHECK_GT(emb_dim, 0);
+    CHECK_EQ(table.valid_size() % emb_dim, 0) << "embedding table size isn't a multiple of emb_dim";
+    int word_num = table.valid_size() / emb_dim;
+    int row_bytes = dtype == AK_INT8 ? emb_dim : (emb_dim + 1) / 2;
+    float qmax = dtype == AK_INT8 ? 127.f : 7.f;
+    const float* src = static_cast<const float*>(table.data()) + table.data_offset();
+    // the fp32 table is freed by re_alloc, only the quantized one is kept aside
+    std::vector<int8_t> packed(static_cast<size_t>(word_num) * row_bytes, 0);
+    std::vector<float> scales(word_num);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < word_num; i++) {
+        const float* row = src + static_cast<size_t>(i) * emb_dim;
+        int8_t* dst = packed.data() + static_cast<size_t>(i) * row_bytes;
+        float max_abs = 0.f;
+        for (int j = 0; j < emb_dim; j++) {
+            max_abs = std::max(max_abs, fabsf(row[j]));
+        }
+        float inv_scale = max_abs > 0.f ? qmax / max_abs : 0.f;
+        if (!std::isfinite(inv_scale)) {
+            // rows of denormals are zero rows
+            inv_scale = 0.f;
+            max_abs = 0.f;
+        }
+        scales[i] = max_abs / qmax;
+        for (int j = 0; j < emb_dim; j++) {
+            int q = static_cast<int>(nearbyintf(row[j] * inv_scale));
+            q = std::min(std::max(q, -static_cast<int>(qmax)), static_cast<int>(qmax));
+            if (dtype == AK_INT8) {
+                dst[j] = static_cast<int8_t>(q);
+            } else {
+                dst[j >> 1] |= static_cast<int8_t>((q & 0xf) << ((j & 1) * 4));
+            }
+        }
+    }
+
+    table.re_alloc(Shape({1, 1, word_num, row_bytes}), dtype);
+    memcpy(table.mutable_data(), packed.data(), packed.size());
+    table.set_scale(scales);
+    return SaberSuccess;
+}
+
+void embedding_row(const Tensor<X86>& table, int row, int emb_dim, float* out, bool accumulate) {
+    size_t index = static_cast<size_t>(row);
+    switch (table.get_dtype()) {
+    case AK_INT8:
+        int8_row(static_cast<const int8_t*>(table.data()) + index * emb_dim,
+                 table.get_scale_data()[row], emb_dim, out, accumulate);
+        break;
+    case AK_INT4:
+        int4_row(static_cast<const int8_t*>(table.data()) + index * ((emb_dim + 1) / 2),
+                 table.get_scale_data()[row], emb_dim, out, accumulate);
+        break;
+    case AK_HALF:
+        half_row(static_cast<const uint16_t*>(table.data()) + index * emb_dim, emb_dim, out, accumulate);
+        break;
+    default:
+        float_row(static_cast<const float*>(table.data()) + index * emb_dim, emb_dim, out, accumulate);
+        break;
+    }
+}
+
+} // namespace saber
+} // namespace anakin
@@ -0,0 +1,44 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_EMBEDDING_QUANT_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_EMBEDDING_QUANT_H
+
+#include "saber/core/tensor.h"
+
+namespace anakin {
+namespace saber {
+
+/**
+ *  \brief Quantize a fp32 embedding table [word_num, emb_dim] in place, one scale per row.
+ *
+ *   AK_INT8 keeps the shape, a row is round(x / scale) in [-127, 127] with scale = max|x| / 127.
+ *   AK_INT4 packs two values in [-7, 7] per byte, element 2i in the low nibble of byte i, and its
+ *   shape is [word_num, (emb_dim + 1) / 2] bytes, scale = max|x| / 7. The scales are the tensor's
+ *   scale (word_num values). Tables shrink 4x and 8x, each element is off by at most scale / 2.
+ */
+SaberStatus quantize_embedding_table(Tensor<X86>& table, int emb_dim, DataType dtype);
+
+/**
+ *  \brief out[emb_dim] = row of table (out += row if accumulate), expanded to fp32.
+ *   table is fp32, fp16 or per row quantized int8 / int4, the quantized rows are scaled with fma.
+ */
+void embedding_row(const Tensor<X86>& table, int row, int emb_dim, float* out, bool accumulate);
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_EMBEDDING_QUANT_H
@@ -0,0 +1,196 @@
+#include "saber/funcs/impl/x86/fp16_gemm.h"
+#include "saber/funcs/impl/x86/packed_gemm.h"
+#include "saber/core/weight_registry.h"
+#include <cmath>
+#include <immintrin.h>
+
+namespace anakin {
+namespace saber {
+
+namespace {
+
+///< columns of a packed B block.
+const int kBlock = 16;
+///< rows of A a micro kernel accumulates at once.
+const int kRows = 4;
+
+inline uint16_t half_at(const void* src, DataType dtype, size_t i) {
+    if (dtype == AK_HALF) {
+        return static_cast<const uint16_t*>(src)[i];
+    }
+    return float_to_half(static_cast<const float*>(src)[i]);
+}
+
+/**
+ *  \brief c[ROWS, 16] (+)= a[ROWS, k] * b[k, 16], b is fp16 and expanded in registers.
+ *   Every path accumulates k in order with fma, so they give the same bits.
+ */
+template <int ROWS>
+inline void micro_kernel(int k, const float* a, int lda, const uint16_t* b,
+                         float* c, int ldc, bool accumulate) {
+#if defined(__AVX512F__)
+    __m512 acc[ROWS];
+    for (int r = 0; r < ROWS; r++) {
+        acc[r] = accumulate ? _mm512_loadu_ps(c + r * ldc) : _mm512_setzero_ps();
+    }
+    for (int p = 0; p < k; p++) {
+        __m512 bv = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * kBlock)));
+        for (int r = 0; r < ROWS; r++) {
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(a[r * lda + p]), bv, acc[r]);
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        _mm512_storeu_ps(c + r * ldc, acc[r]);
+    }
+#elif defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+    __m256 acc[ROWS][2];
+    for (int r = 0; r < ROWS; r++) {
+        acc[r][0] = accumulate ? _mm256_loadu_ps(c + r * ldc) : _mm256_setzero_ps();
+        acc[r][1] = accumulate ? _mm256_loadu_ps(c + r * ldc + 8) : _mm256_setzero_ps();
+    }
+    for (int p = 0; p < k; p++) {
+        __m256 b_lo = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + p * kBlock)));
+        __m256 b_hi = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + p * kBlock + 8)));
+        for (int r = 0; r < ROWS; r++) {
+            __m256 av = _mm256_set1_ps(a[r * lda + p]);
+            acc[r][0] = _mm256_fmadd_ps(av, b_lo, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(av, b_hi, acc[r][1]);
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        _mm256_storeu_ps(c + r * ldc, acc[r][0]);
+        _mm256_storeu_ps(c + r * ldc + 8, acc[r][1]);
+    }
+#else
+    float acc[ROWS][kBlock];
+    for (int r = 0; r < ROWS; r++) {
+        for (int j = 0; j < kBlock; j++) {
+            acc[r][j] = accumulate ? c[r * ldc + j] : 0.f;
+        }
+    }
+    for (int p = 0; p < k; p++) {
+        float bv[kBlock];
+        for (int j = 0; j < kBlock; j++) {
+            bv[j] = half_to_float(b[p * kBlock + j]);
+        }
+        for (int r = 0; r < ROWS; r++) {
+            for (int j = 0; j < kBlock; j++) {
+                acc[r][j] = fmaf(a[r * lda + p], bv[j], acc[r][j]);
+            }
+        }
+    }
+    for (int r = 0; r < ROWS; r++) {
+        for (int j = 0; j < kBlock; j++) {
+            c[r * ldc + j] = acc[r][j];
+        }
+    }
+#endif
+}
+
+inline void micro_kernel(int rows, int k, const float* a, int lda, const uint16_t* b,
+                         float* c, int ldc, bool accumulate) {
+    switch (rows) {
+    case 4:
+        micro_kernel<4>(k, a, lda, b, c, ldc, accumulate);
+        break;
+    case 3:
+        micro_kernel<3>(k, a, lda, b, c, ldc, accumulate);
+        break;
+    case 2:
+        micro_kernel<2>(k, a, lda, b, c, ldc, accumulate);
+        break;
+    default:
+        micro_kernel<1>(k, a, lda, b, c, ldc, accumulate);
+        break;
+    }
+}
+
+} // namespace
+
+void float_to_half(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), 0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = float_to_half(src[i]);
+    }
+}
+
+void half_to_float(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = half_to_float(src[i]);
+    }
+}
+
+SaberStatus tensor_to_half(Tensor<X86>& tensor) {
+    if (tensor.get_dtype() == AK_HALF) {
+        return SaberSuccess;
+    }
+    CHECK_EQ(tensor.get_dtype(), AK_FLOAT) << "only fp32 tensors convert to fp16";
+    Shape shape = tensor.valid_shape();
+    std::vector<float> values(tensor.valid_size());
+    memcpy(values.data(), static_cast<const float*>(tensor.data()) + tensor.data_offset(),
+           values.size() * sizeof(float));
+    tensor.re_alloc(shape, AK_HALF);
+    float_to_half(values.data(), static_cast<uint16_t*>(tensor.mutable_data()), values.size());
+    return SaberSuccess;
+}
+
+SaberStatus Fp16Gemm::init_b(bool trans_b, int n, int k, const void* b, DataType b_dtype) {
+    CHECK(b_dtype == AK_FLOAT || b_dtype == AK_HALF) << "fp16 gemm takes fp32 or fp16 weights";
+    _n = n;
+    _k = k;
+    int blocks = (n + kBlock - 1) / kBlock;
+    size_t count = static_cast<size_t>(blocks) * k * kBlock;
+    int ldb = trans_b ? k : n;
+    std::string key = WeightRegistry::make_key("fp16_gemm/packed_b", b,
+                      static_cast<size_t>(n) * k * type_length(b_dtype),
+                      {(float)n, (float)k, (float)trans_b, (float)b_dtype});
+    _packed_b = WeightRegistry::global().get_or_create<std::vector<uint16_t> >(key, count * sizeof(uint16_t),
+    [&]() {
+        auto packed = std::make_shared<std::vector<uint16_t> >(count);
+        uint16_t* dst = packed->data();
+        #pragma omp parallel for collapse(2) schedule(static)
+        for (int nb = 0; nb < blocks; nb++) {
+            for (int p = 0; p < k; p++) {
+                uint16_t* out = dst + (static_cast<size_t>(nb) * k + p) * kBlock;
+                for (int j = 0; j < kBlock; j++) {
+                    int col = nb * kBlock + j;
+                    size_t idx = trans_b ? static_cast<size_t>(col) * ldb + p : static_cast<size_t>(p) * ldb + col;
+                    out[j] = col < n ? half_at(b, b_dtype, idx) : 0;
+                }
+            }
+        }
+        return packed;
+    });
+    return SaberSuccess;
+}
+
+SaberStatus Fp16Gemm::dispatch_a(int m, const float* a, int lda, float* c, int ldc, bool accumulate) {
+    CHECK(_packed_b != nullptr) << "fp16 gemm: init_b first";
+    int k = _k;
+    packed_gemm<kBlock, kRows>(m, _n, a, lda, _packed_b->data(), static_cast<size_t>(k) * kBlock,
+                               c, ldc, accumulate,
+    [k](int rows, const float* pa, int lda, const uint16_t* pb, float* pc, int ldc, bool accumulate) {
+        micro_kernel(rows, k, pa, lda, pb, pc, ldc, accumulate);
+    });
+    return SaberSuccess;
+}
+
+size_t Fp16Gemm::weights_bytes() const {
+    return _packed_b != nullptr ? _packed_b->size() * sizeof(uint16_t) : 0;
+}
+
+} // namespace saber
+} // namespace anakin
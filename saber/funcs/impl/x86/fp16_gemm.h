@@ -0,0 +1,130 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_FP16_GEMM_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_FP16_GEMM_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "saber/core/tensor.h"
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace anakin {
+namespace saber {
+
+/// ieee half of x, round to nearest even, as vcvtps2ph does it.
+inline uint16_t float_to_half(float x) {
+#if defined(__F16C__)
+    return static_cast<uint16_t>(_cvtss_sh(x, 0));
+#else
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t abs = bits & 0x7fffffffu;
+    if (abs >= 0x7f800000u) {
+        // inf stays inf, nans are quiet
+        return static_cast<uint16_t>(sign | 0x7c00u | (abs > 0x7f800000u ? 0x0200u | ((abs >> 13) & 0x03ffu) : 0));
+    }
+    if (abs >= 0x477ff000u) {
+        // 65520 and above round to inf
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    if (abs < 0x38800000u) {
+        // subnormal half: let the fpu round at the 2^-24 unit
+        float f;
+        memcpy(&f, &abs, sizeof(f));
+        f += 0.5f;
+        uint32_t rounded;
+        memcpy(&rounded, &f, sizeof(rounded));
+        return static_cast<uint16_t>(sign | (rounded - 0x3f000000u));
+    }
+    // rebias the exponent and round the mantissa to nearest even
+    abs += 0xc8000fffu + ((abs >> 13) & 1u);
+    return static_cast<uint16_t>(sign | (abs >> 13));
+#endif
+}
+
+inline float half_to_float(uint16_t x) {
+#if defined(__F16C__)
+    return _cvtsh_ss(x);
+#else
+    uint32_t sign = static_cast<uint32_t>(x & 0x8000u) << 16;
+    uint32_t exp = (x >> 10) & 0x1fu;
+    uint32_t mant = x & 0x03ffu;
+    uint32_t bits = 0;
+    if (exp == 0x1fu) {
+        bits = sign | 0x7f800000u | (mant << 13);
+    } else if (exp == 0) {
+        // zero or subnormal, exact in fp32
+        float f = static_cast<float>(mant) * (1.f / 16777216.f);
+        memcpy(&bits, &f, sizeof(bits));
+        bits |= sign;
+    } else {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+#endif
+}
+
+/// convert count values between fp32 and fp16, with f16c when the build targets it.
+void float_to_half(const float* src, uint16_t* dst, size_t count);
+void half_to_float(const uint16_t* src, float* dst, size_t count);
+
+/// convert a fp32 tensor to fp16 in place, its shape, layout and scale are kept.
+SaberStatus tensor_to_half(Tensor<X86>& tensor);
+
+/**
+ *  \brief C[m, n] = A[m, k] * B[k, n] (+ C) with fp16 weights B, fp32 activations A and fp32 accumulation.
+ *
+ *   B is packed once by init_b, in blocks of 16 columns, and stays fp16 in memory: the kernel
+ *   expands it to fp32 in registers (vcvtph2ps) right before the fma. Only the weights lose
+ *   precision, the activations and the sums are fp32. Fc layers which are bound by the weights
+ *   bandwidth read half the bytes. The packed weights are shared through WeightRegistry.
+ */
+class Fp16Gemm {
+public:
+    Fp16Gemm() {}
+    ~Fp16Gemm() {}
+
+    /**
+     *  \brief Fix B, e.g. the weights of fc.
+     *  \param b k x n (n x k if trans_b), fp32 or fp16 by b_dtype.
+     */
+    SaberStatus init_b(bool trans_b, int n, int k, const void* b, DataType b_dtype);
+
+    /// c[m, n] = a[m, k] * B (+ c if accumulate), a is fp32 of leading dimension lda.
+    SaberStatus dispatch_a(int m, const float* a, int lda, float* c, int ldc, bool accumulate);
+
+    /// bytes of the packed weights.
+    size_t weights_bytes() const;
+
+private:
+    int _n{0};
+    int _k{0};
+    ///< B as blocks of 16 columns of fp16, [n / 16][k][16].
+    std::shared_ptr<const std::vector<uint16_t> > _packed_b;
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_FP16_GEMM_H
@@ -1,6 +1,7 @@
 #include "saber/funcs/impl/x86/gemm_x8s8s32x_conv.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "saber/core/tensor_op.h"
+#include "saber/core/weight_cache.h"
 #include "mkl_cblas.h"
 #include "anakin_thread.h"
 #include "debug.h"
@@ -66,7 +67,12 @@ SaberStatus GemmX8S8S32XConv::create(const std::vector<Tensor<X86>*>& inputs,
 
     weights_internal_ = new Tensor<X86>(weights_orig->shape(), AK_INT8);
     weights_internal_->set_scale(weights_orig->get_scale());
-    weight_reorder_goihw2hwigo(weights_orig, weights_internal_);
+    Shape weights_shape = weights_orig->shape();
+    WeightCache::load_or_build("gemm_x8s8s32x_conv/hwigo", weights_orig->data(), weights_orig->valid_size(),
+                               std::vector<float>(weights_shape.begin(), weights_shape.end()),
+                               weights_internal_->mutable_data(), weights_shape.count(), [&]() {
+        weight_reorder_goihw2hwigo(weights_orig, weights_internal_);
+    });
 
     Tensor<X86>* bias_src = conv_param->mutable_bias();
 
@@ -3,6 +3,8 @@
 #include "saber/funcs/impl/x86/kernel/jit_avx2_conv.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "saber/funcs/impl/x86/saber_normal_activation.h"
+#include "saber/core/weight_registry.h"
+#include "saber/core/weight_cache.h"
 #include "debug.h"
 
 namespace anakin {
@@ -174,15 +176,26 @@ SaberStatus JitAvx2Conv<AK_FLOAT>::create(
 
     // reorder weights
     Tensor<X86>* weights_reorder = conv_param->mutable_weight();
-
-    weights_internal.reset(new Tensor<X86>(weights_reorder->valid_shape()));
-
-    if (inputs[0]->get_layout() == Layout_NCHW) {
-        weight_reorder_OIhwi8o(*weights_reorder, *weights_internal);
-    } else if (inputs[0]->get_layout() == Layout_NCHW_C8
-               || inputs[0]->get_layout() == Layout_NCHW_C8R) {
-        weight_reorder_OIhw8i8o(*weights_reorder, *weights_internal);
-    }
+    LayoutType in_layout = inputs[0]->get_layout();
+    Shape weights_shape = weights_reorder->valid_shape();
+    std::string weights_kind = in_layout == Layout_NCHW ? "jit_avx2_conv/OIhwi8o" : "jit_avx2_conv/OIhw8i8o";
+    size_t weights_bytes = weights_reorder->valid_size() * weights_reorder->get_dtype_size();
+    std::vector<float> weights_attrs(weights_shape.begin(), weights_shape.end());
+    std::string weights_key = WeightRegistry::make_key(weights_kind, weights_reorder->data(),
+            weights_bytes, weights_attrs);
+    weights_internal = WeightRegistry::global().get_or_create<Tensor<X86> >(weights_key,
+            weights_shape.count() * sizeof(float), [&]() {
+        std::shared_ptr<Tensor<X86> > weights(new Tensor<X86>(weights_shape));
+        WeightCache::load_or_build(weights_kind, weights_reorder->data(), weights_bytes, weights_attrs,
+                                   weights->mutable_data(), weights_shape.count() * sizeof(float), [&]() {
+            if (in_layout == Layout_NCHW) {
+                weight_reorder_OIhwi8o(*weights_reorder, *weights);
+            } else if (in_layout == Layout_NCHW_C8 || in_layout == Layout_NCHW_C8R) {
+                weight_reorder_OIhw8i8o(*weights_reorder, *weights);
+            }
+        });
+        return weights;
+    });
 
     if (conf.with_bias) {
         Shape bias_s({1, conf.oc, 1, 1}, Layout_NCHW);
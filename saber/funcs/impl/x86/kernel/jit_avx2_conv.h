@@ -53,7 +53,8 @@ public:
 private:
     jit::jit_conv_conf_t conf;
     jit::jit_avx2_conv_act_kernel *kernel = nullptr;
-    std::unique_ptr<Tensor<X86>> weights_internal;
+    ///< reordered weights, read-only and shared through WeightRegistry.
+    std::shared_ptr<const Tensor<X86>> weights_internal;
     std::unique_ptr<Tensor<X86>> bias_internal;
     Tensor<X86> _temp_output;
     SaberStatus check_conf(const std::vector<Tensor<X86> *>& inputs,
@@ -4,6 +4,8 @@
 #include "saber/funcs/impl/x86/kernel/jit_call_conf.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "tensor_op.h"
+#include "saber/core/weight_registry.h"
+#include "saber/core/weight_cache.h"
 namespace anakin {
 namespace saber {
 
@@ -180,21 +182,42 @@ SaberStatus JitAvx512Conv<AK_FLOAT>::create(
 
     // reorder weights
     Tensor<X86>* weights_reorder = conv_param->mutable_weight();
-    weights_internal.reset(new Tensor<X86>(weights_reorder->valid_shape()));
+    LayoutType in_layout = inputs[0]->get_layout();
+    Shape weights_shape = weights_reorder->valid_shape();
+    std::vector<float> weights_attrs(weights_shape.begin(), weights_shape.end());
+    float weights_scale = 1.f;
 
-    if (inputs[0]->get_layout() == Layout_NCHW) {
-        weight_reorder_OIhwi16o(*weights_reorder, *weights_internal);
-    } else if (inputs[0]->get_layout() == Layout_NCHW_C16
-               || inputs[0]->get_layout() == Layout_NCHW_C16R) {
-        weight_reorder_OIhw16i16o(*weights_reorder, *weights_internal);
-    } else {
-        LOG(FATAL) << "unsupport ";
+    if (output[0].get_dtype() == AK_UINT8) {
+        CHECK(output[0].get_scale().size() > 0);
+        weights_scale = 1.f / (output[0].get_scale()[0] * (127.f / 255.f));
+        weights_attrs.push_back(weights_scale);
     }
 
+    std::string weights_kind = in_layout == Layout_NCHW ? "jit_avx512_conv/OIhwi16o" : "jit_avx512_conv/OIhw16i16o";
+    size_t weights_bytes = weights_reorder->valid_size() * weights_reorder->get_dtype_size();
+    std::string weights_key = WeightRegistry::make_key(weights_kind, weights_reorder->data(),
+            weights_bytes, weights_attrs);
+    weights_internal = WeightRegistry::global().get_or_create<Tensor<X86> >(weights_key,
+            weights_shape.count() * sizeof(float), [&]() {
+        std::shared_ptr<Tensor<X86> > weights(new Tensor<X86>(weights_shape));
+        WeightCache::load_or_build(weights_kind, weights_reorder->data(), weights_bytes, weights_attrs,
+                                   weights->mutable_data(), weights_shape.count() * sizeof(float), [&]() {
+            if (in_layout == Layout_NCHW) {
+                weight_reorder_OIhwi16o(*weights_reorder, *weights);
+            } else if (in_layout == Layout_NCHW_C16 || in_layout == Layout_NCHW_C16R) {
+                weight_reorder_OIhw16i16o(*weights_reorder, *weights);
+            } else {
+                LOG(FATAL) << "unsupport ";
+            }
+            if (output[0].get_dtype() == AK_UINT8) {
+                utils::ScaleUtils::scale_fp32_fp32(*weights, weights_scale);
+            }
+        });
+        return weights;
+    });
+
     if (output[0].get_dtype() == AK_UINT8) {
-        CHECK(output[0].get_scale().size() > 0);
-        float scale = 1.f / (output[0].get_scale()[0] * (127.f / 255.f));
-        utils::ScaleUtils::scale_fp32_fp32(*weights_internal, scale);
+        float scale = weights_scale;
 
         if ((conv_param->bias() != nullptr && conv_param->bias()->valid_size() > 0)) {
             utils::try_expand_tensor(bias_internal, conv_param->bias()->valid_shape());
@@ -61,7 +61,8 @@ typedef typename DataTrait<X86, OpDtype>::Dtype OpDataType;
 private:
     jit::jit_conv_conf_t conf;
     jit::jit_conv_act_kernel *kernel = nullptr;
-    std::shared_ptr<Tensor<X86> > weights_internal;
+    ///< reordered weights, read-only and shared through WeightRegistry.
+    std::shared_ptr<const Tensor<X86> > weights_internal;
     Tensor<X86> bias_internal;
     SaberStatus check_conf(const std::vector<Tensor<X86>*>& inputs,
                            std::vector<Tensor<X86>*>& outputs,
@@ -1,6 +1,8 @@
 #include "saber/funcs/impl/x86/kernel/jit_call_conf.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "saber/funcs/impl/x86/kernel/jit_avx512_conv1x1.h"
+#include "saber/core/weight_registry.h"
+#include "saber/core/weight_cache.h"
 
 namespace anakin {
 namespace saber {
@@ -272,8 +274,21 @@ SaberStatus JitAvx512Conv1x1<AK_FLOAT>::create(
 
     // reorder weights
     Tensor<X86> *weights_reorder = conv_param->mutable_weight();
-    weights_internal.reset(new Tensor<X86>(weights_reorder->valid_shape()));
-    weight_reorder_OIhw16i16o(*weights_reorder, *weights_internal);
+    Shape weights_shape = weights_reorder->valid_shape();
+    size_t weights_bytes = weights_reorder->valid_size() * weights_reorder->get_dtype_size();
+    std::vector<float> weights_attrs(weights_shape.begin(), weights_shape.end());
+    std::string weights_key = WeightRegistry::make_key("jit_avx512_conv1x1/OIhw16i16o",
+            weights_reorder->data(), weights_bytes, weights_attrs);
+    weights_internal = WeightRegistry::global().get_or_create<Tensor<X86> >(weights_key,
+            weights_shape.count() * sizeof(float), [&]() {
+        std::shared_ptr<Tensor<X86> > weights(new Tensor<X86>(weights_shape));
+        WeightCache::load_or_build("jit_avx512_conv1x1/OIhw16i16o", weights_reorder->data(), weights_bytes,
+                                   weights_attrs, weights->mutable_data(), weights_shape.count() * sizeof(float),
+                                   [&]() {
+            weight_reorder_OIhw16i16o(*weights_reorder, *weights);
+        });
+        return weights;
+    });
 
     return SaberSuccess;
 }
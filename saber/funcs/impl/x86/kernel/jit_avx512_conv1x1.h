@@ -79,7 +79,8 @@ private:
     rtus_driver_t *rtus_driver = nullptr;
     size_t ws_per_thread;
     OpDataType *scratch = nullptr;
-    std::shared_ptr<Tensor<X86> > weights_internal = nullptr;
+    ///< reordered weights, read-only and shared through WeightRegistry.
+    std::shared_ptr<const Tensor<X86> > weights_internal = nullptr;
 
     void prepare_rtus();
     SaberStatus check_conf(const std::vector<Tensor<X86> *>& inputs,
@@ -0,0 +1,78 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_GEMM_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_GEMM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace anakin {
+namespace saber {
+
+/// no per thread state for packed_gemm.
+struct NoThreadScope {};
+
+/**
+ *  \brief Driver of the gemms whose B is packed in blocks of BLOCK columns (Fp16Gemm, Bf16Gemm):
+ *   c[m, n] (+)= a[m, :] * b, split in tiles of ROWS rows of a by one block of b.
+ *   kernel(rows, a_tile, lda, b_block, c_tile, ldc, accumulate) computes a full block for up to
+ *   ROWS rows, the last columns of c go through a full block of scratch.
+ *   Each omp thread holds a ThreadScope while it runs its tiles, e.g. to set MXCSR.
+ *  \param b_block elements from a block of b to the next one.
+ */
+template <int BLOCK, int ROWS, typename ThreadScope = NoThreadScope,
+          typename TA, typename TB, typename Kernel>
+void packed_gemm(int m, int n, const TA* a, int lda, const TB* b, size_t b_block,
+                 float* c, int ldc, bool accumulate, Kernel kernel) {
+    int blocks = (n + BLOCK - 1) / BLOCK;
+    int tiles = (m + ROWS - 1) / ROWS;
+    #pragma omp parallel
+    {
+        ThreadScope scope;
+        (void)scope;
+        #pragma omp for collapse(2) schedule(static)
+        for (int nb = 0; nb < blocks; nb++) {
+            for (int tile = 0; tile < tiles; tile++) {
+                int row = tile * ROWS;
+                int rows = std::min(ROWS, m - row);
+                int col = nb * BLOCK;
+                int cols = std::min(BLOCK, n - col);
+                const TA* pa = a + static_cast<size_t>(row) * lda;
+                const TB* pb = b + static_cast<size_t>(nb) * b_block;
+                float* pc = c + static_cast<size_t>(row) * ldc + col;
+                if (cols == BLOCK) {
+                    kernel(rows, pa, lda, pb, pc, ldc, accumulate);
+                    continue;
+                }
+                // last columns go through a full block
+                float tail[ROWS * BLOCK] = {0.f};
+                for (int r = 0; r < rows && accumulate; r++) {
+                    memcpy(tail + r * BLOCK, pc + r * ldc, cols * sizeof(float));
+                }
+                kernel(rows, pa, lda, pb, tail, BLOCK, accumulate);
+                for (int r = 0; r < rows; r++) {
+                    memcpy(pc + r * ldc, tail + r * BLOCK, cols * sizeof(float));
+                }
+            }
+        }
+    }
+}
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_GEMM_H
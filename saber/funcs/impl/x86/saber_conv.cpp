@@ -9,9 +9,11 @@
 #include "saber/funcs/impl/x86/kernel/jit_avx512_core_x8s8s32x_conv.h"
 #include "saber/funcs/impl/x86/kernel/jit_avx512_core_x8s8s32x_1x1_conv.h"
 #include "saber/funcs/impl/x86/gemm_x8s8s32x_conv.h"
+#include "saber/funcs/impl/x86/avx2_x8s8s32x_conv.h"
 #include "saber/funcs/impl/x86/saber_conv_1x1.h"
 #include "saber/funcs/impl/x86/kernel/jit_uni_dwconv.h"
 #include "saber/funcs/impl/x86/winograd.h"
+#include "saber/funcs/impl/x86/bf16_gemm.h"
 #include "saber/funcs/debug.h"
 namespace anakin {
 namespace saber {
@@ -23,9 +25,7 @@ SaberStatus SaberConv2D<X86, AK_FLOAT>::create(const std::vector<Tensor<X86> *>&
         std::vector<Tensor<X86> *>& outputs,
         ConvParam<X86>& param, Context<X86>& ctx) {
     this->_ctx = &ctx;
-    EltwiseParam<X86> elt_param(Eltwise_sum);
-    elt_param.has_eltwise = false;
-    ConvEltwiseParam<X86> conv_elt_param(param, elt_param);
+    ConvEltwiseParam<X86> conv_elt_param = kernel_param(param);
 
     if (_input_trans) {
         int in = inputs[0]->num();
@@ -51,9 +51,8 @@ SaberStatus SaberConv2D<X86, AK_FLOAT>::init(const std::vector<Tensor<X86> *>& i
         std::vector<Tensor<X86> *>& outputs,
         ConvParam<X86>& param, Context<X86>& ctx) {
     this->_ctx = &ctx;
-    EltwiseParam<X86> elt_param(Eltwise_sum);
-    elt_param.has_eltwise = false;
-    ConvEltwiseParam<X86> conv_elt_param(param, elt_param);
+    _float_weights = false;
+    ConvEltwiseParam<X86> conv_elt_param = kernel_param(param);
     bool use_avx512 = mayiuse(avx512_common);
     bool use_avx2 = mayiuse(avx2);
     int group = param.group;
@@ -90,8 +89,24 @@ SaberStatus SaberConv2D<X86, AK_FLOAT>::init(const std::vector<Tensor<X86> *>& i
 
     bool is_winorgrad = (kh == 3 && kw == 3) && (stride_h == 1 && stride_w == 1) && (dilation_h == 1
                         && dilation_w == 1) && group == 1;
+    if (param.weight()->get_dtype() == AK_BFLOAT16) {
+        // only the im2col path multiplies by bf16 weights, the other layouts run fp32 weights
+        if (input_layout == Layout_NCHW && out_layout == Layout_NCHW) {
+            this->impl = new SaberIm2colConv<AK_FLOAT>;
+            return this->impl->init(inputs, outputs, conv_elt_param, ctx);
+        }
+        DLOG(INFO) << "bf16 weights of conv in = " << input_layout << " , out = " << out_layout
+                   << " run as fp32";
+        // the model weights are shared by the nets of the model, the fp32 copy is ours
+        const uint16_t* src = static_cast<const uint16_t*>(param.weight()->data()) + param.weight()->data_offset();
+        _weights_float.re_alloc(param.weight()->valid_shape(), AK_FLOAT);
+        bf16_to_float(src, static_cast<float*>(_weights_float.mutable_data()), _weights_float.valid_size());
+        _float_weights = true;
+        conv_elt_param = kernel_param(param);
+    }
+
 #ifndef USE_SGX
-    if (is_winorgrad && (oc >= 16 && ic >= 16 && ih >= 12 && iw >= 12)
+    if (is_winorgrad && winograd_select_tile(ic, oc, outputs[0]->height(), outputs[0]->width()) > 0
             && (((input_layout == Layout_NCHW) && (out_layout == Layout_NCHW)))) {
         this->impl = new SaberConvWinograd<AK_FLOAT>;
     } else
@@ -141,9 +156,7 @@ SaberStatus SaberConv2D<X86, AK_FLOAT>::\
 dispatch(const std::vector<Tensor<X86> *>& inputs,
          std::vector<Tensor<X86> *>& outputs,
          ConvParam<X86>& param) {
-    EltwiseParam<X86> elt_param(Eltwise_sum);
-    elt_param.has_eltwise = false;
-    ConvEltwiseParam<X86> conv_elt_param(param, elt_param);
+    ConvEltwiseParam<X86> conv_elt_param = kernel_param(param);
 
     if (_input_trans) {
         _input_trans_tensor.set_seq_offset(inputs[0]->get_seq_offset());
@@ -260,7 +273,13 @@ init(const std::vector<Tensor<X86> *>& inputs,
 #else
     bool is_dw = (group > 1 && group == oc && group == ic);
 
-    if (conv_1x1_flag && in_dtyp == AK_UINT8) {
+    if (!mayiuse(avx512_core)) {
+        if (mayiuse(avx2) && Avx2X8S8S32XConv::available(param)) {
+            this->impl = new Avx2X8S8S32XConv();
+        } else {
+            this->impl = new GemmX8S8S32XConv();
+        }
+    } else if (conv_1x1_flag && in_dtyp == AK_UINT8) {
         this->impl = new JitAvx512x8s8s32xConv1x1();
     } else if ((is_dw || group == 1) && pad_w <= 14) {
         this->impl = new JitAvx512X8S8S32XConv();
@@ -58,6 +58,17 @@ public:
     }
 
 private:
+    /// param of the kernels, their weights are _weights_float if the model weights run as fp32.
+    ConvEltwiseParam<X86> kernel_param(ConvParam<X86>& param) {
+        EltwiseParam<X86> elt_param(Eltwise_sum);
+        elt_param.has_eltwise = false;
+        ConvEltwiseParam<X86> conv_elt_param(param, elt_param);
+        if (_float_weights) {
+            conv_elt_param.conv_param.set_weight(&_weights_float);
+        }
+        return conv_elt_param;
+    }
+
     std::vector<Tensor<X86>*> _fake_input_vec;
     Tensor<X86> _input_trans_tensor;
     bool _input_trans{false};
@@ -66,6 +77,9 @@ private:
     Tensor<X86> _output_scale;
     std::vector<Tensor<X86> *> _input_vec;
     std::vector<Tensor<X86> *> _output_vec;
+    ///< fp32 copy of bf16 weights the kernel runs as fp32, the model weights are shared and stay bf16.
+    Tensor<X86> _weights_float;
+    bool _float_weights{false};
 };
 
 } // namespace saber
@@ -11,6 +11,7 @@
 #include "saber/funcs/impl/x86/kernel/jit_avx512_core_x8s8s32x_conv.h"
 #include "saber/funcs/impl/x86/kernel/jit_avx512_core_x8s8s32x_1x1_conv.h"
 #include "saber/funcs/impl/x86/gemm_x8s8s32x_conv.h"
+#include "saber/funcs/impl/x86/avx2_x8s8s32x_conv.h"
 #include "saber/funcs/impl/x86/saber_conv_1x1.h"
 #include "saber/funcs/impl/x86/kernel/jit_uni_dwconv.h"
 
@@ -197,7 +198,9 @@ init(const std::vector<Tensor<X86> *>& inputs,
     this->_impl = new JitAvx512X8S8S32XConv();
 #else
     bool is_dw = (group > 1 && group == oc && group == ic);
-    if (kernel_h == 1 && kernel_w == 1 && conv_param->pad_h == 0 && conv_param->pad_w == 0 && conv_param->stride_h == 1 && conv_param->stride_w == 1 && conv_param->group == 1) {
+    if (!mayiuse(avx512_core) && mayiuse(avx2) && Avx2X8S8S32XConv::available(*conv_param)) {
+        this->_impl = new Avx2X8S8S32XConv();
+    } else if (kernel_h == 1 && kernel_w == 1 && conv_param->pad_h == 0 && conv_param->pad_w == 0 && conv_param->stride_h == 1 && conv_param->stride_w == 1 && conv_param->group == 1) {
         this->_impl = new JitAvx512x8s8s32xConv1x1();
     } else if((is_dw || group == 1) && pad_w <= 14){
         this->_impl = new JitAvx512X8S8S32XConv();
@@ -1,6 +1,7 @@
 
 #include "saber/funcs/impl/x86/saber_embedding.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/funcs/impl/x86/embedding_quant.h"
 
 
 namespace anakin{
@@ -26,6 +27,11 @@ SaberStatus SaberEmbedding<X86, OpDtype>::create(
         EmbeddingParam<X86> &param, 
         Context<X86> &ctx)
 {
+    DataType table_dtype = param.weight()->get_dtype();
+    if (OpDtype == AK_FLOAT && (table_dtype == AK_INT8 || table_dtype == AK_INT4)) {
+        CHECK_EQ(param.weight()->get_scale().size(), (size_t)param.word_num)
+                << "quantized embedding table needs a scale per row";
+    }
     return SaberSuccess;
 }
 
@@ -51,6 +57,15 @@ SaberStatus SaberEmbedding<X86, OpDtype>::dispatch(
     DataType_out *out_data =  (DataType_out*)outputs[0]->mutable_data();
     DataType_out *weight_data = (DataType_out*)param.weight()->data();
     int emb_dim = param.emb_dim;
+    // fp16 and quantized tables are expanded to fp32 row by row
+    bool expand_rows = OpDtype == AK_FLOAT && param.weight()->get_dtype() != AK_FLOAT;
+    auto copy_row = [&](DataType_out* dst, int index) {
+        if (expand_rows) {
+            embedding_row(*param.weight(), index, emb_dim, reinterpret_cast<float*>(dst), false);
+        } else {
+            memcpy(dst, weight_data + static_cast<size_t>(index) * emb_dim, sizeof(DataType_out) * emb_dim);
+        }
+    };
    
     /*positive direct*/
     for (int i = 0; i < num_word; i++) {
@@ -59,7 +74,7 @@ SaberStatus SaberEmbedding<X86, OpDtype>::dispatch(
         } else {
             CHECK_GE(in_data[i], 0);
             CHECK_LT(in_data[i], param.word_num);
-            memcpy(out_data + i * emb_dim, weight_data + int(in_data[i]) * emb_dim, sizeof(DataType_out) * emb_dim);
+            copy_row(out_data + i * emb_dim, int(in_data[i]));
         }
     }
 
@@ -79,7 +94,7 @@ SaberStatus SaberEmbedding<X86, OpDtype>::dispatch(
                 } else {
                     CHECK_GE(index, 0);
                     CHECK_LT(index, param.word_num);
-                    memcpy(out_data + dst_index * emb_dim, weight_data + int(index) * emb_dim, sizeof(DataType_out) * emb_dim);
+                    copy_row(out_data + dst_index * emb_dim, index);
                 }
             }
         }
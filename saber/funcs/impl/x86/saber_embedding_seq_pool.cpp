@@ -0,0 +1,153 @@
+
+#include "saber/funcs/impl/x86/saber_embedding_seq_pool.h"
+#include "saber/funcs/impl/x86/embedding_quant.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace anakin {
+namespace saber {
+
+template <DataType OpDtype>
+SaberStatus SaberEmbeddingSeqPool<X86, OpDtype>::init(
+        const std::vector<Tensor<X86>*>& inputs,
+        std::vector<Tensor<X86>*>& outputs,
+        EmbeddingSeqPoolParam<X86> &param,
+        Context<X86> &ctx)
+{
+    this->_ctx = &ctx;
+    return create(inputs, outputs, param, ctx);
+}
+
+template <DataType OpDtype>
+SaberStatus SaberEmbeddingSeqPool<X86, OpDtype>::create(
+        const std::vector<Tensor<X86>*>& inputs,
+        std::vector<Tensor<X86>*>& outputs,
+        EmbeddingSeqPoolParam<X86> &param,
+        Context<X86> &ctx)
+{
+    DataType table_dtype = param.embedding.weight()->get_dtype();
+    if (table_dtype == AK_INT8 || table_dtype == AK_INT4) {
+        CHECK_EQ(param.embedding.weight()->get_scale().size(), (size_t)param.embedding.word_num)
+                << "quantized embedding table needs a scale per row";
+    }
+    CHECK_EQ(param.embedding.num_direct, 1) << "only the positive direction is fused";
+    CHECK_NE(param.seq_pool.sequence_pool_type, Sequence_pool_unknow) << " UNKNOWN seq pool type";
+    return SaberSuccess;
+}
+
+template <DataType OpDtype>
+SaberStatus SaberEmbeddingSeqPool<X86, OpDtype>::dispatch(
+        const std::vector<Tensor<X86>*>& inputs,
+        std::vector<Tensor<X86>*>& outputs,
+        EmbeddingSeqPoolParam<X86> &param)
+{
+    CHECK_EQ(inputs.size(), (size_t)1);
+    CHECK_EQ(inputs[0]->get_dtype(), AK_FLOAT) << "embedding only support float inputs!";
+
+    EmbeddingParam<X86>& emb = param.embedding;
+    SequencePoolType pool_type = param.seq_pool.sequence_pool_type;
+    const Tensor<X86>& table = *emb.weight();
+    const float* in_data = (const float*)inputs[0]->data();
+    float* out_data = (float*)outputs[0]->mutable_data();
+    int emb_dim = emb.emb_dim;
+
+    // without offsets every word is a sequence
+    std::vector<int> seq_offset;
+    if (inputs[0]->get_seq_offset().size() >= 1 && inputs[0]->get_seq_offset()[0].size() > 1) {
+        seq_offset = inputs[0]->get_seq_offset()[0];
+    } else {
+        for (int i = 0; i <= inputs[0]->valid_size(); i++) {
+            seq_offset.push_back(i);
+        }
+    }
+    int seq_num = seq_offset.size() - 1;
+    for (int i = 0; i < inputs[0]->valid_size(); i++) {
+        if (in_data[i] != emb.padding_idx) {
+            CHECK_GE(in_data[i], 0);
+            CHECK_LT(in_data[i], emb.word_num);
+        }
+    }
+
+    // the padding rows are zero rows: they count in the length and in max, not in the sums
+    #pragma omp parallel
+    {
+        std::vector<float> row(emb_dim);
+        #pragma omp for schedule(static)
+        for (int i = 0; i < seq_num; i++) {
+            float* dst = out_data + static_cast<size_t>(i) * emb_dim;
+            int begin = seq_offset[i];
+            int len = seq_offset[i + 1] - begin;
+            memset(dst, 0, sizeof(float) * emb_dim);
+            if (len <= 0) {
+                continue;
+            }
+            switch (pool_type) {
+            case Sequence_pool_first:
+            case Sequence_pool_last: {
+                int index = in_data[pool_type == Sequence_pool_first ? begin : begin + len - 1];
+                if (index != emb.padding_idx) {
+                    embedding_row(table, index, emb_dim, dst, false);
+                }
+                break;
+            }
+            case Sequence_pool_max: {
+                bool has_padding = false;
+                bool first = true;
+                for (int j = 0; j < len; j++) {
+                    int index = in_data[begin + j];
+                    if (index == emb.padding_idx) {
+                        has_padding = true;
+                        continue;
+                    }
+                    embedding_row(table, index, emb_dim, first ? dst : row.data(), false);
+                    if (!first) {
+                        for (int k = 0; k < emb_dim; k++) {
+                            dst[k] = std::max(dst[k], row[k]);
+                        }
+                    }
+                    first = false;
+                }
+                if (has_padding && !first) {
+                    for (int k = 0; k < emb_dim; k++) {
+                        dst[k] = std::max(dst[k], 0.f);
+                    }
+                }
+                break;
+            }
+            default: {
+                for (int j = 0; j < len; j++) {
+                    int index = in_data[begin + j];
+                    if (index != emb.padding_idx) {
+                        embedding_row(table, index, emb_dim, dst, true);
+                    }
+                }
+                float div = 1.f;
+                if (pool_type == Sequence_pool_average) {
+                    div = len;
+                } else if (pool_type == Sequence_pool_sqrt) {
+                    div = sqrtf(len);
+                }
+                if (div != 1.f) {
+                    for (int k = 0; k < emb_dim; k++) {
+                        dst[k] /= div;
+                    }
+                }
+                break;
+            }
+            }
+        }
+    }
+    std::vector<int> offset_new(seq_num + 1);
+    for (int i = 0; i <= seq_num; i++) {
+        offset_new[i] = i;
+    }
+    outputs[0]->set_seq_offset({offset_new});
+    return SaberSuccess;
+}
+
+template class SaberEmbeddingSeqPool<X86, AK_FLOAT>;
+DEFINE_OP_TEMPLATE(SaberEmbeddingSeqPool, EmbeddingSeqPoolParam, X86, AK_HALF);
+DEFINE_OP_TEMPLATE(SaberEmbeddingSeqPool, EmbeddingSeqPoolParam, X86, AK_INT8);
+}
+} // namespace anakin
@@ -169,6 +169,19 @@ batch_s_aligned(const std::vector<OpTensor*>& inputs,
         h_init = (const OpDataType*)_aligned_init_hidden.data();
     }
 
+    RnnState<X86>* state = param.state;
+
+    if (state != nullptr) {
+        CHECK(!is_reverse && param.num_direction == 1) << "streaming gru only runs forward";
+        CHECK_EQ(state->hidden.valid_size(), batch_size * _hidden_size) << "one state row per sequence";
+        // kept apart from _aligned_init_hidden, whose zeros serve the calls without state
+        utils::try_expand_tensor(_aligned_state_hidden, batch_size * _aligned_hidden_size);
+        aligned_utils.aligned_last_dim((const OpDataType*)state->hidden.data(),
+                                       (OpDataType*)_aligned_state_hidden.mutable_data(),
+                                       batch_size * _hidden_size, _hidden_size, _aligned_hidden_size);
+        h_init = (const OpDataType*)_aligned_state_hidden.data();
+    }
+
     std::vector<int> emit_offset_vec;
     int emit_length = 0;
     utils::SeqSortedseqTranseUtil transe_util(is_reverse);
@@ -293,6 +306,18 @@ batch_s_aligned(const std::vector<OpTensor*>& inputs,
                                          _aligned_hidden_size);
     }
 
+    if (state != nullptr) {
+        // a sequence leaves the hidden of its last word, empty ones keep their state
+        OpDataType* state_hidden = (OpDataType*)state->hidden.mutable_data();
+
+        for (int seq_id = 0; seq_id < batch_size; seq_id++) {
+            if (offset_vec[seq_id + 1] > offset_vec[seq_id]) {
+                memcpy(state_hidden + seq_id * _hidden_size, out + (offset_vec[seq_id + 1] - 1) * _hidden_size,
+                       _hidden_size * sizeof(OpDataType));
+            }
+        }
+    }
+
     return SaberSuccess;
 };
 
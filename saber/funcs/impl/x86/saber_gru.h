@@ -179,6 +179,8 @@ private:
     OpTensor _aligned_weights_h2h_o;
     OpTensor _aligned_weights_bias;
     OpTensor _aligned_init_hidden;
+    ///< hidden of RnnState aligned.
+    OpTensor _aligned_state_hidden;
 
     OpTensor _temp_wx;
     OpTensor _temp_wh;
@@ -110,8 +110,21 @@ SaberStatus SaberIm2colConv<AK_FLOAT>::create(const std::vector<Tensor<X86> *>&
 
     int out_stride = out_h * out_w;
 //    LOG(INFO)<<"im2col m,n,k "<<(out_c / conv_param->group)<<","<<(out_stride)<<","<<(in_c / conv_param->group * kernel_h * kernel_w);
-    _gemm.init(false, false, out_c / conv_param->group, out_stride, in_c / conv_param->group * kernel_h * kernel_w,
-               *(this->_ctx));
+    int m = out_c / conv_param->group;
+    int k = in_c / conv_param->group * kernel_h * kernel_w;
+
+    if (conv_param->weight()->get_dtype() == AK_BFLOAT16) {
+        const uint16_t* weights = static_cast<const uint16_t*>(conv_param->weight()->data());
+        _bf16_gemms.resize(conv_param->group);
+
+        for (int j = 0; j < conv_param->group; j++) {
+            _bf16_gemms[j].init_a(false, m, k, weights + j * m * k, AK_BFLOAT16);
+        }
+
+        return SaberSuccess;
+    }
+
+    _gemm.init(false, false, m, out_stride, k, *(this->_ctx));
 
     return SaberSuccess;
 }
@@ -163,8 +176,13 @@ SaberStatus SaberIm2colConv<AK_FLOAT>::dispatch(const std::vector<Tensor<X86> *>
                 add_out = 1.f;
             }
 
-            _gemm.dispatch(1.f, add_out, weights_d + j * weight_size_per_group, (const float*)_im2col_tensor.data(),
-                           dout);
+            if (!_bf16_gemms.empty()) {
+                _bf16_gemms[j].dispatch_b(out_stride, (const float*)_im2col_tensor.data(), out_stride,
+                                          dout, out_stride, add_out != 0.f);
+            } else {
+                _gemm.dispatch(1.f, add_out, weights_d + j * weight_size_per_group, (const float*)_im2col_tensor.data(),
+                               dout);
+            }
 
             din += in_c / group * in_stride;
             dout += out_c / group * out_stride;
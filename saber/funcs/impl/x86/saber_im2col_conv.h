@@ -3,6 +3,7 @@
 #include "saber_types.h"
 #include "saber/funcs/impl/impl_base.h"
 #include "saber/funcs/gemm.h"
+#include "saber/funcs/impl/x86/bf16_gemm.h"
 
 namespace anakin {
 namespace saber {
@@ -28,6 +29,8 @@ public:
 private:
     Tensor<X86> _im2col_tensor;
     Gemm<X86, VENDER_IMPL, OpDataType> _gemm;
+    ///< one gemm per group when the weights are AK_BFLOAT16.
+    std::vector<Bf16Gemm> _bf16_gemms;
 };
 
 }
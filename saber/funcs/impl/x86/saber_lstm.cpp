@@ -172,6 +172,19 @@ avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
         //        cell_init=_aligned_init_celll.data();
     }
 
+    RnnState<X86>* state = param.state;
+
+    if (state != nullptr) {
+        CHECK(!is_reverse && param.skip_num <= 1) << "streaming lstm only runs forward without skip";
+        CHECK_EQ(state->hidden.valid_size(), batch_size * _hidden_size) << "one state row per sequence";
+        CHECK_EQ(state->cell.valid_size(), batch_size * _hidden_size) << "one state row per sequence";
+        utils::try_expand_tensor(_aligned_init_hidden, batch_size * _aligned_hidden_size);
+        aligned_utils.aligned_last_dim((const OpDataType*)state->hidden.data(),
+                                       (OpDataType*)_aligned_init_hidden.mutable_data(),
+                                       batch_size * _hidden_size, _hidden_size, _aligned_hidden_size);
+        h_init = (const OpDataType*)_aligned_init_hidden.data();
+    }
+
     std::vector<int> emit_offset_vec;
     int emit_length = 0;
     utils::SeqSortedseqTranseUtil transe_util(is_reverse);
@@ -215,12 +228,29 @@ avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
     }
 
     inner_cell = (OpDataType*)_temp_cell.mutable_data();
-    memset(inner_cell, 0, _temp_cell.valid_size()* sizeof(OpDataType));
+
+    if (state != nullptr && transform) {
+        utils::try_expand_tensor(_aligned_init_cell, batch_size * _aligned_hidden_size);
+        aligned_utils.aligned_last_dim((const OpDataType*)state->cell.data(),
+                                       (OpDataType*)_aligned_init_cell.mutable_data(),
+                                       batch_size * _hidden_size, _hidden_size, _aligned_hidden_size);
+        transe_util.hidden_2_sorted_hidden((const OpDataType*)_aligned_init_cell.data(), inner_cell,
+                                           _aligned_hidden_size);
+    } else if (state != nullptr) {
+        aligned_utils.aligned_last_dim((const OpDataType*)state->cell.data(), inner_cell,
+                                       batch_size * _hidden_size, _hidden_size, _aligned_hidden_size);
+    } else {
+        memset(inner_cell, 0, _temp_cell.valid_size()* sizeof(OpDataType));
+    }
 
     OpDataType* temp_wh = (OpDataType*)_temp_wh.mutable_data();
     OpDataType* temp_wx = (OpDataType*)_temp_wx.mutable_data();
 
-    _wx_gemm_fp32.dispatch(1.f,0.f,seqsum, inner_x, weight_w,temp_wx);
+    if (_bf16_weights) {
+        _wx_gemm_bf16.dispatch_a(seqsum, inner_x, _word_size, temp_wx, 4 * _aligned_hidden_size, false);
+    } else {
+        _wx_gemm_fp32.dispatch(1.f,0.f,seqsum, inner_x, weight_w,temp_wx);
+    }
 //    gemm(false, false, seqsum, 4 * _aligned_hidden_size, _word_size, 1.f, inner_x, weight_w, 0.f,
 //         temp_wx);
 
@@ -275,7 +305,13 @@ avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
 //             weight_h,
 //             1.f, temp_wx + emit_word_id_start * 4 * _aligned_hidden_size);
 
-        _wh_gemm_fp32.dispatch(1.f,1.f,emit_word_length,hin, weight_h,temp_wx + emit_word_id_start * 4 * _aligned_hidden_size);
+        if (_bf16_weights) {
+            _wh_gemm_bf16.dispatch_a(emit_word_length, hin, _aligned_hidden_size,
+                                     temp_wx + emit_word_id_start * 4 * _aligned_hidden_size,
+                                     4 * _aligned_hidden_size, true);
+        } else {
+            _wh_gemm_fp32.dispatch(1.f,1.f,emit_word_length,hin, weight_h,temp_wx + emit_word_id_start * 4 * _aligned_hidden_size);
+        }
 
         cal_lstm_batch<BIT, OpDataType, with_peephole>(emit_word_id_start, emit_word_id_end, temp_wx,
                 weight_peephole,
@@ -292,6 +328,26 @@ avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
                                          _aligned_hidden_size);
     }
 
+    if (state != nullptr) {
+        // a sequence leaves the hidden of its last word and its cell, empty ones keep their state
+        OpDataType* state_hidden = (OpDataType*)state->hidden.mutable_data();
+
+        for (int seq_id = 0; seq_id < batch_size; seq_id++) {
+            if (offset_vec[seq_id + 1] > offset_vec[seq_id]) {
+                memcpy(state_hidden + seq_id * _hidden_size, out + (offset_vec[seq_id + 1] - 1) * _hidden_size,
+                       _hidden_size * sizeof(OpDataType));
+            }
+        }
+
+        if (transform) {
+            transe_util.sorted_hidden_2_hidden(inner_cell, (OpDataType*)state->cell.mutable_data(),
+                                               _hidden_size, _aligned_hidden_size);
+        } else {
+            aligned_utils.unaligned_last_dim(inner_cell, (OpDataType*)state->cell.mutable_data(),
+                                             batch_size * _hidden_size, _hidden_size, _aligned_hidden_size);
+        }
+    }
+
     return SaberSuccess;
 }
 
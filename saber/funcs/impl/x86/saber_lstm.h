@@ -4,6 +4,7 @@
 #include "saber_funcs_param.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "saber/funcs/impl/x86/mkl_gemm.h"
+#include "saber/funcs/impl/x86/bf16_gemm.h"
 
 #if defined(__AVX512F__)
 #include <immintrin.h>
@@ -64,11 +65,21 @@ public:
         utils::try_expand_tensor(_aligned_weights_h2h,aligned_weights_h2h_shape);
         utils::try_expand_tensor(_aligned_weights_bias,aligned_weights_bias_shape);
 
+        const OpDataType* weights = (const OpDataType*)param.weight()->data();
+        std::vector<float> widened_weights;
+        _bf16_weights = param.weight()->get_dtype() == AK_BFLOAT16;
+        if (_bf16_weights) {
+            // aligned as fp32, the bf16 gemms narrow them back without a loss
+            widened_weights.resize(param.weight()->valid_size());
+            bf16_to_float((const uint16_t*)param.weight()->data(), widened_weights.data(), widened_weights.size());
+            weights = (const OpDataType*)widened_weights.data();
+        }
+
         utils::AlignedUtils aligned_tool;
-        aligned_tool.aligned_last_dim((OpDataType*)(param.weight()->data()),(OpDataType*)_aligned_weights_i2h.mutable_data(),
+        aligned_tool.aligned_last_dim(weights,(OpDataType*)_aligned_weights_i2h.mutable_data(),
                 weights_i2h_size,_hidden_size,_aligned_hidden_size);
 
-        aligned_tool.aligned_last_dim((OpDataType*)(param.weight()->data()) + weights_i2h_size,(OpDataType*)_aligned_weights_h2h.mutable_data(),
+        aligned_tool.aligned_last_dim(weights + weights_i2h_size,(OpDataType*)_aligned_weights_h2h.mutable_data(),
                 weights_h2h_size,_hidden_size,_aligned_hidden_size);
 
         aligned_tool.aligned_last_dim((OpDataType*)param.bias()->data(),(OpDataType*)_aligned_weights_bias.mutable_data(),
@@ -84,8 +95,13 @@ public:
         int seqsum = inputs[0]->num();
         const float* weight_h = (const float*)_aligned_weights_h2h.data();
         const float* weight_w = (const float*)_aligned_weights_i2h.data();
-        _wx_gemm_fp32.init(false, false,seqsum, 4 * _aligned_hidden_size, _word_size,ctx,weight_w,PACKED_MKLGEMM);
-        _wh_gemm_fp32.init(false, false,seqsum, 4 * _aligned_hidden_size, _aligned_hidden_size,ctx,weight_h,PACKED_MKLGEMM);
+        if (_bf16_weights) {
+            _wx_gemm_bf16.init_b(false, 4 * _aligned_hidden_size, _word_size, weight_w, AK_FLOAT);
+            _wh_gemm_bf16.init_b(false, 4 * _aligned_hidden_size, _aligned_hidden_size, weight_h, AK_FLOAT);
+        } else {
+            _wx_gemm_fp32.init(false, false,seqsum, 4 * _aligned_hidden_size, _word_size,ctx,weight_w,PACKED_MKLGEMM);
+            _wh_gemm_fp32.init(false, false,seqsum, 4 * _aligned_hidden_size, _aligned_hidden_size,ctx,weight_h,PACKED_MKLGEMM);
+        }
 
         return create(inputs,outputs,param,ctx);
     } ;
@@ -121,6 +137,8 @@ private:
     Tensor<X86> _aligned_weights_peephole;
 
     Tensor<X86> _aligned_init_hidden;
+    ///< cell of RnnState aligned, before it's sorted.
+    Tensor<X86> _aligned_init_cell;
 
     Tensor<X86> _temp_wx;
     Tensor<X86> _temp_wh;
@@ -132,6 +150,10 @@ private:
 
     MklDnnGemm<float, float, float> _wx_gemm_fp32;
     MklDnnGemm<float, float, float> _wh_gemm_fp32;
+    ///< used instead of the fp32 gemms when the weights are AK_BFLOAT16.
+    bool _bf16_weights{false};
+    Bf16Gemm _wx_gemm_bf16;
+    Bf16Gemm _wh_gemm_bf16;
 
     template <typename BIT,bool with_peephole >
     SaberStatus avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
@@ -2,13 +2,26 @@
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "mkl_cblas.h"
 #include "mkl_vml_functions.h"
+#include "mkl_service.h"
+#include <sstream>
 #include "tensor_op.h"
+#include "saber/core/weight_registry.h"
+#include "saber/core/weight_cache.h"
 
 namespace anakin {
 namespace saber {
 
 typedef MKL_INT cblas_int;
 
+/// mkl packed weights are opaque, only valid for the mkl build and code branch that packed them.
+static std::string mkl_packed_kind() {
+    MKLVersion version;
+    mkl_get_version(&version);
+    std::ostringstream kind;
+    kind << "vender_fc/mkl_packed/" << version.Build << "/" << mkl_cbwr_get_auto_branch();
+    return kind.str();
+}
+
 template <>
 void VenderFc<X86, AK_FLOAT>::clean() {
     if (bias_sum) {
@@ -16,14 +29,7 @@ void VenderFc<X86, AK_FLOAT>::clean() {
         bias_sum = nullptr;
     }
 
-    for (int i = packed_weights.size() - 1; i >= 0; i--) {
-        float* pw = packed_weights[i];
-        cblas_sgemm_free(pw);
-        pw = nullptr;
-        packed_weights.pop_back();
-    }
-
-    std::vector<OpDataType*>().swap(packed_weights);
+    std::vector<std::shared_ptr<const float> >().swap(packed_weights);
 }
 
 
@@ -41,13 +47,19 @@ SaberStatus VenderFc<X86, AK_FLOAT>
     OC = outputs[0]->channel();
 
     // weights
-    for (int i = packed_weights.size() - 1; i >= 0; i--) {
-        cblas_sgemm_free(packed_weights[i]);
+    std::vector<std::shared_ptr<const float> >().swap(packed_weights);
+
+    if (_bf16_weights || _fp16_weights) {
+        CHECK_EQ(inputs.size(), 1);
+        int IC = inputs[0]->count_valid(param.axis, inputs[0]->dims());
+        // weights are IC x OC if transposed, OC x IC otherwise
+        if (_fp16_weights) {
+            return _fp16_gemm.init_b(!param.is_transpose_weights, OC, IC, param.weights->data(), AK_HALF);
+        }
+        return _bf16_gemm.init_b(!param.is_transpose_weights, OC, IC, param.weights->data(), AK_BFLOAT16);
     }
 
-    std::vector<float*> ().swap(packed_weights);
-
-    const float* weights = (const float*)param.weights->data();
+    const float* weights = (const float*)mkl_weights(param).data();
 
     if (_need_weights_trans) {
         weights = static_cast<const float*>(_weights_trans.data());
@@ -57,15 +69,29 @@ SaberStatus VenderFc<X86, AK_FLOAT>
 
     for (int i = 0; i < inputs.size(); i++) {
         cblas_int IC = inputs[i]->count_valid(param.axis, inputs[i]->dims());
-        packed_weights.push_back(cblas_sgemm_alloc(CblasAMatrix, OC, MB, IC));
-        // LOG(INFO) << "anakin input[" << i << "] alloc passed";
-        cblas_sgemm_pack(CblasColMajor,
-                         CblasAMatrix,
-                         param.is_transpose_weights ? CblasNoTrans : CblasTrans,
-                         OC, MB, IC,
-                         1.0,
-                         weights + total_IC * OC, IC,
-                         packed_weights[i]);
+        const float* weights_i = weights + total_IC * OC;
+        size_t packed_bytes = cblas_sgemm_pack_get_size(CblasAMatrix, OC, MB, IC);
+        // keyed by the model weights, the transformed ones are per instance.
+        const float* src_weights_i = (const float*)mkl_weights(param).data() + total_IC * OC;
+        std::vector<float> weights_attrs = {(float)OC, (float)MB, (float)IC, (float)param.is_transpose_weights,
+                                            (float)(_need_weights_trans ? inputs[0]->get_layout() : Layout_invalid)};
+        std::string weights_key = WeightRegistry::make_key("vender_fc/mkl_packed",
+                                  src_weights_i, sizeof(float) * IC * OC, weights_attrs);
+        packed_weights.push_back(WeightRegistry::global().get_or_create<float>(weights_key, packed_bytes, [&]() {
+            std::shared_ptr<float> packed(cblas_sgemm_alloc(CblasAMatrix, OC, MB, IC), cblas_sgemm_free);
+            WeightCache::load_or_build(mkl_packed_kind(), src_weights_i, sizeof(float) * IC * OC, weights_attrs,
+                                       packed.get(), packed_bytes, [&]() {
+                // transposed weights are IC x OC
+                cblas_sgemm_pack(CblasColMajor,
+                                 CblasAMatrix,
+                                 param.is_transpose_weights ? CblasNoTrans : CblasTrans,
+                                 OC, MB, IC,
+                                 1.0,
+                                 weights_i, param.is_transpose_weights ? OC : IC,
+                                 packed.get());
+            });
+            return packed;
+        }));
         total_IC += IC;
         // LOG(INFO) << "anakin input[" << i << "] pack passed";
     }
@@ -87,8 +113,32 @@ SaberStatus VenderFc<X86, AK_FLOAT>
     this->_ctx = &ctx;
     LayoutType in_layout = inputs[0]->get_layout();
     LayoutType out_layout = outputs[0]->get_layout();
+    bool plain_layout = (in_layout == Layout_NCHW || in_layout == Layout_NC || in_layout == Layout_NHW
+                         || in_layout == Layout_HW) && out_layout == Layout_NCHW;
+    _bf16_weights = param.weights->get_dtype() == AK_BFLOAT16;
+    _fp16_weights = param.weights->get_dtype() == AK_HALF;
+    _float_weights = false;
+
+    if ((_bf16_weights || _fp16_weights) && !plain_layout) {
+        // the bf16/fp16 gemms take plain layouts only, the others run fp32 weights by mkl
+        DLOG(INFO) << (_bf16_weights ? "bf16" : "fp16") << " weights of layout in = " << in_layout
+                   << " , out = " << out_layout << " run as fp32";
+        const uint16_t* src = static_cast<const uint16_t*>(param.weights->data()) + param.weights->data_offset();
+        _weights_float.re_alloc(param.weights->valid_shape(), AK_FLOAT);
+        float* dst = static_cast<float*>(_weights_float.mutable_data());
+        if (_bf16_weights) {
+            bf16_to_float(src, dst, _weights_float.valid_size());
+        } else {
+            half_to_float(src, dst, _weights_float.valid_size());
+        }
+        _bf16_weights = false;
+        _fp16_weights = false;
+        _float_weights = true;
+    }
 
-    if (in_layout == Layout_NCHW_C8R && out_layout == Layout_NCHW) {
+    if (_bf16_weights || _fp16_weights) {
+        _need_weights_trans = false;
+    } else if (in_layout == Layout_NCHW_C8R && out_layout == Layout_NCHW) {
         CHECK(inputs[0]->channel() % 8 == 0) << "only support channel div 8 == 0";
         _need_weights_trans = true;
         _weights_trans.re_alloc(param.weights->valid_shape());
@@ -98,7 +148,7 @@ SaberStatus VenderFc<X86, AK_FLOAT>
         int c_value_div_8 = ic_value / 8;
         int hw_value = inputs[0]->height() * inputs[0]->width();
         float* out_weights = static_cast<float*>(_weights_trans.mutable_data());
-        const float* in_weights = static_cast<const float*>(param.weights->data());
+        const float* in_weights = static_cast<const float*>(mkl_weights(param).data());
 
         for (int oc = 0; oc < oc_value; oc++) {
             for (int ic_div_8 = 0; ic_div_8 < c_value_div_8; ic_div_8++) {
@@ -121,7 +171,7 @@ SaberStatus VenderFc<X86, AK_FLOAT>
         int ic_value = inputs[0]->channel();
         int hw_value = inputs[0]->height() * inputs[0]->width();
         float* out_weights = static_cast<float*>(_weights_trans.mutable_data());
-        const float* in_weights = static_cast<const float*>(param.weights->data());
+        const float* in_weights = static_cast<const float*>(mkl_weights(param).data());
 
         for (int oc = 0; oc < oc_value; oc++) {
             for (int hw = 0; hw < hw_value; hw++) {
@@ -181,13 +231,17 @@ SaberStatus VenderFc<X86, AK_FLOAT>
 
         cblas_int IC = inputs[i]->count_valid(param.axis, inputs[i]->dims());
 
-        if (i == 0) {
+        if (_fp16_weights) {
+            _fp16_gemm.dispatch_a(MB, src, IC, dst, OC, i != 0);
+        } else if (_bf16_weights) {
+            _bf16_gemm.dispatch_a(MB, src, IC, dst, OC, i != 0);
+        } else if (i == 0) {
             // C := alpha * op(A) * op(B) + beta * C
             cblas_sgemm_compute(CblasColMajor,                                     // Layout
                                 CblasPacked,                                       // a
                                 CblasNoTrans,                                      // b是否转置
                                 OC, MB, IC,                                        // m, n, k
-                                packed_weights[i], IC,                             // a, lda
+                                packed_weights[i].get(), IC,                       // a, lda
                                 src, IC,                                           // b, ldb
                                 0.0,                                               // beta
                                 dst, OC);                                          // c, ldc
@@ -196,7 +250,7 @@ SaberStatus VenderFc<X86, AK_FLOAT>
                                 CblasPacked,                                       // a
                                 CblasNoTrans,                                      // b是否转置
                                 OC, MB, IC,                                        // m, n, k
-                                packed_weights[i], IC,                             // a, lda
+                                packed_weights[i].get(), IC,                       // a, lda
                                 src, IC,                                           // b, ldb
                                 1.0,                                               // beta
                                 dst, OC);                                          // c, ldc
@@ -21,6 +21,8 @@
 #include "mkl_cblas.h"
 #include "saber/funcs/impl/impl_fc.h"
 #include "saber/funcs/impl/x86/mkl_packed_int8_gemm.h"
+#include "saber/funcs/impl/x86/bf16_gemm.h"
+#include "saber/funcs/impl/x86/fp16_gemm.h"
 
 namespace anakin {
 namespace saber {
@@ -30,7 +32,7 @@ class VenderFc<X86, OpDtype> : public ImplBase<X86, OpDtype, FcParam<X86> > {
 public:
     typedef typename DataTrait<X86, OpDtype>::Dtype OpDataType;
 
-    VenderFc() : bias_sum(nullptr),_need_weights_trans(false),ws_(nullptr),MB(0),OC(0),
+    VenderFc() : bias_sum(nullptr),_need_weights_trans(false),_bf16_weights(false),_fp16_weights(false),ws_(nullptr),MB(0),OC(0),
                  _batch_size(0),_output_channel(0),_is_transpose_weights(CblasNoTrans)
     {}
 
@@ -54,12 +56,27 @@ public:
     virtual void clean();
 
 private:
+    /// weights the mkl path reads: param.weights, or their fp32 copy when _float_weights is set.
+    const Tensor<X86>& mkl_weights(FcParam<X86>& param) {
+        return _float_weights ? _weights_float : *param.weights;
+    }
+
     OpDataType *bias_sum;
     int MB;
     int OC;
     Tensor<X86> _weights_trans;
     bool _need_weights_trans;
-    std::vector<float*> packed_weights;
+    ///< mkl packed weights, read-only and shared through WeightRegistry.
+    std::vector<std::shared_ptr<const float> > packed_weights;
+    ///< weights stored as AK_BFLOAT16, multiplied by the bf16 gemm instead of mkl.
+    bool _bf16_weights;
+    Bf16Gemm _bf16_gemm;
+    ///< weights stored as AK_HALF, expanded to fp32 in registers by the fp16 gemm.
+    bool _fp16_weights;
+    Fp16Gemm _fp16_gemm;
+    ///< bf16 weights in a layout the bf16 gemm doesn't take run as this fp32 copy by mkl.
+    bool _float_weights{false};
+    Tensor<X86> _weights_float;
     void *ws_;
     int _batch_size;
     int _output_channel;
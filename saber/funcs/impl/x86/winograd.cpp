@@ -1,11 +1,44 @@
 #include "saber/funcs/impl/x86/winograd.h"
 #include "saber/funcs/impl/x86/winograd_float.h"
 #include "saber/funcs/impl/x86/winograd_avx2.h"
+#include <algorithm>
 //#include "saber/funcs/impl/x86/winograd_avx.h"
 //#include "saber/funcs/impl/x86/winograd_avx2_nchwc8.h"
 namespace anakin {
 namespace saber {
 
+/// multiply-adds of a 3x3 stride 1 conv by winograd F(m x m, 3x3), see winograd_select_tile.
+static float winograd_cost(int m, int ic, int oc, int oh, int ow) {
+    // vector ops of the two passes of the transforms per tile, with the lanes f43 leaves empty,
+    // and the scatter or gather of the tile in the transformed blocks.
+    const float input_trans = m == 4 ? 208.f + 36.f : 576.f + 64.f;
+    const float output_trans = m == 4 ? 192.f + 36.f : 480.f + 64.f;
+    // the alpha^2 gemms are small, and short in k when ic is small.
+    const float gemm_efficiency = 0.75f * std::min(1.f, ic / 16.f);
+    float alpha = m + 2;
+    float tiles = static_cast<float>((oh + m - 1) / m) * ((ow + m - 1) / m);
+    return tiles * alpha * alpha * ic * oc / gemm_efficiency
+           + tiles * (ic * input_trans + oc * output_trans);
+}
+
+int winograd_select_tile(int ic, int oc, int oh, int ow) {
+    float direct = 9.f * ic * oc * oh * ow;
+    float f63 = winograd_cost(6, ic, oc, oh, ow);
+#if defined(__AVX2__) and defined(__FMA__)
+    float f43 = winograd_cost(4, ic, oc, oh, ow);
+#else
+    // only the avx2 kernels have F(4x4,3x3)
+    float f43 = f63 + 1.f;
+#endif
+
+    if (std::min(f43, f63) >= direct) {
+        return 0;
+    }
+
+    return f43 <= f63 ? 4 : 6;
+}
+
+
 template <>
 SaberStatus SaberConvWinograd<AK_FLOAT>::create(const std::vector<Tensor<X86> *>& inputs,
         std::vector<Tensor<X86> *>& outputs,
@@ -26,7 +59,9 @@ SaberStatus SaberConvWinograd<AK_FLOAT>::init(const std::vector<Tensor<X86> *>&
     //    }else
     if (input_layout == Layout_NCHW && out_layout == Layout_NCHW) {
 #if defined(__AVX2__) and defined(__FMA__)
-        this->_impl = new SaberConvWinogradAvx2<AK_FLOAT>;
+        int tile = winograd_select_tile(inputs[0]->channel(), outputs[0]->channel(),
+                                        outputs[0]->height(), outputs[0]->width());
+        this->_impl = new SaberConvWinogradAvx2<AK_FLOAT>(tile == 4 ? 4 : 6);
 #else
         this->_impl = new SaberConvWinogradFloat<AK_FLOAT>;
 #endif
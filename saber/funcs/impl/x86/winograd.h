@@ -6,6 +6,16 @@
 
 namespace anakin {
 namespace saber {
+
+/**
+ *  \brief Output tile of a 3x3 stride 1 conv by a cost model: 4 for F(4x4,3x3), 6 for
+ *   F(6x6,3x3), 0 if direct conv is cheaper.
+ *   Each one costs the multiplies of its alpha^2 gemms, slowed down when ic is too short to
+ *   fill them, plus the input and output transforms per tile and channel. Tiles cover the
+ *   output rounded up to the tile, so F(6x6) pays for the padding of small feature maps.
+ */
+int winograd_select_tile(int ic, int oc, int oh, int ow);
+
 template<DataType OpDtype>
 class SaberConvWinograd : public ImplBase <
     X86, OpDtype, ConvEltwiseParam<X86> > {
@@ -1,13 +1,21 @@
 #include "saber/funcs/impl/x86/winograd_avx2.h"
+#include "saber/core/weight_registry.h"
+#include "saber/core/weight_cache.h"
 #include "mkl_cblas.h"
-#include "mkl_trans.h"
 #include "tensor_op.h"
 #include "saber/funcs/impl/x86/saber_avx2_expand.h"
+#include "saber/funcs/impl/x86/anakin_thread.h"
+#include "saber/funcs/saber_util.h"
 namespace anakin {
 namespace saber {
 
 #if defined(__AVX2__) and defined(__FMA__)
 
+/// l2 bytes the blocks of tiles are sized for.
+static const size_t kWinogradL2Bytes = 1024 * 1024;
+/// fewest tiles of a block, the transformed weights are read once per block.
+static const int kMinTileBlock = 16;
+
 /**
  * \brief transpose with arm neon optimization
  * @param data_out
@@ -82,6 +90,56 @@ static void winograd_transform_weights(float* dout, const float* din, int ch_out
     transpose(static_cast<float*>(dout), ptr_out, 64, ch_out * ch_in);
 }
 
+/**
+* \brief winograd transform conv3x3 weights, f43, laid out as the f63 ones: 36 * ch_out * ch_in
+* @param dout
+* @param din
+* @param ch_out
+* @param ch_in
+* @param work_space
+*/
+static void winograd_f4k3_transform_weights(float* dout, const float* din, int ch_out, \
+        int ch_in, float* work_space) {
+    const float coeff[6][3] = {
+        { 1.0f / 4,         0.0f,       0.0f},
+        {-1.0f / 6,    -1.0f / 6,  -1.0f / 6},
+        {-1.0f / 6,     1.0f / 6,  -1.0f / 6},
+        {1.0f / 24,    1.0f / 12,   1.0f / 6},
+        {1.0f / 24,   -1.0f / 12,   1.0f / 6},
+        {     0.0f,         0.0f,       1.0f}
+    };
+
+    float* ptr_out = (float*)work_space;
+
+    for (int i = 0; i < ch_out; i++) {
+        for (int j = 0; j < ch_in; j++) {
+            const float* kernel0 = static_cast<const float*>(din) + (i * ch_in + j) * 9;
+            float* ptr_channel = ptr_out + (i * ch_in + j) * 36;
+            const float* k0 = kernel0;
+            const float* k1 = kernel0 + 3;
+            const float* k2 = kernel0 + 6;
+            float tmp[6][3];
+
+            for (int i = 0; i < 6; i++) {
+                tmp[i][0] = k0[0] * coeff[i][0] + k0[1] * coeff[i][1] + k0[2] * coeff[i][2];
+                tmp[i][1] = k1[0] * coeff[i][0] + k1[1] * coeff[i][1] + k1[2] * coeff[i][2];
+                tmp[i][2] = k2[0] * coeff[i][0] + k2[1] * coeff[i][1] + k2[2] * coeff[i][2];
+            }
+
+            for (int j = 0; j < 6; j++) {
+                float* tmpp = &tmp[j][0];
+
+                for (int i = 0; i < 6; i++) {
+                    ptr_channel[j * 6 + i] = tmpp[0] * coeff[i][0] + tmpp[1] * coeff[i][1] + \
+                                             tmpp[2] * coeff[i][2];
+                }
+            }
+        }
+    }
+
+    transpose(static_cast<float*>(dout), ptr_out, 36, ch_out * ch_in);
+}
+
 
 inline void transpose8_ps(__m256& row0, __m256& row1, __m256& row2, __m256& row3, __m256& row4,
                           __m256& row5, __m256& row6, __m256& row7) {
@@ -412,6 +470,94 @@ static inline void winograd_f6k3_input_inplace_avx2(
     _mm256_storeu_ps(out + 2 * 8, m2);
 }
 
+/// B^T * d * B of f43 on the rows m0..m5 (lanes 0..5), transposed like the f63 one.
+static inline void winograd_f4k3_input_inplace_avx2(__m256* m) {
+    const __m256 m_5p0 = _mm256_set1_ps(5.f);
+    const __m256 m_4p0 = _mm256_set1_ps(4.f);
+    const __m256 m_2p0 = _mm256_set1_ps(2.f);
+
+    for (int pass = 0; pass < 2; pass++) {
+        __m256 t1 = m[4] - m_4p0 * m[2];
+        __m256 t2 = m[3] - m_4p0 * m[1];
+        __m256 t3 = m[4] - m[2];
+        __m256 t4 = m_2p0 * (m[3] - m[1]);
+        __m256 m0 = m_4p0 * m[0] - m_5p0 * m[2] + m[4];
+        __m256 m5 = m_4p0 * m[1] - m_5p0 * m[3] + m[5];
+        m[0] = m0;
+        m[1] = t1 + t2;
+        m[2] = t1 - t2;
+        m[3] = t3 + t4;
+        m[4] = t3 - t4;
+        m[5] = m5;
+
+        if (pass == 0) {
+            m[6] = _mm256_setzero_ps();
+            m[7] = _mm256_setzero_ps();
+            transpose8_ps(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]);
+        }
+    }
+}
+
+/// A^T * m * A of f43 on the rows m0..m5, rows m0..m3 (lanes 0..3) are the output tile.
+static inline void winograd_f4k3_output_inplace_avx2(__m256* m, const float& bias, const bool& with_relu) {
+    const __m256 m_8p0 = _mm256_set1_ps(8.f);
+    const __m256 m_4p0 = _mm256_set1_ps(4.f);
+    const __m256 m_2p0 = _mm256_set1_ps(2.f);
+
+    for (int pass = 0; pass < 2; pass++) {
+        __m256 m1_add_m2 = m[1] + m[2];
+        __m256 m1_sub_m2 = m[1] - m[2];
+        __m256 m3_add_m4 = m[3] + m[4];
+        __m256 m3_sub_m4 = m[3] - m[4];
+        m[0] = m[0] + m1_add_m2 + m3_add_m4;
+        m[1] = m1_sub_m2 + m_2p0 * m3_sub_m4;
+        m[2] = m1_add_m2 + m_4p0 * m3_add_m4;
+        m[3] = m1_sub_m2 + m_8p0 * m3_sub_m4 + m[5];
+
+        if (pass == 0) {
+            m[4] = _mm256_setzero_ps();
+            m[5] = _mm256_setzero_ps();
+            m[6] = _mm256_setzero_ps();
+            m[7] = _mm256_setzero_ps();
+            transpose8_ps(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]);
+        }
+    }
+
+    const __m256 bias_value = _mm256_set1_ps(bias);
+
+    for (int i = 0; i < 4; i++) {
+        m[i] = m[i] + bias_value;
+
+        if (with_relu) {
+            m[i] = _mm256_max_ps(m[i], _mm256_setzero_ps());
+        }
+    }
+}
+
+/// the transforms of F(m x m, 3x3) on a tile of alpha x alpha = (m + 2) x (m + 2) in eight rows.
+template <int M>
+struct WinogradF3;
+
+template <>
+struct WinogradF3<4> {
+    static void input(__m256* m) {
+        winograd_f4k3_input_inplace_avx2(m);
+    }
+    static void output(__m256* m, float bias, bool with_relu) {
+        winograd_f4k3_output_inplace_avx2(m, bias, with_relu);
+    }
+};
+
+template <>
+struct WinogradF3<6> {
+    static void input(__m256* m) {
+        winograd_f6k3_input_inplace_avx2(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]);
+    }
+    static void output(__m256* m, float bias, bool with_relu) {
+        winograd_f6k3_output_inplace_avx2(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], bias, with_relu);
+    }
+};
+
 static void winograd_all_in_one(const float* din, float* dout, \
                                 int num, int chout, int hout, int wout, \
                                 int chin, int hin, int win, \
@@ -494,181 +640,125 @@ static void winograd_all_in_one(const float* din, float* dout, \
 }
 
 
-static void conv_x86_winograd3x3_avx2_opt(const float* din, float* dout, \
+/**
+ * \brief winograd F(M x M, 3x3) over blocks of tile_block tiles, the tiles of all images in a row.
+ *  Each thread transforms the inputs of its block into [alpha^2][chin][tile_block], multiplies them
+ *  by the transformed weights into [alpha^2][chout][tile_block] and transforms the outputs, so the
+ *  block stays in cache from the input to the output transform.
+ *  work_space holds alpha^2 * (chin + chout) * tile_block floats for each of anakin_get_max_threads().
+ */
+template <int M>
+static void conv_x86_winograd3x3_avx2_blocked(const float* din, float* dout, \
         int num, int chout, int hout, int wout, \
         int chin, int hin, int win, \
         const float* weights, const float* bias, \
-        int pad_w, int pad_h, bool flag_bias, bool flag_relu, float* tmp_work_space) {
-    int size_in_channel = win * hin;
-    int size_out_channel = wout * hout;
-    //! transform input
-    int tile_w = (wout + 5) / 6;
-    int tile_h = (hout + 5) / 6;
-    int size_tile = tile_h * tile_w;
-    int size_trans_channel = 8 * 8 * size_tile;
-    int max_ch = chin > chout ? chin : chout;
-
-    int m = chout;
-    int n = size_tile;
-    int k = chin;
-
-
-    //! tmp data buffer for input transform
-    float* tmp_data1 = tmp_work_space;
-    //! tmp data buffer for dot mul
-    float* tmp_data2 = tmp_data1 + size_trans_channel * max_ch;
-
-    //SaberTimer<ARM> t1;
-    //Context<ARM> ctx1;
-
-
-    for (int i = 0; i < num; ++i) {
-
-        const float* din_batch = static_cast<const float*>(din) + i * chin * size_in_channel;
-        float* dout_batch = static_cast<float*>(dout) + i * chout * size_out_channel;
-
-        //t1.start(ctx1);
-        //! transform input Bt * data * B
-#if 1
-        #pragma omp parallel for schedule(static)
-
-        for (int j = 0; j < chin; ++j) {
-
-            const float* din_channel = din_batch + j * size_in_channel;
-            float* data_trans_channel = tmp_data1 + j * size_trans_channel;
-
-            for (int h = 0; h < tile_h; h++) {
-
-                for (int w = 0; w < tile_w; w ++) {
-                    //! prepare data 8x8
-                    //! row 8
-                    __m256 data_in_tmp[8] = {_mm256_setzero_ps()};
-
-                    //memset(data_in_tmp[0], 0, sizeof(float) * 64);
-                    for (int j = 0; j < 8; ++j) {
-                        int start_row = h * 6 + j - pad_h;
+        int pad_w, int pad_h, bool flag_bias, bool flag_relu, \
+        int tile_block, float* work_space) {
+    const int alpha = M + 2;
+    const int alpha2 = alpha * alpha;
+    const int size_in_channel = win * hin;
+    const int size_out_channel = wout * hout;
+    const int tile_w = (wout + M - 1) / M;
+    const int tile_h = (hout + M - 1) / M;
+    const int size_tile = tile_h * tile_w;
+    const int tiles = num * size_tile;
+    const int blocks = (tiles + tile_block - 1) / tile_block;
+    const size_t work_size = static_cast<size_t>(alpha2) * (chin + chout) * tile_block;
+
+    #pragma omp parallel for schedule(static)
+
+    for (int b = 0; b < blocks; ++b) {
+        float* trans_in = work_space + anakin_get_thread_num() * work_size;
+        float* trans_out = trans_in + static_cast<size_t>(alpha2) * chin * tile_block;
+        const int tile_start = b * tile_block;
+        const int block_tiles = std::min(tile_block, tiles - tile_start);
+
+        //! transform input Bt * data * B into [alpha2][chin][tile_block]
+        for (int t = 0; t < block_tiles; ++t) {
+            const int n = (tile_start + t) / size_tile;
+            const int h = (tile_start + t) % size_tile / tile_w;
+            const int w = (tile_start + t) % tile_w;
+            const int start_col = w * M - pad_w;
+
+            for (int c = 0; c < chin; ++c) {
+                const float* din_channel = din + (static_cast<size_t>(n) * chin + c) * size_in_channel;
+                __m256 data_in_tmp[8] = {_mm256_setzero_ps()};
+
+                for (int j = 0; j < alpha; ++j) {
+                    int start_row = h * M + j - pad_h;
+
+                    if (start_row < 0 || start_row >= hin) {
+                        continue;
+                    }
 
-                        if (start_row >= 0 && start_row < hin) {
-                            int start_col = w * 6 - pad_w;
-
-                            if (start_col >= 0) {
-                                if (win - start_col >= 8) {
-                                    data_in_tmp[j] = _mm256_loadu_ps(&din_channel[start_row * win + start_col]);
-                                } else {
-                                    int remainder = win - start_col;
-                                    data_in_tmp[j] = _mm256_maskload_ps(&din_channel[start_row * win + start_col],
-                                                                        _m256_continue_mask_m256i(remainder));
-                                }
-                            } else {
-                                for (int k = 0; k < 8; ++k) {
-                                    int start_col = w * 6 + k - pad_w;
+                    if (start_col >= 0) {
+                        if (start_col < win) {
+                            int remainder = std::min(win - start_col, alpha);
+                            data_in_tmp[j] = _mm256_maskload_ps(&din_channel[start_row * win + start_col],
+                                                                _m256_continue_mask_m256i(remainder));
+                        }
+                    } else {
+                        for (int k = 0; k < alpha; ++k) {
+                            int col = start_col + k;
 
-                                    if (start_col >= 0 && start_col < win) {
-                                        data_in_tmp[j][k] = din_channel[start_row * win + start_col];
-                                    }
-                                }
+                            if (col >= 0 && col < win) {
+                                data_in_tmp[j][k] = din_channel[start_row * win + col];
                             }
-
                         }
                     }
+                }
 
-                    winograd_f6k3_input_inplace_avx2(data_in_tmp[0], data_in_tmp[1], data_in_tmp[2], data_in_tmp[3],
-                                                     data_in_tmp[4],
-                                                     data_in_tmp[5], data_in_tmp[6], data_in_tmp[7], data_trans_channel);
+                WinogradF3<M>::input(data_in_tmp);
+                float* trans_channel = trans_in + c * tile_block + t;
 
-                    data_trans_channel += 64;
+                for (int j = 0; j < alpha; ++j) {
+                    for (int k = 0; k < alpha; ++k) {
+                        trans_channel[static_cast<size_t>(j * alpha + k) * chin * tile_block] = data_in_tmp[j][k];
+                    }
                 }
             }
         }
 
-#endif
-        //! end of transform input
-
-#if 1
-        ////////////////////////////////////////////////////////////////////////////////
-        //! dot mul
-        //! transpose input, convert from ch_in * tile_h * tile_w * 64 to
-        //! 64 * ch_in * tile_h * tile_w
-        int hblock = 16;
-        int m_round = hblock * ((chout + hblock - 1) / hblock);
-        int stride_a = m_round * chin;
-        int stride_b = chin * size_tile;
-        int stride_c = chout * size_tile;
-#if 1
-        MKL_Somatcopy('R', 'T', stride_b, 64, 1.f, tmp_data1, 64, tmp_data2, stride_b);
-#endif
-
-
-        CBLAS_TRANSPOSE trans[1] = {CblasNoTrans};
-        int m_array[1] = {chout};
-        int n_array[1] = {size_tile};
-        int k_array[1] = {chin};
-        int lda_array[1] = {chin};
-        int ldb_array[1] = {size_tile};
-        int ldc_array[1] = {size_tile};
-        float alpha_array[1] = {1.f};
-        float beta_array[1] = {0.f};
-        const float* ptr_a_array[64];
-        const float* ptr_b_array[64];
-        float* ptr_c_array[64];
-        int group_size[1] = {64};
-
-        for (int l = 0; l < 64; ++l) {
-            ptr_a_array[l] = static_cast<const float*>(weights) + l * chout * chin;
-            ptr_b_array[l] = tmp_data2 + l * stride_b;
-            ptr_c_array[l] = tmp_data1 + l * stride_c;
-
+        //! dot mul, one gemm per element of the tile
+        for (int l = 0; l < alpha2; ++l) {
+            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, chout, block_tiles, chin, 1.f,
+                        weights + static_cast<size_t>(l) * chout * chin, chin,
+                        trans_in + static_cast<size_t>(l) * chin * tile_block, tile_block, 0.f,
+                        trans_out + static_cast<size_t>(l) * chout * tile_block, tile_block);
         }
 
+        //! transform output At * m * A
+        for (int t = 0; t < block_tiles; ++t) {
+            const int n = (tile_start + t) / size_tile;
+            const int h = (tile_start + t) % size_tile / tile_w;
+            const int w = (tile_start + t) % tile_w;
+            const int end_col = w * M;
+            const int remainder = std::min(wout - end_col, M);
+
+            for (int c = 0; c < chout; ++c) {
+                float bias_value = flag_bias ? bias[c] : 0.f;
+                const float* trans_channel = trans_out + c * tile_block + t;
+                float* dout_channel = dout + (static_cast<size_t>(n) * chout + c) * size_out_channel;
+                __m256 out_tmp[8] = {_mm256_setzero_ps()};
+
+                for (int j = 0; j < alpha; ++j) {
+                    for (int k = 0; k < alpha; ++k) {
+                        out_tmp[j][k] = trans_channel[static_cast<size_t>(j * alpha + k) * chout * tile_block];
+                    }
+                }
 
-        cblas_sgemm_batch(CblasRowMajor, trans, trans, m_array, n_array, k_array, alpha_array, ptr_a_array,
-                          lda_array, ptr_b_array, ldb_array, beta_array, ptr_c_array, ldc_array, 1, group_size);
-
-        //! transpose output, convert from 64 * ch_out * tile_h * tile_w to
-        //! ch_out * tile_h * tile_w * 64
-#if 1
-        MKL_Somatcopy('R', 'T', 64, stride_c, 1.f, tmp_data1, stride_c, tmp_data2, 64);
-#endif
-        //! end of dot mul
-#endif
-
-#if 1
-        ///////////////////////////////////////////////////////////////////////////////
-        //! transform output
-        #pragma omp parallel for schedule(static)
-
-        for (int i = 0; i < chout; ++i) {
-
-            float bias_value = flag_bias ? static_cast<const float*>(bias)[i] : 0.f;
-            float* dout_tmp = tmp_data2 + i * size_trans_channel;
-            float* dout_channel = dout_batch + i * size_out_channel;
-
-            for (int h = 0; h < tile_h; ++h) {
-                for (int w = 0; w < tile_w; ++w) {
-
-                    __m256 out_tmp[8];
-
-                    winograd_f6k3_output_inplace_avx2_float_in(out_tmp[0], out_tmp[1], out_tmp[2], out_tmp[3],
-                            out_tmp[4], out_tmp[5], out_tmp[6], out_tmp[7], dout_tmp, bias_value, flag_relu);
-                    dout_tmp += 64;
-
-                    for (int j = 0; j < 6; ++j) {
-                        int end_row = h * 6 + j;
+                WinogradF3<M>::output(out_tmp, bias_value, flag_relu);
 
-                        if (end_row < hout) {
-                            int end_col = w * 6 ;
+                for (int j = 0; j < M; ++j) {
+                    int end_row = h * M + j;
 
-                            int remainder = std::min(wout - end_col, 6);
-                            _mm256_maskstore_ps(&dout_channel[end_row * wout + end_col], _m256_continue_mask_m256i(remainder),
-                                                out_tmp[j]);
-                        }
+                    if (end_row < hout) {
+                        _mm256_maskstore_ps(&dout_channel[end_row * wout + end_col],
+                                            _m256_continue_mask_m256i(remainder), out_tmp[j]);
                     }
                 }
             }
         }
-
-        //! end of transform output
-#endif
     }
 }
 
@@ -691,22 +781,32 @@ SaberStatus SaberConvWinogradAvx2<AK_FLOAT>::create(const std::vector<Tensor<X86
     int out_stride = out_h * out_w;
     int group = conv_param->group;
     const float* weights_d = (const float*)conv_param->weight()->data();
-    _winor_weights.re_alloc(Shape({8, 8, out_c, in_c}));
-    Tensor<X86> trans_temp(Shape({8, 8, out_c, in_c}));
-    float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
-
-    winograd_transform_weights(static_cast<float*>(_winor_weights.mutable_data()),
-    static_cast<float*>(conv_param->weight()->data()), out_c, in_c,
-                               trans_tmp_ptr);
-
-
-    int tile_w = (out_w + 5) / 6;
-    int tile_h = (out_h + 5) / 6;
-    int size_tile = tile_h * tile_w;
-    int size_trans_channel = 8 * 8 * size_tile;
-    int max_ch = in_c > out_c ? in_c : out_c;
-    _winor_temp.re_alloc(Shape({1, 2, max_ch, size_trans_channel}));
-
+    CHECK(_tile == 4 || _tile == 6) << "winograd avx2 conv only supports F(4x4,3x3) and F(6x6,3x3)";
+    int alpha = _tile + 2;
+    Shape winor_shape({alpha, alpha, out_c, in_c});
+    std::string kind = _tile == 4 ? "winograd_avx2/f43" : "winograd_avx2/f63";
+    size_t weights_bytes = conv_param->weight()->valid_size() * sizeof(float);
+    std::vector<float> weights_attrs = {(float)out_c, (float)in_c};
+    std::string weights_key = WeightRegistry::make_key(kind, conv_param->weight()->data(),
+                              weights_bytes, weights_attrs);
+    _winor_weights = WeightRegistry::global().get_or_create<Tensor<X86> >(weights_key,
+                     winor_shape.count() * sizeof(float), [&]() {
+        std::shared_ptr<Tensor<X86> > weights(new Tensor<X86>(winor_shape));
+        WeightCache::load_or_build(kind, conv_param->weight()->data(), weights_bytes, weights_attrs,
+                                   weights->mutable_data(), winor_shape.count() * sizeof(float), [&]() {
+            Tensor<X86> trans_temp(winor_shape);
+            float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
+
+            if (_tile == 4) {
+                winograd_f4k3_transform_weights(static_cast<float*>(weights->mutable_data()),
+                                                static_cast<float*>(conv_param->weight()->data()), out_c, in_c, trans_tmp_ptr);
+            } else {
+                winograd_transform_weights(static_cast<float*>(weights->mutable_data()),
+                                           static_cast<float*>(conv_param->weight()->data()), out_c, in_c, trans_tmp_ptr);
+            }
+        });
+        return weights;
+    });
 
     return SaberSuccess;
 }
@@ -716,7 +816,7 @@ SaberStatus SaberConvWinogradAvx2<AK_FLOAT>::init(const std::vector<Tensor<X86>
         std::vector<Tensor<X86> *>& outputs,
         ConvEltwiseParam<X86>& param, Context<X86>& ctx) {
     this->_ctx = &ctx;
-    LOG(INFO) << "SaberConvWinogradAvx2 init";
+    LOG(INFO) << "SaberConvWinogradAvx2 init, F(" << _tile << "x" << _tile << ",3x3)";
     return create(inputs, outputs, param, ctx);
 
 }
@@ -752,10 +852,29 @@ SaberStatus SaberConvWinogradAvx2<AK_FLOAT>::dispatch(const std::vector<Tensor<X
     const float* din = (const float*)inputs[0]->data();
     float* dout = (float*)outputs[0]->mutable_data();
 
-    conv_x86_winograd3x3_avx2_opt(din, dout, batch_size, out_c, out_h, out_w, in_c, in_h, in_w,
-                                  static_cast<const float*>(_winor_weights.data()),
-                                  bias_ptr, conv_param->pad_w, conv_param->pad_h, bias_ptr != nullptr, with_relu,
-                                  static_cast<float*>(_winor_temp.mutable_data()));
+    // the transformed inputs and outputs of a block of tiles fill about half of l2, at least
+    // kMinTileBlock tiles reuse each transformed weight; smaller blocks only to keep all threads busy.
+    // the thread count is read per call, the caller may change it between calls.
+    int alpha = _tile + 2;
+    int tiles = batch_size * ((out_h + _tile - 1) / _tile) * ((out_w + _tile - 1) / _tile);
+    size_t tile_floats = static_cast<size_t>(alpha) * alpha * (in_c + out_c);
+    int nthreads = anakin_get_max_threads();
+    int tile_block = std::max(kMinTileBlock, static_cast<int>(kWinogradL2Bytes / 2 / (tile_floats * sizeof(float))));
+    tile_block = std::min(tile_block, (tiles + nthreads - 1) / nthreads);
+    tile_block = std::max(tile_block, 1);
+    utils::try_expand_tensor(_winor_temp, Shape({1, 1, nthreads, static_cast<int>(tile_floats) * tile_block}));
+
+    if (_tile == 4) {
+        conv_x86_winograd3x3_avx2_blocked<4>(din, dout, batch_size, out_c, out_h, out_w, in_c, in_h, in_w,
+                                             static_cast<const float*>(_winor_weights->data()),
+                                             bias_ptr, conv_param->pad_w, conv_param->pad_h, bias_ptr != nullptr, with_relu,
+                                             tile_block, static_cast<float*>(_winor_temp.mutable_data()));
+    } else {
+        conv_x86_winograd3x3_avx2_blocked<6>(din, dout, batch_size, out_c, out_h, out_w, in_c, in_h, in_w,
+                                             static_cast<const float*>(_winor_weights->data()),
+                                             bias_ptr, conv_param->pad_w, conv_param->pad_h, bias_ptr != nullptr, with_relu,
+                                             tile_block, static_cast<float*>(_winor_temp.mutable_data()));
+    }
 
     return SaberSuccess;
 }
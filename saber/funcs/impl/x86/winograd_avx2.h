@@ -12,7 +12,8 @@ class SaberConvWinogradAvx2 : public ImplBase <
 public:
     typedef typename DataTrait<X86, OpDtype>::Dtype OpDataType;
 
-    SaberConvWinogradAvx2() {}
+    /// tile is the output tile, 4 for F(4x4,3x3) or 6 for F(6x6,3x3).
+    explicit SaberConvWinogradAvx2(int tile = 6) : _tile(tile) {}
 
     ~SaberConvWinogradAvx2() {
     }
@@ -30,8 +31,9 @@ public:
                                  ConvEltwiseParam<X86>& param);
 
 private:
-    Tensor<X86> _winor_weights;
-    Tensor<X86> _winor_temp;
+    std::shared_ptr<const Tensor<X86> > _winor_weights; ///< transformed weights, read-only and shared through WeightRegistry.
+    Tensor<X86> _winor_temp; ///< per thread transformed inputs and outputs of a block of tiles, grown at dispatch.
+    int _tile{6};
 
 };
 }
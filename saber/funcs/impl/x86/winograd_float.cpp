@@ -1,4 +1,6 @@
 #include "saber/funcs/impl/x86/winograd_float.h"
+#include "saber/core/weight_registry.h"
+#include "saber/core/weight_cache.h"
 #include "mkl_cblas.h"
 #include "mkl_trans.h"
 #ifdef USE_SGX
@@ -149,12 +151,23 @@ SaberStatus SaberConvWinogradFloat<AK_FLOAT>::create(const std::vector<Tensor<X8
     int out_stride = out_h * out_w;
     int group = conv_param->group;
     const float* weights_d = (const float*)conv_param->weight()->data();
-    _winor_weights.re_alloc(Shape({8, 8, out_c, in_c}));
-    Tensor<X86> trans_temp(Shape({8, 8, out_c, in_c}));
-    float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
-
-    winograd_transform_weights(static_cast<float*>(_winor_weights.mutable_data()), static_cast<const float*>(conv_param->weight()->data()), out_c, in_c,
-                               trans_tmp_ptr);
+    Shape winor_shape({8, 8, out_c, in_c});
+    size_t weights_bytes = conv_param->weight()->valid_size() * sizeof(float);
+    std::vector<float> weights_attrs = {(float)out_c, (float)in_c};
+    std::string weights_key = WeightRegistry::make_key("winograd_float/f63", conv_param->weight()->data(),
+                              weights_bytes, weights_attrs);
+    _winor_weights = WeightRegistry::global().get_or_create<Tensor<X86> >(weights_key,
+                     winor_shape.count() * sizeof(float), [&]() {
+        std::shared_ptr<Tensor<X86> > weights(new Tensor<X86>(winor_shape));
+        WeightCache::load_or_build("winograd_float/f63", conv_param->weight()->data(), weights_bytes, weights_attrs,
+                                   weights->mutable_data(), winor_shape.count() * sizeof(float), [&]() {
+            Tensor<X86> trans_temp(winor_shape);
+            float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
+            winograd_transform_weights(static_cast<float*>(weights->mutable_data()),
+                                       static_cast<const float*>(conv_param->weight()->data()), out_c, in_c, trans_tmp_ptr);
+        });
+        return weights;
+    });
 
 
     int tile_w = (out_w + 5) / 6;
@@ -652,7 +665,7 @@ SaberStatus SaberConvWinogradFloat<AK_FLOAT>::dispatch(const std::vector<Tensor<
     float* dout = (float*)outputs[0]->mutable_data();
 
     conv_x86_winograd3x3(din, dout, batch_size, out_c, out_h, out_w, in_c, in_h, in_w,
-                         static_cast<const float *>(_winor_weights.data()),
+                         static_cast<const float *>(_winor_weights->data()),
                          bias_ptr, conv_param->pad_w, conv_param->pad_h, bias_ptr != nullptr, with_relu,
                          static_cast<float *>(_winor_temp.mutable_data()));
     return SaberSuccess;
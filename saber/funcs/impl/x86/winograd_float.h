@@ -30,7 +30,7 @@ public:
                                  ConvEltwiseParam<X86>& param);
 
 private:
-    Tensor<X86> _winor_weights;
+    std::shared_ptr<const Tensor<X86> > _winor_weights; ///< transformed weights, read-only and shared through WeightRegistry.
     Tensor<X86> _winor_temp;
 
 };
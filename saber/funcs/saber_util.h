@@ -151,6 +151,21 @@ public:
             }
         }
     }
+    /// inverse of hidden_2_sorted_hidden, rows of input are alligned_hidden_size apart.
+    template <typename Dtype>
+    void sorted_hidden_2_hidden(const Dtype* input, Dtype* output, int hidden_size,
+                                int alligned_hidden_size) {
+        int batch_size = _length_index.size();
+
+        for (int sorted_id = 0; sorted_id < batch_size; ++sorted_id) {
+            const Dtype* in = input + sorted_id * alligned_hidden_size;
+            Dtype* out = output + _length_index[sorted_id] * hidden_size;
+
+            for (int word_vec_offset = 0; word_vec_offset < hidden_size; ++word_vec_offset) {
+                out[word_vec_offset] = in[word_vec_offset];
+            }
+        }
+    }
     template <typename Dtype>
     void sorted_seq_2_seq(const Dtype* input, Dtype* output, int hidden_size) {
         int word_sum = _map_vec.size();
@@ -558,9 +573,11 @@ inline size_t datatype_size(DataType data_type) {
         return sizeof(int32_t);
 
     case AK_HALF:
+    case AK_BFLOAT16:
         return sizeof(int16_t);
 
     case AK_INT8:
+    case AK_INT4:
         return sizeof(int8_t);
 
     case AK_UINT8:
@@ -37,18 +37,20 @@ public:
 
     void clear() {
         ms_time.clear();
+        _sorted = true;
     }
 
     void start(Context<TargetType> &ctx) {
-        tstart = std::chrono::system_clock::now();
+        tstart = std::chrono::steady_clock::now();
     }
 
     void end(Context<TargetType> &ctx) {
-        tend = std::chrono::system_clock::now();
+        tend = std::chrono::steady_clock::now();
         auto ts = std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
         float elapse_ms = 1000.f * float(ts.count()) * std::chrono::microseconds::period::num / \
             std::chrono::microseconds::period::den;
         ms_time.push_back(elapse_ms);
+        _sorted = false;
     }
 
     float get_average_ms() {
@@ -72,7 +74,11 @@ public:
         if (total_items <= 0) {
             return -2.f;
         }
-        ms_time.sort();
+        // sorted once for all the tiles queried after the last sample
+        if (!_sorted) {
+            ms_time.sort();
+            _sorted = true;
+        }
         int pos = (int)(tile * total_items / 100);
         auto it = ms_time.begin();
         for (int i = 0; i < pos; ++i) {
@@ -86,9 +92,10 @@ public:
     }
 
 private:
-    std::chrono::time_point<std::chrono::system_clock> tstart;
-    std::chrono::time_point<std::chrono::system_clock> tend;
+    std::chrono::time_point<std::chrono::steady_clock> tstart;
+    std::chrono::time_point<std::chrono::steady_clock> tend;
     std::list<float> ms_time;
+    bool _sorted{true};
 };
 #ifdef USE_CUDA
 template <>
@@ -107,6 +114,7 @@ public:
 
     void clear() {
         ms_time.clear();
+        _sorted = true;
     }
 
     void start(Context<NV> &ctx) {
@@ -123,6 +131,7 @@ public:
         float elapse_ms = 0.f;
         CUDA_CHECK(cudaEventElapsedTime(&elapse_ms, _e_start, _e_end));
         ms_time.push_back(elapse_ms);
+        _sorted = false;
     }
 
     float get_average_ms() {
@@ -146,7 +155,11 @@ public:
         if (total_items <= 0) {
             return -2.f;
         }
-        ms_time.sort();
+        // sorted once for all the tiles queried after the last sample
+        if (!_sorted) {
+            ms_time.sort();
+            _sorted = true;
+        }
         int pos = (int)(tile * total_items / 100);
         auto it = ms_time.begin();
         for (int i = 0; i < pos; ++i) {
@@ -162,6 +175,7 @@ public:
 private:
     cudaEvent_t _e_start, _e_end;
     std::list<float> ms_time;
+    bool _sorted{true};
 };
 #endif
 
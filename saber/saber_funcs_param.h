@@ -1354,6 +1354,22 @@ struct GenerateProposalsParam {
     float eta{0.f};
 };
 
+/**
+ * \brief Recurrent state of a streaming rnn (gru, lstm) carried across dispatches.
+ *  Row i of hidden (and cell for lstm) is the state of sequence i of the batch, it's read
+ *  as the initial state of the sequence and overwritten with its state after the last step.
+ *  Rows of empty sequences are left as they are. Only fp32, single layer, forward rnns.
+ */
+template <typename TargetType>
+struct RnnState {
+    ///< batch x hidden_size.
+    Tensor<TargetType> hidden;
+    ///< batch x hidden_size, only lstm.
+    Tensor<TargetType> cell;
+    int hidden_size{0};
+    bool with_cell{false};
+};
+
 /**
  * GRU_Formula,origin for paddle,Cudnn for cudnn,difference is w_h_r and weighted mean
  * weight for origin is [W_h_o][W_h_r,W_h_z]
@@ -1376,6 +1392,7 @@ struct GruParam {
         , gate_activity(Active_sigmoid)
         , h_activity(Active_tanh)
         , formula(GRU_ORIGIN)
+        , state(nullptr)
     {}
     /**
      *
@@ -1402,6 +1419,7 @@ struct GruParam {
         , h_activity(h_activity_in)
         , formula(formula_in)
         , init_hidden_tensor(hidden_init_in)
+        , state(nullptr)
     {}
 
 
@@ -1416,6 +1434,7 @@ struct GruParam {
         is_reverse = right.is_reverse;
         formula = right.formula;
         init_hidden_tensor = right.init_hidden_tensor;
+        state = right.state;
         return *this;
     }
 
@@ -1431,6 +1450,7 @@ struct GruParam {
         comp_eq = comp_eq && (is_reverse = right.is_reverse);
         comp_eq = comp_eq && (formula = right.formula);
         comp_eq = comp_eq && (init_hidden_tensor == right.init_hidden_tensor);
+        comp_eq = comp_eq && (state == right.state);
         return comp_eq;
     }
 
@@ -1453,6 +1473,8 @@ struct GruParam {
     ActiveType h_activity;
     GruFormula formula;
     bool is_reverse;
+    ///< streaming state, nullptr starts every sequence from init_hidden (or zeros).
+    RnnState<TargetType>* state;
 private:
     opTensor* weight_tensor;
     opTensor* bias_tensor;
@@ -1646,6 +1668,7 @@ struct LstmParam {
         , skip_num(1)
         , project_dim(-1)
         , cell_dim(-1)
+        , state(nullptr)
     {}
 
     LstmParam(opTensor* weight_in, opTensor* bias_in,
@@ -1681,6 +1704,7 @@ struct LstmParam {
         , skip_num(skip_num_in)
         , project_dim(project_dim_in)
         , cell_dim(cell_dim_in)
+        , state(nullptr)
     {}
 
 
@@ -1701,6 +1725,7 @@ struct LstmParam {
         skip_num = right.skip_num;
         project_dim=right.project_dim;
         cell_dim=right.cell_dim;
+        state = right.state;
         return *this;
     }
 
@@ -1722,6 +1747,7 @@ struct LstmParam {
         comp_eq = comp_eq && (skip_num == right.skip_num);
         comp_eq = comp_eq && (project_dim == right.project_dim);
         comp_eq = comp_eq && (cell_dim == right.cell_dim);
+        comp_eq = comp_eq && (state == right.state);
         return comp_eq;
     }
 
@@ -1759,6 +1785,8 @@ struct LstmParam {
     int skip_num;
     int project_dim;
     int cell_dim;
+    ///< streaming state, nullptr starts every sequence from zeros.
+    RnnState<TargetType>* state;
 private:
     opTensor* weight_tensor;
     opTensor* bias_tensor;
@@ -3730,6 +3758,35 @@ struct SeqConcatSeqPoolSoftSignParam{
     SoftSignParam<TargetType> soft_sign;
 };
 
+template <typename TargetType>
+struct EmbeddingSeqPoolParam{
+    EmbeddingSeqPoolParam() = default;
+
+    EmbeddingSeqPoolParam(EmbeddingParam<TargetType> embedding_in,
+                          SequencePoolParam<TargetType> seq_pool_in):
+                          embedding(embedding_in),
+                          seq_pool(seq_pool_in) {}
+
+    EmbeddingSeqPoolParam(const EmbeddingSeqPoolParam& right) : embedding(right.embedding),
+        seq_pool(right.seq_pool) {}
+
+    EmbeddingSeqPoolParam& operator=(const EmbeddingSeqPoolParam& right) {
+        embedding = right.embedding;
+        seq_pool = right.seq_pool;
+        return *this;
+    }
+
+    bool operator==(const EmbeddingSeqPoolParam& right) {
+        bool flag = true;
+        flag = flag && embedding == right.embedding;
+        flag = flag && seq_pool == right.seq_pool;
+        return flag;
+    }
+
+    EmbeddingParam<TargetType> embedding;
+    SequencePoolParam<TargetType> seq_pool;
+};
+
 template <typename TargetType>
 struct YoloBoxParam {
 
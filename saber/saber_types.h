@@ -218,7 +218,9 @@ enum DataType {
     AK_STRING       =       11,
     AK_BOOL         =       12,
     AK_SHAPE        =       13,
-    AK_TENSOR       =       14
+    AK_TENSOR       =       14,
+    AK_BFLOAT16     =       15, ///< storage only: 8 bit exponent and 7 bit mantissa, kernels accumulate in fp32.
+    AK_INT4         =       16  ///< storage only: two signed 4 bit values per byte, the shape counts bytes.
 };
 typedef enum {
     SaberSuccess         = -1,                             /*!< No errors */
@@ -0,0 +1,131 @@
+#include "core_test.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace {
+
+typedef std::chrono::steady_clock test_clock;
+
+const char* policy_name(SchedulePolicy policy) {
+    return policy == SchedulePolicy::FIFO ? "fifo" : "work_stealing";
+}
+
+} // namespace
+
+TEST(CoreComponentsTest, core_thread_pool_schedule_policy_test) {
+    // both policies must run every task exactly once, including tasks pushed from inside the pool.
+    for (auto policy : {SchedulePolicy::FIFO, SchedulePolicy::WORK_STEALING}) {
+        ThreadPool pool(4, policy);
+        pool.launch();
+        std::atomic<int> sum{0};
+        std::function<int(int)> add = [&sum](int i) {
+            sum += i;
+            return i;
+        };
+        std::function<int(int)> spawn = [&](int i) {
+            pool.RunAsync(add, i);
+            return i;
+        };
+        for (int i = 0; i < 1000; i++) {
+            pool.RunAsync(i % 2 ? spawn : add, i);
+        }
+        auto start = test_clock::now();
+        while (sum.load() != 999 * 1000 / 2 && test_clock::now() - start < std::chrono::seconds(10)) {
+            std::this_thread::yield();
+        }
+        CHECK_EQ(sum.load(), 999 * 1000 / 2) << policy_name(policy);
+    }
+}
+
+/// a task that holds the only thread of a pool until open() is called.
+class Gate {
+public:
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mut);
+        _cv.wait(lock, [this]() { return _open; });
+    }
+    void open() {
+        {
+            std::lock_guard<std::mutex> guard(_mut);
+            _open = true;
+        }
+        _cv.notify_all();
+    }
+private:
+    std::mutex _mut;
+    std::condition_variable _cv;
+    bool _open{false};
+};
+
+TEST(CoreComponentsTest, core_thread_pool_submit_order_test) {
+    // tasks submitted from outside run in arrival order in both policies, the oldest requests don't starve.
+    for (auto policy : {SchedulePolicy::FIFO, SchedulePolicy::WORK_STEALING}) {
+        ThreadPool pool(1, policy);
+        pool.launch();
+        Gate gate;
+        std::function<int(int)> hold = [&gate](int i) {
+            gate.wait();
+            return i;
+        };
+        std::vector<int> order;
+        std::function<int(int)> record = [&order](int i) {
+            order.push_back(i);
+            return i;
+        };
+        auto held = pool.RunAsync(hold, 0);
+        std::vector<std::future<int> > results;
+        for (int i = 0; i < 16; i++) {
+            results.push_back(pool.RunAsync(record, i));
+        }
+        gate.open();
+        held.get();
+        for (auto& result : results) {
+            result.get();
+        }
+        for (int i = 0; i < 16; i++) {
+            CHECK_EQ(order[i], i) << policy_name(policy);
+        }
+    }
+}
+
+TEST(CoreComponentsTest, core_thread_pool_stop_test) {
+    // stop drops the queued tasks in both policies, the running one finishes.
+    for (auto policy : {SchedulePolicy::FIFO, SchedulePolicy::WORK_STEALING}) {
+        std::atomic<int> ran{0};
+        Gate gate;
+        std::function<int(int)> hold = [&](int i) {
+            gate.wait();
+            ran++;
+            return i;
+        };
+        std::function<int(int)> count = [&ran](int i) {
+            ran++;
+            return i;
+        };
+        {
+            ThreadPool pool(1, policy);
+            pool.launch();
+            pool.RunAsync(hold, 0);
+            for (int i = 0; i < 8; i++) {
+                pool.RunAsync(count, i);
+            }
+            std::thread stopper([&pool]() { pool.stop(); });
+            // let stop() raise the flag before the held task returns
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            gate.open();
+            stopper.join();
+        }
+        CHECK_EQ(ran.load(), 1) << policy_name(policy);
+    }
+}
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
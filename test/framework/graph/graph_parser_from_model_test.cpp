@@ -3,6 +3,7 @@
 #include "graph_base.h"
 #include "graph.h"
 #include "scheduler.h"
+#include "framework/model_parser/parser/parser.h"
 
 using namespace anakin;
 using namespace anakin::graph;
@@ -80,6 +81,63 @@ TEST(GraphTest, arm_graph_save_model) {
 #endif
 #endif
 
+#ifdef USE_X86_PLACE
+TEST(GraphTest, x86_graph_load_packed_model) {
+    // pack the model for mapping, its weights are read in place.
+    std::string packed_model_path = model_path + std::string(".mmap");
+    Status status = parser::save_mmap(model_path.c_str(), packed_model_path.c_str());
+    CHECK(status) << "pack model failed";
+    CHECK(parser::MappedModel::is_packed(packed_model_path.c_str()));
+    // the writes are buffered, a full disk is only reported by flush or close.
+    CHECK(!parser::save_mmap(model_path.c_str(), "/dev/full")) << "writing to a full disk succeeded";
+
+    Graph<X86, Precision::FP32>* graph = new Graph<X86, Precision::FP32>();
+    graph->load(model_path);
+    Graph<X86, Precision::FP32>* packed_graph = new Graph<X86, Precision::FP32>();
+    packed_graph->load(packed_model_path);
+
+    // both graphs have the same weights.
+    auto nodes = graph->get_nodes_in_order();
+    for (auto& name : nodes) {
+        auto node = (*graph)[name];
+        auto packed_node = (*packed_graph)[name];
+        for (auto it = node->attr().begin(); it != node->attr().end(); ++it) {
+            if (it->second.type() != "anakin_block") {
+                continue;
+            }
+            auto block = any_cast<PBlock<X86>>(it->second);
+            auto packed_block = packed_node->get_attr<PBlock<X86>>(it->first);
+            CHECK(block.real_shape() == packed_block.real_shape()) << name << "/" << it->first;
+            CHECK_EQ(memcmp(block.h_tensor().data(), packed_block.h_tensor().data(),
+                            block.real_shape().count() * type_length(block.data_type())), 0)
+                    << name << "/" << it->first;
+        }
+    }
+    LOG(INFO) << "packed model check pass";
+}
+
+TEST(GraphTest, x86_graph_load_corrupt_packed_model) {
+    // an index running past the end of the file is refused, not read.
+    std::string corrupt_model_path = model_path + std::string(".corrupt.mmap");
+    parser::PackedModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, parser::PackedModelMagic, sizeof(header.magic));
+    header.index_offset = sizeof(header);
+    header.index_count = 1;
+    uint32_t name_len = 1 << 20;
+    FILE* f = fopen(corrupt_model_path.c_str(), "wb");
+    CHECK(f != nullptr);
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(&name_len, sizeof(name_len), 1, f);
+    fclose(f);
+    CHECK(parser::MappedModel::is_packed(corrupt_model_path.c_str()));
+    CHECK(parser::MappedModel::open(corrupt_model_path.c_str()) == nullptr);
+    Graph<X86, Precision::FP32> graph;
+    CHECK(!graph.load(corrupt_model_path));
+    LOG(INFO) << "corrupt packed model check pass";
+}
+#endif
+
 int main(int argc, const char** argv) {
     // initial logger
     logger::init(argv[0]);
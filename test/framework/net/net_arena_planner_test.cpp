@@ -0,0 +1,71 @@
+#include <string>
+#include <cstdlib>
+#include "net_test.h"
+#include "framework/core/net/arena_planner.h"
+
+int g_buffer_num = 200;
+
+TEST(NetTest, net_arena_planner_test) {
+    // a chain a -> b -> c -> d: a and c can share memory, so can b and d.
+    {
+        ArenaPlanner planner(1);
+        planner.add("a", 100, 0, 1);
+        planner.add("b", 50, 1, 2);
+        planner.add("c", 100, 2, 3);
+        planner.add("d", 50, 3, 4);
+        CHECK_EQ(planner.plan(), 150);
+        CHECK_EQ(planner.total(), 300);
+        CHECK_EQ(planner.offset("a"), planner.offset("c"));
+        CHECK_EQ(planner.offset("b"), planner.offset("d"));
+    }
+    // best fit: the small buffer takes the small gap and leaves the big one.
+    {
+        ArenaPlanner planner(1);
+        planner.add("big", 100, 0, 0);
+        planner.add("small", 10, 0, 0);
+        planner.add("left", 100, 1, 1);
+        planner.add("right", 10, 1, 1);
+        planner.add("late", 10, 0, 2);
+        size_t peak = planner.plan();
+        CHECK_EQ(peak, 120);
+        CHECK_EQ(planner.offset("big"), planner.offset("left"));
+    }
+    // random lifetimes: buffers alive at the same time never overlap in the arena.
+    {
+        srand(12345);
+        ArenaPlanner planner;
+        std::vector<int> size(g_buffer_num), first(g_buffer_num), last(g_buffer_num);
+        for (int i = 0; i < g_buffer_num; i++) {
+            size[i] = rand() % 100000 + 1;
+            first[i] = rand() % 100;
+            last[i] = first[i] + rand() % 10;
+            planner.add(std::to_string(i), size[i], first[i], last[i]);
+        }
+        size_t peak = planner.plan();
+        for (int i = 0; i < g_buffer_num; i++) {
+            CHECK_EQ(planner.offset(std::to_string(i)) % 64, 0);
+            CHECK_LE(planner.offset(std::to_string(i)) + size[i], peak);
+            for (int j = i + 1; j < g_buffer_num; j++) {
+                if (first[i] > last[j] || first[j] > last[i]) {
+                    continue;
+                }
+                size_t oi = planner.offset(std::to_string(i));
+                size_t oj = planner.offset(std::to_string(j));
+                CHECK(oi + size[i] <= oj || oj + size[j] <= oi) << "buffer " << i << " and " << j << " overlap";
+            }
+        }
+        LOG(INFO) << "planned peak: " << peak / 1024.0 / 1024.0 << " MB, sum of buffers: "
+                  << planner.total() / 1024.0 / 1024.0 << " MB";
+    }
+}
+
+int main(int argc, const char** argv) {
+    if (argc > 1) {
+        g_buffer_num = atoi(argv[1]);
+    }
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <string>
+#include "net_test.h"
+#include "saber/core/tensor_op.h"
+#include <cmath>
+
+std::string g_model_path = "";
+int g_frames = 12;
+int g_chunk = 4;
+
+#ifdef USE_X86_PLACE
+
+TEST(NetTest, net_rnn_session_store_test) {
+    auto session = [](int floats) {
+        auto state = std::make_shared<RnnSession>();
+        state->hidden.push_back(std::vector<float>(floats, 1.f));
+        return state;
+    };
+    // room for two sessions of 64 floats
+    RnnSessionStore store(2 * 64 * sizeof(float));
+    store.put("a", session(64));
+    store.put("b", session(64));
+    CHECK(store.find("a") != nullptr);
+    // b is the least recently used one now
+    store.put("c", session(64));
+    CHECK(store.find("b") == nullptr);
+    CHECK(store.find("a") != nullptr);
+    CHECK(store.find("c") != nullptr);
+    CHECK_EQ(store.evicted(), 1);
+    CHECK_EQ(store.bytes(), 2 * 64 * sizeof(float));
+    CHECK(store.erase("a"));
+    CHECK(!store.erase("a"));
+    CHECK_EQ(store.size(), 1);
+    // a state bigger than the cap still stays until the next put
+    store.put("d", session(256));
+    CHECK_EQ(store.size(), 1);
+    CHECK(store.find("d") != nullptr);
+}
+
+/// frames of sequences with seq_offset, small integers fit id inputs (embedding) and features.
+void fill_frames(Tensor4dPtr<X86> in, int word_size, std::vector<int> seq_offset, unsigned int seed) {
+    in->reshape(Shape({seq_offset.back(), word_size, 1, 1}));
+    auto* data = static_cast<float*>(in->mutable_data());
+    for (int i = 0; i < in->valid_size(); i++) {
+        data[i] = (seed + i * 7) % 10;
+    }
+    in->set_seq_offset({seq_offset});
+}
+
+TEST(NetTest, net_rnn_session_stream_test) {
+    if (g_model_path.empty()) {
+        LOG(INFO) << "no rnn model, streaming isn't checked";
+        return;
+    }
+    Graph<X86, Precision::FP32> graph;
+    auto status = graph.load(g_model_path);
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+    auto in_name = graph.get_ins()[0];
+    auto shape = graph[in_name]->template get_attr<PTuple<int>>("input_shape");
+    int word_size = shape[1];
+    graph.Reshape(in_name, {2 * g_frames, word_size, 1, 1});
+    graph.Optimize();
+    Net<X86, Precision::FP32> net(graph, true);
+
+    // two streams fed whole: the reference
+    fill_frames(net.get_in(in_name), word_size, {0, g_frames, 2 * g_frames}, 0);
+    auto all_frames = std::make_shared<Tensor4d<X86> >();
+    all_frames->re_alloc(net.get_in(in_name)->valid_shape());
+    all_frames->copy_from(*net.get_in(in_name));
+    net.prediction();
+    auto out = net.get_out_list()[0];
+    if (out->num() != 2 * g_frames) {
+        LOG(WARNING) << "the model doesn't output per frame, streaming isn't checked";
+        return;
+    }
+    Tensor4d<X86> reference;
+    reference.re_alloc(out->valid_shape());
+    reference.copy_from(*out);
+    int out_size = out->valid_size() / out->num();
+
+    // the same streams fed g_chunk frames at a time
+    float max_diff = 0.f;
+    for (int start = 0; start < g_frames; start += g_chunk) {
+        int len = std::min(g_chunk, g_frames - start);
+        auto in = net.get_in(in_name);
+        in->reshape(Shape({2 * len, word_size, 1, 1}));
+        auto* frames = static_cast<const float*>(all_frames->data());
+        auto* data = static_cast<float*>(in->mutable_data());
+        for (int stream = 0; stream < 2; stream++) {
+            memcpy(data + stream * len * word_size, frames + (stream * g_frames + start) * word_size,
+                   len * word_size * sizeof(float));
+        }
+        in->set_seq_offset({{0, len, 2 * len}});
+        CHECK(net.prediction({"stream_0", "stream_1"}));
+        auto chunk_out = net.get_out_list()[0];
+        auto* got = static_cast<const float*>(chunk_out->data());
+        auto* expected = static_cast<const float*>(reference.data());
+        for (int stream = 0; stream < 2; stream++) {
+            for (int i = 0; i < len * out_size; i++) {
+                float diff = std::fabs(got[stream * len * out_size + i]
+                                       - expected[(stream * g_frames + start) * out_size + i]);
+                max_diff = std::max(max_diff, diff);
+            }
+        }
+    }
+    LOG(INFO) << "streamed vs whole max diff " << max_diff;
+    CHECK_LT(max_diff, 1e-4f);
+    CHECK_EQ(net.sessions().size(), 2);
+    // a session continued twice by one prediction is refused, its state is untouched
+    auto saved = net.sessions().find("stream_0");
+    CHECK(!net.prediction({"stream_0", "stream_0"}));
+    CHECK(net.sessions().find("stream_0") == saved);
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    if (argc > 1) {
+        g_model_path = std::string(argv[1]);
+    }
+    if (argc > 2) {
+        g_frames = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        g_chunk = atoi(argv[3]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -17,6 +17,11 @@ int g_thread_num = 1;
 bool g_random = 0;
 int g_instance = 1;
 int g_change_batch = 0;
+int g_frozen_plan = 0;
+int g_branch_threads = 0;
+int g_arena_memory = 0;
+int g_weights_cache = 0;
+int g_profile_every = 0;
 int g_auto_config_layout = 0;
 #define USE_FROZEN_INT8 0
 
@@ -74,6 +79,10 @@ void  instance_run() {
 #else
     Net<X86, Precision::FP32> net_executer(true);
 #endif
+    net_executer.set_arena_memory(g_arena_memory);
+    if (g_weights_cache) {
+        net_executer.set_weights_cache(g_model_path + ".wcache");
+    }
     if (g_auto_config_layout){
         LOG(INFO) << "===================auto_config_layout====================";
         net_executer.init(*graph,true);
@@ -81,6 +90,11 @@ void  instance_run() {
 //        net_executer.load_x86_layout_config("layout_config_me.txt");
         net_executer.init(*graph);
     }
+    net_executer.set_frozen_plan(g_frozen_plan);
+    net_executer.set_parallel_branches(g_branch_threads);
+    if (g_profile_every > 0) {
+        net_executer.set_profiling(g_profile_every);
+    }
     // get in
     std::vector<std::vector<int>> seq_offset={{0,g_batch_size}};
     srand(12345);
@@ -161,6 +175,11 @@ void  instance_run() {
 #ifdef ENABLE_OP_TIMER
     net_executer.print_and_reset_optime_summary(g_warm_up + g_epoch);
 #endif
+    if (g_profile_every > 0) {
+        LOG(INFO) << net_executer.profiler().summary();
+        net_executer.profiler().export_csv(replace_all(g_model_path, "/", "_") + ".profile.csv");
+        net_executer.profiler().export_chrome_trace(replace_all(g_model_path, "/", "_") + ".trace.json");
+    }
 
 
 //    std::string save_g_model_path = g_model_path + std::string(".saved");
@@ -276,6 +295,11 @@ void  net_execute_base_test_int8() {
  * g_epoch 计时次数,默认1
  * g_thread_num 用到的线程数,默认1
  * g_random 是否是随机数输入,默认是,0代表常量输入
+ * g_frozen_plan 输入shape不变时跳过infer_shape,默认0
+ * g_branch_threads 并行执行独立分支的线程数,默认0(串行)
+ * g_arena_memory 按生命周期把中间tensor规划到一块内存,默认0
+ * g_weights_cache 把重排后的权重缓存到模型旁的.wcache文件,默认0
+ * g_profile_every 每N次预测统计一次各op耗时,导出csv和chrome trace,默认0(关闭)
  * @param argc
  * @param argv
  * @return
@@ -325,6 +349,26 @@ int main(int argc, const char** argv) {
         g_change_batch = atoi(argv[9]);
     }
 
+    if (argc > 10) {
+        g_frozen_plan = atoi(argv[10]);
+    }
+
+    if (argc > 11) {
+        g_branch_threads = atoi(argv[11]);
+    }
+
+    if (argc > 12) {
+        g_arena_memory = atoi(argv[12]);
+    }
+
+    if (argc > 13) {
+        g_weights_cache = atoi(argv[13]);
+    }
+
+    if (argc > 14) {
+        g_profile_every = atoi(argv[14]);
+    }
+
 
 
     Env<X86>::env_init();
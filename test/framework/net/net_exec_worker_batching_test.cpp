@@ -0,0 +1,133 @@
+#include <string>
+#include "net_test.h"
+#include "saber/funcs/timer.h"
+#include "saber/core/tensor_op.h"
+#include <chrono>
+
+std::string g_model_path = "";
+int g_client_num = 16;
+int g_request_num = 100;
+int g_max_batch = 16;
+int g_max_wait_us = 2000;
+int g_thread_num = 2;
+
+#ifdef USE_X86_PLACE
+
+typedef Tensor4d<X86> HostTensor;
+
+/// run g_client_num concurrent clients against worker and return the average latency in ms
+float run_clients(Worker<X86, Precision::FP32>& worker, std::vector<HostTensor>& ins) {
+    std::vector<std::thread> clients;
+    std::vector<float> latency(g_client_num, 0.f);
+    for (int c = 0; c < g_client_num; c++) {
+        clients.emplace_back([&, c]() {
+            std::vector<HostTensor> my_ins;
+            for (auto& in : ins) {
+                my_ins.push_back(in);
+            }
+            for (int i = 0; i < g_request_num; i++) {
+                auto start = std::chrono::steady_clock::now();
+                auto outs = worker.sync_prediction(my_ins).get();
+                latency[c] += std::chrono::duration<float, std::milli>(
+                        std::chrono::steady_clock::now() - start).count();
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    float sum = 0.f;
+    for (auto t : latency) {
+        sum += t;
+    }
+    return sum / (g_client_num * g_request_num);
+}
+
+TEST(NetTest, net_execute_worker_batching_test) {
+    Graph<X86, Precision::FP32> graph;
+    auto status = graph.load(g_model_path);
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+    auto ins_name = graph.get_ins();
+    auto outs_name = graph.get_outs();
+
+    std::vector<HostTensor> ins;
+    for (auto& in_name : ins_name) {
+        auto shape = graph[in_name]->template get_attr<PTuple<int>>("input_shape");
+        HostTensor in(Shape({1, shape[1], shape[2], shape[3]}));
+        fill_tensor_rand(in);
+        ins.push_back(in);
+    }
+
+    float batched_ms = 0.f;
+    float single_ms = 0.f;
+    std::vector<HostTensor> batched_outs;
+    {
+        Worker<X86, Precision::FP32> worker(g_model_path, g_thread_num);
+        worker.register_inputs(ins_name);
+        worker.register_outputs(outs_name);
+        for (int i = 0; i < ins_name.size(); i++) {
+            worker.Reshape(ins_name[i], {1, ins[i].channel(), ins[i].height(), ins[i].width()});
+        }
+        worker.set_batching(g_max_batch, g_max_wait_us);
+        worker.launch();
+        batched_ms = run_clients(worker, ins);
+        batched_outs = worker.sync_prediction(ins).get();
+    }
+    {
+        Worker<X86, Precision::FP32> worker(g_model_path, g_thread_num);
+        worker.register_inputs(ins_name);
+        worker.register_outputs(outs_name);
+        for (int i = 0; i < ins_name.size(); i++) {
+            worker.Reshape(ins_name[i], {1, ins[i].channel(), ins[i].height(), ins[i].width()});
+        }
+        worker.launch();
+        single_ms = run_clients(worker, ins);
+        auto single_outs = worker.sync_prediction(ins).get();
+        for (int i = 0; i < single_outs.size(); i++) {
+            double max_ratio = 0;
+            double max_diff = 0;
+            tensor_cmp_host((const float*)single_outs[i].data(), (const float*)batched_outs[i].data(),
+                            single_outs[i].valid_size(), max_ratio, max_diff);
+            LOG(INFO) << outs_name[i] << " max_ratio: " << max_ratio << " max_diff: " << max_diff;
+            CHECK_LE(max_diff, 1e-3f) << "batched output mismatch";
+        }
+    }
+    LOG(INFO) << "clients: " << g_client_num << " max_batch: " << g_max_batch
+              << " deadline: " << g_max_wait_us << " us";
+    LOG(INFO) << "avg latency with batching: " << batched_ms << " ms, without batching: " << single_ms << " ms";
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        LOG(ERROR) << "usage: " << argv[0] << " model_path [clients] [requests] [max_batch] [max_wait_us] [threads]";
+        return 0;
+    }
+    g_model_path = std::string(argv[1]);
+    if (argc > 2) {
+        g_client_num = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        g_request_num = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        g_max_batch = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        g_max_wait_us = atoi(argv[5]);
+    }
+    if (argc > 6) {
+        g_thread_num = atoi(argv[6]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
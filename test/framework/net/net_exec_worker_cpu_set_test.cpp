@@ -0,0 +1,137 @@
+#include <string>
+#include "net_test.h"
+#include "saber/core/tensor_op.h"
+#include "framework/core/net/op_profiler.h"
+#include <chrono>
+
+std::string g_model_path_a = "";
+std::string g_model_path_b = "";
+int g_client_num = 4;
+int g_request_num = 200;
+int g_thread_num = 2;
+
+#ifdef USE_X86_PLACE
+
+typedef Tensor4d<X86> HostTensor;
+
+/// a served model: its worker and random inputs.
+struct Model {
+    std::unique_ptr<Worker<X86, Precision::FP32> > worker;
+    std::vector<HostTensor> ins;
+};
+
+void serve(Model& model, const std::string& path, const std::vector<int>& cores, int omp_threads) {
+    Graph<X86, Precision::FP32> graph;
+    auto status = graph.load(path);
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+    auto ins_name = graph.get_ins();
+    model.worker.reset(new Worker<X86, Precision::FP32>(path, g_thread_num));
+    model.worker->register_inputs(ins_name);
+    model.worker->register_outputs(graph.get_outs());
+    for (auto& in_name : ins_name) {
+        auto shape = graph[in_name]->template get_attr<PTuple<int>>("input_shape");
+        HostTensor in(Shape({1, shape[1], shape[2], shape[3]}));
+        fill_tensor_rand(in);
+        model.ins.push_back(in);
+        model.worker->Reshape(in_name, {1, shape[1], shape[2], shape[3]});
+    }
+    model.worker->set_cpu_set(cores, omp_threads);
+    model.worker->launch();
+}
+
+/// load both models with g_client_num clients each at the same time, return their latencies.
+std::vector<LatencyHistogram> run_clients(std::vector<Model>& models) {
+    std::vector<std::vector<LatencyHistogram> > hists(models.size(),
+                                                      std::vector<LatencyHistogram>(g_client_num));
+    std::vector<std::thread> clients;
+    for (int m = 0; m < models.size(); m++) {
+        for (int c = 0; c < g_client_num; c++) {
+            clients.emplace_back([&, m, c]() {
+                std::vector<HostTensor> my_ins;
+                for (auto& in : models[m].ins) {
+                    my_ins.push_back(in);
+                }
+                for (int i = 0; i < g_request_num; i++) {
+                    auto start = OpProfiler::now_ns();
+                    auto outs = models[m].worker->sync_prediction(my_ins).get();
+                    hists[m][c].add(OpProfiler::now_ns() - start);
+                }
+            });
+        }
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    std::vector<LatencyHistogram> ret(models.size());
+    for (int m = 0; m < models.size(); m++) {
+        for (auto& hist : hists[m]) {
+            ret[m].merge(hist);
+        }
+    }
+    return ret;
+}
+
+void report(const std::string& title, std::vector<LatencyHistogram>& hists) {
+    for (int m = 0; m < hists.size(); m++) {
+        LOG(INFO) << title << " model " << m << ": mean " << hists[m].mean_ms() << " ms, p50 "
+                  << hists[m].percentile_ms(50) << " ms, p99 " << hists[m].percentile_ms(99)
+                  << " ms, max " << hists[m].max_ns() / 1e6 << " ms";
+    }
+}
+
+TEST(NetTest, net_execute_worker_cpu_set_test) {
+    auto cores = thread_cores();
+    int half = std::max<int>(1, cores.size() / 2);
+    LOG(INFO) << "cores: " << cores.size() << ", numa nodes: " << numa_node_num()
+              << ", threads per model: " << g_thread_num << ", clients per model: " << g_client_num;
+    // both models float over all cores, every thread runs a full OpenMP team
+    {
+        std::vector<Model> models(2);
+        serve(models[0], g_model_path_a, {}, 1);
+        serve(models[1], g_model_path_b, {}, 1);
+        auto hists = run_clients(models);
+        report("shared cores", hists);
+    }
+    // each model owns half of the cores (a socket on two socket hosts), split between its threads
+    {
+        std::vector<int> cores_a(cores.begin(), cores.begin() + half);
+        std::vector<int> cores_b(cores.begin() + std::min<int>(half, cores.size() - 1), cores.end());
+        int omp_a = std::max<int>(1, cores_a.size() / g_thread_num);
+        int omp_b = std::max<int>(1, cores_b.size() / g_thread_num);
+        std::vector<Model> models(2);
+        serve(models[0], g_model_path_a, cores_a, omp_a);
+        serve(models[1], g_model_path_b, cores_b, omp_b);
+        auto hists = run_clients(models);
+        report("partitioned cores", hists);
+    }
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        LOG(ERROR) << "usage: " << argv[0] << " model_a [model_b] [clients] [requests] [threads]";
+        return 0;
+    }
+    g_model_path_a = std::string(argv[1]);
+    g_model_path_b = argc > 2 ? std::string(argv[2]) : g_model_path_a;
+    if (argc > 3) {
+        g_client_num = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        g_request_num = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        g_thread_num = atoi(argv[5]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <string>
+#include "net_test.h"
+#include "saber/core/tensor_op.h"
+#include <algorithm>
+#include <chrono>
+
+std::string g_model_path = "";
+int g_request_num = 1000;
+int g_online_every = 10;
+int g_thread_num = 2;
+
+typedef PriorityScheduler::TimePoint TimePoint;
+
+TEST(NetTest, net_priority_scheduler_test) {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<TimePoint> heads = {now, now};
+    PriorityScheduler strict;
+    strict.configure(2, {}, 0);
+    CHECK_EQ(strict.pick(heads, now), 0);
+    CHECK_EQ(strict.pick({TimePoint::max(), now}, now), 1);
+    CHECK_EQ(strict.pick({TimePoint::max(), TimePoint::max()}, now), -1);
+    CHECK_EQ(strict.class_of(-3), 0);
+    CHECK_EQ(strict.class_of(7), 1);
+
+    // both classes always waiting: 3 of every 4 picks go to class 0
+    PriorityScheduler weighted;
+    weighted.configure(2, {3, 1}, 0);
+    std::vector<int> picks(2, 0);
+    for (int i = 0; i < 400; i++) {
+        int cls = weighted.pick(heads, now);
+        weighted.served(cls, heads);
+        picks[cls]++;
+    }
+    CHECK_EQ(picks[0], 300);
+    CHECK_EQ(picks[1], 100);
+
+    // a background request past max_wait goes before the urgent ones
+    PriorityScheduler bounded;
+    bounded.configure(2, {}, 10);
+    CHECK_EQ(bounded.pick({now, now - std::chrono::milliseconds(5)}, now), 0);
+    CHECK_EQ(bounded.pick({now, now - std::chrono::milliseconds(20)}, now), 1);
+}
+
+#ifdef USE_X86_PLACE
+
+typedef Tensor4d<X86> HostTensor;
+typedef Worker<X86, Precision::FP32> TestWorker;
+
+double p99_ms(std::vector<long long>& latency_ns) {
+    if (latency_ns.empty()) {
+        return 0.;
+    }
+    std::sort(latency_ns.begin(), latency_ns.end());
+    return latency_ns[latency_ns.size() * 99 / 100] / 1e6;
+}
+
+TEST(NetTest, net_execute_worker_priority_test) {
+    if (g_model_path.empty()) {
+        LOG(INFO) << "no model, the worker isn't checked";
+        return;
+    }
+    Graph<X86, Precision::FP32> graph;
+    auto status = graph.load(g_model_path);
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+    auto ins_name = graph.get_ins();
+    std::vector<HostTensor> ins;
+    TestWorker worker(g_model_path, g_thread_num);
+    worker.register_inputs(ins_name);
+    worker.register_outputs(graph.get_outs());
+    for (auto& in_name : ins_name) {
+        auto shape = graph[in_name]->template get_attr<PTuple<int>>("input_shape");
+        HostTensor in(Shape({1, shape[1], shape[2], shape[3]}));
+        fill_tensor_rand(in);
+        ins.push_back(in);
+        worker.Reshape(in_name, {1, shape[1], shape[2], shape[3]});
+    }
+    worker.set_priority_classes(2);
+    worker.launch();
+
+    // a background burst with online requests in between: the online ones skip the backlog
+    std::mutex mut;
+    std::vector<std::vector<long long> > latency_ns(2);
+    std::atomic<int> finished{0};
+    for (int i = 0; i < g_request_num; i++) {
+        int priority = i % g_online_every == 0 ? 0 : 1;
+        auto submit = std::chrono::steady_clock::now();
+        CHECK(worker.submit_prediction(ins, [&, priority, submit](std::vector<HostTensor>& outs,
+                                                                  const TestWorker::Timing& timing) {
+            CHECK_GT(outs.size(), 0);
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - submit).count();
+            std::lock_guard<std::mutex> guard(mut);
+            latency_ns[priority].push_back(ns);
+            finished++;
+        }, TestWorker::Deadline::max(), priority));
+    }
+    while (finished < g_request_num) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double online_p99 = p99_ms(latency_ns[0]);
+    double background_p99 = p99_ms(latency_ns[1]);
+    LOG(INFO) << "online p99 " << online_p99 << " ms, background p99 " << background_p99 << " ms";
+    CHECK_LT(online_p99, background_p99);
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    if (argc > 1) {
+        g_model_path = std::string(argv[1]);
+    }
+    if (argc > 2) {
+        g_request_num = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        g_online_every = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        g_thread_num = atoi(argv[4]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
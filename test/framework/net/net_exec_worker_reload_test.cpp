@@ -0,0 +1,108 @@
+#include <string>
+#include "net_test.h"
+#include "saber/core/tensor_op.h"
+#include <atomic>
+#include <chrono>
+
+std::string g_model_path = "";
+std::string g_new_model_path = "";
+int g_thread_num = 2;
+
+#ifdef USE_X86_PLACE
+
+typedef Tensor4d<X86> HostTensor;
+typedef Worker<X86, Precision::FP32> TestWorker;
+
+TEST(NetTest, net_execute_worker_reload_test) {
+    Graph<X86, Precision::FP32> graph;
+    auto status = graph.load(g_model_path);
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+    auto ins_name = graph.get_ins();
+    std::vector<HostTensor> ins;
+    auto worker = std::make_shared<TestWorker>(g_model_path, g_thread_num);
+    worker->register_inputs(ins_name);
+    worker->register_outputs(graph.get_outs());
+    for (auto& in_name : ins_name) {
+        auto shape = graph[in_name]->template get_attr<PTuple<int>>("input_shape");
+        HostTensor in(Shape({1, shape[1], shape[2], shape[3]}));
+        fill_tensor_rand(in);
+        ins.push_back(in);
+        worker->Reshape(in_name, {1, shape[1], shape[2], shape[3]});
+    }
+    worker->launch();
+    CHECK(worker->wait_ready());
+
+    // a version that fails to load is reported, it never serves
+    {
+        TestWorker broken(g_model_path + ".missing", g_thread_num);
+        broken.copy_config(*worker);
+        broken.launch();
+        CHECK(!broken.wait_ready());
+    }
+
+    // requests keep flowing while the new version loads, warms up and takes over
+    std::shared_ptr<TestWorker> current = worker;
+    std::atomic<int> answered{0};
+    std::atomic<bool> stop{false};
+    int submitted = 0;
+    std::thread client([&]() {
+        while (!stop) {
+            auto serving = std::atomic_load(&current);
+            serving->submit_prediction(ins, [serving, &answered](std::vector<HostTensor>& outs,
+                                                                 const TestWorker::Timing& timing) {
+                CHECK_GT(outs.size(), 0);
+                answered++;
+            });
+            submitted++;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    auto new_worker = std::make_shared<TestWorker>(g_new_model_path, g_thread_num);
+    new_worker->copy_config(*worker);
+    new_worker->set_warmup(2, ins);
+    new_worker->launch();
+    CHECK(new_worker->wait_ready());
+    std::atomic_store(&current, new_worker);
+    // the old version drains, then its threads, graph and nets go away
+    while (worker.use_count() > 1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    worker.reset();
+    LOG(INFO) << "reload took " << std::chrono::duration<float, std::milli>(
+                  std::chrono::steady_clock::now() - start).count() << " ms";
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    stop = true;
+    client.join();
+    while (answered < submitted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    LOG(INFO) << "requests answered across the reload: " << answered;
+    // the warmed up version answers at once
+    auto outs = new_worker->sync_prediction(ins).get();
+    CHECK_GT(outs.size(), 0);
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        LOG(ERROR) << "usage: " << argv[0] << " model_path [new_model_path] [threads]";
+        return 0;
+    }
+    g_model_path = std::string(argv[1]);
+    g_new_model_path = argc > 2 ? std::string(argv[2]) : g_model_path;
+    if (argc > 3) {
+        g_thread_num = atoi(argv[3]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
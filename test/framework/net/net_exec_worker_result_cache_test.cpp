@@ -0,0 +1,139 @@
+#include <string>
+#include "net_test.h"
+#include "saber/core/tensor_op.h"
+
+std::string g_model_path = "";
+int g_thread_num = 2;
+
+#ifdef USE_X86_PLACE
+
+typedef Tensor4d<X86> HostTensor;
+typedef Worker<X86, Precision::FP32> TestWorker;
+
+HostTensor filled(int count, float value) {
+    HostTensor tensor(Shape({1, count, 1, 1}));
+    fill_tensor_const(tensor, value);
+    return tensor;
+}
+
+ResultKey key_of(const std::string& version, const HostTensor& in) {
+    ResultKeyBuilder builder(version);
+    builder.update(in.data(), in.valid_size() * sizeof(float));
+    return builder.key();
+}
+
+TEST(NetTest, net_result_cache_test) {
+    auto one = filled(64, 1.f);
+    auto two = filled(64, 2.f);
+    CHECK(key_of("v1", one) == key_of("v1", one));
+    CHECK(!(key_of("v1", one) == key_of("v1", two)));
+    CHECK(!(key_of("v1", one) == key_of("v2", one)));
+
+    // room for the outputs of two requests
+    ResultCache<X86> cache(2 * 64 * sizeof(float));
+    ResultCache<X86>::Outputs outs;
+    CHECK(!cache.find(key_of("v1", one), outs));
+    cache.put(key_of("v1", one), {one});
+    cache.put(key_of("v1", two), {two});
+    CHECK(cache.find(key_of("v1", one), outs));
+    CHECK_EQ(outs.size(), 1);
+    CHECK_EQ(static_cast<const float*>(outs[0].data())[0], 1.f);
+    // the cache keeps its own copy
+    fill_tensor_const(outs[0], 5.f);
+    CHECK(cache.find(key_of("v1", one), outs));
+    CHECK_EQ(static_cast<const float*>(outs[0].data())[0], 1.f);
+    // two is the least recently used one now
+    auto three = filled(64, 3.f);
+    cache.put(key_of("v1", three), {three});
+    CHECK(!cache.find(key_of("v1", two), outs));
+    CHECK_EQ(cache.size(), 2);
+    CHECK_EQ(cache.evicted(), 1);
+    CHECK_EQ(cache.hits(), 2);
+    CHECK_EQ(cache.misses(), 2);
+    // outputs bigger than the cap aren't kept
+    auto big = filled(1024, 4.f);
+    cache.put(key_of("v1", big), {big});
+    CHECK(!cache.find(key_of("v1", big), outs));
+    cache.clear();
+    CHECK_EQ(cache.bytes(), 0);
+}
+
+TEST(NetTest, net_execute_worker_result_cache_test) {
+    if (g_model_path.empty()) {
+        LOG(INFO) << "no model, the worker isn't checked";
+        return;
+    }
+    Graph<X86, Precision::FP32> graph;
+    auto status = graph.load(g_model_path);
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+    auto ins_name = graph.get_ins();
+    std::vector<HostTensor> ins;
+    TestWorker worker(g_model_path, g_thread_num);
+    worker.register_inputs(ins_name);
+    worker.register_outputs(graph.get_outs());
+    for (auto& in_name : ins_name) {
+        auto shape = graph[in_name]->template get_attr<PTuple<int>>("input_shape");
+        HostTensor in(Shape({1, shape[1], shape[2], shape[3]}));
+        fill_tensor_rand(in);
+        ins.push_back(in);
+        worker.Reshape(in_name, {1, shape[1], shape[2], shape[3]});
+    }
+    worker.set_result_cache(64 << 20);
+    worker.launch();
+
+    auto computed = worker.sync_prediction(ins).get();
+    auto cached = worker.sync_prediction(ins).get();
+    auto stats = worker.load_stats();
+    CHECK_EQ(stats.cache_misses, 1);
+    CHECK_EQ(stats.cache_hits, 1);
+    CHECK_EQ(computed.size(), cached.size());
+    for (int i = 0; i < computed.size(); i++) {
+        CHECK_EQ(computed[i].valid_size(), cached[i].valid_size());
+        CHECK_EQ(memcmp(computed[i].data(), cached[i].data(), computed[i].valid_size() * sizeof(float)), 0);
+    }
+    // a submitted hit is answered on a pool thread, as a request that runs
+    std::promise<std::thread::id> answered;
+    CHECK(worker.submit_prediction(ins, [&answered](std::vector<HostTensor>&, const TestWorker::Timing&) {
+        answered.set_value(std::this_thread::get_id());
+    }));
+    CHECK(answered.get_future().get() != std::this_thread::get_id());
+    CHECK_EQ(worker.load_stats().cache_hits, 2);
+    // other inputs miss
+    std::vector<HostTensor> other_ins;
+    for (auto& in : ins) {
+        HostTensor other(in.valid_shape());
+        fill_tensor_rand(other);
+        other_ins.push_back(other);
+    }
+    worker.sync_prediction(other_ins).get();
+    CHECK_EQ(worker.load_stats().cache_misses, 2);
+
+    // a reloaded model starts with an empty cache
+    TestWorker reloaded(g_model_path, g_thread_num);
+    reloaded.copy_config(worker);
+    reloaded.launch();
+    reloaded.sync_prediction(ins).get();
+    CHECK_EQ(reloaded.load_stats().cache_hits, 0);
+    CHECK_EQ(reloaded.load_stats().cache_misses, 1);
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    if (argc > 1) {
+        g_model_path = std::string(argv[1]);
+    }
+    if (argc > 2) {
+        g_thread_num = atoi(argv[2]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
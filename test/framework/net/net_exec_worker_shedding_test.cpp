@@ -0,0 +1,104 @@
+#include <string>
+#include "net_test.h"
+#include "saber/core/tensor_op.h"
+#include <chrono>
+
+std::string g_model_path = "";
+int g_request_num = 1000;
+int g_max_queue = 8;
+int g_timeout_ms = 5;
+int g_thread_num = 2;
+
+#ifdef USE_X86_PLACE
+
+typedef Tensor4d<X86> HostTensor;
+typedef Worker<X86, Precision::FP32> TestWorker;
+
+TEST(NetTest, net_execute_worker_shedding_test) {
+    Graph<X86, Precision::FP32> graph;
+    auto status = graph.load(g_model_path);
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+    auto ins_name = graph.get_ins();
+    std::vector<HostTensor> ins;
+    TestWorker worker(g_model_path, g_thread_num);
+    worker.register_inputs(ins_name);
+    worker.register_outputs(graph.get_outs());
+    for (auto& in_name : ins_name) {
+        auto shape = graph[in_name]->template get_attr<PTuple<int>>("input_shape");
+        HostTensor in(Shape({1, shape[1], shape[2], shape[3]}));
+        fill_tensor_rand(in);
+        ins.push_back(in);
+        worker.Reshape(in_name, {1, shape[1], shape[2], shape[3]});
+    }
+    worker.set_queue_limit(g_max_queue);
+    worker.launch();
+
+    // a burst far beyond the bound: the queue never grows past it, the rest is refused at once
+    std::atomic<int> finished{0};
+    std::atomic<int> expired{0};
+    std::atomic<long long> max_depth{0};
+    int rejected = 0;
+    for (int i = 0; i < g_request_num; i++) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(g_timeout_ms);
+        bool accepted = worker.submit_prediction(ins, [&](std::vector<HostTensor>& outs,
+                                                          const TestWorker::Timing& timing) {
+            if (timing.expired) {
+                CHECK_EQ(outs.size(), 0);
+                CHECK_GE(timing.queue_ns, g_timeout_ms * 1000000LL);
+                expired++;
+            } else {
+                CHECK_GT(outs.size(), 0);
+            }
+            finished++;
+        }, deadline);
+        rejected += !accepted;
+        long long depth = worker.load_stats().queue_depth;
+        CHECK_LE(depth, g_max_queue);
+        max_depth = std::max<long long>(max_depth, depth);
+    }
+    auto stats = worker.load_stats();
+    while (finished < stats.accepted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stats = worker.load_stats();
+    LOG(INFO) << "requests: " << g_request_num << " accepted: " << stats.accepted
+              << " rejected: " << stats.rejected << " expired: " << stats.expired
+              << " completed: " << stats.completed << " max queue depth: " << max_depth;
+    CHECK_EQ(stats.rejected, rejected);
+    CHECK_EQ(stats.accepted + stats.rejected, g_request_num);
+    CHECK_EQ(stats.completed + stats.expired, stats.accepted);
+    CHECK_EQ(stats.expired, expired);
+    CHECK_EQ(stats.queue_depth, 0);
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        LOG(ERROR) << "usage: " << argv[0] << " model_path [requests] [max_queue] [timeout_ms] [threads]";
+        return 0;
+    }
+    g_model_path = std::string(argv[1]);
+    if (argc > 2) {
+        g_request_num = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        g_max_queue = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        g_timeout_ms = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        g_thread_num = atoi(argv[5]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
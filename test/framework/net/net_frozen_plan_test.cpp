@@ -0,0 +1,78 @@
+#include <string>
+#include "net_test.h"
+
+#ifdef USE_X86_PLACE
+using Target = X86;
+
+/// one fc x[n, 1, 1, 3] -> y[n, 2], all weights one, initialized for batch max_batch.
+Graph<Target, Precision::FP32>* fc_graph(int max_batch) {
+    auto* graph = new Graph<Target, Precision::FP32>();
+    graph->AddOp("fc", "Dense", {"x"}, {"y"});
+    graph->AddOpAttr("fc", "out_dim", 2);
+    graph->AddOpAttr("fc", "bias_term", false);
+    graph->AddOpAttr("fc", "axis", 1);
+    anakin::saber::Shape weight_shape({1, 1, 3, 2});
+    PBlock<Target> weight(weight_shape);
+    float* weight_data = static_cast<float*>(weight.h_tensor().mutable_data());
+    for (int i = 0; i < weight_shape.count(); i++) {
+        weight_data[i] = 1.f;
+    }
+    weight.d_tensor().set_shape(weight_shape);
+    weight.d_tensor().copy_from(weight.h_tensor());
+    graph->AddOpAttr("fc", "weight_1", weight);
+    CHECK(graph->Freeze()) << "Freeze error";
+    graph->Optimize();
+    anakin::PTuple<int> input_shape = {max_batch, 1, 1, 3};
+    graph->AddOpAttr("x", "input_shape", input_shape);
+    return graph;
+}
+
+/// run batch rows, row b is filled with b + 1, and check y is trimmed back to batch rows of 3 * (b + 1).
+void predict_and_check(Net<Target, Precision::FP32>& net, int batch) {
+    auto in = net.get_in("x");
+    in->reshape(Shape({batch, 1, 1, 3}));
+    float* in_data = static_cast<float*>(in->mutable_data());
+    for (int i = 0; i < in->valid_size(); i++) {
+        in_data[i] = i / 3 + 1;
+    }
+    net.prediction();
+    auto out = net.get_out("y");
+    CHECK_EQ(out->num(), batch) << "outputs are not trimmed to the real batch";
+    CHECK_EQ(out->valid_size(), batch * 2);
+    const float* out_data = static_cast<const float*>(out->data());
+    for (int i = 0; i < out->valid_size(); i++) {
+        CHECK_EQ(out_data[i], 3.f * (i / 2 + 1)) << "batch " << batch << ", at " << i;
+    }
+}
+
+TEST(NetTest, net_frozen_plan_bucket_test) {
+    auto* graph = fc_graph(8);
+    Net<Target, Precision::FP32> net(true);
+    net.init(*graph);
+    net.register_shape_buckets("x", {Shape({8, 1, 1, 3}), Shape({4, 1, 1, 3})});
+    // batch 3 is padded to bucket 4, 6 to bucket 8, then both buckets run their frozen ops again
+    for (int batch : {3, 6, 3, 4, 8, 1}) {
+        predict_and_check(net, batch);
+    }
+    // padding rows are zeros in the input of the bucket
+    predict_and_check(net, 5);
+    auto in = net.get_in("x");
+    CHECK_EQ(in->num(), 8) << "input is not padded to the bucket";
+    const float* in_data = static_cast<const float*>(in->data());
+    for (int i = 5 * 3; i < in->valid_size(); i++) {
+        CHECK_EQ(in_data[i], 0.f);
+    }
+    delete graph;
+}
+#endif
+
+int main(int argc, const char** argv) {
+#ifdef USE_X86_PLACE
+    Env<Target>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <string>
+#include <sstream>
+#include "net_test.h"
+#include "framework/core/net/metrics.h"
+
+/// value of the sample line starting with series in text, -1 if missing.
+double sample(const std::string& text, const std::string& series) {
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, series.size() + 1, series + " ") == 0) {
+            return std::stod(line.substr(series.size() + 1));
+        }
+    }
+    return -1;
+}
+
+TEST(NetTest, net_metrics_test) {
+    MetricsRegistry registry;
+    // a series is created once, later lookups return it
+    auto* requests = registry.counter("anakin_requests_total", "Requests.", {{"model", "a"}});
+    CHECK_EQ(requests, registry.counter("anakin_requests_total", "Requests.", {{"model", "a"}}));
+    requests->inc(3);
+    registry.counter("anakin_requests_total", "Requests.", {{"model", "b\"c"}})->inc();
+    auto* depth = registry.gauge("anakin_queue_depth", "Depth.", {{"model", "a"}});
+    depth->add(5);
+    depth->add(-2);
+    auto* latency = registry.summary("anakin_request_latency_seconds", "Latency.", {{"model", "a"}});
+    for (int i = 1; i <= 1000; i++) {
+        latency->observe_ns(i * 1000000ULL);
+    }
+    auto* batch = registry.histogram("anakin_batch_size", "Batch.", {1, 2, 4, 8}, {{"model", "a"}});
+    for (auto size : {1, 1, 3, 8, 16}) {
+        batch->observe(size);
+    }
+
+    auto text = registry.prometheus_text();
+    LOG(INFO) << "\n" << text;
+    CHECK_NE(text.find("# TYPE anakin_requests_total counter"), std::string::npos);
+    CHECK_NE(text.find("# TYPE anakin_request_latency_seconds summary"), std::string::npos);
+    CHECK_EQ(sample(text, "anakin_requests_total{model=\"a\"}"), 3);
+    CHECK_EQ(sample(text, "anakin_requests_total{model=\"b\\\"c\"}"), 1);
+    CHECK_EQ(sample(text, "anakin_queue_depth{model=\"a\"}"), 3);
+    // quantiles in seconds within the histogram resolution
+    double p50 = sample(text, "anakin_request_latency_seconds{model=\"a\",quantile=\"0.5\"}");
+    double p999 = sample(text, "anakin_request_latency_seconds{model=\"a\",quantile=\"0.999\"}");
+    CHECK(p50 > 0.5 * 15 / 16 && p50 < 0.5 * 17 / 16) << "p50 " << p50;
+    CHECK(p999 > 0.999 * 15 / 16 && p999 <= 1.) << "p999 " << p999;
+    CHECK_EQ(sample(text, "anakin_request_latency_seconds_count{model=\"a\"}"), 1000);
+    CHECK(std::abs(sample(text, "anakin_request_latency_seconds_sum{model=\"a\"}") - 500.5) < 1e-6);
+    // histogram buckets are cumulative
+    CHECK_EQ(sample(text, "anakin_batch_size_bucket{model=\"a\",le=\"1\"}"), 2);
+    CHECK_EQ(sample(text, "anakin_batch_size_bucket{model=\"a\",le=\"4\"}"), 3);
+    CHECK_EQ(sample(text, "anakin_batch_size_bucket{model=\"a\",le=\"8\"}"), 4);
+    CHECK_EQ(sample(text, "anakin_batch_size_bucket{model=\"a\",le=\"+Inf\"}"), 5);
+    CHECK_EQ(sample(text, "anakin_batch_size_sum{model=\"a\"}"), 29);
+}
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
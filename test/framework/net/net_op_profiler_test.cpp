@@ -0,0 +1,116 @@
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "net_test.h"
+#include "framework/core/net/op_profiler.h"
+
+TEST(NetTest, net_op_profiler_test) {
+    // buckets cover the ns line without gaps, a percentile is within 1 / 16 of the sample.
+    {
+        for (int i = 1; i < LatencyHistogram::BucketNum; i++) {
+            CHECK_EQ(LatencyHistogram::lower_ns(i), LatencyHistogram::upper_ns(i - 1));
+        }
+        for (unsigned long long ns = 1; ns < (1ULL << 40); ns = ns * 3 + 1) {
+            int bucket = LatencyHistogram::bucket(ns);
+            CHECK_LE(LatencyHistogram::lower_ns(bucket), ns);
+            CHECK_GT(LatencyHistogram::upper_ns(bucket), ns);
+        }
+        LatencyHistogram hist;
+        for (int i = 1; i <= 1000; i++) {
+            hist.add(i * 1000ULL);
+        }
+        CHECK_EQ(hist.count(), 1000);
+        CHECK_EQ(hist.max_ns(), 1000000);
+        double p50 = hist.percentile_ms(50);
+        double p99 = hist.percentile_ms(99);
+        CHECK(p50 > 0.5 * 15 / 16 && p50 < 0.5 * 17 / 16) << "p50 " << p50;
+        CHECK(p99 > 0.99 * 15 / 16 && p99 < 0.99 * 17 / 16) << "p99 " << p99;
+        CHECK_EQ(hist.percentile_ms(100), 1.);
+        LatencyHistogram other;
+        other.add(5000000ULL);
+        hist.merge(other);
+        CHECK_EQ(hist.count(), 1001);
+        CHECK_EQ(hist.max_ns(), 5000000);
+    }
+    // one in sample_every predictions is profiled, ops are aggregated per type.
+    {
+        OpProfiler profiler;
+        profiler.init({"conv_0", "relu_0", "conv_1"}, {"Convolution", "ReLU", "Convolution"});
+        CHECK(!profiler.begin_prediction());
+        profiler.set_sample_every(4);
+        int sampled = 0;
+        for (int i = 0; i < 20; i++) {
+            if (profiler.begin_prediction()) {
+                unsigned long long start = OpProfiler::now_ns();
+                for (int op = 0; op < profiler.op_num(); op++) {
+                    profiler.record(op, start + op * 3000, start + op * 3000 + (op + 1) * 1000);
+                }
+                profiler.end_prediction();
+                sampled++;
+            }
+        }
+        CHECK_EQ(sampled, 5);
+        CHECK_EQ(profiler.sampled_predictions(), 5);
+        CHECK_EQ(profiler.op_histogram(2).count(), 5);
+        CHECK_EQ(profiler.type_names().size(), 2);
+        auto conv = profiler.type_histogram("Convolution");
+        CHECK_EQ(conv.count(), 10);
+        CHECK_EQ(conv.sum_ns(), 5 * (1000 + 3000));
+        LOG(INFO) << profiler.summary();
+
+        std::string csv = "net_op_profiler_test.csv";
+        std::string trace = "net_op_profiler_test.json";
+        profiler.export_csv(csv);
+        CHECK(profiler.export_chrome_trace(trace));
+        std::ifstream trace_file(trace);
+        std::stringstream json;
+        json << trace_file.rdbuf();
+        CHECK_NE(json.str().find("\"traceEvents\""), std::string::npos);
+        CHECK_NE(json.str().find("\"name\":\"relu_0\",\"cat\":\"ReLU\""), std::string::npos);
+        std::ifstream csv_file(csv);
+        std::string line;
+        int rows = 0;
+        while (std::getline(csv_file, line)) {
+            rows++;
+        }
+        // epoch, 3 ops, sum and 2 op types
+        CHECK_EQ(rows, 7);
+        remove(csv.c_str());
+        remove(trace.c_str());
+
+        profiler.reset();
+        CHECK_EQ(profiler.sampled_predictions(), 0);
+        CHECK_EQ(profiler.op_histogram(0).count(), 0);
+    }
+    // the trace ring keeps the latest events.
+    {
+        OpProfiler profiler;
+        profiler.init({"op"}, {"Op"}, 8);
+        profiler.set_sample_every(1);
+        for (int i = 0; i < 20; i++) {
+            profiler.begin_prediction();
+            unsigned long long start = OpProfiler::now_ns();
+            profiler.record(0, start, start + 10);
+            profiler.end_prediction();
+        }
+        std::string trace = "net_op_profiler_ring.json";
+        CHECK(profiler.export_chrome_trace(trace));
+        std::ifstream trace_file(trace);
+        std::string line;
+        int events = 0;
+        while (std::getline(trace_file, line)) {
+            events += line.find("\"ph\":\"X\"") != std::string::npos;
+        }
+        CHECK_EQ(events, 8);
+        remove(trace.c_str());
+    }
+}
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <string>
+#include "service_test.h"
+#include "framework/service/completion_store.h"
+
+TEST(ServiceTest, Service_completion_store_test) {
+    CompletionStore store(2);
+    RPCResponse response;
+    std::string key = CompletionStore::key("mobilenet_v2", 1);
+    CHECK_EQ(store.fetch(key, &response), CompletionStore::NOT_FOUND);
+    CHECK_EQ(store.submit(key), CompletionStore::ADMITTED);
+    // a request id can't be reused before its result is fetched
+    CHECK_EQ(store.submit(key), CompletionStore::DUPLICATE);
+    CHECK_EQ(store.fetch(key, &response), CompletionStore::PENDING);
+
+    std::unique_ptr<RPCResponse> result(new RPCResponse);
+    result->set_request_id(1);
+    result->mutable_info()->set_msg("SUC");
+    store.complete(key, std::move(result));
+    CHECK_EQ(store.pending(), 0);
+    CHECK_EQ(store.fetch(key, &response), CompletionStore::DONE);
+    CHECK_EQ(response.request_id(), 1);
+    CHECK_EQ(response.info().msg(), "SUC");
+    // results are fetched once
+    CHECK_EQ(store.fetch(key, &response), CompletionStore::NOT_FOUND);
+    CHECK_EQ(store.submit(key), CompletionStore::ADMITTED);
+
+    // at most capacity requests are pending
+    CHECK_EQ(store.submit(CompletionStore::key("mobilenet_v2", 2)), CompletionStore::ADMITTED);
+    CHECK_EQ(store.submit(CompletionStore::key("mobilenet_v2", 3)), CompletionStore::FULL);
+    CHECK_EQ(store.fetch(CompletionStore::key("mobilenet_v2", 3), &response), CompletionStore::NOT_FOUND);
+    CHECK_EQ(store.pending(), 2);
+
+    // the oldest results not fetched are evicted beyond the capacity
+    for (int id = 2; id <= 4; id++) {
+        if (id > 2) {
+            CHECK_EQ(store.submit(CompletionStore::key("mobilenet_v2", id)), CompletionStore::ADMITTED);
+        }
+        std::unique_ptr<RPCResponse> result(new RPCResponse);
+        result->set_request_id(id);
+        store.complete(CompletionStore::key("mobilenet_v2", id), std::move(result));
+    }
+    CHECK_EQ(store.completed(), 2);
+    CHECK_EQ(store.evicted(), 1);
+    CHECK_EQ(store.pending(), 1);
+    CHECK_EQ(store.fetch(CompletionStore::key("mobilenet_v2", 2), &response), CompletionStore::NOT_FOUND);
+    CHECK_EQ(store.fetch(CompletionStore::key("mobilenet_v2", 4), &response), CompletionStore::DONE);
+    CHECK_EQ(response.request_id(), 4);
+    CHECK_EQ(store.fetch(CompletionStore::key("mobilenet_v2", 3), &response), CompletionStore::DONE);
+    CHECK_EQ(store.fetch(key, &response), CompletionStore::PENDING);
+    // a cancelled request is forgotten, its id can be submitted again
+    store.cancel(key);
+    CHECK_EQ(store.fetch(key, &response), CompletionStore::NOT_FOUND);
+    CHECK_EQ(store.submit(key), CompletionStore::ADMITTED);
+}
+
+int main(int argc, const char** argv){
+    // initial logger
+    logger::init(argv[0]);
+	InitTest();
+	RUN_ALL_TESTS(argv[0]);
+	return 0;
+}
@@ -0,0 +1,323 @@
+#include <string>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include "service_test.h"
+#include "framework/core/net/op_profiler.h"
+#include <brpc/channel.h>
+
+#if defined(USE_CUDA)
+using Target = NV;
+using Target_H = X86;
+#elif defined(USE_X86_PLACE)
+using Target = X86;
+using Target_H = X86;
+#elif defined(USE_ARM_PLACE)
+using Target = ARM;
+using Target_H = ARM;
+#endif
+
+/// load generator config, see main for the command line.
+std::string g_model_path = "";
+///< closed: g_load clients send a request after their previous one is answered.
+///< open: requests are sent at g_load QPS (poisson arrivals), whether the service keeps up or not.
+std::string g_mode = "closed";
+double g_load = 8;
+int g_duration_sec = 10;
+///< input shapes and their weights, e.g. "1x3x224x224:0.8,8x3x224x224:0.2".
+std::string g_shape_mix = "1x3x224x224";
+int g_thread_num = 4;
+int g_max_batch = 1;
+int g_max_wait_us = 1000;
+int g_port = 8010;
+///< calls in flight beyond which the open loop drops its arrivals (client side saturation).
+int g_max_in_flight = 10000;
+
+const std::string kModelName = "model";
+
+/// shapes of the mix and the cumulative weights to pick them.
+struct ShapeMix {
+    std::vector<std::vector<int> > shapes;
+    std::vector<double> cumulative;
+
+    bool parse(const std::string& mix) {
+        std::stringstream entries(mix);
+        std::string entry;
+        double total = 0.;
+        while (std::getline(entries, entry, ',')) {
+            auto colon = entry.find(':');
+            double weight = colon == std::string::npos ? 1. : atof(entry.substr(colon + 1).c_str());
+            std::stringstream dims(entry.substr(0, colon));
+            std::string dim;
+            std::vector<int> shape;
+            while (std::getline(dims, dim, 'x')) {
+                shape.push_back(atoi(dim.c_str()));
+            }
+            if (shape.empty() || shape.size() > 4 || weight <= 0) {
+                LOG(ERROR) << "bad shape mix entry: " << entry;
+                return false;
+            }
+            total += weight;
+            shapes.push_back(shape);
+            cumulative.push_back(total);
+        }
+        for (auto& weight : cumulative) {
+            weight /= total;
+        }
+        return !shapes.empty();
+    }
+
+    int pick(std::mt19937& rng) const {
+        double draw = std::uniform_real_distribution<double>(0., 1.)(rng);
+        return std::lower_bound(cumulative.begin(), cumulative.end(), draw) - cumulative.begin();
+    }
+};
+
+/// outcome of the calls, latency from the intended send time (no coordinated omission).
+struct LoadStats {
+    std::mutex mut;
+    LatencyHistogram latency;
+    LatencyHistogram window;
+    long long ok{0};
+    long long overloaded{0};
+    long long expired{0};
+    long long failed{0};
+    std::atomic<long long> dropped{0};
+    std::atomic<int> in_flight{0};
+
+    void record(brpc::Controller& cntl, const RPCResponse& response, unsigned long long intended_ns) {
+        auto latency_ns = OpProfiler::now_ns() - intended_ns;
+        std::lock_guard<std::mutex> guard(mut);
+        if (cntl.Failed()) {
+            failed++;
+        } else if (response.info().msg() == "OVERLOADED") {
+            overloaded++;
+        } else if (response.info().msg() == "DEADLINE_EXCEEDED") {
+            expired++;
+        } else {
+            ok++;
+            latency.add(latency_ns);
+            window.add(latency_ns);
+        }
+    }
+};
+
+/// async call of the open loop, it records and deletes itself when the response arrives.
+struct AsyncCall : public google::protobuf::Closure {
+    brpc::Controller cntl;
+    RPCResponse response;
+    unsigned long long intended_ns{0};
+    LoadStats* stats{nullptr};
+
+    void Run() override {
+        stats->record(cntl, response, intended_ns);
+        stats->in_flight--;
+        delete this;
+    }
+};
+
+/// one request template per shape of the mix, with random float inputs.
+std::vector<RPCRequest> make_requests(const ShapeMix& mix) {
+    std::vector<RPCRequest> requests(mix.shapes.size());
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> value(-1.f, 1.f);
+    for (int i = 0; i < mix.shapes.size(); i++) {
+        requests[i].set_model(kModelName);
+        Data* data = requests[i].add_inputs()->mutable_tensor();
+        int count = 1;
+        for (auto dim : mix.shapes[i]) {
+            data->add_shape(dim);
+            count *= dim;
+        }
+        std::vector<float> values(count);
+        for (auto& v : values) {
+            v = value(rng);
+        }
+        data->set_dtype(DT_FLOAT32);
+        data->set_raw_data(values.data(), values.size() * sizeof(float));
+        requests[i].set_raw_output(true);
+    }
+    return requests;
+}
+
+void report(const std::string& title, LatencyHistogram& hist, double seconds) {
+    LOG(INFO) << title << ": " << hist.count() / seconds << " QPS, latency ms p50 " << hist.percentile_ms(50)
+              << " p90 " << hist.percentile_ms(90) << " p99 " << hist.percentile_ms(99)
+              << " p999 " << hist.percentile_ms(99.9) << " max " << hist.max_ns() / 1e6;
+}
+
+void run_closed_loop(RPCService_Stub& stub, const std::vector<RPCRequest>& requests, const ShapeMix& mix,
+                     LoadStats& stats, std::atomic<bool>& stop) {
+    std::vector<std::thread> clients;
+    for (int c = 0; c < (int)g_load; c++) {
+        clients.emplace_back([&, c]() {
+            std::mt19937 rng(c + 1);
+            long long id = (long long)c << 32;
+            while (!stop) {
+                RPCRequest request;
+                request.CopyFrom(requests[mix.pick(rng)]);
+                request.set_request_id(id++);
+                RPCResponse response;
+                brpc::Controller cntl;
+                auto intended_ns = OpProfiler::now_ns();
+                stub.evaluate(&cntl, &request, &response, NULL);
+                stats.record(cntl, response, intended_ns);
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+}
+
+void run_open_loop(RPCService_Stub& stub, const std::vector<RPCRequest>& requests, const ShapeMix& mix,
+                   LoadStats& stats, std::atomic<bool>& stop) {
+    std::mt19937 rng(1);
+    std::exponential_distribution<double> gap_sec(g_load);
+    long long id = 0;
+    auto next = std::chrono::steady_clock::now();
+    while (!stop) {
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(gap_sec(rng)));
+        std::this_thread::sleep_until(next);
+        // the arrival counts from when it was due, even if this thread woke up late
+        auto intended_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               next.time_since_epoch()).count();
+        if (stats.in_flight >= g_max_in_flight) {
+            stats.dropped++;
+            continue;
+        }
+        RPCRequest request;
+        request.CopyFrom(requests[mix.pick(rng)]);
+        request.set_request_id(id++);
+        auto* call = new AsyncCall;
+        call->intended_ns = intended_ns;
+        call->stats = &stats;
+        stats.in_flight++;
+        stub.evaluate(&call->cntl, &request, &call->response, call);
+    }
+    while (stats.in_flight > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+TEST(ServiceTest, Service_load_generator) {
+    ShapeMix mix;
+    CHECK(mix.parse(g_shape_mix)) << "bad shape mix: " << g_shape_mix;
+    graph::Graph<Target, Precision::FP32> graph;
+    auto status = graph.load(g_model_path);
+    CHECK(status) << "load " << g_model_path << " failed: " << status.info();
+    auto ins_name = graph.get_ins();
+    CHECK_EQ(ins_name.size(), 1) << "the load generator feeds models of one input";
+
+    // the service under test, started in this process
+    AnakinService<Target, Precision::FP32, ServiceRunPattern::SYNC> rpc_service;
+    rpc_service.set_device_id(0);
+    rpc_service.initial(kModelName, g_model_path, g_thread_num);
+    rpc_service.register_inputs(kModelName, ins_name);
+    rpc_service.register_outputs(kModelName, graph.get_outs());
+    // nets are sized for the largest shape of the mix
+    std::vector<int> max_shape = mix.shapes[0];
+    for (auto& shape : mix.shapes) {
+        int count = 1;
+        int max_count = 1;
+        for (auto dim : shape) {
+            count *= dim;
+        }
+        for (auto dim : max_shape) {
+            max_count *= dim;
+        }
+        if (count > max_count) {
+            max_shape = shape;
+        }
+    }
+    rpc_service.Reshape(kModelName, ins_name[0], max_shape);
+    rpc_service.set_batching(kModelName, g_max_batch, g_max_wait_us);
+    rpc_service.launch();
+    brpc::Server server;
+    CHECK_EQ(server.AddService(&rpc_service, brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+    brpc::ServerOptions server_options;
+    server_options.num_threads = 16;
+    CHECK_EQ(server.Start(g_port, &server_options), 0) << "can't start the service on port " << g_port;
+
+    brpc::Channel channel;
+    brpc::ChannelOptions options;
+    options.protocol = "baidu_std";
+    options.connection_type = "pooled";
+    options.timeout_ms = 10000;
+    options.max_retry = 0;
+    std::string address = "127.0.0.1:" + std::to_string(g_port);
+    CHECK_EQ(channel.Init(address.c_str(), &options), 0) << "can't connect " << address;
+    RPCService_Stub stub(&channel);
+
+    auto requests = make_requests(mix);
+    LoadStats stats;
+    std::atomic<bool> stop{false};
+    LOG(INFO) << g_mode << " loop, " << (g_mode == "open" ? "target QPS " : "clients ") << g_load
+              << ", shapes " << g_shape_mix << ", " << g_duration_sec << " s";
+    auto start = std::chrono::steady_clock::now();
+    std::thread load([&]() {
+        if (g_mode == "open") {
+            run_open_loop(stub, requests, mix, stats, stop);
+        } else {
+            run_closed_loop(stub, requests, mix, stats, stop);
+        }
+    });
+    for (int sec = 1; sec <= g_duration_sec; sec++) {
+        std::this_thread::sleep_until(start + std::chrono::seconds(sec));
+        std::lock_guard<std::mutex> guard(stats.mut);
+        report("second " + std::to_string(sec), stats.window, 1.);
+        stats.window.reset();
+    }
+    stop = true;
+    load.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    report("total", stats.latency, seconds);
+    LOG(INFO) << "ok: " << stats.ok << " overloaded: " << stats.overloaded << " deadline exceeded: "
+              << stats.expired << " failed: " << stats.failed << " dropped by client: " << stats.dropped;
+    // the view of the service: its latencies exclude the network and the rpc framework
+    LOG(INFO) << "service metrics:\n" << rpc_service.metrics().prometheus_text();
+    server.Stop(0);
+    server.Join();
+    CHECK_GT(stats.ok, 0);
+}
+
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        LOG(ERROR) << "usage: " << argv[0] << " model_path [closed|open] [clients|qps] [duration_sec]"
+                   << " [shape_mix e.g. 1x3x224x224:0.8,8x3x224x224:0.2] [threads] [max_batch] [port]";
+        return 0;
+    }
+    g_model_path = std::string(argv[1]);
+    if (argc > 2) {
+        g_mode = std::string(argv[2]);
+    }
+    if (argc > 3) {
+        g_load = atof(argv[3]);
+    }
+    if (argc > 4) {
+        g_duration_sec = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        g_shape_mix = std::string(argv[5]);
+    }
+    if (argc > 6) {
+        g_thread_num = atoi(argv[6]);
+    }
+    if (argc > 7) {
+        g_max_batch = atoi(argv[7]);
+    }
+    if (argc > 8) {
+        g_port = atoi(argv[8]);
+    }
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
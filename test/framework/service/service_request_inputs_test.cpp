@@ -0,0 +1,87 @@
+#include <string>
+#include "service_test.h"
+#include "framework/service/request_inputs.h"
+
+/// add a float input of dims and count floats of payload to request.
+void add_float_input(RPCRequest& request, std::vector<int> dims, int count) {
+    auto* data = request.add_inputs()->mutable_tensor();
+    for (auto dim : dims) {
+        data->add_shape(dim);
+    }
+    for (int i = 0; i < count; i++) {
+        data->add_data(i);
+    }
+}
+
+/// extract request for a net of net_dtypes inputs, return the error, empty if it's accepted.
+std::string extract_error(const RPCRequest& request, std::vector<saber::DataType> net_dtypes) {
+    std::vector<Tensor4d<X86> > inputs;
+    std::string error;
+    if (extract_request_inputs(request, net_dtypes, inputs, &error)) {
+        CHECK_EQ(inputs.size(), net_dtypes.size());
+        return "";
+    }
+    CHECK(!error.empty());
+    return error;
+}
+
+TEST(ServiceTest, Service_request_inputs_test) {
+    RPCRequest request;
+    add_float_input(request, {2, 3}, 6);
+    CHECK_EQ(extract_error(request, {AK_FLOAT}), "");
+
+    // the inputs views the payload
+    std::vector<Tensor4d<X86> > inputs;
+    std::string error;
+    CHECK(extract_request_inputs(request, {AK_FLOAT}, inputs, &error));
+    CHECK(inputs[0].valid_shape() == saber::Shape({2, 3}, Layout_NC));
+    CHECK_EQ(inputs[0].data(), request.inputs(0).tensor().data().data());
+
+    // one input per net input
+    LOG(INFO) << extract_error(request, {AK_FLOAT, AK_FLOAT});
+    CHECK_NE(extract_error(request, {AK_FLOAT, AK_FLOAT}), "");
+    CHECK_NE(extract_error(request, {}), "");
+
+    // of the net input dtype
+    CHECK_NE(extract_error(request, {AK_INT32}), "");
+    RPCRequest raw_request;
+    auto* raw = raw_request.add_inputs()->mutable_tensor();
+    raw->add_shape(4);
+    raw->set_dtype(DT_INT32);
+    raw->set_raw_data(std::string(4 * sizeof(int), '\0'));
+    CHECK_EQ(extract_error(raw_request, {AK_INT32}), "");
+    LOG(INFO) << extract_error(raw_request, {AK_FLOAT});
+    CHECK_NE(extract_error(raw_request, {AK_FLOAT}), "");
+    CHECK_NE(extract_error(raw_request, {AK_INT64}), "");
+
+    // dims > 0, even when the payload matches their product
+    RPCRequest zero_request;
+    add_float_input(zero_request, {0, 3}, 0);
+    LOG(INFO) << extract_error(zero_request, {AK_FLOAT});
+    CHECK_NE(extract_error(zero_request, {AK_FLOAT}), "");
+    RPCRequest negative_request;
+    add_float_input(negative_request, {-2, -3}, 6);
+    CHECK_NE(extract_error(negative_request, {AK_FLOAT}), "");
+
+    // 1 to 4 dims
+    RPCRequest rank_request;
+    add_float_input(rank_request, {1, 1, 1, 1, 2}, 2);
+    CHECK_NE(extract_error(rank_request, {AK_FLOAT}), "");
+
+    // payload of exactly the shape, dims whose product wraps around don't match it
+    RPCRequest size_request;
+    add_float_input(size_request, {2, 3}, 5);
+    CHECK_NE(extract_error(size_request, {AK_FLOAT}), "");
+    RPCRequest wrap_request;
+    add_float_input(wrap_request, {65536, 65536, 1, 1}, 0);
+    LOG(INFO) << extract_error(wrap_request, {AK_FLOAT});
+    CHECK_NE(extract_error(wrap_request, {AK_FLOAT}), "");
+}
+
+int main(int argc, const char** argv){
+    // initial logger
+    logger::init(argv[0]);
+	InitTest();
+	RUN_ALL_TESTS(argv[0]);
+	return 0;
+}
@@ -21,6 +21,8 @@ std::string server = "0.0.0.0:8000";
 void fill_request(int id, RPCRequest& request) {
     request.set_model("mobilenet_v2");
     request.set_request_id(id);
+    // get outputs as raw bytes too
+    request.set_raw_output(true);
     int batch_size = 1;
     IO* input = request.add_inputs();
     Data* data = input->mutable_tensor();
@@ -28,18 +30,9 @@ void fill_request(int id, RPCRequest& request) {
     data->add_shape(3);
     data->add_shape(224);
     data->add_shape(224);
-    float new_tmp_data[batch_size*3*224*224];
-    for(int i=0; i < batch_size*3*224*224; i++) {
-        new_tmp_data[i] = 1.0f;
-    }
-    data->mutable_data()->Reserve(batch_size*3*224*224);
-    LOG(WARNING) << " client data_p: " << data->mutable_data()->mutable_data() << " o: " 
-        << request.inputs(0).tensor().data().data();
-    //memcpy(data->mutable_data()->mutable_data(), new_tmp_data, 3*224*224*sizeof(float));
-    for(int i=0; i<batch_size*3*224*224; i++) {
-        request.inputs(0).tensor().add_data(1.0f);
-        //LOG(INFO) << " |-- data[" << i << "]: " << request.inputs(0).tensor().data().data()[i];
-    }
+    data->set_dtype(DT_FLOAT32);
+    std::vector<float> new_tmp_data(batch_size*3*224*224, 1.0f);
+    data->set_raw_data(new_tmp_data.data(), new_tmp_data.size() * sizeof(float));
 }
 
 TEST(ServiceTest, Service_client_base_test) {
@@ -91,9 +84,10 @@ TEST(ServiceTest, Service_client_base_test) {
                 LOG(INFO) << "I (" << cntl.local_side() << ") Received response from remote (" << cntl.remote_side() 
                           << "): " << response.info().msg() 
                           << " latency = " << cntl.latency_us() <<" us";
-                for(int j =0; j<10; j++) {
-                    LOG(WARNING) << "  \\__ get response data[" << j << "]: " 
-                        << response.outputs(0).tensor().data(j);
+                auto& out = response.outputs(0).tensor();
+                const float* out_data = (const float*)(out.raw_data().data());
+                for(int j =0; j<10 && j < out.raw_data().size() / sizeof(float); j++) {
+                    LOG(WARNING) << "  \\__ get response data[" << j << "]: " << out_data[j];
                 }
             } else {
                 LOG(INFO) << "I (" << cntl.local_side() << ") Received response from remote (" << cntl.remote_side()
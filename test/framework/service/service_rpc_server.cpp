@@ -1,5 +1,6 @@
 #include <string>
 #include "service_test.h"
+#include "framework/service/metrics_service.h"
 #include "saber/funcs/timer.h"
 #include <chrono>
 
@@ -45,6 +46,13 @@ int service_start(int port, int dev_id) {
         LOG(ERROR) << "Fail to add service"; 
         return -1; 
     }
+
+    // serve the metrics of the models at http://host:port/metrics
+    MetricsHttpService metrics_service(&rpc_service.metrics());
+    if (server.AddService(&metrics_service, brpc::SERVER_DOESNT_OWN_SERVICE, "/metrics => metrics") != 0) {
+        LOG(ERROR) << "Fail to add metrics service";
+        return -1;
+    }
     
     // Start the server
     brpc::ServerOptions options; 
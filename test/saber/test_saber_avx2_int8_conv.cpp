@@ -0,0 +1,218 @@
+#include "test_saber_func.h"
+#include "saber/core/context.h"
+#include "saber/core/tensor_op.h"
+#include <cmath>
+#include <vector>
+using namespace anakin::saber;
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/avx2_x8s8s32x_conv.h"
+
+struct ConvCase {
+    int n, ic, h, w, oc, kh, kw, stride_h, stride_w, pad_h, pad_w, dilation;
+};
+
+/// the avx2 kernel in scalar code, the s32 sums are exact.
+void conv_int8_ref(const ConvCase& c, int oh, int ow, const Tensor<X86>& input,
+                   const std::vector<int8_t>& wei, const std::vector<float>& bias,
+                   const std::vector<float>& scale, std::vector<float>& ref) {
+    bool is_signed = input.get_dtype() == AK_INT8;
+    const int8_t* s8 = static_cast<const int8_t*>(input.data());
+    const uint8_t* u8 = static_cast<const uint8_t*>(input.data());
+    ref.assign(c.n * oh * ow * c.oc, 0.f);
+
+    for (int n = 0; n < c.n; n++) {
+        for (int y = 0; y < oh; y++) {
+            for (int x = 0; x < ow; x++) {
+                for (int o = 0; o < c.oc; o++) {
+                    int acc = 0;
+
+                    for (int ky = 0; ky < c.kh; ky++) {
+                        for (int kx = 0; kx < c.kw; kx++) {
+                            int iy = y * c.stride_h - c.pad_h + ky * c.dilation;
+                            int ix = x * c.stride_w - c.pad_w + kx * c.dilation;
+
+                            if (iy < 0 || iy >= c.h || ix < 0 || ix >= c.w) {
+                                continue;
+                            }
+
+                            for (int k = 0; k < c.ic; k++) {
+                                int idx = ((n * c.h + iy) * c.w + ix) * c.ic + k;
+                                int a = is_signed ? s8[idx] : u8[idx];
+                                acc += a * wei[((o * c.ic + k) * c.kh + ky) * c.kw + kx];
+                            }
+                        }
+                    }
+
+                    ref[((n * oh + y) * ow + x) * c.oc + o] = ((float)acc + bias[o]) * scale[o];
+                }
+            }
+        }
+    }
+}
+
+template <typename OutputDtype>
+void check_case(const ConvCase& c, DataType in_dtype, DataType out_dtype, bool relu,
+                bool sum, DataType sum_dtype, float beta, bool extremes = false) {
+    Context<X86> ctx(0, 1, 1);
+    int oh = (c.h + 2 * c.pad_h - c.dilation * (c.kh - 1) - 1) / c.stride_h + 1;
+    int ow = (c.w + 2 * c.pad_w - c.dilation * (c.kw - 1) - 1) / c.stride_w + 1;
+    Tensor<X86> input(Shape({c.n, c.h, c.w, c.ic}, Layout_NHWC), in_dtype);
+    Tensor<X86> output(Shape({c.n, oh, ow, c.oc}, Layout_NHWC), out_dtype);
+    Tensor<X86> weights(Shape({c.oc, c.ic, c.kh, c.kw}), AK_INT8);
+    Tensor<X86> bias(Shape({1, c.oc, 1, 1}), AK_FLOAT);
+    uint8_t* in_data = static_cast<uint8_t*>(input.mutable_data());
+
+    for (int i = 0; i < input.valid_size(); i++) {
+        // 255 for u8, -1 for s8
+        in_data[i] = extremes ? 255 : rand() % 256;
+    }
+
+    std::vector<int8_t> wei(weights.valid_size());
+    std::vector<float> w_scale(c.oc);
+
+    for (int i = 0; i < wei.size(); i++) {
+        // pairs of u8 inputs at 255 and weights at 127 of the same sign exceed int16
+        wei[i] = extremes ? (rand() % 4 == 0 ? -127 : 127) : rand() % 255 - 127;
+    }
+
+    for (int o = 0; o < c.oc; o++) {
+        w_scale[o] = 0.001f + 0.0001f * (rand() % 100);
+    }
+
+    memcpy(weights.mutable_data(), wei.data(), wei.size());
+    weights.set_scale(w_scale);
+    fill_tensor_rand(bias, -2.f, 2.f);
+    float in_scale = 0.02f;
+    float out_scale = out_dtype == AK_FLOAT ? 1.f : 0.3f;
+    input.set_scale({in_scale});
+    output.set_scale({out_scale});
+
+    // previous output for the sum
+    uint8_t* out_data = static_cast<uint8_t*>(output.mutable_data());
+
+    for (int i = 0; i < output.valid_size() * sizeof(OutputDtype); i++) {
+        out_data[i] = rand() % 256;
+    }
+
+    std::vector<OutputDtype> prev(static_cast<OutputDtype*>(output.mutable_data()),
+                                  static_cast<OutputDtype*>(output.mutable_data()) + output.valid_size());
+
+    ActivationParam<X86> act = relu ? ActivationParam<X86>(Active_relu) : ActivationParam<X86>();
+    ConvParam<X86> conv_param(1, c.pad_h, c.pad_w, c.stride_h, c.stride_w, c.dilation, c.dilation,
+                              &weights, &bias, sum ? ActivationParam<X86>() : act, 1.f, beta, sum_dtype);
+    EltwiseParam<X86> elt_param(Eltwise_sum, {1.f, 1.f}, act);
+    elt_param.has_eltwise = sum;
+    ConvEltwiseParam<X86> param(conv_param, elt_param);
+    CHECK(Avx2X8S8S32XConv::available(conv_param));
+
+    std::vector<Tensor<X86>*> ins = {&input};
+    std::vector<Tensor<X86>*> outs = {&output};
+    Avx2X8S8S32XConv conv;
+    CHECK_EQ(conv.init(ins, outs, param, ctx), SaberSuccess);
+    CHECK_EQ(conv.dispatch(ins, outs, param), SaberSuccess);
+
+    // the epilogue of the kernel: bias and scale, relu, sum, relu after the sum, saturation
+    float fin = in_dtype == AK_UINT8 ? 127.f / 255.f : 1.f;
+    float fout = out_dtype == AK_UINT8 ? 127.f / 255.f : 1.f;
+    std::vector<float> bias_s32(c.oc);
+    std::vector<float> scale(c.oc);
+    const float* bias_data = static_cast<const float*>(bias.data());
+
+    for (int o = 0; o < c.oc; o++) {
+        bias_s32[o] = bias_data[o] * (1.f / (w_scale[o] * in_scale * fin));
+        scale[o] = (w_scale[o] * in_scale * fin) / (out_scale * fout);
+    }
+
+    float sum_scale = beta / out_scale;
+
+    if (sum_dtype == AK_INT8 && out_dtype == AK_UINT8) {
+        sum_scale = beta * (255.f / 127.f) / out_scale;
+    } else if (sum_dtype == AK_UINT8 && out_dtype == AK_INT8) {
+        sum_scale = beta * (127.f / 255.f) / out_scale;
+    }
+
+    std::vector<float> ref;
+    conv_int8_ref(c, oh, ow, input, wei, bias_s32, scale, ref);
+    const OutputDtype* result = static_cast<const OutputDtype*>(output.data());
+
+    for (int i = 0; i < ref.size(); i++) {
+        float d = ref[i];
+
+        if (relu && !sum) {
+            d = std::max(d, 0.f);
+        }
+
+        if (sum) {
+            float p = sum_dtype == AK_INT8 ? (float)(int8_t)prev[i] : (float)(uint8_t)prev[i];
+            d = sum_scale == 1.f ? d + p : fmaf(p, sum_scale, d);
+
+            if (relu || out_dtype == AK_UINT8) {
+                d = std::max(d, 0.f);
+            }
+        }
+
+        if (out_dtype != AK_FLOAT) {
+            float lo = out_dtype == AK_INT8 ? -128.f : 0.f;
+            float hi = out_dtype == AK_INT8 ? 127.f : 255.f;
+            d = nearbyintf(std::min(std::max(d, lo), hi));
+        }
+
+        CHECK_EQ((float)result[i], d) << "at " << i << " of " << c.ic << "x" << c.h << "x" << c.w
+                                      << " -> " << c.oc << " k" << c.kh << "x" << c.kw;
+    }
+}
+
+TEST(TestSaberFunc, test_saber_avx2_int8_conv) {
+    Env<X86>::env_init();
+    ConvEltwiseParam<X86> probe;
+    probe.conv_param.group = 1;
+
+    if (!Avx2X8S8S32XConv::available(probe.conv_param)) {
+        LOG(INFO) << "no avx2 int8 conv in this build, skip";
+        return;
+    }
+
+    std::vector<ConvCase> cases = {
+        {2, 35, 9, 11, 37, 1, 1, 1, 1, 0, 0, 1},
+        {1, 16, 12, 12, 32, 3, 3, 1, 1, 1, 1, 1},
+        {2, 7, 13, 10, 20, 3, 3, 2, 2, 1, 1, 1},
+        {1, 19, 9, 17, 33, 5, 3, 1, 2, 2, 1, 1},
+        {1, 12, 15, 15, 16, 3, 3, 1, 1, 2, 2, 2},
+        {1, 4, 3, 3, 5, 3, 3, 1, 1, 3, 3, 1},
+    };
+
+    for (auto& c : cases) {
+        for (DataType in_dtype : {AK_UINT8, AK_INT8}) {
+            for (bool relu : {false, true}) {
+                check_case<int8_t>(c, in_dtype, AK_INT8, relu, false, AK_INT8, 0.f);
+                check_case<uint8_t>(c, in_dtype, AK_UINT8, relu, false, AK_INT8, 0.f);
+                check_case<float>(c, in_dtype, AK_FLOAT, relu, false, AK_INT8, 0.f);
+                check_case<int8_t>(c, in_dtype, AK_INT8, relu, true, AK_INT8, 0.3f);
+                check_case<int8_t>(c, in_dtype, AK_INT8, relu, true, AK_UINT8, 0.5f);
+                check_case<uint8_t>(c, in_dtype, AK_UINT8, relu, true, AK_INT8, 0.2f);
+                check_case<uint8_t>(c, in_dtype, AK_UINT8, relu, true, AK_UINT8, 0.3f);
+            }
+        }
+    }
+
+    // the largest products, sums of pairs beyond int16
+    for (auto& c : cases) {
+        for (DataType in_dtype : {AK_UINT8, AK_INT8}) {
+            check_case<float>(c, in_dtype, AK_FLOAT, false, false, AK_INT8, 0.f, true);
+            check_case<int8_t>(c, in_dtype, AK_INT8, true, false, AK_INT8, 0.f, true);
+        }
+    }
+
+    LOG(INFO) << "avx2 int8 conv check pass";
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include "test_saber_func.h"
+#include "saber/core/context.h"
+#include "saber/core/tensor_op.h"
+#include "saber/funcs/fc.h"
+#include <cmath>
+#include <vector>
+using namespace anakin::saber;
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/bf16_gemm.h"
+
+float bits_float(uint32_t bits) {
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+float bf16_round(float x) {
+    return bf16_to_float(float_to_bf16(x));
+}
+
+/// c = a * b (+ c) as vdpbf16ps computes it: bf16 operands, the odd element of each pair first.
+void bf16_gemm_ref(int m, int n, int k, const std::vector<float>& a, const std::vector<float>& b,
+                   std::vector<float>& c, bool accumulate = false) {
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            float acc = accumulate ? c[i * n + j] : 0.f;
+            for (int p = 0; p < k; p += 2) {
+                if (p + 1 < k) {
+                    acc = fmaf(bf16_round(a[i * k + p + 1]), bf16_round(b[(p + 1) * n + j]), acc);
+                }
+                acc = fmaf(bf16_round(a[i * k + p]), bf16_round(b[p * n + j]), acc);
+            }
+            c[i * n + j] = acc;
+        }
+    }
+}
+
+TEST(TestSaberFunc, test_saber_bf16_convert) {
+    CHECK_EQ(float_to_bf16(1.f), 0x3f80);
+    // halfway cases round to even
+    CHECK_EQ(float_to_bf16(bits_float(0x3f808000u)), 0x3f80);
+    CHECK_EQ(float_to_bf16(bits_float(0x3f818000u)), 0x3f82);
+    CHECK_EQ(float_to_bf16(bits_float(0x3f808001u)), 0x3f81);
+    // denormals are flushed, nans stay nans
+    CHECK_EQ(float_to_bf16(bits_float(0x80000001u)), 0x8000);
+    CHECK(std::isnan(bf16_to_float(float_to_bf16(NAN))));
+    CHECK(std::isinf(bf16_to_float(float_to_bf16(INFINITY))));
+
+    Tensor<X86> tensor(Shape({1, 3, 5, 7}));
+    fill_tensor_rand(tensor, -1.f, 1.f);
+    std::vector<float> values((const float*)tensor.data(), (const float*)tensor.data() + tensor.valid_size());
+    tensor.set_scale({0.5f});
+    CHECK_EQ(tensor_to_bf16(tensor), SaberSuccess);
+    CHECK_EQ(tensor.get_dtype(), AK_BFLOAT16);
+    CHECK_EQ(tensor.valid_shape() == Shape({1, 3, 5, 7}), true);
+    CHECK_EQ(tensor.get_scale()[0], 0.5f);
+    CHECK_EQ(tensor_to_float(tensor), SaberSuccess);
+    for (int i = 0; i < values.size(); i++) {
+        CHECK_EQ(((const float*)tensor.data())[i], bf16_round(values[i]));
+    }
+}
+
+TEST(TestSaberFunc, test_saber_bf16_gemm) {
+    LOG(INFO) << "bf16 gemm runs " << (bf16_native() ? "avx512_bf16" : "emulated");
+    std::vector<std::vector<int> > shapes = {{1, 1, 1}, {3, 17, 5}, {4, 16, 32}, {7, 37, 29}, {33, 70, 128}};
+    for (auto& shape : shapes) {
+        int m = shape[0];
+        int n = shape[1];
+        int k = shape[2];
+        std::vector<float> a(m * k);
+        std::vector<float> b(k * n);
+        std::vector<float> b_trans(n * k);
+        for (int i = 0; i < a.size(); i++) {
+            a[i] = (float)(rand() % 2001 - 1000) / 137.f;
+        }
+        for (int i = 0; i < k; i++) {
+            for (int j = 0; j < n; j++) {
+                b[i * n + j] = (float)(rand() % 2001 - 1000) / 91.f;
+                b_trans[j * k + i] = b[i * n + j];
+            }
+        }
+        std::vector<float> ref(m * n);
+        bf16_gemm_ref(m, n, k, a, b, ref);
+
+        // fixed B, fp32 or transposed
+        std::vector<float> c(m * n, 0.f);
+        Bf16Gemm fc_like;
+        fc_like.init_b(false, n, k, b.data(), AK_FLOAT);
+        fc_like.dispatch_a(m, a.data(), k, c.data(), n, false);
+        CHECK_EQ(memcmp(c.data(), ref.data(), c.size() * sizeof(float)), 0) << m << "x" << n << "x" << k;
+        std::fill(c.begin(), c.end(), 0.f);
+        Bf16Gemm fc_trans;
+        fc_trans.init_b(true, n, k, b_trans.data(), AK_FLOAT);
+        fc_trans.dispatch_a(m, a.data(), k, c.data(), n, false);
+        CHECK_EQ(memcmp(c.data(), ref.data(), c.size() * sizeof(float)), 0) << m << "x" << n << "x" << k;
+
+        // fixed A stored as bf16, accumulated twice
+        std::vector<uint16_t> a_bf16(a.size());
+        float_to_bf16(a.data(), a_bf16.data(), a.size());
+        std::fill(c.begin(), c.end(), 0.f);
+        Bf16Gemm conv_like;
+        conv_like.init_a(false, m, k, a_bf16.data(), AK_BFLOAT16);
+        conv_like.dispatch_b(n, b.data(), n, c.data(), n, false);
+        CHECK_EQ(memcmp(c.data(), ref.data(), c.size() * sizeof(float)), 0) << m << "x" << n << "x" << k;
+        conv_like.dispatch_b(n, b.data(), n, c.data(), n, true);
+        // the products are added to c one pair at a time
+        std::vector<float> twice = ref;
+        bf16_gemm_ref(m, n, k, a, b, twice, true);
+        CHECK_EQ(memcmp(c.data(), twice.data(), c.size() * sizeof(float)), 0) << m << "x" << n << "x" << k;
+    }
+    LOG(INFO) << "bf16 gemm check pass";
+}
+
+/// fc with bf16 weights against fp32 weights, the weights are ic x oc when transpose is set.
+void check_bf16_fc(Shape in_shape, bool transpose) {
+    Context<X86> ctx(0, 1, 1);
+    int ic = in_shape.count() / in_shape.num();
+    int oc = 70;
+    Shape weights_shape = transpose ? Shape({1, 1, ic, oc}) : Shape({1, 1, oc, ic});
+    Tensor<X86> input(in_shape);
+    Tensor<X86> weights(weights_shape);
+    Tensor<X86> weights_bf16(weights_shape);
+    Tensor<X86> bias(Shape({1, 1, 1, oc}));
+    fill_tensor_rand(input, -1.f, 1.f);
+    fill_tensor_rand(weights, -1.f, 1.f);
+    fill_tensor_rand(bias, -1.f, 1.f);
+    weights_bf16.copy_from(weights);
+    tensor_to_bf16(weights_bf16);
+
+    std::vector<Tensor<X86>*> ins = {&input};
+    Tensor<X86> out_fp32;
+    Tensor<X86> out_bf16;
+    std::vector<Tensor<X86>*> outs_fp32 = {&out_fp32};
+    std::vector<Tensor<X86>*> outs_bf16 = {&out_bf16};
+    FcParam<X86> param_fp32(&weights, &bias, oc, 1, transpose);
+    FcParam<X86> param_bf16(&weights_bf16, &bias, oc, 1, transpose);
+    Fc<X86, AK_FLOAT> fc_fp32;
+    Fc<X86, AK_FLOAT> fc_bf16;
+    fc_fp32.compute_output_shape(ins, outs_fp32, param_fp32);
+    fc_bf16.compute_output_shape(ins, outs_bf16, param_bf16);
+    out_fp32.re_alloc(out_fp32.valid_shape());
+    out_bf16.re_alloc(out_bf16.valid_shape());
+    fc_fp32.init(ins, outs_fp32, param_fp32, SPECIFY, VENDER_IMPL, ctx);
+    fc_bf16.init(ins, outs_bf16, param_bf16, SPECIFY, VENDER_IMPL, ctx);
+    fc_fp32(ins, outs_fp32, param_fp32, ctx);
+    fc_bf16(ins, outs_bf16, param_bf16, ctx);
+
+    // each bf16 operand is off by at most 2^-9 relatively
+    const float* expect = (const float*)out_fp32.data();
+    const float* result = (const float*)out_bf16.data();
+    for (int i = 0; i < out_fp32.valid_size(); i++) {
+        CHECK_LE(fabsf(expect[i] - result[i]), ic * 2.f / 256.f) << "at " << i;
+    }
+    double max_ratio = 0.;
+    double max_diff = 0.;
+    tensor_cmp_host(expect, result, out_fp32.valid_size(), max_ratio, max_diff);
+    LOG(INFO) << "bf16 fc " << in_shape.get_layout() << (transpose ? " transposed" : "")
+              << " max diff " << max_diff << ", ratio " << max_ratio;
+}
+
+TEST(TestSaberFunc, test_saber_bf16_fc) {
+    Env<X86>::env_init();
+    check_bf16_fc(Shape({9, 300, 1, 1}), false);
+    check_bf16_fc(Shape({9, 300, 1, 1}), true);
+    // the bf16 gemm takes plain layouts only, nhwc runs the weights as fp32
+    check_bf16_fc(Shape({9, 2, 3, 50}, Layout_NHWC), false);
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "test_saber_func.h"
+#include "saber/core/context.h"
+#include "saber/core/tensor_op.h"
+#include "saber/funcs/embedding.h"
+#include "saber/funcs/embedding_seq_pool.h"
+#include "saber/funcs/sequence_pool.h"
+#include <cmath>
+#include <vector>
+using namespace anakin::saber;
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/embedding_quant.h"
+
+/// element j of row i of a quantized table, dequantized the plain way.
+float dequant_ref(const Tensor<X86>& table, int emb_dim, int i, int j) {
+    const int8_t* data = (const int8_t*)table.data();
+    float scale = table.get_scale()[i];
+    if (table.get_dtype() == AK_INT8) {
+        return data[i * emb_dim + j] * scale;
+    }
+    int byte = data[i * ((emb_dim + 1) / 2) + j / 2];
+    int q = (j % 2) ? (byte >> 4) : ((byte & 0xf) >= 8 ? (byte & 0xf) - 16 : (byte & 0xf));
+    return q * scale;
+}
+
+TEST(TestSaberFunc, test_saber_embedding_quant) {
+    std::vector<int> dims = {1, 7, 16, 37, 64, 100};
+    for (auto dtype : {AK_INT8, AK_INT4}) {
+        for (int emb_dim : dims) {
+            int word_num = 33;
+            Tensor<X86> table(Shape({1, 1, word_num, emb_dim}));
+            fill_tensor_rand(table, -2.f, 2.f);
+            // a zero row keeps a zero scale
+            memset((float*)table.mutable_data() + 5 * emb_dim, 0, sizeof(float) * emb_dim);
+            std::vector<float> values((const float*)table.data(), (const float*)table.data() + table.valid_size());
+            CHECK_EQ(quantize_embedding_table(table, emb_dim, dtype), SaberSuccess);
+            CHECK_EQ(table.get_dtype(), dtype);
+            CHECK_EQ(table.get_scale().size(), word_num);
+            CHECK_EQ(table.valid_size(), word_num * (dtype == AK_INT8 ? emb_dim : (emb_dim + 1) / 2));
+            CHECK_EQ(table.get_scale()[5], 0.f);
+
+            std::vector<float> row(emb_dim);
+            std::vector<float> acc(emb_dim, 1.f);
+            for (int i = 0; i < word_num; i++) {
+                float scale = table.get_scale()[i];
+                embedding_row(table, i, emb_dim, row.data(), false);
+                embedding_row(table, i, emb_dim, acc.data(), true);
+                for (int j = 0; j < emb_dim; j++) {
+                    float expect = dequant_ref(table, emb_dim, i, j);
+                    CHECK_EQ(row[j], expect) << i << ", " << j;
+                    CHECK_LE(fabsf(row[j] - values[i * emb_dim + j]), scale * 0.5f + 1e-6f);
+                }
+            }
+            LOG(INFO) << (dtype == AK_INT8 ? "int8" : "int4") << " table of dim " << emb_dim << " check pass";
+        }
+    }
+}
+
+TEST(TestSaberFunc, test_saber_embedding_seq_pool) {
+    Env<X86>::env_init();
+    Context<X86> ctx(0, 1, 1);
+    int word_num = 100;
+    int emb_dim = 45;
+    int padding_idx = 3;
+    // the unfused pool reads past empty sequences, every sequence has a word
+    std::vector<int> offset = {0, 4, 5, 11, 12, 20};
+    Tensor<X86> ids(Shape({offset.back(), 1, 1, 1}));
+    float* id_data = (float*)ids.mutable_data();
+    for (int i = 0; i < ids.valid_size(); i++) {
+        id_data[i] = (i * 37 + 1) % word_num;
+    }
+    id_data[2] = padding_idx;
+    ids.set_seq_offset({offset});
+    std::vector<Tensor<X86>*> ins = {&ids};
+
+    for (auto dtype : {AK_FLOAT, AK_INT8, AK_INT4}) {
+        Tensor<X86> table(Shape({1, 1, word_num, emb_dim}));
+        fill_tensor_rand(table, -1.f, 1.f);
+        if (dtype != AK_FLOAT) {
+            quantize_embedding_table(table, emb_dim, dtype);
+        }
+        EmbeddingParam<X86> emb_param(word_num, emb_dim, padding_idx, &table);
+        // the unfused graph, Embedding -> SequencePool, is the reference
+        Tensor<X86> rows;
+        std::vector<Tensor<X86>*> rows_v = {&rows};
+        Embedding<X86, AK_FLOAT> embedding;
+        embedding.compute_output_shape(ins, rows_v, emb_param);
+        rows.re_alloc(rows.valid_shape());
+        embedding.init(ins, rows_v, emb_param, SPECIFY, SABER_IMPL, ctx);
+        embedding(ins, rows_v, emb_param, ctx);
+
+        for (auto pool_type : {Sequence_pool_sum, Sequence_pool_average, Sequence_pool_sqrt,
+                               Sequence_pool_max, Sequence_pool_first, Sequence_pool_last}) {
+            SequencePoolParam<X86> pool_param(pool_type);
+            Tensor<X86> pooled;
+            std::vector<Tensor<X86>*> pooled_v = {&pooled};
+            SequencePool<X86, AK_FLOAT> seq_pool;
+            seq_pool.compute_output_shape(rows_v, pooled_v, pool_param);
+            pooled.re_alloc(pooled.valid_shape());
+            seq_pool.init(rows_v, pooled_v, pool_param, SPECIFY, SABER_IMPL, ctx);
+            seq_pool(rows_v, pooled_v, pool_param, ctx);
+
+            EmbeddingSeqPoolParam<X86> param(emb_param, pool_param);
+            Tensor<X86> out;
+            std::vector<Tensor<X86>*> outs = {&out};
+            EmbeddingSeqPool<X86, AK_FLOAT> fused;
+            fused.compute_output_shape(ins, outs, param);
+            CHECK(out.valid_shape() == pooled.valid_shape()) << out.valid_shape() << " vs " << pooled.valid_shape();
+            CHECK(out.get_seq_offset() == pooled.get_seq_offset()) << "seq offset of the fused output differs";
+            out.re_alloc(out.valid_shape());
+            fused.init(ins, outs, param, SPECIFY, SABER_IMPL, ctx);
+            fused(ins, outs, param, ctx);
+            CHECK(out.get_seq_offset() == pooled.get_seq_offset()) << "seq offset of the fused output differs";
+            const float* out_data = (const float*)out.data();
+            const float* expect = (const float*)pooled.data();
+            for (int i = 0; i < pooled.valid_size(); i++) {
+                // the fused sums scale with fma
+                CHECK_LE(fabsf(out_data[i] - expect[i]), 1e-5f)
+                        << "dtype " << dtype << ", pool " << pool_type << " at " << i;
+            }
+        }
+    }
+    LOG(INFO) << "embedding seq pool check pass";
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "test_saber_func.h"
+#include "saber/core/context.h"
+#include "saber/core/tensor_op.h"
+#include "saber/funcs/fc.h"
+#include "saber/funcs/embedding.h"
+#include <cmath>
+#include <vector>
+using namespace anakin::saber;
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/fp16_gemm.h"
+
+float half_round(float x) {
+    return half_to_float(float_to_half(x));
+}
+
+TEST(TestSaberFunc, test_saber_fp16_convert) {
+    CHECK_EQ(float_to_half(1.f), 0x3c00);
+    CHECK_EQ(float_to_half(65504.f), 0x7bff);
+    CHECK_EQ(float_to_half(65520.f), 0x7c00);
+    // smallest subnormal and halfway cases round to even
+    CHECK_EQ(float_to_half(5.9604645e-8f), 0x0001);
+    CHECK_EQ(float_to_half(1.f + 1.f / 2048.f), 0x3c00);
+    CHECK_EQ(float_to_half(1.f + 3.f / 2048.f), 0x3c02);
+    // every half survives a round trip, scalar and bulk agree
+    std::vector<uint16_t> halves;
+    for (int h = 0; h < 65536; h++) {
+        if ((h & 0x7c00) != 0x7c00) {
+            halves.push_back(h);
+        }
+    }
+    std::vector<float> floats(halves.size());
+    std::vector<uint16_t> back(halves.size());
+    half_to_float(halves.data(), floats.data(), halves.size());
+    float_to_half(floats.data(), back.data(), floats.size());
+    for (int i = 0; i < halves.size(); i++) {
+        CHECK_EQ(floats[i], half_to_float(halves[i]));
+        CHECK_EQ(back[i], halves[i]);
+    }
+}
+
+TEST(TestSaberFunc, test_saber_fp16_gemm) {
+    std::vector<std::vector<int> > shapes = {{1, 1, 1}, {3, 17, 5}, {4, 16, 32}, {7, 37, 29}, {33, 70, 128}};
+    for (auto& shape : shapes) {
+        int m = shape[0];
+        int n = shape[1];
+        int k = shape[2];
+        std::vector<float> a(m * k);
+        std::vector<float> b(k * n);
+        std::vector<uint16_t> b_trans(n * k);
+        for (int i = 0; i < a.size(); i++) {
+            a[i] = (float)(rand() % 2001 - 1000) / 137.f;
+        }
+        for (int i = 0; i < k; i++) {
+            for (int j = 0; j < n; j++) {
+                b[i * n + j] = (float)(rand() % 2001 - 1000) / 91.f;
+                b_trans[j * k + i] = float_to_half(b[i * n + j]);
+            }
+        }
+        // fp32 activations, fp16 weights, k accumulated in order
+        std::vector<float> ref(m * n);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                float acc = 0.f;
+                for (int p = 0; p < k; p++) {
+                    acc = fmaf(a[i * k + p], half_round(b[p * n + j]), acc);
+                }
+                ref[i * n + j] = acc;
+            }
+        }
+
+        std::vector<float> c(m * n, 0.f);
+        Fp16Gemm gemm;
+        gemm.init_b(false, n, k, b.data(), AK_FLOAT);
+        gemm.dispatch_a(m, a.data(), k, c.data(), n, false);
+        CHECK_EQ(memcmp(c.data(), ref.data(), c.size() * sizeof(float)), 0) << m << "x" << n << "x" << k;
+        Fp16Gemm gemm_trans;
+        gemm_trans.init_b(true, n, k, b_trans.data(), AK_HALF);
+        gemm_trans.dispatch_a(m, a.data(), k, c.data(), n, true);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                float acc = ref[i * n + j];
+                for (int p = 0; p < k; p++) {
+                    acc = fmaf(a[i * k + p], half_round(b[p * n + j]), acc);
+                }
+                CHECK_EQ(c[i * n + j], acc);
+            }
+        }
+    }
+    LOG(INFO) << "fp16 gemm check pass";
+}
+
+/// fc with fp16 weights against fp32 weights, the weights are ic x oc when transpose is set.
+void check_fp16_fc(Shape in_shape, bool transpose) {
+    Context<X86> ctx(0, 1, 1);
+    int ic = in_shape.count() / in_shape.num();
+    int oc = 70;
+    Shape weights_shape = transpose ? Shape({1, 1, ic, oc}) : Shape({1, 1, oc, ic});
+    Tensor<X86> input(in_shape);
+    Tensor<X86> weights(weights_shape);
+    Tensor<X86> weights_fp16(weights_shape);
+    fill_tensor_rand(input, -1.f, 1.f);
+    fill_tensor_rand(weights, -1.f, 1.f);
+    weights_fp16.copy_from(weights);
+    tensor_to_half(weights_fp16);
+
+    std::vector<Tensor<X86>*> ins = {&input};
+    Tensor<X86> out_fp32;
+    Tensor<X86> out_fp16;
+    std::vector<Tensor<X86>*> outs_fp32 = {&out_fp32};
+    std::vector<Tensor<X86>*> outs_fp16 = {&out_fp16};
+    FcParam<X86> param_fp32(&weights, oc, 1, transpose);
+    FcParam<X86> param_fp16(&weights_fp16, oc, 1, transpose);
+    Fc<X86, AK_FLOAT> fc_fp32;
+    Fc<X86, AK_FLOAT> fc_fp16;
+    fc_fp32.compute_output_shape(ins, outs_fp32, param_fp32);
+    fc_fp16.compute_output_shape(ins, outs_fp16, param_fp16);
+    out_fp32.re_alloc(out_fp32.valid_shape());
+    out_fp16.re_alloc(out_fp16.valid_shape());
+    fc_fp32.init(ins, outs_fp32, param_fp32, SPECIFY, VENDER_IMPL, ctx);
+    fc_fp16.init(ins, outs_fp16, param_fp16, SPECIFY, VENDER_IMPL, ctx);
+    fc_fp32(ins, outs_fp32, param_fp32, ctx);
+    fc_fp16(ins, outs_fp16, param_fp16, ctx);
+    // each weight is off by at most 2^-11 relatively
+    const float* expect = (const float*)out_fp32.data();
+    const float* result = (const float*)out_fp16.data();
+    for (int i = 0; i < out_fp32.valid_size(); i++) {
+        CHECK_LE(fabsf(expect[i] - result[i]), ic / 1024.f) << "at " << i;
+    }
+}
+
+TEST(TestSaberFunc, test_saber_fp16_fc_embedding) {
+    Env<X86>::env_init();
+    Context<X86> ctx(0, 1, 1);
+    check_fp16_fc(Shape({9, 300, 1, 1}), false);
+    check_fp16_fc(Shape({9, 300, 1, 1}), true);
+    // the fp16 gemm takes plain layouts only, nhwc runs the weights as fp32
+    check_fp16_fc(Shape({9, 2, 3, 50}, Layout_NHWC), false);
+
+    // embedding: the rows of a fp16 table are the rounded fp32 rows
+    int word_num = 50;
+    int emb_dim = 37;
+    Tensor<X86> table(Shape({1, 1, word_num, emb_dim}));
+    fill_tensor_rand(table, -1.f, 1.f);
+    Tensor<X86> table_fp16(table.valid_shape());
+    table_fp16.copy_from(table);
+    tensor_to_half(table_fp16);
+    Tensor<X86> ids(Shape({6, 1, 1, 1}));
+    float* id_data = (float*)ids.mutable_data();
+    for (int i = 0; i < ids.valid_size(); i++) {
+        id_data[i] = (i * 17) % word_num;
+    }
+    ids.set_seq_offset({{0, ids.valid_size()}});
+    std::vector<Tensor<X86>*> emb_ins = {&ids};
+    Tensor<X86> emb_out;
+    std::vector<Tensor<X86>*> emb_outs = {&emb_out};
+    EmbeddingParam<X86> emb_param(word_num, emb_dim, -1, &table_fp16);
+    Embedding<X86, AK_FLOAT> embedding;
+    embedding.compute_output_shape(emb_ins, emb_outs, emb_param);
+    emb_out.re_alloc(emb_out.valid_shape());
+    embedding.init(emb_ins, emb_outs, emb_param, SPECIFY, SABER_IMPL, ctx);
+    embedding(emb_ins, emb_outs, emb_param, ctx);
+    const float* rows = (const float*)table.data();
+    const float* looked_up = (const float*)emb_out.data();
+    for (int i = 0; i < ids.valid_size(); i++) {
+        for (int j = 0; j < emb_dim; j++) {
+            CHECK_EQ(looked_up[i * emb_dim + j], half_round(rows[int(id_data[i]) * emb_dim + j]));
+        }
+    }
+    LOG(INFO) << "fp16 fc and embedding check pass";
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
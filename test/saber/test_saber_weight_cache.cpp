@@ -0,0 +1,80 @@
+#include "test_saber_func.h"
+#include "saber/core/weight_cache.h"
+#include <cstdio>
+using namespace anakin::saber;
+
+TEST(TestSaberFunc, test_saber_weight_cache) {
+    std::string path = "test_saber_weight_cache.bin";
+    remove(path.c_str());
+    std::vector<float> weights(1000);
+    for (int i = 0; i < weights.size(); i++) {
+        weights[i] = 0.1f * i;
+    }
+    int builds = 0;
+    auto build_into = [&](std::vector<float>& packed) {
+        return [&]() {
+            builds++;
+            for (int i = 0; i < weights.size(); i++) {
+                packed[i] = weights[weights.size() - 1 - i];
+            }
+        };
+    };
+    auto load_or_build = [&](std::vector<float>& packed, float attr) {
+        WeightCache::load_or_build("test/reverse", weights.data(), weights.size() * sizeof(float), {attr},
+                                   packed.data(), packed.size() * sizeof(float), build_into(packed));
+    };
+    // without a current cache the weights are just built.
+    std::vector<float> packed(weights.size());
+    load_or_build(packed, 1.f);
+    CHECK_EQ(builds, 1);
+    // the first process builds and saves.
+    {
+        auto cache = WeightCache::open(path);
+        WeightCache::Scope scope(cache);
+        load_or_build(packed, 1.f);
+        CHECK_EQ(builds, 2);
+        CHECK_EQ(cache->misses(), 1);
+        CHECK(cache->save());
+    }
+    // the next one loads, unless anything the weights are derived from changed.
+    {
+        auto cache = WeightCache::open(path);
+        WeightCache::Scope scope(cache);
+        std::vector<float> loaded(weights.size(), 0.f);
+        load_or_build(loaded, 1.f);
+        CHECK_EQ(builds, 2);
+        CHECK_EQ(cache->hits(), 1);
+        for (int i = 0; i < weights.size(); i++) {
+            CHECK_EQ(loaded[i], packed[i]);
+        }
+        load_or_build(loaded, 2.f);
+        CHECK_EQ(builds, 3);
+        weights[500] += 1.f;
+        load_or_build(loaded, 1.f);
+        CHECK_EQ(builds, 4);
+        CHECK(cache->save());
+    }
+    {
+        auto cache = WeightCache::open(path);
+        CHECK(WeightCache::current() == nullptr);
+        WeightCache::Scope scope(cache);
+        CHECK_EQ(WeightCache::current(), cache.get());
+        // all the versions are kept.
+        load_or_build(packed, 1.f);
+        weights[500] -= 1.f;
+        load_or_build(packed, 1.f);
+        load_or_build(packed, 2.f);
+        CHECK_EQ(builds, 4);
+        CHECK_EQ(cache->hits(), 3);
+    }
+    remove(path.c_str());
+    LOG(INFO) << "weight cache check pass";
+}
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "test_saber_func.h"
+#include "saber/core/weight_registry.h"
+#include <thread>
+#include <atomic>
+using namespace anakin::saber;
+
+TEST(TestSaberFunc, test_saber_weight_registry) {
+    auto& registry = WeightRegistry::global();
+    std::vector<float> weights(1000);
+    for (int i = 0; i < weights.size(); i++) {
+        weights[i] = 0.1f * i;
+    }
+    std::atomic<int> builds{0};
+    std::function<std::shared_ptr<std::vector<float> >()> pack = [&]() {
+        builds++;
+        return std::make_shared<std::vector<float> >(weights.rbegin(), weights.rend());
+    };
+    std::string key = WeightRegistry::make_key("test/reverse", weights.data(),
+                      weights.size() * sizeof(float), {1000.f});
+    // every thread gets the same copy, it is built once.
+    {
+        std::vector<std::shared_ptr<const std::vector<float> > > users(8);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < users.size(); t++) {
+            threads.emplace_back([&, t]() {
+                users[t] = registry.get_or_create<std::vector<float> >(key, weights.size() * sizeof(float), pack);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK_EQ(builds.load(), 1);
+        for (auto& user : users) {
+            CHECK_EQ(user.get(), users[0].get());
+        }
+        CHECK_EQ((*users[0])[0], weights.back());
+        CHECK_EQ(registry.shared_bytes(), weights.size() * sizeof(float));
+        CHECK_EQ(registry.unshared_bytes(), 8 * weights.size() * sizeof(float));
+        LOG(INFO) << "weight registry report:\n" << registry.report();
+    }
+    // the memory goes away with the last user, the next one builds again.
+    CHECK_EQ(registry.shared_bytes(), 0);
+    registry.get_or_create<std::vector<float> >(key, weights.size() * sizeof(float), pack);
+    CHECK_EQ(builds.load(), 2);
+
+    // different content or attrs give different keys.
+    CHECK_NE(key, WeightRegistry::make_key("test/reverse", weights.data(),
+                                           weights.size() * sizeof(float), {999.f}));
+    CHECK_NE(WeightRegistry::make_key("test/reverse", weights.data(), weights.size() * sizeof(float)),
+             WeightRegistry::make_key("test/reverse", weights.data(), weights.size() * sizeof(float) - 4));
+    CHECK_NE(key, WeightRegistry::make_key("test/reverse", weights.data(),
+                                           weights.size() * sizeof(float), {1000.0001f}));
+    // every word counts, and equal weights elsewhere share the key.
+    std::vector<float> copy(weights);
+    CHECK_EQ(key, WeightRegistry::make_key("test/reverse", copy.data(), copy.size() * sizeof(float), {1000.f}));
+    copy[777] += 1.f;
+    CHECK_NE(key, WeightRegistry::make_key("test/reverse", copy.data(), copy.size() * sizeof(float), {1000.f}));
+
+    // the registry isn't held while a key builds, a build may use other keys.
+    std::string outer_key = WeightRegistry::make_key("test/outer", copy.data(), copy.size() * sizeof(float));
+    std::function<std::shared_ptr<std::vector<float> >()> outer = [&]() {
+        std::shared_ptr<const std::vector<float> > inner;
+        std::thread other([&]() {
+            inner = registry.get_or_create<std::vector<float> >(key, weights.size() * sizeof(float), pack);
+        });
+        other.join();
+        return std::make_shared<std::vector<float> >(*inner);
+    };
+    auto outer_weights = registry.get_or_create<std::vector<float> >(outer_key, copy.size() * sizeof(float), outer);
+    CHECK_EQ((*outer_weights)[0], weights.back());
+    registry.purge();
+    LOG(INFO) << "weight registry check pass";
+}
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "test_saber_func.h"
+#include "saber/core/context.h"
+#include "saber/core/tensor_op.h"
+#include <cmath>
+#include <vector>
+using namespace anakin::saber;
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/winograd.h"
+#include "saber/funcs/impl/x86/winograd_avx2.h"
+#include "saber/funcs/impl/x86/anakin_thread.h"
+
+TEST(TestSaberFunc, test_saber_winograd_select_tile) {
+    // deep layers on small maps take the small tile, F(6x6) would mostly compute padding
+    CHECK_EQ(winograd_select_tile(512, 512, 7, 7), 4);
+    CHECK_EQ(winograd_select_tile(256, 256, 14, 14), 4);
+    CHECK_GT(winograd_select_tile(64, 64, 56, 56), 0);
+    // too few channels for the transforms to pay off
+    CHECK_EQ(winograd_select_tile(3, 64, 224, 224), 0);
+    CHECK_EQ(winograd_select_tile(4, 4, 56, 56), 0);
+    LOG(INFO) << "winograd tile of 64x64 56x56: " << winograd_select_tile(64, 64, 56, 56)
+              << ", of 128x128 28x28: " << winograd_select_tile(128, 128, 28, 28);
+}
+
+TEST(TestSaberFunc, test_saber_winograd_conv) {
+#if defined(__AVX2__) and defined(__FMA__)
+    Env<X86>::env_init();
+    Context<X86> ctx(0, 1, 1);
+    // n, ic, oc, h, w, pad
+    std::vector<std::vector<int> > shapes = {{1, 16, 16, 12, 12, 1}, {2, 7, 19, 17, 13, 1},
+        {3, 32, 24, 9, 23, 2}, {1, 40, 33, 28, 28, 1}, {2, 3, 5, 5, 4, 3}};
+
+    for (int tile : {4, 6}) {
+        for (auto& shape : shapes) {
+            for (bool with_relu : {false, true}) {
+                int n = shape[0];
+                int ic = shape[1];
+                int oc = shape[2];
+                int h = shape[3];
+                int w = shape[4];
+                int pad = shape[5];
+                int oh = h + 2 * pad - 2;
+                int ow = w + 2 * pad - 2;
+                Tensor<X86> input(Shape({n, ic, h, w}));
+                Tensor<X86> output(Shape({n, oc, oh, ow}));
+                Tensor<X86> weights(Shape({oc, ic, 3, 3}));
+                Tensor<X86> bias(Shape({1, oc, 1, 1}));
+                fill_tensor_rand(input, -1.f, 1.f);
+                fill_tensor_rand(weights, -1.f, 1.f);
+                fill_tensor_rand(bias, -1.f, 1.f);
+
+                ActivationParam<X86> act = with_relu ? ActivationParam<X86>(Active_relu) : ActivationParam<X86>();
+                ConvParam<X86> conv_param(1, pad, pad, 1, 1, 1, 1, &weights, &bias, act);
+                EltwiseParam<X86> elt_param(Eltwise_sum);
+                elt_param.has_eltwise = false;
+                ConvEltwiseParam<X86> param(conv_param, elt_param);
+                std::vector<Tensor<X86>*> ins = {&input};
+                std::vector<Tensor<X86>*> outs = {&output};
+                SaberConvWinogradAvx2<AK_FLOAT> conv(tile);
+                CHECK_EQ(conv.init(ins, outs, param, ctx), SaberSuccess);
+                CHECK_EQ(conv.dispatch(ins, outs, param), SaberSuccess);
+
+                // direct conv; the error bound scales with the sum of |x * w| of each output
+                const float* x = static_cast<const float*>(input.data());
+                const float* wt = static_cast<const float*>(weights.data());
+                const float* b = static_cast<const float*>(bias.data());
+                const float* result = static_cast<const float*>(output.data());
+                double max_error = 0.;
+
+                for (int i = 0; i < n * oc * oh * ow; i++) {
+                    int ox = i % ow;
+                    int oy = i / ow % oh;
+                    int o = i / (ow * oh) % oc;
+                    int b_idx = i / (ow * oh * oc);
+                    double acc = b[o];
+                    double abs_sum = fabs(b[o]);
+
+                    for (int c = 0; c < ic; c++) {
+                        for (int ky = 0; ky < 3; ky++) {
+                            for (int kx = 0; kx < 3; kx++) {
+                                int iy = oy - pad + ky;
+                                int ix = ox - pad + kx;
+
+                                if (iy < 0 || iy >= h || ix < 0 || ix >= w) {
+                                    continue;
+                                }
+
+                                double p = (double)x[((b_idx * ic + c) * h + iy) * w + ix]
+                                           * wt[((o * ic + c) * 3 + ky) * 3 + kx];
+                                acc += p;
+                                abs_sum += fabs(p);
+                            }
+                        }
+                    }
+
+                    if (with_relu) {
+                        acc = std::max(acc, 0.);
+                    }
+
+                    double error = fabs(result[i] - acc) / (abs_sum + 1.);
+                    max_error = std::max(max_error, error);
+                    CHECK_LE(error, tile == 4 ? 1e-5 : 1e-4) << "F(" << tile << ") at " << i
+                            << " of " << ic << "x" << h << "x" << w << " -> " << oc;
+                }
+
+                DLOG(INFO) << "F(" << tile << "x" << tile << ",3x3) max relative error " << max_error;
+            }
+        }
+    }
+
+    LOG(INFO) << "winograd conv check pass";
+#endif
+}
+
+TEST(TestSaberFunc, test_saber_winograd_conv_threads) {
+#if defined(__AVX2__) and defined(__FMA__)
+    Env<X86>::env_init();
+    Context<X86> ctx(0, 1, 1);
+    // the thread count changes after init: the workspace and the blocks follow it
+    int n = 2;
+    int ic = 32;
+    int oc = 24;
+    int h = 30;
+    int w = 30;
+    Tensor<X86> input(Shape({n, ic, h, w}));
+    Tensor<X86> weights(Shape({oc, ic, 3, 3}));
+    Tensor<X86> output(Shape({n, oc, h, w}));
+    Tensor<X86> output_more(Shape({n, oc, h, w}));
+    fill_tensor_rand(input, -1.f, 1.f);
+    fill_tensor_rand(weights, -1.f, 1.f);
+    ConvParam<X86> conv_param(1, 1, 1, 1, 1, 1, 1, &weights, nullptr);
+    EltwiseParam<X86> elt_param(Eltwise_sum);
+    elt_param.has_eltwise = false;
+    ConvEltwiseParam<X86> param(conv_param, elt_param);
+    std::vector<Tensor<X86>*> ins = {&input};
+    std::vector<Tensor<X86>*> outs = {&output};
+    std::vector<Tensor<X86>*> outs_more = {&output_more};
+    int nthreads = anakin_get_max_threads();
+    anakin_set_num_threads(1);
+    SaberConvWinogradAvx2<AK_FLOAT> conv(4);
+    CHECK_EQ(conv.init(ins, outs, param, ctx), SaberSuccess);
+    CHECK_EQ(conv.dispatch(ins, outs, param), SaberSuccess);
+    anakin_set_num_threads(nthreads * 2);
+    CHECK_EQ(conv.dispatch(ins, outs_more, param), SaberSuccess);
+    anakin_set_num_threads(nthreads);
+
+    const float* expect = static_cast<const float*>(output.data());
+    const float* result = static_cast<const float*>(output_more.data());
+
+    for (int i = 0; i < output.valid_size(); i++) {
+        CHECK_LE(fabsf(expect[i] - result[i]), 1e-4f * (1.f + fabsf(expect[i]))) << "at " << i;
+    }
+
+    LOG(INFO) << "winograd conv threads check pass";
+#endif
+}
+
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}